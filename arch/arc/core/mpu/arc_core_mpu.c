@@ -10,6 +10,7 @@
 #include <soc.h>
 #include <arch/arc/v2/mpu/arc_core_mpu.h>
 #include <kernel_structs.h>
+#include <kernel_internal.h>
 
 /*
  * @brief Configure MPU for the thread
@@ -20,6 +21,8 @@
  */
 void configure_mpu_thread(struct k_thread *thread)
 {
+	z_user_current_set(thread);
+
 	arc_core_mpu_disable();
 	arc_core_mpu_configure_thread(thread);
 	arc_core_mpu_enable();
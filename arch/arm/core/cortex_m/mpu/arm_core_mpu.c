@@ -9,6 +9,7 @@
 #include <kernel.h>
 #include <soc.h>
 #include <kernel_structs.h>
+#include <kernel_internal.h>
 
 #include "arm_core_mpu_dev.h"
 #include <linker/linker-defs.h>
@@ -156,6 +157,9 @@ void z_arch_configure_dynamic_mpu_regions(struct k_thread *thread)
 #if defined(CONFIG_USERSPACE)
 	struct k_mem_partition thread_stack;
 
+	/* Called on every context switch, with the incoming thread */
+	z_user_current_set(thread);
+
 	/* Memory domain */
 	LOG_DBG("configure thread %p's domain", thread);
 	struct k_mem_domain *mem_domain = thread->mem_domain_info.mem_domain;
@@ -37,7 +37,6 @@ void z_impl_k_thread_abort(k_tid_t thread)
 		 "essential thread aborted");
 
 	z_thread_single_abort(thread);
-	z_thread_monitor_exit(thread);
 
 	if (_current == thread) {
 		if ((SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) == 0) {
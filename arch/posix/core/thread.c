@@ -16,6 +16,7 @@
 #include <toolchain.h>
 #include <kernel_structs.h>
 #include <wait_q.h>
+#include <debug/tracing.h>
 
 #include "posix_core.h"
 #include "posix_soc_if.h"
@@ -78,5 +79,11 @@ void z_new_thread(struct k_thread *thread, k_thread_stack_t *stack,
 
 void posix_new_thread_pre_start(void)
 {
+#ifdef CONFIG_TRACING
+	/* A new thread doesn't return from __swap(), so report it as
+	 * switched in here
+	 */
+	z_sys_trace_thread_switched_in();
+#endif
 	posix_irq_full_unlock();
 }
@@ -183,6 +183,13 @@
 				     MMU_ENTRY_SUPERVISOR | \
 				     MMU_ENTRY_EXECUTE_DISABLE)
 
+#ifdef CONFIG_X86_KPTI
+/* Partitions are only applied to the user page tables, the kernel
+ * always runs on its own where they stay writable
+ */
+#define K_MEM_PARTITION_P_RW_U_RO   K_MEM_PARTITION_P_RO_U_RO
+#endif
+
 /* Execution-allowed attributes */
 #define K_MEM_PARTITION_P_RWX_U_RWX (MMU_ENTRY_WRITE | MMU_ENTRY_USER)
 
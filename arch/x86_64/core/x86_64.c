@@ -138,11 +138,29 @@ void z_arch_sched_ipi(void)
 	};
 }
 
+/* Physical APIC ID of each CPU, recorded as they start.  Not in
+ * .bss, which is zeroed after the first CPU starts.
+ */
+static __noinit u8_t cpu_apic_id[CONFIG_MP_NUM_CPUS];
+
+void z_arch_sched_ipi_cpu(int cpu)
+{
+	_apic.ICR_HI = (struct apic_icr_hi) {
+		.destination = cpu_apic_id[cpu],
+	};
+	_apic.ICR_LO = (struct apic_icr_lo) {
+		.delivery_mode = FIXED,
+		.vector = SCHED_IPI_VECTOR,
+		.shorthand = NONE,
+	};
+}
+
 
 /* Called from xuk layer on actual CPU start */
 void z_cpu_start(int cpu)
 {
 	xuk_set_f_ptr(cpu, &_kernel.cpus[cpu]);
+	cpu_apic_id[cpu] = _apic.ID >> 24;
 
 	/* Set up the timer ISR, but ensure the timer is disabled */
 	xuk_set_isr(INT_APIC_LVT_TIMER, 13, x86_apic_timer_isr, 0);
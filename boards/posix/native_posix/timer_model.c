@@ -9,6 +9,7 @@
  *  - A system tick
  *  - A real time clock
  *  - A one shot HW timer which can be used to awake the CPU at a given time
+ *  - A one shot alarm raising the system tick interrupt at a given time
  *  - The clock source for all of this, and therefore for native_posix
  *
  * Please see doc/board.rst for more information, specially sections:
@@ -68,6 +69,7 @@ u64_t hw_timer_timer;
 
 u64_t hw_timer_tick_timer;
 u64_t hw_timer_awake_timer;
+u64_t hw_timer_alarm_timer;
 
 static u64_t tick_p; /* Period of the ticker */
 static s64_t silent_ticks;
@@ -126,7 +128,8 @@ void hwtimer_set_real_time_mode(bool new_rt)
 
 static void hwtimer_update_timer(void)
 {
-	hw_timer_timer = MIN(hw_timer_tick_timer, hw_timer_awake_timer);
+	hw_timer_timer = MIN(MIN(hw_timer_tick_timer, hw_timer_awake_timer),
+			     hw_timer_alarm_timer);
 }
 
 static inline void host_clock_gettime(struct timespec *tv)
@@ -151,6 +154,7 @@ void hwtimer_init(void)
 	silent_ticks = 0;
 	hw_timer_tick_timer = NEVER;
 	hw_timer_awake_timer = NEVER;
+	hw_timer_alarm_timer = NEVER;
 	hwtimer_update_timer();
 	if (real_time_mode) {
 		boot_time = get_host_us_time();
@@ -234,6 +238,13 @@ static void hwtimer_awake_timer_reached(void)
 	hw_irq_ctrl_set_irq(PHONY_HARD_IRQ);
 }
 
+static void hwtimer_alarm_timer_reached(void)
+{
+	hw_timer_alarm_timer = NEVER;
+	hwtimer_update_timer();
+	hw_irq_ctrl_set_irq(TIMER_TICK_IRQ);
+}
+
 void hwtimer_timer_reached(void)
 {
 	u64_t Now = hw_timer_timer;
@@ -242,6 +253,10 @@ void hwtimer_timer_reached(void)
 		hwtimer_awake_timer_reached();
 	}
 
+	if (hw_timer_alarm_timer == Now) {
+		hwtimer_alarm_timer_reached();
+	}
+
 	if (hw_timer_tick_timer == Now) {
 		hwtimer_tick_timer_reached();
 	}
@@ -263,6 +278,19 @@ void hwtimer_wake_in_time(u64_t time)
 	}
 }
 
+/**
+ * Raise the system tick interrupt once <time> comes, regardless of the
+ * silent ticks, or right away if <time> has already passed
+ *
+ * A new alarm replaces the previous one, and NEVER cancels it
+ */
+void hwtimer_set_alarm(u64_t time)
+{
+	hw_timer_alarm_timer = MAX(time, hwm_get_time());
+	hwtimer_update_timer();
+	hwm_find_next_timer();
+}
+
 /**
  * The kernel wants to skip the next sys_ticks tick interrupts
  * If sys_ticks == 0, the next interrupt will be raised.
@@ -33,6 +33,32 @@ static unsigned int max_ticks;
 static unsigned int cyc_per_tick;
 static unsigned int last_count;
 
+#ifdef CONFIG_TIMEOUT_SUBTICK
+/* Comparator value wanted for the next tick, and the sub-tick alarm */
+static u32_t tick_count;
+static u32_t subtick_count;
+static bool subtick_pending;
+#endif
+
+/* Programs the comparator for the tick at "cyc", or for the sub-tick
+ * alarm when that comes first.  Called with the lock held.
+ */
+static void set_comparator(u32_t cyc)
+{
+#ifdef CONFIG_TIMEOUT_SUBTICK
+	tick_count = cyc;
+	if (subtick_pending && (s32_t)(subtick_count - cyc) < 0) {
+		u32_t now = MAIN_COUNTER_REG;
+
+		cyc = subtick_count;
+		if ((s32_t)(cyc - now) < MIN_DELAY) {
+			cyc = now + MIN_DELAY;
+		}
+	}
+#endif
+	TIMER0_COMPARATOR_REG = cyc;
+}
+
 static void hpet_isr(void *arg)
 {
 	ARG_UNUSED(arg);
@@ -42,6 +68,11 @@ static void hpet_isr(void *arg)
 
 	last_count += dticks * cyc_per_tick;
 
+#ifdef CONFIG_TIMEOUT_SUBTICK
+	/* This may be the sub-tick alarm, with no new tick to announce */
+	subtick_pending = false;
+#endif
+
 	if (!IS_ENABLED(CONFIG_TICKLESS_KERNEL) ||
 	    IS_ENABLED(CONFIG_QEMU_TICKLESS_WORKAROUND)) {
 		u32_t next = last_count + cyc_per_tick;
@@ -49,7 +80,7 @@ static void hpet_isr(void *arg)
 		if ((s32_t)(next - now) < MIN_DELAY) {
 			next += cyc_per_tick;
 		}
-		TIMER0_COMPARATOR_REG = next;
+		set_comparator(next);
 	}
 
 	k_spin_unlock(&lock, key);
@@ -93,7 +124,7 @@ int z_clock_driver_init(struct device *device)
 	last_count = MAIN_COUNTER_REG;
 
 	TIMER0_CONF_REG |= TCONF_INT_ENABLE;
-	TIMER0_COMPARATOR_REG = MAIN_COUNTER_REG + cyc_per_tick;
+	set_comparator(MAIN_COUNTER_REG + cyc_per_tick);
 
 	return 0;
 }
@@ -111,7 +142,7 @@ void z_clock_set_timeout(s32_t ticks, bool idle)
 	ARG_UNUSED(idle);
 
 #if defined(CONFIG_TICKLESS_KERNEL) && !defined(CONFIG_QEMU_TICKLESS_WORKAROUND)
-	if (ticks == K_FOREVER && idle) {
+	if (ticks == K_FOREVER && idle && !IS_ENABLED(CONFIG_TIMEOUT_SUBTICK)) {
 		GENERAL_CONF_REG &= ~GCONF_ENABLE;
 		return;
 	}
@@ -131,11 +162,32 @@ void z_clock_set_timeout(s32_t ticks, bool idle)
 		cyc += cyc_per_tick;
 	}
 
-	TIMER0_COMPARATOR_REG = cyc;
+	set_comparator(cyc);
 	k_spin_unlock(&lock, key);
 #endif
 }
 
+#ifdef CONFIG_TIMEOUT_SUBTICK
+u32_t z_clock_elapsed_cycles(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	u32_t ret = MAIN_COUNTER_REG - last_count;
+
+	k_spin_unlock(&lock, key);
+	return ret;
+}
+
+void z_clock_set_timeout_cycles(u32_t cycles)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	subtick_pending = true;
+	subtick_count = last_count + cycles;
+	set_comparator(tick_count);
+	k_spin_unlock(&lock, key);
+}
+#endif
+
 u32_t z_clock_elapsed(void)
 {
 	if (!IS_ENABLED(CONFIG_TICKLESS_KERNEL)) {
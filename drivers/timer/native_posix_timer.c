@@ -44,6 +44,10 @@ static void np_timer_isr(void *arg)
 	s32_t elapsed_ticks = (now - last_tick_time)/tick_period;
 
 	last_tick_time += elapsed_ticks*tick_period;
+#if defined(CONFIG_TIMEOUT_SUBTICK)
+	/* This may be the sub-tick alarm, with no new tick to announce */
+	hwtimer_set_alarm(NEVER);
+#endif
 	z_clock_announce(elapsed_ticks);
 }
 
@@ -114,6 +118,26 @@ u32_t z_clock_elapsed(void)
 	return (hwm_get_time() - last_tick_time)/tick_period;
 }
 
+#if defined(CONFIG_TIMEOUT_SUBTICK)
+/**
+ * @brief Cycles (microseconds) elapsed since the last announced tick
+ */
+u32_t z_clock_elapsed_cycles(void)
+{
+	return hwm_get_time() - last_tick_time;
+}
+
+/**
+ * @brief Announce once a number of cycles have passed since the last
+ * announced tick
+ *
+ * See system_timer.h for more information
+ */
+void z_clock_set_timeout_cycles(u32_t cycles)
+{
+	hwtimer_set_alarm(last_tick_time + cycles);
+}
+#endif
 
 #if defined(CONFIG_ARCH_HAS_CUSTOM_BUSY_WAIT)
 /**
@@ -107,12 +107,16 @@ struct z_app_region {
  * @param name Name of the k_mem_partition to declare
  */
 #define K_APPMEM_PARTITION_DEFINE(name) \
+	Z_APPMEM_PARTITION_DEFINE(name, K_MEM_PARTITION_P_RW_U_RW)
+
+/* As K_APPMEM_PARTITION_DEFINE(), with the given access attributes */
+#define Z_APPMEM_PARTITION_DEFINE(name, attributes) \
 	extern char Z_APP_START(name)[]; \
 	extern char Z_APP_SIZE(name)[]; \
 	struct k_mem_partition name = { \
 		.start = (u32_t) &Z_APP_START(name), \
 		.size = (u32_t) &Z_APP_SIZE(name), \
-		.attr = K_MEM_PARTITION_P_RW_U_RW \
+		.attr = attributes \
 	}; \
 	extern char Z_APP_BSS_START(name)[]; \
 	extern char Z_APP_BSS_SIZE(name)[]; \
@@ -16,6 +16,8 @@
 extern "C" {
 #endif
 
+struct net_buf;
+
 /**
  * @brief Structured Data
  * @defgroup structured_data Structured Data
@@ -634,6 +636,299 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 		    const void *val, json_append_bytes_t append_bytes,
 		    void *data);
 
+/**
+ * @brief Return value of a json_stream_cb_t callback to skip the value
+ * of a key, or the contents of an object or array, without reporting
+ * their tokens.
+ */
+#define JSON_STREAM_SKIP 1
+
+/** Maximum nesting depth of objects and arrays in a JSON stream */
+#define JSON_STREAM_MAX_DEPTH 32
+
+/**
+ * @brief Token reported by an incremental JSON parser
+ */
+struct json_stream_token {
+	/** JSON_TOK_OBJECT_START, JSON_TOK_OBJECT_END, JSON_TOK_LIST_START,
+	 * JSON_TOK_LIST_END, JSON_TOK_STRING, JSON_TOK_NUMBER,
+	 * JSON_TOK_TRUE, JSON_TOK_FALSE or JSON_TOK_NULL
+	 */
+	enum json_tokens type;
+
+	/** Number of objects and arrays the token is in */
+	u8_t depth;
+
+	/** JSON_TOK_STRING is an object key rather than a value */
+	bool key;
+
+	/** JSON_TOK_NUMBER is an integer which fits in @a i64 */
+	bool integer;
+
+	/** Unescaped JSON_TOK_STRING, or text of JSON_TOK_NUMBER, NUL
+	 * terminated; only valid during the callback
+	 */
+	const char *str;
+
+	/** Length of @a str */
+	size_t len;
+
+	/** Value of an integer JSON_TOK_NUMBER */
+	s64_t i64;
+
+	/** Value of any JSON_TOK_NUMBER */
+	double dbl;
+};
+
+/**
+ * @brief Callback receiving the tokens of an incremental JSON parser
+ *
+ * @param token Token parsed
+ * @param user_data User data given to json_stream_init()
+ *
+ * @return 0 to go on, JSON_STREAM_SKIP after a key to skip its value or
+ * after the start of an object or array to skip its contents and end,
+ * or a negative number to stop parsing, returned by json_stream_feed().
+ */
+typedef int (*json_stream_cb_t)(const struct json_stream_token *token,
+				void *user_data);
+
+/**
+ * @brief Incremental JSON parser
+ *
+ * All fields are private.
+ */
+struct json_stream {
+	json_stream_cb_t cb;
+	void *user_data;
+	char *buf;
+	size_t buf_size;
+	size_t len;
+	const char *literal;
+	u32_t objects;
+	u16_t unicode;
+	u16_t high_surrogate;
+	u8_t lex;
+	u8_t expect;
+	u8_t depth;
+	u8_t skip_from;
+	u8_t pos;
+	bool skipping;
+	int err;
+};
+
+/**
+ * @brief Initialize an incremental JSON parser
+ *
+ * The parser takes one JSON value, usually an object, fed in chunks of
+ * any size through json_stream_feed(), and reports its tokens to @a cb
+ * as they are parsed. Unlike json_obj_parse(), it never needs the whole
+ * payload in memory nor modifies it; strings and numbers are copied to
+ * @a buf, which must hold the longest of them plus a NUL character,
+ * except within skipped values.
+ *
+ * @param js Parser to initialize
+ * @param cb Callback receiving the tokens
+ * @param user_data User data passed to @a cb
+ * @param buf Buffer for strings and numbers
+ * @param buf_size Size of @a buf
+ */
+void json_stream_init(struct json_stream *js, json_stream_cb_t cb,
+		      void *user_data, char *buf, size_t buf_size);
+
+/**
+ * @brief Feed a chunk of JSON data to an incremental parser
+ *
+ * Tokens completed by the chunk are reported before this returns; a
+ * token split between chunks is reported once its end is fed.
+ *
+ * Strings are unescaped, including \\u escapes, which are encoded as
+ * UTF-8. Numbers are converted to double, and to s64_t when they are
+ * integers in its range; the conversion to double is not always
+ * correctly rounded in the last bit.
+ *
+ * @param js Parser
+ * @param data JSON data
+ * @param len Length of @a data
+ *
+ * @return 0 if all data has been parsed, -EINVAL if it is not valid
+ * JSON, -ENOMEM if a string or number doesn't fit the buffer or the
+ * value is nested deeper than JSON_STREAM_MAX_DEPTH, -ERANGE if a
+ * number is out of the range of a double, or the negative value the
+ * callback returned. Once an error is returned, it is returned again
+ * for any further data.
+ */
+int json_stream_feed(struct json_stream *js, const char *data, size_t len);
+
+/**
+ * @brief Feed the data of a chain of network buffers to an incremental
+ * parser
+ *
+ * @param js Parser
+ * @param frags First of the buffers, whose data is fed in order
+ *
+ * @return As json_stream_feed().
+ */
+int json_stream_feed_net_buf(struct json_stream *js, struct net_buf *frags);
+
+/**
+ * @brief Tell an incremental parser that all data has been fed
+ *
+ * This reports a number ending the data, as its end can't be known
+ * before.
+ *
+ * @param js Parser
+ *
+ * @return 0 if a complete JSON value has been parsed, -EINVAL if it is
+ * incomplete, or an error as returned by json_stream_feed().
+ */
+int json_stream_finish(struct json_stream *js);
+
+/**
+ * @brief Incremental JSON writer
+ *
+ * All fields are private.
+ */
+struct json_writer {
+	json_append_bytes_t append_bytes;
+	void *data;
+	u32_t has_members;
+	u8_t depth;
+	bool after_key;
+};
+
+/**
+ * @brief Initialize an incremental JSON writer
+ *
+ * The writer outputs a JSON value piece by piece, inserting commas
+ * between the members of objects and arrays. Output goes to
+ * @a append_bytes as it is produced, e.g. to json_append_bytes_net_buf()
+ * to write it straight to network buffers.
+ *
+ * @param jw Writer to initialize
+ * @param append_bytes Function to append bytes to the output
+ * @param data Data pointer to be passed to @a append_bytes
+ */
+void json_writer_init(struct json_writer *jw,
+		      json_append_bytes_t append_bytes, void *data);
+
+/**
+ * @brief Start an object
+ *
+ * @param jw Writer
+ *
+ * @return 0 on success, -ENOMEM if nested deeper than
+ * JSON_STREAM_MAX_DEPTH, or the error returned by the append function.
+ */
+int json_writer_obj_start(struct json_writer *jw);
+
+/**
+ * @brief End an object
+ *
+ * @param jw Writer
+ *
+ * @return 0 on success, -EINVAL if no object or array is open, or the
+ * error returned by the append function.
+ */
+int json_writer_obj_end(struct json_writer *jw);
+
+/**
+ * @brief Start an array
+ *
+ * @param jw Writer
+ *
+ * @return As json_writer_obj_start().
+ */
+int json_writer_arr_start(struct json_writer *jw);
+
+/**
+ * @brief End an array
+ *
+ * @param jw Writer
+ *
+ * @return As json_writer_obj_end().
+ */
+int json_writer_arr_end(struct json_writer *jw);
+
+/**
+ * @brief Write the key of an object member, before its value
+ *
+ * @param jw Writer
+ * @param key NUL terminated key, escaped as needed
+ *
+ * @return 0 on success, or the error returned by the append function.
+ */
+int json_writer_key(struct json_writer *jw, const char *key);
+
+/**
+ * @brief Write a string value
+ *
+ * @param jw Writer
+ * @param str NUL terminated string, escaped as needed
+ *
+ * @return 0 on success, or the error returned by the append function.
+ */
+int json_writer_str(struct json_writer *jw, const char *str);
+
+/**
+ * @brief Write an integer value
+ *
+ * @param jw Writer
+ * @param num Value
+ *
+ * @return 0 on success, or the error returned by the append function.
+ */
+int json_writer_int64(struct json_writer *jw, s64_t num);
+
+/**
+ * @brief Write a floating point value
+ *
+ * The value is written with up to 9 decimal places, in exponent
+ * notation if very large or small.
+ *
+ * @param jw Writer
+ * @param num Value
+ *
+ * @return 0 on success, -EINVAL if @a num is infinite or not a number,
+ * or the error returned by the append function.
+ */
+int json_writer_double(struct json_writer *jw, double num);
+
+/**
+ * @brief Write a boolean value
+ *
+ * @param jw Writer
+ * @param value Value
+ *
+ * @return 0 on success, or the error returned by the append function.
+ */
+int json_writer_bool(struct json_writer *jw, bool value);
+
+/**
+ * @brief Write a null value
+ *
+ * @param jw Writer
+ *
+ * @return 0 on success, or the error returned by the append function.
+ */
+int json_writer_null(struct json_writer *jw);
+
+/**
+ * @brief Append bytes to a chain of network buffers
+ *
+ * This is a json_append_bytes_t function for json_obj_encode() or
+ * json_writer_init(), whose data pointer is the first network buffer of
+ * a chain. Bytes are added to its last buffer; more buffers are taken
+ * from the pool of the first one, without waiting, when it is full.
+ *
+ * @param bytes Bytes to append
+ * @param len Number of bytes
+ * @param data First network buffer
+ *
+ * @return 0 on success, or -ENOMEM if the pool has no buffer left.
+ */
+int json_append_bytes_net_buf(const char *bytes, size_t len, void *data);
+
 #ifdef __cplusplus
 }
 #endif
@@ -220,6 +220,63 @@ extern "C" {
  */
 #define DEVICE_DECLARE(name) static struct device DEVICE_NAME_GET(name)
 
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+#define Z_DEVICE_INIT_ASYNC(dev_name, is_deferred, ...)			  \
+	static const char *const _CONCAT(__init_deps_, dev_name)[] = {	  \
+		__VA_ARGS__						  \
+	};								  \
+	static const Z_STRUCT_SECTION_ITERABLE(device_async,		  \
+					_CONCAT(__async_, dev_name)) = {  \
+		.dev = DEVICE_GET(dev_name),				  \
+		.deps = _CONCAT(__init_deps_, dev_name),		  \
+		.num_deps = sizeof(_CONCAT(__init_deps_, dev_name)) /	  \
+			    sizeof(const char *),			  \
+		.deferred = is_deferred,				  \
+	}
+#else
+#define Z_DEVICE_INIT_ASYNC(dev_name, is_deferred, ...)			  \
+	extern struct device DEVICE_NAME_GET(dev_name)
+#endif
+
+/**
+ * @def DEVICE_INIT_ASYNC
+ *
+ * @brief Initialize a device on a worker thread
+ *
+ * @details Marks a device defined earlier in the same file with
+ * DEVICE_INIT(), DEVICE_AND_API_INIT() or DEVICE_DEFINE() as safe to
+ * initialize in parallel with the rest of its init level.  Its init
+ * function is run by one of the CONFIG_DEVICE_INIT_ASYNC_THREADS
+ * worker threads once the devices it depends on are initialized, and
+ * the kernel waits for it before moving on to the next init level.
+ *
+ * Entries at a PRE_KERNEL level, or in a build without
+ * CONFIG_DEVICE_INIT_ASYNC, are initialized synchronously as usual.
+ *
+ * @param dev_name The same as dev_name provided to DEVICE_INIT()
+ * @param ... Names of the devices it depends on, as passed to
+ * device_get_binding().  They must be initialized earlier than it,
+ * by level and priority.  If one of them fails to initialize, so
+ * does the device.
+ */
+#define DEVICE_INIT_ASYNC(dev_name, ...) \
+	Z_DEVICE_INIT_ASYNC(dev_name, false, __VA_ARGS__)
+
+/**
+ * @def DEVICE_INIT_DEFERRED
+ *
+ * @brief Initialize a device on a worker thread, in the background
+ *
+ * @details Like DEVICE_INIT_ASYNC(), except that nothing waits for the
+ * device: later init levels and main() may run before it is ready.
+ * Users of the device call device_init_wait() before touching it.
+ *
+ * @param dev_name The same as dev_name provided to DEVICE_INIT()
+ * @param ... Names of the devices it depends on
+ */
+#define DEVICE_INIT_DEFERRED(dev_name, ...) \
+	Z_DEVICE_INIT_ASYNC(dev_name, true, __VA_ARGS__)
+
 struct device;
 
 typedef void (*device_pm_cb)(struct device *dev,
@@ -276,8 +333,31 @@ struct device {
 	struct device_config *config;
 	const void *driver_api;
 	void *driver_data;
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+	u8_t init_state;
+#endif
+#ifdef CONFIG_DEVICE_INIT_TIMING
+	u32_t init_cycles;
+#endif
 };
 
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+/**
+ * @brief Asynchronous initialization of a device, see DEVICE_INIT_ASYNC()
+ *
+ * @param dev device to initialize
+ * @param deps names of the devices it depends on
+ * @param num_deps number of names in @a deps
+ * @param deferred true if nothing waits for the device at boot
+ */
+struct device_async {
+	struct device *dev;
+	const char *const *deps;
+	u8_t num_deps;
+	bool deferred;
+};
+#endif
+
 void z_sys_device_do_config_level(s32_t level);
 
 /**
@@ -294,6 +374,52 @@ void z_sys_device_do_config_level(s32_t level);
  */
 __syscall struct device *device_get_binding(const char *name);
 
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+/**
+ * @brief Wait for a device to be initialized
+ *
+ * @details Blocks until the init function of @a dev has run, which may
+ * be later than the end of its init level if it was declared with
+ * DEVICE_INIT_DEFERRED().  Must be called from a thread.
+ *
+ * @param dev device to wait for
+ *
+ * @retval 0 the device is ready
+ * @retval -ENODEV the device failed to initialize
+ */
+int device_init_wait(struct device *dev);
+#else
+static inline int device_init_wait(struct device *dev)
+{
+	return dev->driver_api != NULL ? 0 : -ENODEV;
+}
+#endif
+
+#ifdef CONFIG_DEVICE_INIT_TIMING
+/**
+ * @brief Callback for device_init_timing_foreach()
+ *
+ * @param dev device or SYS_INIT() entry
+ * @param level init level it ran at
+ * @param cycles hardware cycles its init function took
+ * @param user_data user data passed to device_init_timing_foreach()
+ */
+typedef void (*device_init_timing_cb_t)(struct device *dev, int level,
+					u32_t cycles, void *user_data);
+
+/**
+ * @brief Walk the boot time spent in each init function
+ *
+ * Calls @a cb for every device and SYS_INIT() entry, in init order,
+ * with the cycles its init function took.  Entries not initialized
+ * yet report zero cycles.
+ *
+ * @param cb callback to invoke
+ * @param user_data passed to @a cb
+ */
+void device_init_timing_foreach(device_init_timing_cb_t cb, void *user_data);
+#endif
+
 /**
  * @}
  */
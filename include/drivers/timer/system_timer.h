@@ -126,6 +126,30 @@ extern void z_clock_announce(s32_t ticks);
  */
 extern u32_t z_clock_elapsed(void);
 
+/**
+ * @brief Cycles elapsed since last z_clock_announce() call
+ *
+ * Like z_clock_elapsed(), but in hardware cycles counted from the
+ * tick boundary last announced.  Only needed from drivers that
+ * select CONFIG_SUBTICK_CAPABLE.
+ */
+extern u32_t z_clock_elapsed_cycles(void);
+
+/**
+ * @brief Set a timeout within the current tick
+ *
+ * Asks for a call to z_clock_announce(), with zero ticks if no tick
+ * boundary was crossed in the meantime, once the specified number of
+ * hardware cycles have elapsed since the tick boundary last
+ * announced.  The request holds in addition to, not instead of, the
+ * one made with z_clock_set_timeout(), and is cleared by the next
+ * call to z_clock_announce().  Only needed from drivers that select
+ * CONFIG_SUBTICK_CAPABLE.
+ *
+ * @param cycles Timeout in hardware cycles, less than one tick
+ */
+extern void z_clock_set_timeout_cycles(u32_t cycles);
+
 #ifdef __cplusplus
 }
 #endif
@@ -50,6 +50,25 @@ extern "C" {
 	DEVICE_AND_API_INIT(Z_SYS_NAME(init_fn), "", init_fn, NULL, NULL, level,\
 	prio, NULL)
 
+/**
+ * @def SYS_INIT_ASYNC
+ *
+ * @brief Run an initialization function at boot on a worker thread
+ *
+ * @details Like SYS_INIT(), but the function runs in parallel with the
+ * rest of its level, see DEVICE_INIT_ASYNC().  Only one such entry may
+ * be declared per function.
+ *
+ * @param init_fn Pointer to the boot function to run
+ * @param level The initialization level
+ * @param prio Priority within the selected initialization level
+ * @param ... Names of the devices the function depends on
+ */
+#define SYS_INIT_ASYNC(init_fn, level, prio, ...)			\
+	DEVICE_AND_API_INIT(_CONCAT(sys_init_async_, init_fn), "",	\
+			    init_fn, NULL, NULL, level, prio, NULL);	\
+	DEVICE_INIT_ASYNC(_CONCAT(sys_init_async_, init_fn), __VA_ARGS__)
+
 /**
  * @def SYS_DEVICE_DEFINE
  *
@@ -79,6 +79,10 @@ extern "C" {
 
 typedef struct {
 	struct _priq_rb waitq;
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/* cycles threads spent pended on the queue, summed */
+	u64_t blocked_cycles;
+#endif
 } _wait_q_t;
 
 extern bool z_priq_rb_lessthan(struct rbnode *a, struct rbnode *b);
@@ -89,6 +93,10 @@ extern bool z_priq_rb_lessthan(struct rbnode *a, struct rbnode *b);
 
 typedef struct {
 	sys_dlist_t waitq;
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/* cycles threads spent pended on the queue, summed */
+	u64_t blocked_cycles;
+#endif
 } _wait_q_t;
 
 #define Z_WAIT_Q_INIT(wait_q) { SYS_DLIST_STATIC_INIT(&(wait_q)->waitq) }
@@ -127,6 +135,7 @@ struct k_mem_pool;
 struct k_timer;
 struct k_poll_event;
 struct k_poll_signal;
+struct k_poll_set;
 struct k_mem_domain;
 struct k_mem_partition;
 struct k_futex;
@@ -454,6 +463,11 @@ struct _thread_base {
 	/* CPU index on which thread was last run */
 	u8_t cpu;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPU index of the ready queue which owns the thread */
+	u8_t runq_cpu;
+#endif
+
 	/* Recursive count of irq_lock() calls */
 	u8_t global_lock_count;
 
@@ -471,6 +485,11 @@ struct _thread_base {
 	/* this thread's entry in a timeout queue */
 	struct _timeout timeout;
 #endif
+
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* slack, in ticks, for timeouts armed by this thread */
+	s32_t timer_slack;
+#endif
 };
 
 typedef struct _thread_base _thread_base_t;
@@ -501,8 +520,53 @@ struct _mem_domain_info {
 	struct k_mem_domain *mem_domain;
 };
 
+#if CONFIG_KOBJECT_CACHE_SIZE > 0
+/* Kernel objects the thread recently passed permission checks on */
+struct _kobject_cache {
+	/* validation generation the entries are good for */
+	u32_t gen;
+	/* entry to replace next */
+	u8_t next;
+	struct {
+		void *obj;
+		struct _k_object *ko;
+	} entries[CONFIG_KOBJECT_CACHE_SIZE];
+};
+#endif
+
 #endif /* CONFIG_USERSPACE */
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+#define K_THREAD_LATENCY_BUCKETS 16
+
+/**
+ * @ingroup thread_apis
+ * Thread runtime statistics
+ */
+struct k_thread_runtime_stats {
+	/** cycles spent running, interrupts excluded */
+	u64_t execution_cycles;
+	/** cycles spent pended on wait queues */
+	u64_t blocked_cycles;
+	/** number of times the thread was switched in */
+	u32_t switches;
+	/** longest time from being made ready to running, in cycles */
+	u32_t max_latency;
+	/* latency[i]: wakeups that waited [2^i, 2^(i+1)) us to run */
+	u32_t latency[K_THREAD_LATENCY_BUCKETS];
+};
+
+struct _thread_runtime {
+	struct k_thread_runtime_stats stats;
+	/* wait queue pended on, and since when */
+	_wait_q_t *blocked_on;
+	u32_t blocked_since;
+	/* made ready and not run yet, and since when */
+	bool readied;
+	u32_t ready_since;
+};
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
 #ifdef CONFIG_THREAD_USERSPACE_LOCAL_DATA
 struct _thread_userspace_local_data {
 	int errno_var;
@@ -568,6 +632,10 @@ struct k_thread {
 	struct _mem_domain_info mem_domain_info;
 	/** Base address of thread stack */
 	k_thread_stack_t *stack_obj;
+#if CONFIG_KOBJECT_CACHE_SIZE > 0
+	/** recently validated kernel objects */
+	struct _kobject_cache kobject_cache;
+#endif
 #endif /* CONFIG_USERSPACE */
 
 #if defined(CONFIG_USE_SWITCH)
@@ -584,6 +652,16 @@ struct k_thread {
 	/** resource pool */
 	struct k_mem_pool *resource_pool;
 
+#if defined(CONFIG_THREAD_POOL)
+	/** thread pool the thread was spawned from, if any */
+	struct k_thread_pool *pool;
+#endif
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+	/** runtime statistics */
+	struct _thread_runtime runtime;
+#endif
+
 	/** arch-specifics: must always be at the end */
 	struct _thread_arch arch;
 };
@@ -819,6 +897,41 @@ __syscall s32_t k_sleep(s32_t ms);
  */
 __syscall s32_t k_usleep(s32_t us);
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+/* A 64-bit argument doesn't fit a system call argument register */
+__syscall s32_t z_sleep_until(u32_t deadline_lo, u32_t deadline_hi);
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Put the current thread to sleep until an absolute deadline.
+ *
+ * This routine puts the current thread to sleep until the uptime, as
+ * returned by k_uptime_cycles_get(), reaches @a deadline.  Unlike a
+ * relative sleep the wakeup time doesn't depend on when the call is
+ * made, so a loop advancing its deadline by a fixed amount keeps its
+ * period without accumulating drift.
+ *
+ * Unless :option:`CONFIG_TIMEOUT_SUBTICK` is enabled, the thread wakes
+ * at the first tick boundary at or after the deadline.  A deadline
+ * already past makes the thread yield instead, and one more than INT_MAX
+ * ticks away wakes the thread after INT_MAX ticks with -EAGAIN.
+ *
+ * @param deadline Uptime to wake at, in hardware clock cycles.
+ *
+ * @retval 0 The deadline was reached.
+ * @retval -EAGAIN The thread was woken up by a \ref k_wakeup call.
+ */
+static inline s32_t k_sleep_until(u64_t deadline)
+{
+	return z_sleep_until((u32_t)deadline, (u32_t)(deadline >> 32));
+}
+
 /**
  * @brief Cause the current thread to busy wait.
  *
@@ -864,6 +977,27 @@ __syscall void k_wakeup(k_tid_t thread);
  */
 __syscall k_tid_t k_current_get(void);
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+#ifdef CONFIG_USER_RO_PARTITION
+/* Kernel data user threads can read but not write */
+extern struct k_mem_partition z_user_ro_partition;
+#endif
+
+#ifdef CONFIG_USER_CURRENT_THREAD
+/* The running thread, in z_user_ro_partition.  The kernel updates it
+ * whenever it switches threads, so a thread reading it always finds
+ * itself.
+ */
+extern struct k_thread *z_user_current;
+#endif
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
 /**
  * @brief Abort a thread.
  *
@@ -1062,6 +1196,27 @@ __syscall void k_thread_priority_set(k_tid_t thread, int prio);
 __syscall void k_thread_deadline_set(k_tid_t thread, int deadline);
 #endif
 
+/**
+ * @brief Set a thread's default timer slack.
+ *
+ * Timeouts armed by the thread (its own sleeps and waits, and timers
+ * and delayed work it starts without an explicit slack of their own)
+ * may expire up to @a slack milliseconds late, so that the kernel can
+ * serve them together with other timeouts due in that window instead
+ * of waking up the system once for each.  Zero, the default for new
+ * threads, keeps expiries exact.
+ *
+ * @note
+ *    @rst
+ *    You should enable :option:`CONFIG_TIMEOUT_SLACK` in your project
+ *    configuration.
+ *    @endrst
+ *
+ * @param thread Thread whose slack is set
+ * @param slack Slack in milliseconds
+ */
+__syscall void k_thread_timer_slack_set(k_tid_t thread, s32_t slack);
+
 #ifdef CONFIG_SCHED_CPU_MASK
 /**
  * @brief Sets all CPU enable masks to zero
@@ -1272,6 +1427,21 @@ extern void k_sched_lock(void);
  */
 extern void k_sched_unlock(void);
 
+#ifdef CONFIG_SMP
+/**
+ * @brief Get the number of scheduler IPIs a CPU has taken.
+ *
+ * Counts the interprocessor interrupts the scheduler sent to @a cpu to
+ * abort a thread or, with CONFIG_SCHED_READY_IPI, to run a thread that
+ * became ready, since boot.
+ *
+ * @param cpu CPU number, less than CONFIG_MP_NUM_CPUS.
+ *
+ * @return Number of scheduler IPIs taken by @a cpu.
+ */
+extern u32_t k_sched_ipi_count_get(int cpu);
+#endif
+
 /**
  * @brief Set current thread's custom data.
  *
@@ -1338,10 +1508,181 @@ const char *k_thread_name_get(k_tid_t thread_id);
 __syscall int k_thread_name_copy(k_tid_t thread_id, char *buf,
 				 size_t size);
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/**
+ * @brief Get the runtime statistics of a thread
+ *
+ * Statistics are kept from the creation of the thread.  Its execution
+ * time includes the current time slice if it is running.
+ *
+ * @param thread Thread to get the statistics of
+ * @param stats Buffer the statistics are copied to
+ *
+ * @retval 0 Success
+ * @retval -EINVAL A parameter is NULL
+ */
+extern int k_thread_runtime_stats_get(k_tid_t thread,
+				      struct k_thread_runtime_stats *stats);
+#endif
+
 /**
  * @}
  */
 
+#ifdef CONFIG_THREAD_POOL
+/**
+ * @defgroup thread_pool_apis Thread Pool APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct z_thread_pool_slot {
+	sys_snode_t node;
+	/* references on the slot: the thread itself until it exits,
+	 * plus any taken with k_thread_pool_hold()
+	 */
+	u8_t refs;
+	/* the slot's stack was already initialized by an earlier thread */
+	bool stack_used;
+};
+
+struct k_thread_pool {
+	struct k_spinlock lock;
+	sys_slist_t free;
+	struct z_thread_pool_slot *slots;
+	u8_t *threads;
+	size_t thread_size;
+	k_thread_stack_t *stacks;
+	size_t stack_stride;
+	size_t stack_size;
+	u16_t count;
+};
+
+/* Defines a pool over an existing array of structs starting with a
+ * struct k_thread, with an optional array of stacks
+ */
+#define Z_THREAD_POOL_DEFINE(name, thread_array, stack_array, stride, size) \
+	static struct z_thread_pool_slot \
+		_k_thread_pool_slots_##name[ARRAY_SIZE(thread_array)]; \
+	Z_STRUCT_SECTION_ITERABLE(k_thread_pool, name) = { \
+		.slots = _k_thread_pool_slots_##name, \
+		.threads = (u8_t *)(thread_array), \
+		.thread_size = sizeof((thread_array)[0]), \
+		.stacks = (k_thread_stack_t *)(stack_array), \
+		.stack_stride = (stride), \
+		.stack_size = (size), \
+		.count = ARRAY_SIZE(thread_array), \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Statically define and initialize a thread pool.
+ *
+ * The pool holds @a count thread structs, each with a stack of
+ * @a stack_size bytes.  Both are ordinary static kernel objects, so no
+ * allocation or permission setup is needed to spawn threads from the
+ * pool.
+ *
+ * The thread pool can be accessed outside the module where it is
+ * defined using:
+ *
+ * @code extern struct k_thread_pool <name>; @endcode
+ *
+ * @param name Name of the thread pool.
+ * @param count Number of threads in the pool.
+ * @param stack_size Size of each thread's stack.
+ */
+#define K_THREAD_POOL_DEFINE(name, count, stack_size) \
+	static struct k_thread _k_thread_pool_threads_##name[count]; \
+	static K_THREAD_STACK_ARRAY_DEFINE(_k_thread_pool_stacks_##name, \
+					   count, stack_size); \
+	Z_THREAD_POOL_DEFINE(name, _k_thread_pool_threads_##name, \
+			     _k_thread_pool_stacks_##name, \
+			     sizeof(_k_thread_pool_stacks_##name[0]), \
+			     stack_size)
+
+/**
+ * @brief Spawn a thread from a thread pool.
+ *
+ * This routine takes a free thread struct from the pool in constant
+ * time and creates a thread on it, like k_thread_create() does.  The
+ * thread runs on the stack the pool keeps for that struct, unless
+ * @a stack is not NULL.
+ *
+ * The struct returns to the pool when the thread exits or is aborted,
+ * and no reference to it taken with k_thread_pool_hold() remains.
+ *
+ * With :option:`CONFIG_INIT_STACKS`, a stack of the pool is only
+ * filled once, by the first thread to run on it; stack usage reported
+ * for later threads is the highest of all threads that used it.
+ *
+ * @param pool Address of the thread pool.
+ * @param stack Stack to use instead of the pool's, or NULL.
+ * @param stack_size Size of @a stack, ignored when it is NULL.
+ * @param entry Thread entry function.
+ * @param p1 1st entry point parameter.
+ * @param p2 2nd entry point parameter.
+ * @param p3 3rd entry point parameter.
+ * @param prio Thread priority.
+ * @param options Thread options.
+ * @param delay Scheduling delay (in milliseconds), or K_NO_WAIT (for no
+ *              delay).
+ *
+ * @return ID of the new thread, or NULL if the pool has no free thread.
+ */
+extern k_tid_t k_thread_pool_spawn(struct k_thread_pool *pool,
+				   k_thread_stack_t *stack, size_t stack_size,
+				   k_thread_entry_t entry,
+				   void *p1, void *p2, void *p3,
+				   int prio, u32_t options, s32_t delay);
+
+/**
+ * @brief Keep a pool thread's struct from returning to its pool.
+ *
+ * This routine takes a reference on the struct of a thread spawned
+ * from a pool, so that it stays allocated after the thread exits,
+ * for instance until its exit status has been read.  To take it before
+ * the thread may exit, spawn the thread with a delay of K_FOREVER and
+ * start it afterwards.
+ *
+ * @param thread Thread spawned from a pool.
+ *
+ * @return N/A
+ */
+extern void k_thread_pool_hold(k_tid_t thread);
+
+/**
+ * @brief Release a reference on a pool thread's struct.
+ *
+ * This routine drops a reference taken with k_thread_pool_hold().  The
+ * struct returns to its pool once the thread has exited and no
+ * reference remains.
+ *
+ * @param thread Thread spawned from a pool.
+ *
+ * @return N/A
+ */
+extern void k_thread_pool_put(k_tid_t thread);
+
+/**
+ * @brief Get the number of free threads in a thread pool.
+ *
+ * @param pool Address of the thread pool.
+ *
+ * @return Number of threads that can be spawned from the pool.
+ */
+extern u32_t k_thread_pool_num_free_get(struct k_thread_pool *pool);
+
+/** @} */
+#endif /* CONFIG_THREAD_POOL */
+
 /**
  * @addtogroup clock_apis
  * @{
@@ -1440,18 +1781,44 @@ struct k_timer {
 	/* runs in the context of the thread that calls k_timer_stop() */
 	void (*stop_fn)(struct k_timer *timer);
 
-	/* timer period */
+	/* timer period, in ticks */
 	s32_t period;
 
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* nominal expiry tick, which a periodic timer is re-armed from
+	 * so that the slack of its expiries does not add up
+	 */
+	u64_t deadline_tick;
+#endif
+
+#ifdef CONFIG_TIMER_START_AT
+	/* expiry and period in cycles of a timer started with
+	 * k_timer_start_at(); period_cycles is zero for other timers
+	 */
+	u64_t deadline_cycles;
+	u32_t period_cycles;
+#endif
+
 	/* timer status */
 	u32_t status;
 
 	/* user-specific data, also used to support legacy features */
 	void *user_data;
 
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* requested slack in ticks, -1 to use the starting thread's */
+	s32_t slack;
+#endif
+
 	_OBJECT_TRACING_NEXT_PTR(k_timer)
 };
 
+#ifdef CONFIG_TIMEOUT_SLACK
+#define Z_TIMER_SLACK_INIT .slack = -1,
+#else
+#define Z_TIMER_SLACK_INIT
+#endif
+
 #define Z_TIMER_INITIALIZER(obj, expiry, stop) \
 	{ \
 	.timeout = { \
@@ -1465,6 +1832,7 @@ struct k_timer {
 	.period = 0, \
 	.status = 0, \
 	.user_data = 0, \
+	Z_TIMER_SLACK_INIT \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -1574,6 +1942,55 @@ __syscall void k_timer_start(struct k_timer *timer,
  *
  * @return N/A
  */
+#ifdef CONFIG_TIMER_START_AT
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+__syscall void z_timer_start_at(struct k_timer *timer, u32_t deadline_lo,
+				u32_t deadline_hi, u32_t period_cycles);
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Start a timer at an absolute deadline.
+ *
+ * This routine starts a timer, and resets its status to zero, so that
+ * it first expires when the uptime as returned by k_uptime_cycles_get()
+ * reaches @a deadline, then every @a period_cycles after that.  Each
+ * expiry is computed from the previous deadline rather than from the
+ * time the timer was handled, so the timer doesn't drift.
+ *
+ * The timer expires at the first tick boundary at or after each
+ * deadline, unless :option:`CONFIG_TIMEOUT_SUBTICK` is enabled.  A
+ * deadline already past expires at the next tick, and one more than
+ * INT_MAX ticks away expires after INT_MAX ticks.  Timer slack does not
+ * apply to timers started this way.
+ *
+ * @note
+ *    @rst
+ *    You should enable :option:`CONFIG_TIMER_START_AT` in your project
+ *    configuration.
+ *    @endrst
+ *
+ * @param timer          Address of timer.
+ * @param deadline       Uptime of the first expiry, in hardware clock
+ *                       cycles.
+ * @param period_cycles  Timer period in hardware clock cycles, or zero
+ *                       for a one-shot timer.
+ *
+ * @return N/A
+ */
+static inline void k_timer_start_at(struct k_timer *timer, u64_t deadline,
+				    u32_t period_cycles)
+{
+	z_timer_start_at(timer, (u32_t)deadline, (u32_t)(deadline >> 32),
+			 period_cycles);
+}
+#endif /* CONFIG_TIMER_START_AT */
+
 __syscall void k_timer_stop(struct k_timer *timer);
 
 /**
@@ -1668,6 +2085,45 @@ static inline void *z_impl_k_timer_user_data_get(struct k_timer *timer)
 	return timer->user_data;
 }
 
+/**
+ * @brief Set the slack of a timer.
+ *
+ * Allows every expiry of @a timer to be deferred by up to @a slack
+ * milliseconds, so that it can share a system wakeup with other
+ * timeouts.  A negative value makes the timer use the default slack
+ * of the thread that starts it (see k_thread_timer_slack_set()).
+ * Takes effect the next time the timer is started.
+ *
+ * @note
+ *    @rst
+ *    You should enable :option:`CONFIG_TIMEOUT_SLACK` in your project
+ *    configuration.
+ *    @endrst
+ *
+ * @param timer     Address of timer.
+ * @param slack     Slack in milliseconds, or negative for the default.
+ *
+ * @return N/A
+ */
+__syscall void k_timer_slack_set(struct k_timer *timer, s32_t slack);
+
+/**
+ * @brief Read the number of wakeups avoided by timer slack.
+ *
+ * Counts the timeouts whose expiry was moved, within their slack,
+ * onto that of a timeout that was already pending, so that both are
+ * served by a single wakeup.
+ *
+ * @note
+ *    @rst
+ *    You should enable :option:`CONFIG_TIMEOUT_SLACK` in your project
+ *    configuration.
+ *    @endrst
+ *
+ * @return Number of coalesced timeouts since boot.
+ */
+__syscall u32_t k_timer_wakeups_avoided_get(void);
+
 /** @} */
 
 /**
@@ -1675,6 +2131,61 @@ static inline void *z_impl_k_timer_user_data_get(struct k_timer *timer)
  * @{
  */
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+/* Ticks elapsed since boot, as seen by the kernel */
+__syscall s64_t z_uptime_ticks(void);
+
+#ifdef CONFIG_TIME_PAGE
+/* Copy of the tick count kept by the kernel for user mode, in a
+ * partition user threads can read but not write.  The count is
+ * current as long as "ticking" is set; "seq" is odd while the kernel
+ * updates the page.  Every user thread can read it: those the
+ * application put in no memory domain are in one the kernel keeps for
+ * the purpose.
+ */
+struct z_time_page {
+	u32_t seq;
+	u32_t ticking;
+	u64_t ticks;
+};
+
+extern struct z_time_page z_time_page;
+
+static inline s64_t z_time_page_ticks_get(void)
+{
+	volatile struct z_time_page *page = &z_time_page;
+	u32_t seq, ticking;
+	u64_t ticks;
+
+	do {
+		seq = __atomic_load_n(&page->seq, __ATOMIC_ACQUIRE);
+		ticks = page->ticks;
+		ticking = page->ticking;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while ((seq & 1U) != 0U ||
+		 seq != __atomic_load_n(&page->seq, __ATOMIC_RELAXED));
+
+	return ticking != 0U ? (s64_t)ticks : z_uptime_ticks();
+}
+#endif
+
+static inline s64_t z_uptime_ticks_get(void)
+{
+#if defined(CONFIG_TIME_PAGE) && !defined(__ZEPHYR_SUPERVISOR__)
+	if (_is_user_context()) {
+		return z_time_page_ticks_get();
+	}
+#endif
+	return z_uptime_ticks();
+}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
 /**
  * @brief Get system uptime.
  *
@@ -1690,7 +2201,10 @@ static inline void *z_impl_k_timer_user_data_get(struct k_timer *timer)
  *
  * @return Current uptime in milliseconds.
  */
-__syscall s64_t k_uptime_get(void);
+static inline s64_t k_uptime_get(void)
+{
+	return __ticks_to_ms(z_uptime_ticks_get());
+}
 
 /**
  * @brief Enable clock always on in tickless kernel
@@ -1746,7 +2260,10 @@ __deprecated static inline void k_disable_sys_clock_always_on(void)
  *
  * @return Current uptime in milliseconds.
  */
-__syscall u32_t k_uptime_get_32(void);
+static inline u32_t k_uptime_get_32(void)
+{
+	return __ticks_to_ms((u32_t)z_uptime_ticks_get());
+}
 
 /**
  * @brief Get elapsed time.
@@ -1801,6 +2318,55 @@ static inline u32_t k_uptime_delta_32(s64_t *reftime)
  */
 #define k_cycle_get_32()	z_arch_k_cycle_get_32()
 
+/**
+ * @brief Get system uptime in hardware clock cycles.
+ *
+ * This routine returns the elapsed time since the system booted, in
+ * hardware clock cycles.  It is the time base of k_sleep_until() and
+ * k_timer_start_at().
+ *
+ * Unless :option:`CONFIG_TIMEOUT_SUBTICK` is enabled, the uptime only
+ * has the resolution of a tick.
+ *
+ * @return Current uptime in hardware clock cycles.
+ */
+__syscall u64_t k_uptime_cycles_get(void);
+
+/**
+ * @brief Convert nanoseconds to hardware clock cycles.
+ *
+ * The result is rounded up.
+ *
+ * @param ns Duration in nanoseconds.
+ *
+ * @return Duration in hardware clock cycles.
+ */
+static inline u64_t k_ns_to_cycles(u64_t ns)
+{
+	u64_t cyc = (u64_t)sys_clock_hw_cycles_per_sec();
+
+	/* Split to keep the product from overflowing */
+	return (ns / NSEC_PER_SEC) * cyc +
+	       ceiling_fraction((ns % NSEC_PER_SEC) * cyc, NSEC_PER_SEC);
+}
+
+/**
+ * @brief Convert hardware clock cycles to nanoseconds.
+ *
+ * The result is rounded down.
+ *
+ * @param cycles Duration in hardware clock cycles.
+ *
+ * @return Duration in nanoseconds.
+ */
+static inline u64_t k_cycles_to_ns(u64_t cycles)
+{
+	u64_t cyc = (u64_t)sys_clock_hw_cycles_per_sec();
+
+	return (cycles / cyc) * NSEC_PER_SEC +
+	       ((cycles % cyc) * NSEC_PER_SEC) / cyc;
+}
+
 /**
  * @}
  */
@@ -2687,12 +3253,36 @@ typedef void (*k_work_handler_t)(struct k_work *work);
  * @cond INTERNAL_HIDDEN
  */
 
-struct k_work_q {
-	struct k_queue queue;
+#ifdef CONFIG_WORKQUEUE_POOL
+struct k_work_q_worker {
 	struct k_thread thread;
+	struct k_work_q *work_q;
+	sys_slist_t deque;		/* Work items handed to this worker */
 };
 
-enum {
+#define K_WORK_Q_LATENCY_BUCKETS 16
+#endif
+
+struct k_work_q {
+	struct k_queue queue;
+	struct k_thread thread;
+#ifdef CONFIG_WORKQUEUE_POOL
+	/* Pool workers, NULL if the queue is served by @a thread alone */
+	struct k_work_q_worker *workers;
+	int num_workers;
+	int next_worker;
+	struct k_spinlock lock;
+	_wait_q_t idle;			/* Workers with nothing to do */
+#ifdef CONFIG_WORKQUEUE_POOL_STATS
+	sys_snode_t node;
+	/* latency[i]: work items that waited [2^i, 2^(i+1)) us to run */
+	u32_t latency[K_WORK_Q_LATENCY_BUCKETS];
+	u32_t steals;
+#endif
+#endif
+};
+
+enum {
 	K_WORK_STATE_PENDING,	/* Work item pending state */
 };
 
@@ -2700,16 +3290,28 @@ struct k_work {
 	void *_reserved;		/* Used by k_queue implementation. */
 	k_work_handler_t handler;
 	atomic_t flags[1];
+#ifdef CONFIG_WORKQUEUE_POOL_STATS
+	u32_t submit_time;		/* Cycle count at submission */
+#endif
 };
 
 struct k_delayed_work {
 	struct k_work work;
 	struct _timeout timeout;
 	struct k_work_q *work_q;
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* requested slack in ticks, -1 to use the submitting thread's */
+	s32_t slack;
+#endif
 };
 
 extern struct k_work_q k_sys_work_q;
 
+#ifdef CONFIG_WORKQUEUE_POOL
+extern void z_work_q_pool_append(struct k_work_q *work_q,
+				 struct k_work *work);
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -2780,6 +3382,12 @@ static inline void k_work_submit_to_queue(struct k_work_q *work_q,
 					  struct k_work *work)
 {
 	if (!atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+#ifdef CONFIG_WORKQUEUE_POOL
+		if (work_q->workers != NULL) {
+			z_work_q_pool_append(work_q, work);
+			return;
+		}
+#endif
 		k_queue_append(&work_q->queue, work);
 	}
 }
@@ -2793,7 +3401,10 @@ static inline void k_work_submit_to_queue(struct k_work_q *work_q,
  * thread must have memory access to the k_work item being submitted. The caller
  * must have permission granted on the work_q parameter's queue object.
  *
- * Otherwise this works the same as k_work_submit_to_queue().
+ * Otherwise this works the same as k_work_submit_to_queue().  A user
+ * mode caller must not pass a workqueue pool, as it can not tell one
+ * apart and the pool would never see the work item; supervisor callers
+ * have their work items handed to the pool's workers.
  *
  * @note Can be called by ISRs.
  *
@@ -2811,6 +3422,21 @@ static inline int k_work_submit_to_user_queue(struct k_work_q *work_q,
 	int ret = -EBUSY;
 
 	if (!atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+#ifdef CONFIG_WORKQUEUE_POOL
+		/* Pool workers never read work_q->queue.  Only supervisor
+		 * callers can look at the workqueue object, so they are
+		 * routed to the pool; user callers must not pass one.
+		 */
+		bool supervisor = true;
+
+#ifdef CONFIG_USERSPACE
+		supervisor = !_is_user_context();
+#endif
+		if (supervisor && work_q->workers != NULL) {
+			z_work_q_pool_append(work_q, work);
+			return 0;
+		}
+#endif
 		ret = k_queue_alloc_append(&work_q->queue, work);
 
 		/* Couldn't insert into the queue. Clear the pending bit
@@ -2887,6 +3513,59 @@ extern void k_work_q_user_start(struct k_work_q *work_q,
 				k_thread_stack_t *stack,
 				size_t stack_size, int prio);
 
+#ifdef CONFIG_WORKQUEUE_POOL
+/**
+ * @brief Start a workqueue served by several threads.
+ *
+ * This routine starts workqueue @a work_q with @a num_workers worker
+ * threads. Each worker processes the work items handed to it in the
+ * order they were submitted; a worker that runs out of work takes
+ * work items waiting for a busy worker instead of going idle. Work
+ * items submitted by a worker's own handler go to that worker.
+ *
+ * A pool is used with the same APIs as any other workqueue, but work
+ * items submitted to it may run concurrently with each other.
+ *
+ * @note A pool can not be started in user mode, and user mode threads can
+ * not submit work items to it with k_work_submit_to_user_queue().
+ *
+ * @param work_q Address of workqueue.
+ * @param workers Array of @a num_workers worker objects.
+ * @param num_workers Number of worker threads.
+ * @param stacks Worker thread stacks, as defined by
+ *		K_THREAD_STACK_ARRAY_DEFINE() with @a num_workers elements.
+ * @param stack_size Size of each worker thread's stack (in bytes), which
+ *		must be the same constant passed to
+ *		K_THREAD_STACK_ARRAY_DEFINE().
+ * @param prio Priority of the worker threads.
+ *
+ * @return N/A
+ */
+extern void k_work_q_pool_start(struct k_work_q *work_q,
+				struct k_work_q_worker *workers,
+				int num_workers, k_thread_stack_t *stacks,
+				size_t stack_size, int prio);
+#endif
+
+#ifdef CONFIG_WORKQUEUE_POOL_STATS
+typedef void (*k_work_q_user_cb_t)(const struct k_work_q *work_q,
+				   void *user_data);
+
+/**
+ * @brief Iterate over all workqueue pools.
+ *
+ * This routine invokes @a user_cb on each workqueue pool that has been
+ * started, for instance to report its latency histogram.
+ *
+ * @param user_cb Callback invoked for each pool.
+ * @param user_data Opaque pointer passed to @a user_cb.
+ *
+ * @return N/A
+ */
+extern void k_work_q_pool_foreach(k_work_q_user_cb_t user_cb,
+				  void *user_data);
+#endif
+
 /**
  * @brief Initialize a delayed work item.
  *
@@ -2902,6 +3581,29 @@ extern void k_work_q_user_start(struct k_work_q *work_q,
 extern void k_delayed_work_init(struct k_delayed_work *work,
 				k_work_handler_t handler);
 
+/**
+ * @brief Set the slack of a delayed work item.
+ *
+ * Allows the countdown of @a work to end up to @a slack milliseconds
+ * late, so that it can share a system wakeup with other timeouts.  A
+ * negative value, the default, makes the item use the default slack
+ * of the thread that submits it (see k_thread_timer_slack_set()).
+ * Takes effect the next time the item is submitted.
+ *
+ * @note
+ *    @rst
+ *    You should enable :option:`CONFIG_TIMEOUT_SLACK` in your project
+ *    configuration.
+ *    @endrst
+ *
+ * @param work Address of delayed work item.
+ * @param slack Slack in milliseconds, or negative for the default.
+ *
+ * @return N/A
+ */
+extern void k_delayed_work_slack_set(struct k_delayed_work *work,
+				     s32_t slack);
+
 /**
  * @brief Submit a delayed work item.
  *
@@ -3145,6 +3847,153 @@ __syscall int k_mutex_lock(struct k_mutex *mutex, s32_t timeout);
  */
 __syscall void k_mutex_unlock(struct k_mutex *mutex);
 
+/**
+ * @}
+ */
+
+/**
+ * @defgroup rwlock_apis Reader-Writer Lock APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * Reader-Writer Lock Structure
+ * @ingroup rwlock_apis
+ */
+struct k_rwlock {
+	/* Number of readers holding the lock, plus the Z_RWLOCK_* flags */
+	atomic_t state;
+	_wait_q_t rd_wait_q;
+	_wait_q_t wr_wait_q;
+	/** Writer holding the lock */
+	struct k_thread *writer;
+	int writer_orig_prio;
+
+	_OBJECT_TRACING_NEXT_PTR(k_rwlock)
+};
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+/* A writer holds the lock */
+#define Z_RWLOCK_WRITER BIT(30)
+/* Writers are waiting, new readers must wait behind them */
+#define Z_RWLOCK_WRITERS_WAITING BIT(29)
+#define Z_RWLOCK_READERS_MASK (Z_RWLOCK_WRITERS_WAITING - 1)
+
+#define Z_RWLOCK_INITIALIZER(obj) \
+	{ \
+	.state = ATOMIC_INIT(0), \
+	.rd_wait_q = Z_WAIT_Q_INIT(&obj.rd_wait_q), \
+	.wr_wait_q = Z_WAIT_Q_INIT(&obj.wr_wait_q), \
+	.writer = NULL, \
+	.writer_orig_prio = K_LOWEST_THREAD_PRIO, \
+	_OBJECT_TRACING_INIT \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Statically define and initialize a reader-writer lock.
+ *
+ * The lock can be accessed outside the module where it is defined using:
+ *
+ * @code extern struct k_rwlock <name>; @endcode
+ *
+ * @param name Name of the reader-writer lock.
+ */
+#define K_RWLOCK_DEFINE(name) \
+	Z_STRUCT_SECTION_ITERABLE(k_rwlock, name) = \
+		Z_RWLOCK_INITIALIZER(name)
+
+/**
+ * @brief Initialize a reader-writer lock.
+ *
+ * This routine initializes a reader-writer lock, prior to its first use.
+ * Upon completion, the lock is held by neither readers nor a writer.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @return N/A
+ */
+__syscall void k_rwlock_init(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader-writer lock for reading.
+ *
+ * Any number of threads can hold the lock for reading at the same time.
+ * While the lock is free of writers this is a single atomic operation.
+ * The caller waits if a writer holds the lock, or is waiting for it:
+ * writers are preferred, so that a steady stream of readers cannot
+ * starve them.  Because of this, a thread must not lock for reading a
+ * lock it already holds for reading.
+ *
+ * A thread waiting for a lock held by a writer lends its priority to
+ * the writer, as with k_mutex_lock().  Readers holding the lock are not
+ * boosted.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Lock held for reading.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EDEADLK The caller holds the lock for writing.
+ */
+__syscall int k_rwlock_read_lock(struct k_rwlock *rwlock, s32_t timeout);
+
+/**
+ * @brief Release a reader-writer lock held for reading.
+ *
+ * When the last reader leaves, the lock is handed to the highest
+ * priority waiting writer, if any.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @retval 0 Lock released.
+ * @retval -EINVAL The lock was not held for reading.
+ */
+__syscall int k_rwlock_read_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader-writer lock for writing.
+ *
+ * A writer has exclusive access to the lock.  The caller waits until
+ * all readers and any other writer have released it; while it waits,
+ * new readers are held back.  Waiting for another writer lends it the
+ * caller's priority, as with k_mutex_lock().
+ *
+ * Locking for writing is not recursive.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Lock held for writing.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EDEADLK The caller already holds the lock for writing.
+ */
+__syscall int k_rwlock_write_lock(struct k_rwlock *rwlock, s32_t timeout);
+
+/**
+ * @brief Release a reader-writer lock held for writing.
+ *
+ * The lock goes to the highest priority waiting writer if there is one,
+ * otherwise all waiting readers get it at once.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @retval 0 Lock released.
+ * @retval -EPERM The caller does not hold the lock for writing.
+ */
+__syscall int k_rwlock_write_unlock(struct k_rwlock *rwlock);
+
 /**
  * @}
  */
@@ -3316,6 +4165,8 @@ struct k_msgq {
 	char *read_ptr;
 	char *write_ptr;
 	u32_t used_msgs;
+	/* slots not yet reusable after k_msgq_get_claim(), 0 if none */
+	u32_t get_held;
 
 	_OBJECT_TRACING_NEXT_PTR(k_msgq)
 	u8_t flags;
@@ -3344,6 +4195,7 @@ struct k_msgq {
 
 
 #define K_MSGQ_FLAG_ALLOC	BIT(0)
+#define K_MSGQ_FLAG_PUT_CLAIM	BIT(1)
 
 /**
  * @brief Message Queue Attributes
@@ -3446,6 +4298,7 @@ void k_msgq_cleanup(struct k_msgq *q);
  * @retval 0 Message sent.
  * @retval -ENOMSG Returned without waiting or queue purged.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A slot is reserved by k_msgq_put_claim().
  * @req K-MSGQ-002
  */
 __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
@@ -3466,10 +4319,138 @@ __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
  * @retval 0 Message received.
  * @retval -ENOMSG Returned without waiting.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A message is being read by k_msgq_get_claim().
  * @req K-MSGQ-002
  */
 __syscall int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Reserve space for a message in a message queue.
+ *
+ * This routine reserves the next free slot of message queue @a q and
+ * returns its address, so that the message can be written in place
+ * instead of being copied in by k_msgq_put(). The message is sent by
+ * k_msgq_put_commit().
+ *
+ * Until then, the caller is the queue's only writer: other attempts to
+ * send a message fail with -EBUSY instead of waiting.
+ *
+ * @note Can be called by ISRs. Not available to user mode threads,
+ * which cannot access the queue's ring buffer.
+ *
+ * @param q Address of the message queue.
+ * @param data Set to the address of a @a msg_size byte slot.
+ *
+ * @retval 0 Slot reserved.
+ * @retval -ENOMSG The queue is full.
+ * @retval -EBUSY The queue already has a reserved slot.
+ */
+int k_msgq_put_claim(struct k_msgq *q, void **data);
+
+/**
+ * @brief Send a message written in place.
+ *
+ * This routine sends the message written to the slot returned by
+ * k_msgq_put_claim(). If a thread is waiting for a message, it gets
+ * this one.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param q Address of the message queue.
+ */
+void k_msgq_put_commit(struct k_msgq *q);
+
+/**
+ * @brief Receive a message from a message queue in place.
+ *
+ * This routine removes the oldest message from message queue @a q and
+ * returns its address in the queue's ring buffer, so that it can be
+ * read without being copied out. The slot is handed back to the queue
+ * by k_msgq_get_finish().
+ *
+ * Until then, the caller is the queue's only reader: other attempts to
+ * receive a message fail with -EBUSY instead of waiting.
+ *
+ * @note Can be called by ISRs. Not available to user mode threads,
+ * which cannot access the queue's ring buffer.
+ *
+ * @param q Address of the message queue.
+ * @param data Set to the address of the message.
+ *
+ * @retval 0 Message received.
+ * @retval -ENOMSG The queue is empty.
+ * @retval -EBUSY A message is already being read in place.
+ */
+int k_msgq_get_claim(struct k_msgq *q, void **data);
+
+/**
+ * @brief Release a message received in place.
+ *
+ * This routine gives the slot returned by k_msgq_get_claim() back to
+ * message queue @a q. A thread waiting to send a message may then be
+ * woken up.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param q Address of the message queue.
+ */
+void k_msgq_get_finish(struct k_msgq *q);
+
+/**
+ * @brief Send several messages to a message queue.
+ *
+ * This routine sends up to @a num consecutive messages from @a data to
+ * message queue @a q. Threads waiting for messages get the first ones,
+ * the rest are copied into the ring buffer with at most two copies;
+ * the queue's lock is taken once and at most one reschedule happens.
+ *
+ * The routine only waits if not a single message can be sent, then
+ * sends as many as it can once it has been woken up.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Pointer to @a num messages.
+ * @param num Number of messages.
+ * @param timeout Waiting period to send the first message (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @return Number of messages sent (at least 1).
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A slot is reserved by k_msgq_put_claim().
+ */
+__syscall int k_msgq_put_n(struct k_msgq *q, const void *data, u32_t num,
+			   s32_t timeout);
+
+/**
+ * @brief Receive several messages from a message queue.
+ *
+ * This routine receives up to @a num messages from message queue @a q
+ * into @a data. The queue's lock is taken once, and threads waiting to
+ * send are moved into the space freed with at most one reschedule.
+ *
+ * The routine only waits if the queue is empty, then receives as many
+ * messages as are available once it has been woken up.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Address of an area for @a num messages.
+ * @param num Maximum number of messages.
+ * @param timeout Waiting period for the first message (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @return Number of messages received (at least 1).
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A message is being read by k_msgq_get_claim().
+ */
+__syscall int k_msgq_get_n(struct k_msgq *q, void *data, u32_t num,
+			   s32_t timeout);
+
 /**
  * @brief Peek/read a message from a message queue.
  *
@@ -3530,7 +4511,10 @@ __syscall void  k_msgq_get_attrs(struct k_msgq *q, struct k_msgq_attrs *attrs);
 
 static inline u32_t z_impl_k_msgq_num_free_get(struct k_msgq *q)
 {
-	return q->max_msgs - q->used_msgs;
+	u32_t claimed = q->get_held +
+		(((q->flags & K_MSGQ_FLAG_PUT_CLAIM) != 0U) ? 1U : 0U);
+
+	return q->max_msgs - q->used_msgs - claimed;
 }
 
 /**
@@ -3563,11 +4547,18 @@ static inline u32_t z_impl_k_msgq_num_used_get(struct k_msgq *q)
  * to 16M of memory managed by a single pool.  Long term it would be
  * good to move to a variable bit size based on configuration.
  */
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+struct k_mem_block_id {
+	struct k_heap *heap;
+	void *data;
+};
+#else
 struct k_mem_block_id {
 	u32_t pool : 8;
 	u32_t level : 4;
 	u32_t block : 20;
 };
+#endif
 
 struct k_mem_block {
 	void *data;
@@ -3941,6 +4932,77 @@ __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 			 size_t bytes_to_read, size_t *bytes_read,
 			 size_t min_xfer, s32_t timeout);
 
+/**
+ * @brief Pipe data segment.
+ *
+ * Describes one of the buffers that k_pipe_writev() gathers data from,
+ * or that k_pipe_readv() scatters data into.
+ */
+struct k_pipe_iovec {
+	void *base;                     /**< Start of the segment */
+	size_t len;                     /**< Segment size (in bytes) */
+};
+
+/** Maximum number of segments per k_pipe_writev()/k_pipe_readv() call
+ *  made by a user mode thread.
+ */
+#define K_PIPE_IOV_MAX 16
+
+/**
+ * @brief Write data from several buffers to a pipe.
+ *
+ * This routine behaves like k_pipe_put(), but gathers the data to write
+ * from @a iovcnt segments, in order, as if they were a single buffer.
+ * Data is copied straight into the buffers of waiting readers where
+ * possible.
+ *
+ * @param pipe Address of the pipe.
+ * @param iov Array of segments to write.
+ * @param iovcnt Number of segments in @a iov (at most K_PIPE_IOV_MAX when
+ *               called from user mode).
+ * @param bytes_written Address of area to hold the number of bytes written.
+ * @param min_xfer Minimum number of bytes to write.
+ * @param timeout Waiting period to wait for the data to be written (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @retval 0 At least @a min_xfer bytes of data were written.
+ * @retval -EIO Returned without waiting; zero data bytes were written.
+ * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
+ *                 minus one data bytes were written.
+ */
+__syscall int k_pipe_writev(struct k_pipe *pipe,
+			    const struct k_pipe_iovec *iov, size_t iovcnt,
+			    size_t *bytes_written, size_t min_xfer,
+			    s32_t timeout);
+
+/**
+ * @brief Read data from a pipe into several buffers.
+ *
+ * This routine behaves like k_pipe_get(), but scatters the data read
+ * over @a iovcnt segments, filling each one before moving on to the next.
+ * Unlike k_pipe_get(), it returns as soon as at least @a min_xfer bytes,
+ * and at least one byte, have been read; it does not wait for more.
+ *
+ * @param pipe Address of the pipe.
+ * @param iov Array of segments to fill.
+ * @param iovcnt Number of segments in @a iov (at most K_PIPE_IOV_MAX when
+ *               called from user mode).
+ * @param bytes_read Address of area to hold the number of bytes read.
+ * @param min_xfer Minimum number of data bytes to read.
+ * @param timeout Waiting period to wait for the data to be read (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @retval 0 At least @a min_xfer bytes of data were read.
+ * @retval -EIO Returned without waiting; zero data bytes were read.
+ * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
+ *                 minus one data bytes were read.
+ */
+__syscall int k_pipe_readv(struct k_pipe *pipe,
+			   const struct k_pipe_iovec *iov, size_t iovcnt,
+			   size_t *bytes_read, size_t min_xfer, s32_t timeout);
+
 /**
  * @brief Write memory block to a pipe.
  *
@@ -3965,13 +5027,29 @@ extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+struct k_mem_slab_cache {
+	struct k_spinlock lock;
+	char *free_list;
+	u32_t count;
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
 	u32_t num_blocks;
 	size_t block_size;
 	char *buffer;
 	char *free_list;
+	/* Blocks not on free_list, including those in CPU caches */
 	u32_t num_used;
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	/* Allocations that found the slab empty and are about to
+	 * block; frees must not stash blocks in a cache meanwhile
+	 */
+	u32_t num_waiting;
+	struct k_mem_slab_cache cache[CONFIG_MP_NUM_CPUS];
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab)
 };
@@ -4085,6 +5163,39 @@ extern int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem,
  */
 extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
 
+/**
+ * @brief Allocate several blocks from a memory slab at once.
+ *
+ * This routine allocates @a count memory blocks from a memory slab,
+ * taking the slab lock only once.  Either all blocks are allocated or
+ * none are; the routine never waits.
+ *
+ * @param slab Address of the memory slab.
+ * @param mem Array of @a count block addresses, filled in on success.
+ * @param count Number of blocks to allocate.
+ *
+ * @retval 0 Memory allocated.
+ * @retval -ENOMEM Fewer than @a count blocks were free.
+ */
+extern int k_mem_slab_alloc_bulk(struct k_mem_slab *slab, void **mem,
+				 u32_t count);
+
+/**
+ * @brief Free several blocks to a memory slab at once.
+ *
+ * This routine releases @a count memory blocks back to their memory
+ * slab, taking the slab lock only once.  Threads waiting on the slab
+ * are handed blocks first.
+ *
+ * @param slab Address of the memory slab.
+ * @param mem Array of @a count block addresses to free.
+ * @param count Number of blocks to free.
+ *
+ * @return N/A
+ */
+extern void k_mem_slab_free_bulk(struct k_mem_slab *slab, void **mem,
+				 u32_t count);
+
 /**
  * @brief Get the number of used blocks in a memory slab.
  *
@@ -4098,7 +5209,21 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	u32_t used = slab->num_used;
+	u32_t cached = 0U;
+
+	/* Blocks parked in a CPU cache are free.  The counts are
+	 * sampled without locking, so clamp a racing refill or flush.
+	 */
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cached += slab->cache[i].count;
+	}
+
+	return used > cached ? used - cached : 0U;
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -4114,19 +5239,120 @@ static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
  */
 static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
 /** @} */
 
+/**
+ * @defgroup k_heap_apis Kernel Heap APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_heap {
+	struct sys_heap heap;
+	_wait_q_t wait_q;
+	struct k_spinlock lock;
+};
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Initialize a k_heap
+ *
+ * This constructs a synchronized k_heap object over a memory region
+ * specified by the user.  Note that while any alignment and size can
+ * be passed as valid parameters, internal alignment restrictions
+ * inside the inner sys_heap mean that not all bytes may be usable as
+ * allocated memory.
+ *
+ * @param h Heap struct to initialize
+ * @param mem Pointer to memory.
+ * @param bytes Size of memory region, in bytes
+ */
+void k_heap_init(struct k_heap *h, void *mem, size_t bytes);
+
+/**
+ * @brief Allocate memory from a k_heap
+ *
+ * Allocates and returns a memory buffer from the memory region owned
+ * by the heap.  If no memory is available immediately, the call will
+ * block for the specified timeout (in milliseconds) waiting for
+ * memory to be freed.  If the allocation cannot be performed by the
+ * expiration of the timeout, NULL will be returned.
+ *
+ * Both allocation and free complete in constant time.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param h Heap from which to allocate
+ * @param bytes Desired size of block to allocate
+ * @param timeout Maximum time to wait (in milliseconds), or K_NO_WAIT
+ *        or K_FOREVER
+ * @return A pointer to valid heap memory, or NULL
+ */
+void *k_heap_alloc(struct k_heap *h, size_t bytes, s32_t timeout);
+
+/**
+ * @brief Free memory allocated by k_heap_alloc()
+ *
+ * Returns the specified memory block, which must have been returned
+ * from k_heap_alloc(), to the heap for use by other callers.  Passing
+ * a NULL block is legal, and has no effect.
+ *
+ * @param h Heap to which to return the memory
+ * @param mem A valid memory block, or NULL
+ */
+void k_heap_free(struct k_heap *h, void *mem);
+
+/**
+ * @brief Define a static k_heap
+ *
+ * This macro defines and initializes a static memory region and
+ * k_heap of the requested size.  After kernel start, &name can be
+ * used as if k_heap_init() had been called.
+ *
+ * @param name Symbol name for the struct k_heap object
+ * @param bytes Size of memory region, in bytes
+ */
+#define K_HEAP_DEFINE(name, bytes)				\
+	char __aligned(sizeof(void *)) kheap_##name[bytes];	\
+	Z_STRUCT_SECTION_ITERABLE(k_heap, name) = {		\
+		.heap = {					\
+			.init_mem = kheap_##name,		\
+			.init_bytes = (bytes),			\
+		 },						\
+	}
+
+/** @} */
+
 /**
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+struct k_mem_pool {
+	struct k_heap *heap;
+};
+#else
 struct k_mem_pool {
 	struct sys_mem_pool_base base;
 	_wait_q_t wait_q;
+#ifdef CONFIG_MEM_POOL_WAIT_STATS
+	/* Allocations that had to block */
+	u32_t n_blocked;
+	/* Blocked allocations woken up by a free */
+	u32_t n_wakeups;
+#endif
 };
+#endif
 
 /**
  * INTERNAL_HIDDEN @endcond
@@ -4150,6 +5376,11 @@ struct k_mem_pool {
  *
  * @code extern struct k_mem_pool <name>; @endcode
  *
+ * When CONFIG_MEM_POOL_HEAP_BACKEND is enabled the pool is instead a
+ * k_heap sized to hold @a n_max blocks of @a max_size bytes, blocks are
+ * carved out at their requested size, and @a min_size and @a align
+ * are ignored.
+ *
  * @param name Name of the memory pool.
  * @param minsz Size of the smallest blocks in the pool (in bytes).
  * @param maxsz Size of the largest blocks in the pool (in bytes).
@@ -4157,6 +5388,14 @@ struct k_mem_pool {
  * @param align Alignment of the pool's buffer (power of 2).
  * @req K-MPOOL-001
  */
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+#define K_MEM_POOL_DEFINE(name, minsz, maxsz, nmax, align)		\
+	K_HEAP_DEFINE(_mpool_heap_##name,				\
+		      SYS_HEAP_BUF_SIZE(WB_UP(maxsz) * (nmax), 4 * (nmax))); \
+	struct k_mem_pool name = {					\
+		.heap = &_mpool_heap_##name,				\
+	}
+#else
 #define K_MEM_POOL_DEFINE(name, minsz, maxsz, nmax, align)		\
 	char __aligned(WB_UP(align)) _mpool_buf_##name[WB_UP(maxsz) * nmax \
 				  + _MPOOL_BITS_SIZE(maxsz, minsz, nmax)]; \
@@ -4172,6 +5411,7 @@ struct k_mem_pool {
 		} \
 	}; \
 	BUILD_ASSERT(WB_UP(maxsz) >= _MPOOL_MINBLK);
+#endif
 
 /**
  * @brief Allocate memory from a memory pool.
@@ -4299,6 +5539,8 @@ extern void *k_calloc(size_t nmemb, size_t size);
 struct _poller {
 	struct k_thread *thread;
 	volatile bool is_polling;
+	/* embedded in a struct k_poll_set, thread is unused */
+	bool is_set;
 };
 
 /* private - types bit positions */
@@ -4594,6 +5836,143 @@ __syscall void k_poll_signal_check(struct k_poll_signal *signal,
 
 __syscall int k_poll_signal_raise(struct k_poll_signal *signal, int result);
 
+/* public - poll set object */
+/* one object registered in a poll set */
+struct k_poll_set_entry {
+	/* PRIVATE - DO NOT TOUCH */
+	struct k_poll_event event;
+
+	/* full tag, the event's own only has 8 bits */
+	u32_t tag;
+};
+
+struct k_poll_set {
+	/* PRIVATE - DO NOT TOUCH */
+	_wait_q_t wait_q;
+	sys_dlist_t ready;
+	struct _poller poller;
+	struct k_poll_set_entry *entries;
+	int num_entries;
+};
+
+/* public - one ready event reported by k_poll_set_wait() */
+struct k_poll_set_event {
+	/* object passed to k_poll_set_add() */
+	void *obj;
+
+	/* tag passed to k_poll_set_add() */
+	u32_t tag;
+
+	/* bitfield of event states (bitwise-ORed K_POLL_STATE_xxx values) */
+	u32_t state;
+};
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+#define _K_POLL_SET_INITIALIZER(obj, set_entries, set_num_entries) \
+	{ \
+	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	.ready = SYS_DLIST_STATIC_INIT(&obj.ready), \
+	.poller = { .thread = NULL, .is_polling = false, .is_set = true }, \
+	.entries = set_entries, \
+	.num_entries = set_num_entries, \
+	}
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Statically define and initialize a poll set.
+ *
+ * The poll set can hold up to @a max_events objects at a time.
+ *
+ * @param name Name of the poll set.
+ * @param max_events Maximum number of objects in the set.
+ */
+#define K_POLL_SET_DEFINE(name, max_events) \
+	static struct k_poll_set_entry _k_poll_set_entries_##name[max_events]; \
+	Z_STRUCT_SECTION_ITERABLE(k_poll_set, name) = \
+		_K_POLL_SET_INITIALIZER(name, _k_poll_set_entries_##name, \
+					max_events)
+
+/**
+ * @brief Initialize a poll set.
+ *
+ * A poll set is a persistent alternative to k_poll(): objects are
+ * registered once with k_poll_set_add() and stay registered across
+ * calls to k_poll_set_wait(), which only looks at the objects that
+ * became ready. Waiting is thus independent of the number of objects
+ * in the set.
+ *
+ * @param set Address of the poll set.
+ * @param entries Buffer for @a max_events entries, owned by the set
+ *                until it is no longer used.
+ * @param max_events Maximum number of objects in the set.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_init(struct k_poll_set *set,
+			    struct k_poll_set_entry *entries, int max_events);
+
+/**
+ * @brief Add an object to a poll set.
+ *
+ * If the object is already ready, a thread waiting on the set is
+ * woken up.
+ *
+ * @param set Address of the poll set.
+ * @param type Exactly one of K_POLL_TYPE_SIGNAL, K_POLL_TYPE_SEM_AVAILABLE
+ *             or K_POLL_TYPE_DATA_AVAILABLE.
+ * @param obj Kernel object or poll signal.
+ * @param tag Opaque value reported along with the object's events.
+ *
+ * @retval 0 Object added.
+ * @retval -EEXIST Object is already in the set.
+ * @retval -ENOSPC Set is full.
+ * @retval -EINVAL Invalid event type.
+ */
+__syscall int k_poll_set_add(struct k_poll_set *set, u32_t type, void *obj,
+			     u32_t tag);
+
+/**
+ * @brief Remove an object from a poll set.
+ *
+ * @param set Address of the poll set.
+ * @param obj Object passed to k_poll_set_add().
+ *
+ * @retval 0 Object removed.
+ * @retval -ENOENT Object is not in the set.
+ */
+__syscall int k_poll_set_remove(struct k_poll_set *set, void *obj);
+
+/**
+ * @brief Wait for objects in a poll set to become ready.
+ *
+ * Reports up to @a max_ready objects that became ready. As with
+ * k_poll(), the objects are not acquired. An object whose condition
+ * still holds on the next call, because it was not consumed in the
+ * meantime, is reported again. Objects that were not reported because
+ * @a ready was full are reported by the next call.
+ *
+ * An object cancelled with k_queue_cancel_wait() is reported with
+ * the K_POLL_STATE_CANCELLED state.
+ *
+ * @param set Address of the poll set.
+ * @param ready Array filled with the ready objects.
+ * @param max_ready Number of entries in @a ready.
+ * @param timeout Waiting period for an object to be ready (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @return Number of entries written to @a ready (at least 1).
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EINVAL Bad parameters (user mode only)
+ */
+__syscall int k_poll_set_wait(struct k_poll_set *set,
+			      struct k_poll_set_event *ready, int max_ready,
+			      s32_t timeout);
+
 /**
  * @internal
  */
@@ -4920,6 +6299,10 @@ struct k_mem_domain {
  * See documentation for k_mem_domain_add_partition() for details about
  * partition constraints.
  *
+ * With CONFIG_USER_RO_PARTITION the kernel adds a partition of its own,
+ * holding data user threads may read, to every domain, so @a num_parts
+ * must be one less than the number of partitions the hardware supports.
+ *
  * @param domain The memory domain to be initialized.
  * @param num_parts The number of array items of "parts" parameter.
  * @param parts An array of pointers to the memory partitions. Can be NULL
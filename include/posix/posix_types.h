@@ -76,11 +76,8 @@ typedef struct pthread_barrierattr {
 typedef u32_t pthread_rwlockattr_t;
 
 typedef struct pthread_rwlock_obj {
-	struct k_sem rd_sem;
-	struct k_sem wr_sem;
-	struct k_sem reader_active;/* blocks WR till reader has acquired lock */
+	struct k_rwlock rwlock;
 	s32_t status;
-	k_tid_t wr_owner;
 } pthread_rwlock_t;
 
 #endif /* CONFIG_PTHREAD_IPC */
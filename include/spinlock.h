@@ -50,10 +50,44 @@ struct k_spinlock_key {
 
 typedef struct k_spinlock_key k_spinlock_key_t;
 
+#ifdef CONFIG_SPINLOCK_STATS
+struct k_spinlock;
+
+/* Contention statistics kept in every spinlock.  They are only ever
+ * updated by the lock holder.
+ */
+struct k_spinlock_stats {
+	/* Number of times the lock was taken */
+	u32_t acquisitions;
+	/* Number of those that found it held by another CPU */
+	u32_t contended;
+	/* Total number of times a waiter polled the lock */
+	u32_t spins;
+	/* Longest time the lock was held, in cycles */
+	u32_t max_hold;
+	/* Cycle count when the lock was last taken */
+	u32_t acquired_at;
+	/* Set by k_spin_stats_register() */
+	const char *name;
+	struct k_spinlock *next;
+};
+
+void z_spin_stats_acquired(struct k_spinlock *l, u32_t spins);
+void z_spin_stats_released(struct k_spinlock *l);
+#endif
+
 struct k_spinlock {
 #ifdef CONFIG_SMP
+#ifdef CONFIG_SPINLOCK_TICKET
+	/* Next ticket to hand out, and the ticket being served: the
+	 * lock is free when they are equal
+	 */
+	atomic_t next;
+	atomic_t owner;
+#else
 	atomic_t locked;
 #endif
+#endif
 
 #ifdef SPIN_VALIDATE
 	/* Stores the thread that holds the lock with the locking CPU
@@ -61,12 +95,60 @@ struct k_spinlock {
 	 */
 	uintptr_t thread_cpu;
 #endif
+
+#ifdef CONFIG_SPINLOCK_STATS
+	struct k_spinlock_stats stats;
+#endif
 };
 
+#ifdef CONFIG_SMP
+/* Waits for the lock to be ours, returning how many times it had to
+ * poll it
+ */
+static ALWAYS_INLINE u32_t z_spin_acquire(struct k_spinlock *l)
+{
+	u32_t spins = 0U;
+
+#ifdef CONFIG_SPINLOCK_TICKET
+	/* Waiters only read the lock while they spin, and get it in the
+	 * order they took their tickets
+	 */
+	atomic_val_t ticket = atomic_inc(&l->next);
+
+	while (atomic_get(&l->owner) != ticket) {
+		spins++;
+	}
+#else
+	while (!atomic_cas(&l->locked, 0, 1)) {
+		spins++;
+	}
+#endif
+
+	return spins;
+}
+
+static ALWAYS_INLINE void z_spin_drop(struct k_spinlock *l)
+{
+#ifdef CONFIG_SPINLOCK_TICKET
+	(void)atomic_inc(&l->owner);
+#else
+	/* Strictly we don't need atomic_clear() here (which is an
+	 * exchange operation that returns the old value).  We are always
+	 * setting a zero and (because we hold the lock) know the existing
+	 * state won't change due to a race.  But some architectures need
+	 * a memory barrier when used like this, and we don't have a
+	 * Zephyr framework for that.
+	 */
+	atomic_clear(&l->locked);
+#endif
+}
+#endif /* CONFIG_SMP */
+
 static ALWAYS_INLINE k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
 {
 	ARG_UNUSED(l);
 	k_spinlock_key_t k;
+	u32_t spins = 0U;
 
 	/* Note that we need to use the underlying arch-specific lock
 	 * implementation.  The "irq_lock()" API in SMP context is
@@ -79,13 +161,18 @@ static ALWAYS_INLINE k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
 #endif
 
 #ifdef CONFIG_SMP
-	while (!atomic_cas(&l->locked, 0, 1)) {
-	}
+	spins = z_spin_acquire(l);
 #endif
 
 #ifdef SPIN_VALIDATE
 	z_spin_lock_set_owner(l);
 #endif
+
+#ifdef CONFIG_SPINLOCK_STATS
+	z_spin_stats_acquired(l, spins);
+#else
+	ARG_UNUSED(spins);
+#endif
 	return k;
 }
 
@@ -97,15 +184,12 @@ static ALWAYS_INLINE void k_spin_unlock(struct k_spinlock *l,
 	__ASSERT(z_spin_unlock_valid(l), "Not my spinlock!");
 #endif
 
+#ifdef CONFIG_SPINLOCK_STATS
+	z_spin_stats_released(l);
+#endif
+
 #ifdef CONFIG_SMP
-	/* Strictly we don't need atomic_clear() here (which is an
-	 * exchange operation that returns the old value).  We are always
-	 * setting a zero and (because we hold the lock) know the existing
-	 * state won't change due to a race.  But some architectures need
-	 * a memory barrier when used like this, and we don't have a
-	 * Zephyr framework for that.
-	 */
-	atomic_clear(&l->locked);
+	z_spin_drop(l);
 #endif
 	z_arch_irq_unlock(key.key);
 }
@@ -119,10 +203,42 @@ static ALWAYS_INLINE void k_spin_release(struct k_spinlock *l)
 #ifdef SPIN_VALIDATE
 	__ASSERT(z_spin_unlock_valid(l), "Not my spinlock!");
 #endif
+#ifdef CONFIG_SPINLOCK_STATS
+	z_spin_stats_released(l);
+#endif
 #ifdef CONFIG_SMP
-	atomic_clear(&l->locked);
+	z_spin_drop(l);
 #endif
 }
 
+#ifdef CONFIG_SPINLOCK_STATS
+/**
+ * @brief Make a spinlock's statistics available by name
+ *
+ * Adds @a l to the list of spinlocks walked by k_spin_stats_foreach(),
+ * and so shown by the "kernel spinlocks" shell command.  The lock must
+ * remain valid, and must not be re-initialized, from then on.
+ *
+ * @param l Spinlock to register
+ * @param name Name to report the lock under
+ */
+void k_spin_stats_register(struct k_spinlock *l, const char *name);
+
+typedef void (*k_spin_stats_cb_t)(const struct k_spinlock *l,
+				  const struct k_spinlock_stats *stats,
+				  void *user_data);
+
+/**
+ * @brief Iterate over the registered spinlocks
+ *
+ * Invokes @a user_cb on each spinlock passed to k_spin_stats_register().
+ * The statistics may be updated while the callback reads them.
+ *
+ * @param user_cb Callback invoked for each lock
+ * @param user_data Opaque pointer passed to @a user_cb
+ */
+void k_spin_stats_foreach(k_spin_stats_cb_t user_cb, void *user_data);
+#endif /* CONFIG_SPINLOCK_STATS */
+
 
 #endif /* ZEPHYR_INCLUDE_SPINLOCK_H_ */
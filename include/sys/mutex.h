@@ -11,23 +11,39 @@
  * sys_mutex behaves almost exactly like k_mutex, with the added advantage
  * that a sys_mutex instance can reside in user memory.
  *
- * Further enhancements will support locking/unlocking uncontended sys_mutexes
- * with simple atomic ops instead of syscalls, similar to Linux's
- * FUTEX_LOCK_PI and FUTEX_UNLOCK_PI
+ * With CONFIG_SYS_MUTEX_FUTEX, uncontended sys_mutexes are locked and
+ * unlocked with atomic ops instead of syscalls, similar to Linux's
+ * FUTEX_LOCK_PI and FUTEX_UNLOCK_PI.  User threads read their own
+ * identity from z_user_current; only without CONFIG_USER_CURRENT_THREAD
+ * do they need the k_current_get() syscall for it.
+ *
+ * The mutex value holds the owning thread, plus Z_SYS_MUTEX_WAITERS once
+ * another thread has gone to the kernel to wait for it.  A set waiters
+ * bit makes the owner's unlock fail its compare-and-swap and enter the
+ * kernel, which hands the mutex to the highest priority waiter and undoes
+ * any priority inheritance.
  */
 
 #ifdef CONFIG_USERSPACE
+#include <kernel.h>
 #include <sys/atomic.h>
 #include <zephyr/types.h>
 
 struct sys_mutex {
-	/* Currently unused, but will be used to store state for fast mutexes
-	 * that can be locked/unlocked with atomic ops if there is no
-	 * contention
+	/* Owning thread, or 0 when unlocked. Only used with
+	 * CONFIG_SYS_MUTEX_FUTEX.
 	 */
 	atomic_t val;
+#ifdef CONFIG_SYS_MUTEX_FUTEX
+	/* Number of times the owner locked it again, only ever touched
+	 * by the owner
+	 */
+	u32_t lock_count;
+#endif
 };
 
+#define Z_SYS_MUTEX_WAITERS ((atomic_val_t)1)
+
 #define SYS_MUTEX_DEFINE(name) \
 	struct sys_mutex name
 
@@ -58,6 +74,19 @@ __syscall int z_sys_mutex_kernel_lock(struct sys_mutex *mutex, s32_t timeout);
 
 __syscall int z_sys_mutex_kernel_unlock(struct sys_mutex *mutex);
 
+#ifdef CONFIG_SYS_MUTEX_FUTEX
+/* The owner value for the calling thread */
+static inline atomic_val_t z_sys_mutex_self(void)
+{
+#ifdef CONFIG_USER_CURRENT_THREAD
+	if (_is_user_context()) {
+		return (atomic_val_t)(uintptr_t)z_user_current;
+	}
+#endif
+	return (atomic_val_t)(uintptr_t)k_current_get();
+}
+#endif
+
 /**
  * @brief Lock a mutex.
  *
@@ -77,10 +106,25 @@ __syscall int z_sys_mutex_kernel_unlock(struct sys_mutex *mutex);
  * @retval -EAGAIN Waiting period timed out.
  * @retval -EACCESS Caller has no access to provided mutex address
  * @retval -EINVAL Provided mutex not recognized by the kernel
+ *
+ * @note With CONFIG_SYS_MUTEX_FUTEX the mutex memory is accessed directly
+ * by the caller, so an invalid or inaccessible address faults rather
+ * than returning -EACCESS or -EINVAL.
  */
 static inline int sys_mutex_lock(struct sys_mutex *mutex, s32_t timeout)
 {
-	/* For now, make the syscall unconditionally */
+#ifdef CONFIG_SYS_MUTEX_FUTEX
+	atomic_val_t self = z_sys_mutex_self();
+
+	if (atomic_cas(&mutex->val, 0, self)) {
+		return 0;
+	}
+
+	if ((atomic_get(&mutex->val) & ~Z_SYS_MUTEX_WAITERS) == self) {
+		mutex->lock_count++;
+		return 0;
+	}
+#endif
 	return z_sys_mutex_kernel_lock(mutex, timeout);
 }
 
@@ -102,7 +146,27 @@ static inline int sys_mutex_lock(struct sys_mutex *mutex, s32_t timeout)
  */
 static inline int sys_mutex_unlock(struct sys_mutex *mutex)
 {
-	/* For now, make the syscall unconditionally */
+#ifdef CONFIG_SYS_MUTEX_FUTEX
+	atomic_val_t self = z_sys_mutex_self();
+	atomic_val_t val = atomic_get(&mutex->val);
+
+	if (val == 0) {
+		return -EINVAL;
+	}
+
+	if ((val & ~Z_SYS_MUTEX_WAITERS) != self) {
+		return -EPERM;
+	}
+
+	if (mutex->lock_count != 0U) {
+		mutex->lock_count--;
+		return 0;
+	}
+
+	if (atomic_cas(&mutex->val, self, 0)) {
+		return 0;
+	}
+#endif
 	return z_sys_mutex_kernel_unlock(mutex);
 }
 
@@ -449,6 +449,284 @@ int ring_buf_get_finish(struct ring_buf *buf, u32_t size);
  */
 u32_t ring_buf_get(struct ring_buf *buf, u8_t *data, u32_t size);
 
+/**
+ * @brief Areas of a ring buffer claimed at once.
+ *
+ * A claim that wraps around the end of the buffer is made of two
+ * contiguous areas, the end and then the start of the buffer. The second
+ * one is empty when the claim doesn't wrap.
+ */
+struct ring_buf_segs {
+	u8_t *data[2];	/**< Start of each area */
+	u32_t size[2];	/**< Size of each area (in bytes) */
+};
+
+/**
+ * @brief A lock-free single-producer, single-consumer byte ring buffer.
+ *
+ * Indexes run freely and are masked on access, so the whole buffer can be
+ * filled. Each index is only written by one side, which publishes it with
+ * release semantics once the data it covers is written or read.
+ */
+struct ring_buf_spsc {
+	u32_t head;	/**< Read index, only written by the consumer */
+	u32_t tail;	/**< Write index, only written by the producer */
+	u32_t mask;	/**< Size of buf minus 1, the size being a power of 2 */
+	u8_t *buf;	/**< Memory region for stored data */
+};
+
+/**
+ * @brief A lock-free multi-producer, single-consumer item ring buffer.
+ *
+ * Producers reserve room for an item by advancing the reserve index with
+ * a compare-and-swap, then commit it once written. The consumer takes the
+ * items in reservation order; one reserved but not committed yet holds
+ * back those after it, without blocking any producer.
+ */
+struct ring_buf_mpsc {
+	u32_t head;	/**< Read index, only written by the consumer */
+	atomic_t reserve; /**< Index up to which producers reserved room */
+	atomic_t dropped_put_count; /**< Count of failed put attempts */
+	u32_t mask;	/**< Size of buf minus 1, the size being a power of 2 */
+	u32_t *buf;	/**< Memory region for stored entries */
+};
+
+/**
+ * @brief Statically define and initialize a lock-free SPSC byte ring buffer.
+ *
+ * This macro establishes a ring buffer of 2^pow bytes, for one producer
+ * and one consumer, which may run concurrently on different CPUs.
+ *
+ * The ring buffer can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct ring_buf_spsc <name>; @endcode
+ *
+ * @param name Name of the ring buffer.
+ * @param pow Ring buffer size exponent.
+ */
+#define RING_BUF_SPSC_DECLARE_POW2(name, pow) \
+	static u8_t _ring_buffer_data_##name[BIT(pow)]; \
+	struct ring_buf_spsc name = { \
+		.mask = (BIT(pow)) - 1, \
+		.buf = _ring_buffer_data_##name \
+	}
+
+/**
+ * @brief Statically define and initialize a lock-free MPSC item ring buffer.
+ *
+ * This macro establishes a ring buffer of 2^pow 32-bit words, for any
+ * number of producers and one consumer, which may run concurrently on
+ * different CPUs.
+ *
+ * The ring buffer can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct ring_buf_mpsc <name>; @endcode
+ *
+ * @param name Name of the ring buffer.
+ * @param pow Ring buffer size exponent.
+ */
+#define RING_BUF_MPSC_DECLARE_POW2(name, pow) \
+	static u32_t _ring_buffer_data_##name[BIT(pow)]; \
+	struct ring_buf_mpsc name = { \
+		.mask = (BIT(pow)) - 1, \
+		.buf = _ring_buffer_data_##name \
+	}
+
+/**
+ * @brief Initialize a lock-free SPSC byte ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use. It is
+ * only used for ring buffers not defined using RING_BUF_SPSC_DECLARE_POW2.
+ *
+ * @param rb Address of ring buffer.
+ * @param size Ring buffer size (in bytes), a power of 2.
+ * @param data Ring buffer data area (u8_t data[size]).
+ */
+static inline void ring_buf_spsc_init(struct ring_buf_spsc *rb, u32_t size,
+				      u8_t *data)
+{
+	__ASSERT(size != 0U && (size & (size - 1)) == 0U,
+		 "size must be a power of 2");
+
+	rb->head = 0U;
+	rb->tail = 0U;
+	rb->mask = size - 1;
+	rb->buf = data;
+}
+
+/**
+ * @brief Initialize a lock-free MPSC item ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use. It is
+ * only used for ring buffers not defined using RING_BUF_MPSC_DECLARE_POW2.
+ *
+ * @param rb Address of ring buffer.
+ * @param size32 Ring buffer size (in 32-bit words), a power of 2.
+ * @param data Ring buffer data area (u32_t data[size32]).
+ */
+static inline void ring_buf_mpsc_init(struct ring_buf_mpsc *rb, u32_t size32,
+				      u32_t *data)
+{
+	__ASSERT(size32 != 0U && (size32 & (size32 - 1)) == 0U,
+		 "size must be a power of 2");
+
+	/* Free room must read as zero, see ring_buf_mpsc_item_put() */
+	memset(data, 0, size32 * sizeof(u32_t));
+	rb->head = 0U;
+	atomic_set(&rb->reserve, 0);
+	atomic_set(&rb->dropped_put_count, 0);
+	rb->mask = size32 - 1;
+	rb->buf = data;
+}
+
+/**
+ * @brief Determine free space in a lock-free SPSC ring buffer.
+ *
+ * Only the producer gets an exact value, the consumer may free more space
+ * at any time.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Ring buffer free space (in bytes).
+ */
+u32_t ring_buf_spsc_space_get(struct ring_buf_spsc *rb);
+
+/**
+ * @brief Determine the amount of data in a lock-free SPSC ring buffer.
+ *
+ * Only the consumer gets an exact value, the producer may add more data
+ * at any time.
+ *
+ * @param rb Address of ring buffer.
+ *
+ * @return Number of bytes available for reading.
+ */
+u32_t ring_buf_spsc_size_get(struct ring_buf_spsc *rb);
+
+/**
+ * @brief Claim free space in a lock-free SPSC ring buffer.
+ *
+ * This routine gives the producer up to @a size bytes of free space to
+ * write in, as one or two areas when the space wraps around the end of
+ * the buffer. The data becomes visible to the consumer once
+ * ring_buf_spsc_put_finish() is called; claiming again before that gives
+ * the same space.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] segs Areas to write to.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Number of bytes claimed, smaller than requested if there is not
+ *	   enough free space.
+ */
+u32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *rb,
+			      struct ring_buf_segs *segs, u32_t size);
+
+/**
+ * @brief Publish data written to claimed space.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Number of bytes written, from the start of the claim.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds free space in the ring buffer.
+ */
+int ring_buf_spsc_put_finish(struct ring_buf_spsc *rb, u32_t size);
+
+/**
+ * @brief Write data to a lock-free SPSC ring buffer.
+ *
+ * @param rb   Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written.
+ */
+u32_t ring_buf_spsc_put(struct ring_buf_spsc *rb, const u8_t *data,
+			u32_t size);
+
+/**
+ * @brief Claim data in a lock-free SPSC ring buffer.
+ *
+ * This routine gives the consumer up to @a size bytes of data to read,
+ * as one or two areas when the data wraps around the end of the buffer.
+ * The space is given back to the producer once ring_buf_spsc_get_finish()
+ * is called.
+ *
+ * @param[in]  rb   Address of ring buffer.
+ * @param[out] segs Areas to read from.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Number of bytes claimed, smaller than requested if there is not
+ *	   enough data.
+ */
+u32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *rb,
+			      struct ring_buf_segs *segs, u32_t size);
+
+/**
+ * @brief Free data read from a claim.
+ *
+ * @param rb   Address of ring buffer.
+ * @param size Number of bytes read, from the start of the claim.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds valid bytes in the ring buffer.
+ */
+int ring_buf_spsc_get_finish(struct ring_buf_spsc *rb, u32_t size);
+
+/**
+ * @brief Read data from a lock-free SPSC ring buffer.
+ *
+ * @param rb   Address of ring buffer.
+ * @param data Address of the output buffer.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written to the output buffer.
+ */
+u32_t ring_buf_spsc_get(struct ring_buf_spsc *rb, u8_t *data, u32_t size);
+
+/**
+ * @brief Write a data item to a lock-free MPSC ring buffer.
+ *
+ * This routine may be called concurrently from any number of threads,
+ * ISRs and CPUs. An item takes @a size32 words plus 2 words of header.
+ *
+ * @param rb Address of ring buffer.
+ * @param type Data item's type identifier (application specific).
+ * @param value Data item's integer value (application specific).
+ * @param data Address of data item.
+ * @param size32 Data item size (number of 32-bit words).
+ *
+ * @retval 0 Data item was written.
+ * @retval -EMSGSIZE Ring buffer has insufficient free space.
+ */
+int ring_buf_mpsc_item_put(struct ring_buf_mpsc *rb, u16_t type, u8_t value,
+			   const u32_t *data, u8_t size32);
+
+/**
+ * @brief Read a data item from a lock-free MPSC ring buffer.
+ *
+ * This routine must only be called by the consumer.
+ *
+ * @param rb Address of ring buffer.
+ * @param type Area to store the data item's type identifier.
+ * @param value Area to store the data item's integer value.
+ * @param data Area to store the data item.
+ * @param size32 Size of the data item storage area (number of 32-bit
+ *		 words).
+ *
+ * @retval 0 Data item was fetched; @a size32 now contains the number of
+ *	   32-bit words read into data area @a data.
+ * @retval -EAGAIN Ring buffer is empty, or its next item is not
+ *	   committed yet.
+ * @retval -EMSGSIZE Data area @a data is too small; @a size32 now contains
+ *	   the number of 32-bit words needed.
+ */
+int ring_buf_mpsc_item_get(struct ring_buf_mpsc *rb, u16_t *type,
+			   u8_t *value, u32_t *data, u8_t *size32);
+
 /**
  * @}
  */
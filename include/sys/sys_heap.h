@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_SYS_HEAP_H_
+#define ZEPHYR_INCLUDE_SYS_SYS_HEAP_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+/**
+ * @brief Two-Level Segregated Fit heap
+ *
+ * A sys_heap manages a caller-provided buffer of arbitrary size and
+ * serves allocations of arbitrary size out of it.  Free blocks are
+ * kept in size-segregated lists indexed by a two-level bitmap, so
+ * both sys_heap_alloc() and sys_heap_free() complete in constant
+ * time regardless of heap size or fragmentation state, and adjacent
+ * free blocks are coalesced immediately on free.
+ *
+ * Per-allocation overhead is one machine word; allocations are
+ * aligned to sizeof(void *).  The free list index lives at the
+ * start of the heap buffer and its size grows with the logarithm
+ * of the buffer size.
+ *
+ * The sys_heap API is not synchronized.  Callers must provide their
+ * own locking (see k_heap for a kernel object wrapping one).
+ */
+
+/** @cond INTERNAL_HIDDEN */
+
+/* Number of second-level lists per first-level (power of two)
+ * size class, log2.  Bounds internal fragmentation to 1/16.
+ */
+#define Z_HEAP_SL_LOG2 4
+#define Z_HEAP_SL_COUNT (1 << Z_HEAP_SL_LOG2)
+
+struct z_heap;
+
+/* Compile-time find-last-set, for sizing static heap buffers */
+#define Z_HEAP_FLS4(x, n) ((((x) >> (n)) != 0) +	\
+			   (((x) >> ((n) + 1)) != 0) +	\
+			   (((x) >> ((n) + 2)) != 0) +	\
+			   (((x) >> ((n) + 3)) != 0))
+
+#define Z_HEAP_FLS(x) (Z_HEAP_FLS4((u32_t)(x), 0) +	\
+		       Z_HEAP_FLS4((u32_t)(x), 4) +	\
+		       Z_HEAP_FLS4((u32_t)(x), 8) +	\
+		       Z_HEAP_FLS4((u32_t)(x), 12) +	\
+		       Z_HEAP_FLS4((u32_t)(x), 16) +	\
+		       Z_HEAP_FLS4((u32_t)(x), 20) +	\
+		       Z_HEAP_FLS4((u32_t)(x), 24) +	\
+		       Z_HEAP_FLS4((u32_t)(x), 28))
+
+/* Upper bound on the free list index stored at the start of a heap
+ * buffer of @a bytes: a fixed header plus one bitmap word and
+ * Z_HEAP_SL_COUNT list heads per first-level class.
+ */
+#define Z_HEAP_CTL_SIZE(bytes)						\
+	(8 * sizeof(void *) + Z_HEAP_FLS(bytes) *			\
+	 (sizeof(u32_t) + Z_HEAP_SL_COUNT * sizeof(void *)))
+
+/** @endcond */
+
+/**
+ * @brief Buffer size for a heap holding @a bytes of user data
+ *
+ * Returns a buffer size large enough that a heap initialized on it
+ * can simultaneously hold @a nblocks allocations totalling @a bytes,
+ * accounting for the free list index, per-block headers and the
+ * size class rounding done by the allocator.
+ *
+ * @param bytes Total bytes of user data
+ * @param nblocks Number of allocations
+ */
+#define SYS_HEAP_BUF_SIZE(bytes, nblocks)				\
+	((bytes) + (bytes) / Z_HEAP_SL_COUNT +				\
+	 ((nblocks) + 2) * sizeof(void *) + Z_HEAP_CTL_SIZE(2 * (bytes)))
+
+struct sys_heap {
+	struct z_heap *heap;
+	void *init_mem;
+	size_t init_bytes;
+};
+
+struct sys_heap_stats {
+	/** Bytes in free blocks, excluding block headers */
+	size_t free_bytes;
+	/** Size of the largest free block */
+	size_t max_free_bytes;
+	/** Bytes in allocated blocks, excluding block headers */
+	size_t allocated_bytes;
+	/** High water mark of allocated_bytes */
+	size_t max_allocated_bytes;
+	/** Number of free blocks */
+	u32_t free_blocks;
+};
+
+/**
+ * @brief Initialize a heap
+ *
+ * Sets up the heap on the specified buffer.  The buffer is owned by
+ * the heap from this point on and must not be used for anything
+ * else.  The buffer need not be aligned.
+ *
+ * @param h Heap to initialize
+ * @param mem Untyped pointer to unused memory
+ * @param bytes Size of the buffer, in bytes
+ */
+void sys_heap_init(struct sys_heap *h, void *mem, size_t bytes);
+
+/**
+ * @brief Allocate memory from a heap
+ *
+ * Returns a pointer to a block of at least @a bytes bytes, aligned
+ * to sizeof(void *), or NULL if no suitable free block exists.
+ * Runs in constant time.
+ *
+ * @param h Heap from which to allocate
+ * @param bytes Number of bytes requested
+ * @return Pointer to memory the caller can use, or NULL
+ */
+void *sys_heap_alloc(struct sys_heap *h, size_t bytes);
+
+/**
+ * @brief Free memory into a heap
+ *
+ * Returns a block obtained from sys_heap_alloc() to the heap,
+ * merging it with any free physical neighbours.  Runs in constant
+ * time.  Passing NULL is a no-op.
+ *
+ * @param h Heap to which to return the memory
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ */
+void sys_heap_free(struct sys_heap *h, void *mem);
+
+/**
+ * @brief Usable size of an allocated block
+ *
+ * Returns the number of bytes the caller may use at @a mem, which
+ * is at least the size originally requested.
+ *
+ * @param h Heap owning the block
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ * @return Usable size in bytes
+ */
+size_t sys_heap_usable_size(struct sys_heap *h, void *mem);
+
+/**
+ * @brief Gather heap usage statistics
+ *
+ * Walks every block in the heap, so unlike alloc/free this takes
+ * time linear in the number of blocks.
+ *
+ * @param h Heap to inspect
+ * @param stats Filled in with current usage
+ */
+void sys_heap_stats_get(struct sys_heap *h, struct sys_heap_stats *stats);
+
+/**
+ * @brief Validate heap integrity
+ *
+ * Checks the physical block chain and the free lists for internal
+ * consistency.  Intended for tests; takes linear time.
+ *
+ * @param h Heap to validate
+ * @return true if the heap is consistent
+ */
+bool sys_heap_validate(struct sys_heap *h);
+
+#endif /* ZEPHYR_INCLUDE_SYS_SYS_HEAP_H_ */
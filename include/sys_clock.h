@@ -237,6 +237,18 @@ struct _timeout {
 	sys_dnode_t node;
 	s32_t dticks;
 	_timeout_func_t fn;
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	/* absolute tick of expiry */
+	u64_t expiry;
+#endif
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* ticks the expiry may be deferred by to share a wakeup */
+	s32_t slack;
+#endif
+#ifdef CONFIG_TIMEOUT_SUBTICK
+	/* cycles into its expiry tick at which it expires */
+	u32_t cycles;
+#endif
 };
 
 #ifdef __cplusplus
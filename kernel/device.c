@@ -7,9 +7,12 @@
 #include <errno.h>
 #include <string.h>
 #include <device.h>
+#include <init.h>
 #include <sys/util.h>
 #include <sys/atomic.h>
 #include <syscall_handler.h>
+#include <ksched.h>
+#include <wait_q.h>
 
 extern struct device __device_init_start[];
 extern struct device __device_PRE_KERNEL_1_start[];
@@ -25,6 +28,224 @@ extern u32_t __device_busy_end[];
 #define DEVICE_BUSY_SIZE (__device_busy_end - __device_busy_start)
 #endif
 
+static struct device *const config_levels[] = {
+	__device_PRE_KERNEL_1_start,
+	__device_PRE_KERNEL_2_start,
+	__device_POST_KERNEL_start,
+	__device_APPLICATION_start,
+	/* End marker */
+	__device_init_end,
+};
+
+static int device_run_init(struct device *info)
+{
+	struct device_config *device_conf = info->config;
+	int retval;
+#ifdef CONFIG_DEVICE_INIT_TIMING
+	u32_t start = k_cycle_get_32();
+#endif
+
+	retval = device_conf->init(info);
+#ifdef CONFIG_DEVICE_INIT_TIMING
+	info->init_cycles = k_cycle_get_32() - start;
+#endif
+	if (retval != 0) {
+		/* Initialization failed. Clear the API struct so that
+		 * device_get_binding() will not succeed for it.
+		 */
+		info->driver_api = NULL;
+	} else {
+		z_object_init(info);
+	}
+
+	return retval;
+}
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+/* Values of device::init_state */
+enum {
+	INIT_PENDING,	/* Synchronous, not initialized yet */
+	INIT_QUEUED,	/* Waiting for a worker thread */
+	INIT_RUNNING,
+	INIT_DONE,
+	INIT_FAILED,
+};
+
+/* Protects the init states.  Threads waiting for an entry to be
+ * initialized, or for work, all sleep on the same wait queue and are
+ * woken whenever an entry completes.
+ */
+static struct k_spinlock async_lock;
+static _wait_q_t async_wait_q = Z_WAIT_Q_INIT(&async_wait_q);
+static bool async_all_queued;
+
+static K_THREAD_STACK_ARRAY_DEFINE(async_stacks,
+				   CONFIG_DEVICE_INIT_ASYNC_THREADS,
+				   CONFIG_DEVICE_INIT_ASYNC_STACK_SIZE);
+static struct k_thread async_threads[CONFIG_DEVICE_INIT_ASYNC_THREADS];
+
+static inline bool init_finished(struct device *info)
+{
+	return info->init_state == INIT_DONE ||
+	       info->init_state == INIT_FAILED;
+}
+
+static void init_complete(struct device *info, int retval)
+{
+	k_spinlock_key_t key = k_spin_lock(&async_lock);
+
+	info->init_state = retval == 0 ? INIT_DONE : INIT_FAILED;
+
+	if (z_unpend_all(&async_wait_q) != 0) {
+		z_reschedule(&async_lock, key);
+	} else {
+		k_spin_unlock(&async_lock, key);
+	}
+}
+
+int device_init_wait(struct device *dev)
+{
+	k_spinlock_key_t key = k_spin_lock(&async_lock);
+
+	while (!init_finished(dev)) {
+		(void)z_pend_curr(&async_lock, key, &async_wait_q, K_FOREVER);
+		key = k_spin_lock(&async_lock);
+	}
+
+	k_spin_unlock(&async_lock, key);
+
+	return dev->init_state == INIT_DONE ? 0 : -ENODEV;
+}
+
+static struct device *device_find(const char *name)
+{
+	for (struct device *info = __device_init_start;
+	     info != __device_init_end; info++) {
+		if (info->config->name == name ||
+		    strcmp(name, info->config->name) == 0) {
+			return info;
+		}
+	}
+
+	return NULL;
+}
+
+static int async_run(const struct device_async *entry)
+{
+	for (int i = 0; i < entry->num_deps; i++) {
+		struct device *dep = device_find(entry->deps[i]);
+
+		__ASSERT(dep != NULL && dep < entry->dev,
+			 "%s must be initialized before %s", entry->deps[i],
+			 entry->dev->config->name);
+
+		if (dep == NULL || device_init_wait(dep) != 0) {
+			entry->dev->driver_api = NULL;
+			return -ENODEV;
+		}
+	}
+
+	return device_run_init(entry->dev);
+}
+
+/* Entries are claimed in init order.  Since an entry only depends on
+ * earlier ones, whatever it waits for has been claimed already, and
+ * the workers can't all end up waiting for entries still queued.
+ */
+static const struct device_async *async_next(void)
+{
+	const struct device_async *next = NULL;
+
+	Z_STRUCT_SECTION_FOREACH(device_async, entry) {
+		if (entry->dev->init_state == INIT_QUEUED &&
+		    (next == NULL || entry->dev < next->dev)) {
+			next = entry;
+		}
+	}
+
+	return next;
+}
+
+static void async_thread(void *p1, void *p2, void *p3)
+{
+	const struct device_async *entry;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		key = k_spin_lock(&async_lock);
+
+		entry = async_next();
+		if (entry == NULL) {
+			if (async_all_queued) {
+				k_spin_unlock(&async_lock, key);
+				return;
+			}
+			(void)z_pend_curr(&async_lock, key, &async_wait_q,
+					  K_FOREVER);
+			continue;
+		}
+
+		entry->dev->init_state = INIT_RUNNING;
+		k_spin_unlock(&async_lock, key);
+
+		init_complete(entry->dev, async_run(entry));
+	}
+}
+
+/* Hands the asynchronous entries of a level to the worker threads,
+ * which are started along with the first of them
+ */
+static void async_queue_level(s32_t level)
+{
+	static bool started;
+	bool queued = false;
+	k_spinlock_key_t key = k_spin_lock(&async_lock);
+
+	Z_STRUCT_SECTION_FOREACH(device_async, entry) {
+		if (entry->dev >= config_levels[level] &&
+		    entry->dev < config_levels[level + 1]) {
+			entry->dev->init_state = INIT_QUEUED;
+			queued = true;
+		}
+	}
+
+	async_all_queued = level == _SYS_INIT_LEVEL_APPLICATION;
+
+	if (z_unpend_all(&async_wait_q) != 0) {
+		z_reschedule(&async_lock, key);
+	} else {
+		k_spin_unlock(&async_lock, key);
+	}
+
+	if (queued && !started) {
+		started = true;
+		for (int i = 0; i < CONFIG_DEVICE_INIT_ASYNC_THREADS; i++) {
+			k_thread_create(&async_threads[i], async_stacks[i],
+					K_THREAD_STACK_SIZEOF(async_stacks[i]),
+					async_thread, NULL, NULL, NULL,
+					CONFIG_MAIN_THREAD_PRIORITY, 0,
+					K_NO_WAIT);
+		}
+	}
+}
+
+/* Waits for the asynchronous entries of a level, except deferred ones */
+static void async_wait_level(s32_t level)
+{
+	Z_STRUCT_SECTION_FOREACH(device_async, entry) {
+		if (!entry->deferred &&
+		    entry->dev >= config_levels[level] &&
+		    entry->dev < config_levels[level + 1]) {
+			(void)device_init_wait(entry->dev);
+		}
+	}
+}
+#endif /* CONFIG_DEVICE_INIT_ASYNC */
+
 /**
  * @brief Execute all the device initialization functions at a given level
  *
@@ -34,36 +255,56 @@ extern u32_t __device_busy_end[];
  * they need to be invoked, with symbols indicating where one level leaves
  * off and the next one begins.
  *
+ * From POST_KERNEL on, objects marked with DEVICE_INIT_ASYNC() are
+ * initialized by worker threads instead, and the level is over once
+ * they are done too.
+ *
  * @param level init level to run.
  */
 void z_sys_device_do_config_level(s32_t level)
 {
 	struct device *info;
-	static struct device *config_levels[] = {
-		__device_PRE_KERNEL_1_start,
-		__device_PRE_KERNEL_2_start,
-		__device_POST_KERNEL_start,
-		__device_APPLICATION_start,
-		/* End marker */
-		__device_init_end,
-	};
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+	if (level >= _SYS_INIT_LEVEL_POST_KERNEL) {
+		async_queue_level(level);
+	}
+#endif
 
 	for (info = config_levels[level]; info < config_levels[level+1];
 								info++) {
-		int retval;
-		struct device_config *device_conf = info->config;
-
-		retval = device_conf->init(info);
-		if (retval != 0) {
-			/* Initialization failed. Clear the API struct so that
-			 * device_get_binding() will not succeed for it.
-			 */
-			info->driver_api = NULL;
-		} else {
-			z_object_init(info);
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+		if (info->init_state != INIT_PENDING) {
+			/* Queued for a worker thread */
+			continue;
 		}
+		init_complete(info, device_run_init(info));
+#else
+		(void)device_run_init(info);
+#endif
+	}
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+	if (level >= _SYS_INIT_LEVEL_POST_KERNEL) {
+		async_wait_level(level);
+	}
+#endif
+}
+
+#ifdef CONFIG_DEVICE_INIT_TIMING
+void device_init_timing_foreach(device_init_timing_cb_t cb, void *user_data)
+{
+	int level = _SYS_INIT_LEVEL_PRE_KERNEL_1;
+
+	for (struct device *info = __device_init_start;
+	     info != __device_init_end; info++) {
+		while (info >= config_levels[level + 1]) {
+			level++;
+		}
+		cb(info, level, info->init_cycles, user_data);
 	}
 }
+#endif
 
 struct device *z_impl_device_get_binding(const char *name)
 {
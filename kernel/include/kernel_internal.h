@@ -51,6 +51,8 @@ extern void z_setup_new_thread(struct k_thread *new_thread,
 			      void *p1, void *p2, void *p3,
 			      int prio, u32_t options, const char *name);
 
+extern void z_schedule_new_thread(struct k_thread *thread, s32_t delay);
+
 #if defined(CONFIG_FLOAT) && defined(CONFIG_FP_SHARING)
 /**
  * @brief Disable floating point context preservation
@@ -231,8 +233,45 @@ extern size_t z_arch_user_string_nlen(const char *s, size_t maxsize, int *err);
  * z_cstart() if userspace is enabled.
  */
 extern void z_app_shmem_bss_zero(void);
+
+#ifdef CONFIG_USER_RO_PARTITION
+/**
+ * @brief Give a user thread that is in no memory domain z_user_ro_partition
+ *
+ * Puts the thread in a kernel domain holding only that partition.  Does
+ * nothing for supervisor threads and for threads that already are in a
+ * domain.
+ *
+ * @param thread Thread entering, or created in, user mode
+ */
+extern void z_mem_domain_default_add(struct k_thread *thread);
+#endif
+
+/**
+ * @brief Take an aborted thread out of its memory domain, if any
+ *
+ * @param thread Thread being aborted
+ */
+extern void z_mem_domain_thread_exit(struct k_thread *thread);
 #endif /* CONFIG_USERSPACE */
 
+/**
+ * @brief Publish the thread being switched to for user mode
+ *
+ * Called by the architecture on every context switch, with the
+ * incoming thread.
+ *
+ * @param thread Thread being switched to
+ */
+static inline void z_user_current_set(struct k_thread *thread)
+{
+#ifdef CONFIG_USER_CURRENT_THREAD
+	z_user_current = thread;
+#else
+	ARG_UNUSED(thread);
+#endif
+}
+
 /**
  * @brief Allocate some memory from the current thread's resource pool
  *
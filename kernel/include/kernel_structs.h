@@ -54,6 +54,11 @@
 
 /* end - states */
 
+/* Internal thread option: the stack was already filled by an earlier
+ * thread, see k_thread_pool_spawn()
+ */
+#define Z_THREAD_STACK_RECYCLED (BIT(4))
+
 #ifdef CONFIG_STACK_SENTINEL
 /* Magic value in lowest bytes of the stack */
 #define STACK_SENTINEL 0xF0F0F0F0
@@ -109,6 +114,9 @@ struct _cpu {
 #ifdef CONFIG_SMP
 	/* True when _current is allowed to context switch */
 	u8_t swap_ok;
+
+	/* Number of scheduler IPIs taken */
+	u32_t ipi_count;
 #endif
 };
 
@@ -219,8 +227,11 @@ static ALWAYS_INLINE void z_new_thread_init(struct k_thread *thread,
 #endif
 
 #ifdef CONFIG_INIT_STACKS
-	memset(pStack, 0xaa, stackSize);
+	if ((options & Z_THREAD_STACK_RECYCLED) == 0U) {
+		memset(pStack, 0xaa, stackSize);
+	}
 #endif
+	options &= ~Z_THREAD_STACK_RECYCLED;
 #ifdef CONFIG_STACK_SENTINEL
 	/* Put the stack sentinel at the lowest 4 bytes of the stack area.
 	 * We periodically check that it's still present and kill the thread
@@ -85,6 +85,17 @@ static inline bool z_is_idle_thread(void *entry_point)
 	return entry_point == idle;
 }
 
+static inline bool z_is_idle_thread_object(struct k_thread *thread)
+{
+#ifdef CONFIG_SMP
+	return thread->base.is_idle;
+#else
+	extern k_tid_t const _idle_thread;
+
+	return thread == _idle_thread;
+#endif
+}
+
 static inline bool z_is_thread_pending(struct k_thread *thread)
 {
 	return (thread->base.thread_state & _THREAD_PENDING) != 0U;
@@ -49,6 +49,26 @@ enum _obj_init_check {
 int z_object_validate(struct _k_object *ko, enum k_objects otype,
 		       enum _obj_init_check init);
 
+/**
+ * Validate a kernel object pointer passed in by the current thread
+ *
+ * Looks up the object and validates it like z_object_validate(),
+ * dumping out error information if that fails. Objects the current
+ * thread recently passed the checks on are found in its cache of
+ * CONFIG_KOBJECT_CACHE_SIZE entries, which skips the lookup and the
+ * permission test.
+ *
+ * @param obj Untrusted kernel object pointer
+ * @param otype Expected type of the kernel object, or K_OBJ_ANY if type
+ *	  doesn't matter
+ * @param init Indicate whether the object needs to already be in initialized
+ *             or uninitialized state, or that we don't care
+ * @return 0 If the object is valid, or an error code as for
+ *         z_object_validate()
+ */
+int z_object_check(void *obj, enum k_objects otype,
+		   enum _obj_init_check init);
+
 /**
  * Dump out error information on failed z_object_validate() call
  *
@@ -413,8 +433,8 @@ static inline int z_obj_validation_check(struct _k_object *ko,
 }
 
 #define Z_SYSCALL_IS_OBJ(ptr, type, init) \
-	Z_SYSCALL_VERIFY_MSG(z_obj_validation_check(z_object_find((void *)ptr), (void *)ptr, \
-				   type, init) == 0, "access denied")
+	Z_SYSCALL_VERIFY_MSG(z_object_check((void *)ptr, type, init) == 0, \
+			     "access denied")
 
 /**
  * @brief Runtime check driver object pointer for presence of operation
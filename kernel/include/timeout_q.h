@@ -25,9 +25,16 @@ extern "C" {
 static inline void z_init_timeout(struct _timeout *t, _timeout_func_t fn)
 {
 	sys_dnode_init(&t->node);
+#ifdef CONFIG_TIMEOUT_SLACK
+	t->slack = 0;
+#endif
 }
 
-void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks);
+u64_t z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks);
+
+void z_add_timeout_tick(struct _timeout *to, _timeout_func_t fn, u64_t tick);
+
+void z_add_timeout_abs(struct _timeout *to, _timeout_func_t fn, u64_t cycles);
 
 int z_abort_timeout(struct _timeout *to);
 
@@ -43,11 +50,24 @@ static inline void z_init_thread_timeout(struct _thread_base *thread_base)
 
 extern void z_thread_timeout(struct _timeout *to);
 
+#ifdef CONFIG_TIMEOUT_SLACK
+s32_t z_timeout_slack(s32_t slack);
+#endif
+
 static inline void z_add_thread_timeout(struct k_thread *th, s32_t ticks)
 {
+#ifdef CONFIG_TIMEOUT_SLACK
+	th->base.timeout.slack = th->base.timer_slack;
+#endif
 	z_add_timeout(&th->base.timeout, z_thread_timeout, ticks);
 }
 
+static inline void z_add_thread_timeout_abs(struct k_thread *th,
+					    u64_t cycles)
+{
+	z_add_timeout_abs(&th->base.timeout, z_thread_timeout, cycles);
+}
+
 static inline int z_abort_thread_timeout(struct k_thread *thread)
 {
 	return z_abort_timeout(&thread->base.timeout);
@@ -64,6 +84,7 @@ s32_t z_timeout_remaining(struct _timeout *timeout);
 /* Stubs when !CONFIG_SYS_CLOCK_EXISTS */
 #define z_init_thread_timeout(t) do {} while (false)
 #define z_add_thread_timeout(th, to) do {} while (false && (void *)to && (void *)th)
+#define z_add_thread_timeout_abs(th, to) do {} while (false && (void *)th)
 #define z_abort_thread_timeout(t) (0)
 #define z_is_inactive_timeout(t) 0
 #define z_get_next_timeout_expiry() (K_FOREVER)
@@ -32,6 +32,9 @@ static inline void z_waitq_init(_wait_q_t *w)
 			.lessthan_fn = z_priq_rb_lessthan
 		}
 	};
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	w->blocked_cycles = 0U;
+#endif
 }
 
 static inline struct k_thread *z_waitq_head(_wait_q_t *w)
@@ -48,6 +51,9 @@ static inline struct k_thread *z_waitq_head(_wait_q_t *w)
 static inline void z_waitq_init(_wait_q_t *w)
 {
 	sys_dlist_init(&w->waitq);
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	w->blocked_cycles = 0U;
+#endif
 }
 
 static inline struct k_thread *z_waitq_head(_wait_q_t *w)
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <init.h>
+
+void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
+{
+	z_waitq_init(&h->wait_q);
+	sys_heap_init(&h->heap, mem, bytes);
+}
+
+static int statics_init(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	Z_STRUCT_SECTION_FOREACH(k_heap, h) {
+		k_heap_init(h, h->heap.init_mem, h->heap.init_bytes);
+	}
+
+	return 0;
+}
+
+SYS_INIT(statics_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+/* Descriptor of a blocked allocation, hung off the waiting thread's
+ * swap_data so that k_heap_free() can satisfy it directly.
+ */
+struct heap_wait {
+	size_t bytes;
+	void *mem;
+	struct k_thread *next;	/* granted waiters, linked by heap_handoff() */
+};
+
+void *k_heap_alloc(struct k_heap *h, size_t bytes, s32_t timeout)
+{
+	struct heap_wait wait;
+	void *ret;
+	k_spinlock_key_t key;
+
+	__ASSERT(!(z_is_in_isr() && timeout != K_NO_WAIT), "");
+
+	key = k_spin_lock(&h->lock);
+
+	ret = sys_heap_alloc(&h->heap, bytes);
+	if (ret != NULL || timeout == K_NO_WAIT) {
+		k_spin_unlock(&h->lock, key);
+		return ret;
+	}
+
+	/* k_heap_free() allocates on our behalf and passes the block
+	 * back through the wait descriptor
+	 */
+	wait.bytes = bytes;
+	_current->base.swap_data = &wait;
+	if (z_pend_curr(&h->lock, key, &h->wait_q, timeout) != 0) {
+		return NULL;
+	}
+
+	return wait.mem;
+}
+
+/* Hand memory to every waiter whose request now fits, in wait
+ * queue order, with a single walk of the queue.  Once an allocation
+ * of some size fails, waiters asking for at least that much are
+ * skipped: nothing gets freed while the walk runs.  Granted waiters
+ * are chained through their descriptors and woken after the walk,
+ * as the wait queue cannot be unpended from while it is iterated.
+ * Returns true if any thread was readied.
+ */
+static bool heap_handoff(struct k_heap *h)
+{
+	struct k_thread *thread, *granted = NULL, **tail = &granted;
+	size_t fail_sz = SIZE_MAX;
+
+	_WAIT_Q_FOR_EACH(&h->wait_q, thread) {
+		struct heap_wait *wait = thread->base.swap_data;
+
+		if (wait->bytes >= fail_sz) {
+			continue;
+		}
+
+		wait->mem = sys_heap_alloc(&h->heap, wait->bytes);
+		if (wait->mem == NULL) {
+			fail_sz = wait->bytes;
+			continue;
+		}
+
+		wait->next = NULL;
+		*tail = thread;
+		tail = &wait->next;
+	}
+
+	for (thread = granted; thread != NULL; ) {
+		struct k_thread *next =
+			((struct heap_wait *)thread->base.swap_data)->next;
+
+		z_unpend_thread(thread);
+		z_set_thread_return_value(thread, 0);
+		z_ready_thread(thread);
+		thread = next;
+	}
+
+	return granted != NULL;
+}
+
+void k_heap_free(struct k_heap *h, void *mem)
+{
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+
+	sys_heap_free(&h->heap, mem);
+
+	/* Rather than waking everyone up to race for the memory,
+	 * allocate on behalf of the waiters it can satisfy and wake
+	 * only those.
+	 */
+	if (heap_handoff(h)) {
+		z_reschedule(&h->lock, key);
+	} else {
+		k_spin_unlock(&h->lock, key);
+	}
+}
@@ -11,10 +11,27 @@
 #include <sys/__assert.h>
 #include <stdbool.h>
 #include <spinlock.h>
+#include <app_memory/app_memdomain.h>
 
 static struct k_spinlock lock;
 static u8_t max_partitions;
 
+/* Partitions the kernel adds to every domain, out of the ones the
+ * hardware supports
+ */
+#ifdef CONFIG_USER_RO_PARTITION
+#define RESERVED_PARTITIONS 1U
+
+Z_APPMEM_PARTITION_DEFINE(z_user_ro_partition, K_MEM_PARTITION_P_RW_U_RO);
+
+/* Holds the user threads the application put in no domain, so that they
+ * can read z_user_ro_partition too
+ */
+static struct k_mem_domain default_domain;
+#else
+#define RESERVED_PARTITIONS 0U
+#endif
+
 #if (defined(CONFIG_EXECUTE_XOR_WRITE) || \
 	defined(CONFIG_MPU_REQUIRES_NON_OVERLAPPING_REGIONS)) && __ASSERT_ON
 static bool sane_partition(const struct k_mem_partition *part,
@@ -87,7 +104,8 @@ void k_mem_domain_init(struct k_mem_domain *domain, u8_t num_parts,
 
 	__ASSERT(domain != NULL, "");
 	__ASSERT(num_parts == 0U || parts != NULL, "");
-	__ASSERT(num_parts <= max_partitions, "");
+	__ASSERT(num_parts + RESERVED_PARTITIONS <= max_partitions,
+		 "too many partitions");
 
 	key = k_spin_lock(&lock);
 
@@ -115,11 +133,60 @@ void k_mem_domain_init(struct k_mem_domain *domain, u8_t num_parts,
 		}
 	}
 
+#ifdef CONFIG_USER_RO_PARTITION
+	/* Lets the domain's threads read kernel data without syscalls.  The
+	 * slot is reserved by the num_parts check above; should a caller
+	 * ignore that, leave the partition out rather than write past the
+	 * partitions the hardware supports.
+	 */
+	if (domain->num_partitions < max_partitions) {
+		domain->partitions[domain->num_partitions] = z_user_ro_partition;
+		domain->num_partitions++;
+	}
+#endif
+
 	sys_dlist_init(&domain->mem_domain_q);
 
 	k_spin_unlock(&lock, key);
 }
 
+static void add_thread_locked(struct k_mem_domain *domain,
+			      struct k_thread *thread)
+{
+	sys_dlist_append(&domain->mem_domain_q,
+			 &thread->mem_domain_info.mem_domain_q_node);
+	thread->mem_domain_info.mem_domain = domain;
+
+	z_arch_mem_domain_thread_add(thread);
+}
+
+static void remove_thread_locked(struct k_thread *thread)
+{
+	z_arch_mem_domain_thread_remove(thread);
+
+	sys_dlist_remove(&thread->mem_domain_info.mem_domain_q_node);
+	thread->mem_domain_info.mem_domain = NULL;
+}
+
+#ifdef CONFIG_USER_RO_PARTITION
+static void default_domain_add_locked(struct k_thread *thread)
+{
+	if (thread->mem_domain_info.mem_domain == NULL &&
+	    (thread->base.user_options & K_USER) != 0U) {
+		add_thread_locked(&default_domain, thread);
+	}
+}
+
+void z_mem_domain_default_add(struct k_thread *thread)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	default_domain_add_locked(thread);
+
+	k_spin_unlock(&lock, key);
+}
+#endif
+
 void k_mem_domain_destroy(struct k_mem_domain *domain)
 {
 	k_spinlock_key_t key;
@@ -137,6 +204,9 @@ void k_mem_domain_destroy(struct k_mem_domain *domain)
 
 		sys_dlist_remove(&thread->mem_domain_info.mem_domain_q_node);
 		thread->mem_domain_info.mem_domain = NULL;
+#ifdef CONFIG_USER_RO_PARTITION
+		default_domain_add_locked(thread);
+#endif
 	}
 
 	k_spin_unlock(&lock, key);
@@ -218,16 +288,19 @@ void k_mem_domain_add_thread(struct k_mem_domain *domain, k_tid_t thread)
 
 	__ASSERT(domain != NULL, "");
 	__ASSERT(thread != NULL, "");
-	__ASSERT(thread->mem_domain_info.mem_domain == NULL,
-		 "mem domain unset");
 
 	key = k_spin_lock(&lock);
 
-	sys_dlist_append(&domain->mem_domain_q,
-			 &thread->mem_domain_info.mem_domain_q_node);
-	thread->mem_domain_info.mem_domain = domain;
+#ifdef CONFIG_USER_RO_PARTITION
+	/* Only stood in until the thread got a domain of its own */
+	if (thread->mem_domain_info.mem_domain == &default_domain) {
+		remove_thread_locked(thread);
+	}
+#endif
+	__ASSERT(thread->mem_domain_info.mem_domain == NULL,
+		 "mem domain unset");
 
-	z_arch_mem_domain_thread_add(thread);
+	add_thread_locked(domain, thread);
 
 	k_spin_unlock(&lock, key);
 }
@@ -240,10 +313,21 @@ void k_mem_domain_remove_thread(k_tid_t thread)
 	__ASSERT(thread->mem_domain_info.mem_domain != NULL, "mem domain set");
 
 	key = k_spin_lock(&lock);
-	z_arch_mem_domain_thread_remove(thread);
+	remove_thread_locked(thread);
+#ifdef CONFIG_USER_RO_PARTITION
+	default_domain_add_locked(thread);
+#endif
+	k_spin_unlock(&lock, key);
+}
+
+void z_mem_domain_thread_exit(struct k_thread *thread)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (thread->mem_domain_info.mem_domain != NULL) {
+		remove_thread_locked(thread);
+	}
 
-	sys_dlist_remove(&thread->mem_domain_info.mem_domain_q_node);
-	thread->mem_domain_info.mem_domain = NULL;
 	k_spin_unlock(&lock, key);
 }
 
@@ -259,6 +343,10 @@ static int init_mem_domain_module(struct device *arg)
 	 */
 	__ASSERT(max_partitions <= CONFIG_MAX_DOMAIN_PARTITIONS, "");
 
+#ifdef CONFIG_USER_RO_PARTITION
+	k_mem_domain_init(&default_domain, 0, NULL);
+#endif
+
 	return 0;
 }
 
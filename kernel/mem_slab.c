@@ -13,6 +13,7 @@
 #include <sys/dlist.h>
 #include <ksched.h>
 #include <init.h>
+#include <string.h>
 
 static struct k_spinlock lock;
 
@@ -77,6 +78,10 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->block_size = block_size;
 	slab->buffer = buffer;
 	slab->num_used = 0U;
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	slab->num_waiting = 0U;
+	(void)memset(slab->cache, 0, sizeof(slab->cache));
+#endif
 	create_free_list(slab);
 	z_waitq_init(&slab->wait_q);
 	SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
@@ -84,16 +89,150 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	z_object_init(slab);
 }
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+
+#define CACHE_SIZE CONFIG_MEM_SLAB_CPU_CACHE_SIZE
+#define CACHE_BATCH (CACHE_SIZE / 2)
+
+/* A CPU cache lock may be taken with the slab lock held, never the
+ * other way around.
+ */
+
+static inline struct k_mem_slab_cache *cpu_cache(struct k_mem_slab *slab)
+{
+	/* Migrating right after the lookup only costs locality, every
+	 * cache has its own lock.
+	 */
+	return &slab->cache[_current_cpu->id];
+}
+
+static bool cache_alloc(struct k_mem_slab *slab, void **mem)
+{
+	struct k_mem_slab_cache *c = cpu_cache(slab);
+	k_spinlock_key_t key = k_spin_lock(&c->lock);
+	char *blk = c->free_list;
+
+	if (blk != NULL) {
+		c->free_list = *(char **)blk;
+		c->count--;
+		*mem = blk;
+	}
+
+	k_spin_unlock(&c->lock, key);
+
+	return blk != NULL;
+}
+
+static bool cache_free(struct k_mem_slab *slab, char *blk)
+{
+	struct k_mem_slab_cache *c = cpu_cache(slab);
+	k_spinlock_key_t key = k_spin_lock(&c->lock);
+	bool cached = false;
+
+	/* An allocation about to block has already emptied the caches,
+	 * anything stashed now would be lost to it.
+	 */
+	if (slab->num_waiting == 0U && c->count < CACHE_SIZE) {
+		*(char **)blk = c->free_list;
+		c->free_list = blk;
+		c->count++;
+		cached = true;
+	}
+
+	k_spin_unlock(&c->lock, key);
+
+	return cached;
+}
+
+/* Top up @a c to @a target blocks from the slab free list.  Called
+ * with the slab lock held.
+ */
+static void cache_refill(struct k_mem_slab *slab, struct k_mem_slab_cache *c,
+			 u32_t target)
+{
+	k_spinlock_key_t key = k_spin_lock(&c->lock);
+
+	while (c->count < target && slab->free_list != NULL) {
+		char *blk = slab->free_list;
+
+		slab->free_list = *(char **)blk;
+		*(char **)blk = c->free_list;
+		c->free_list = blk;
+		c->count++;
+		slab->num_used++;
+	}
+
+	k_spin_unlock(&c->lock, key);
+}
+
+/* Return blocks from @a c to the slab free list until at most @a keep
+ * are left.  Called with the slab lock held.
+ */
+static void cache_flush(struct k_mem_slab *slab, struct k_mem_slab_cache *c,
+			u32_t keep)
+{
+	k_spinlock_key_t key = k_spin_lock(&c->lock);
+
+	while (c->count > keep) {
+		char *blk = c->free_list;
+
+		c->free_list = *(char **)blk;
+		c->count--;
+		*(char **)blk = slab->free_list;
+		slab->free_list = blk;
+		slab->num_used--;
+	}
+
+	k_spin_unlock(&c->lock, key);
+}
+
+/* Pull every cached block back so that no CPU sits on free memory
+ * while an allocation fails.  Called with the slab lock held.
+ */
+static void cache_reclaim(struct k_mem_slab *slab)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cache_flush(slab, &slab->cache[i], 0U);
+	}
+}
+
+#endif /* CONFIG_MEM_SLAB_CPU_CACHE */
+
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key;
 	int result;
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (cache_alloc(slab, mem)) {
+		return 0;
+	}
+#endif
+
+	key = k_spin_lock(&lock);
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (slab->free_list == NULL) {
+		/* Announce ourselves before looking at the caches, so
+		 * that a racing free doesn't stash its block behind our
+		 * back.
+		 */
+		slab->num_waiting++;
+		cache_reclaim(slab);
+		if (slab->free_list != NULL || timeout == K_NO_WAIT) {
+			slab->num_waiting--;
+		}
+	}
+#endif
+
 	if (slab->free_list != NULL) {
 		/* take a free block */
 		*mem = slab->free_list;
 		slab->free_list = *(char **)(slab->free_list);
 		slab->num_used++;
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+		cache_refill(slab, cpu_cache(slab), CACHE_BATCH);
+#endif
 		result = 0;
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a free block to become available */
@@ -105,6 +244,11 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+		key = k_spin_lock(&lock);
+		slab->num_waiting--;
+		k_spin_unlock(&lock, key);
+#endif
 		return result;
 	}
 
@@ -113,19 +257,89 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 	return result;
 }
 
-void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
+/* Give @a blk to the first waiter, or put it back on the free list.
+ * Returns true if a thread was readied.  Called with the lock held.
+ */
+static bool free_locked(struct k_mem_slab *slab, char *blk)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
 	struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
 
 	if (pending_thread != NULL) {
-		z_set_thread_return_value_with_data(pending_thread, 0, *mem);
+		z_set_thread_return_value_with_data(pending_thread, 0, blk);
 		z_ready_thread(pending_thread);
+		return true;
+	}
+
+	*(char **)blk = slab->free_list;
+	slab->free_list = blk;
+	slab->num_used--;
+	return false;
+}
+
+void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
+{
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (cache_free(slab, *mem)) {
+		return;
+	}
+#endif
+
+	key = k_spin_lock(&lock);
+
+	if (free_locked(slab, *mem)) {
+		z_reschedule(&lock, key);
+		return;
+	}
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	/* The local cache was full, make room for the next frees */
+	cache_flush(slab, cpu_cache(slab), CACHE_SIZE - CACHE_BATCH);
+#endif
+	k_spin_unlock(&lock, key);
+}
+
+int k_mem_slab_alloc_bulk(struct k_mem_slab *slab, void **mem, u32_t count)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	/* num_used counts every block that isn't on the free list */
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (slab->num_blocks - slab->num_used < count) {
+		cache_reclaim(slab);
+	}
+#endif
+	if (slab->num_blocks - slab->num_used < count) {
+		k_spin_unlock(&lock, key);
+		return -ENOMEM;
+	}
+
+	for (u32_t i = 0U; i < count; i++) {
+		mem[i] = slab->free_list;
+		slab->free_list = *(char **)(slab->free_list);
+	}
+	slab->num_used += count;
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+void k_mem_slab_free_bulk(struct k_mem_slab *slab, void **mem, u32_t count)
+{
+	bool need_sched = false;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (u32_t i = 0U; i < count; i++) {
+		if (free_locked(slab, mem[i])) {
+			need_sched = true;
+		}
+	}
+
+	if (need_sched) {
 		z_reschedule(&lock, key);
 	} else {
-		**(char ***)mem = slab->free_list;
-		slab->free_list = *(char **)mem;
-		slab->num_used--;
 		k_spin_unlock(&lock, key);
 	}
 }
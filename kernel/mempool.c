@@ -13,6 +13,34 @@
 #include <sys/math_extras.h>
 #include <stdbool.h>
 
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+
+/* k_mem_pool is a thin wrapper around a k_heap: blocks are carved
+ * out of the heap at their exact size and the block id records
+ * where to return them.
+ */
+
+int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
+		     size_t size, s32_t timeout)
+{
+	block->data = k_heap_alloc(p->heap, size, timeout);
+	block->id.heap = p->heap;
+	block->id.data = block->data;
+
+	if (block->data != NULL) {
+		return 0;
+	}
+
+	return timeout == K_NO_WAIT ? -ENOMEM : -EAGAIN;
+}
+
+void k_mem_pool_free_id(struct k_mem_block_id *id)
+{
+	k_heap_free(id->heap, id->data);
+}
+
+#else
+
 static struct k_spinlock lock;
 
 static struct k_mem_pool *get_pool(int id)
@@ -46,88 +74,157 @@ int init_static_pools(struct device *unused)
 
 SYS_INIT(init_static_pools, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
+/* Descriptor of a blocked allocation, hung off the waiting thread's
+ * swap_data so that the free path can satisfy it directly.
+ */
+struct mem_pool_wait {
+	struct k_mem_block *block;
+	size_t size;
+	struct k_thread *next;	/* granted waiters, linked by pool_handoff() */
+};
+
+static int pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
+		      size_t size)
+{
+	int ret;
+	u32_t level_num, block_num;
+
+	/* There is a "managed race" in alloc that can fail
+	 * (albeit in a well-defined way, see comments there)
+	 * with -EAGAIN when simultaneous allocations happen.
+	 * Retry exactly once to resolve it.  If we're so
+	 * contended that it fails twice, then we clearly want
+	 * to block.
+	 */
+	for (int i = 0; i < 2; i++) {
+		ret = z_sys_mem_pool_block_alloc(&p->base, size,
+						&level_num, &block_num,
+						&block->data);
+		if (ret != -EAGAIN) {
+			break;
+		}
+	}
+
+	if (ret == -EAGAIN) {
+		ret = -ENOMEM;
+	}
+
+	block->id.pool = pool_id(p);
+	block->id.level = level_num;
+	block->id.block = block_num;
+
+	return ret;
+}
+
 int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 		     size_t size, s32_t timeout)
 {
+	struct mem_pool_wait wait;
+	k_spinlock_key_t key;
 	int ret;
-	s64_t end = 0;
 
 	__ASSERT(!(z_is_in_isr() && timeout != K_NO_WAIT), "");
 
-	if (timeout > 0) {
-		end = k_uptime_get() + timeout;
+	ret = pool_alloc(p, block, size);
+	if (ret == 0 || timeout == K_NO_WAIT || ret != -ENOMEM) {
+		return ret;
 	}
 
-	while (true) {
-		u32_t level_num, block_num;
-
-		/* There is a "managed race" in alloc that can fail
-		 * (albeit in a well-defined way, see comments there)
-		 * with -EAGAIN when simultaneous allocations happen.
-		 * Retry exactly once before sleeping to resolve it.
-		 * If we're so contended that it fails twice, then we
-		 * clearly want to block.
-		 */
-		for (int i = 0; i < 2; i++) {
-			ret = z_sys_mem_pool_block_alloc(&p->base, size,
-							&level_num, &block_num,
-							&block->data);
-			if (ret != -EAGAIN) {
-				break;
-			}
+	/* A free that completed between the attempt above and
+	 * taking the lock could not have seen us on the wait queue,
+	 * so try once more before pending.
+	 */
+	key = k_spin_lock(&lock);
+
+	ret = pool_alloc(p, block, size);
+	if (ret != -ENOMEM) {
+		k_spin_unlock(&lock, key);
+		return ret;
+	}
+
+	wait.block = block;
+	wait.size = size;
+	_current->base.swap_data = &wait;
+
+#ifdef CONFIG_MEM_POOL_WAIT_STATS
+	p->n_blocked++;
+#endif
+
+	/* Returns 0 once a free has allocated on our behalf, or
+	 * -EAGAIN on timeout
+	 */
+	return z_pend_curr(&lock, key, &p->wait_q, timeout);
+}
+
+/* Hand memory to every waiter whose request now fits, in wait
+ * queue order, with a single walk of the queue.  Once an allocation
+ * of some size fails, waiters asking for at least that much are
+ * skipped: nothing gets freed while the walk runs.  The wait queue
+ * cannot be unpended from while it is being iterated, so granted
+ * waiters are chained through their descriptors and woken after
+ * the walk.  Returns true if any thread was readied.
+ */
+static bool pool_handoff(struct k_mem_pool *p)
+{
+	struct k_thread *thread, *granted = NULL, **tail = &granted;
+	size_t fail_sz = SIZE_MAX;
+
+	_WAIT_Q_FOR_EACH(&p->wait_q, thread) {
+		struct mem_pool_wait *wait = thread->base.swap_data;
+
+		if (wait->size >= fail_sz) {
+			continue;
 		}
 
-		if (ret == -EAGAIN) {
-			ret = -ENOMEM;
+		if (pool_alloc(p, wait->block, wait->size) != 0) {
+			fail_sz = wait->size;
+			continue;
 		}
 
-		block->id.pool = pool_id(p);
-		block->id.level = level_num;
-		block->id.block = block_num;
+		wait->next = NULL;
+		*tail = thread;
+		tail = &wait->next;
+	}
 
-		if (ret == 0 || timeout == K_NO_WAIT ||
-		    ret != -ENOMEM) {
-			return ret;
-		}
+	for (thread = granted; thread != NULL; ) {
+		struct k_thread *next =
+			((struct mem_pool_wait *)thread->base.swap_data)->next;
 
-		z_pend_curr_unlocked(&p->wait_q, timeout);
+		z_unpend_thread(thread);
+		z_set_thread_return_value(thread, 0);
+		z_ready_thread(thread);
 
-		if (timeout != K_FOREVER) {
-			timeout = end - k_uptime_get();
-			if (timeout <= 0) {
-				break;
-			}
-		}
+#ifdef CONFIG_MEM_POOL_WAIT_STATS
+		p->n_wakeups++;
+#endif
+		thread = next;
 	}
 
-	return -EAGAIN;
+	return granted != NULL;
 }
 
 void k_mem_pool_free_id(struct k_mem_block_id *id)
 {
-	int need_sched = 0;
 	struct k_mem_pool *p = get_pool(id->pool);
+	k_spinlock_key_t key;
 
 	z_sys_mem_pool_block_free(&p->base, id->level, id->block);
 
-	/* Wake up anyone blocked on this pool and let them repeat
-	 * their allocation attempts
-	 *
-	 * (Note that this spinlock only exists because z_unpend_all()
-	 * is unsynchronized.  Maybe we want to put the lock into the
-	 * wait_q instead and make the API safe?)
+	/* Rather than waking everyone up to race for the memory,
+	 * allocate on behalf of the waiters it can satisfy and wake
+	 * only those.
 	 */
-	k_spinlock_key_t key = k_spin_lock(&lock);
-
-	need_sched = z_unpend_all(&p->wait_q);
+	key = k_spin_lock(&lock);
 
-	if (need_sched != 0) {
+	if (pool_handoff(p)) {
 		z_reschedule(&lock, key);
 	} else {
 		k_spin_unlock(&lock, key);
 	}
 }
 
+#endif /* CONFIG_MEM_POOL_HEAP_BACKEND */
+
 void k_mem_pool_free(struct k_mem_block *block)
 {
 	k_mem_pool_free_id(&block->id);
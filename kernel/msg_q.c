@@ -54,6 +54,7 @@ void k_msgq_init(struct k_msgq *msgq, char *buffer, size_t msg_size,
 	msgq->read_ptr = buffer;
 	msgq->write_ptr = buffer;
 	msgq->used_msgs = 0;
+	msgq->get_held = 0;
 	msgq->flags = 0;
 	z_waitq_init(&msgq->wait_q);
 	msgq->lock = (struct k_spinlock) {};
@@ -105,6 +106,80 @@ void k_msgq_cleanup(struct k_msgq *msgq)
 	}
 }
 
+/*
+ * Threads wait on a message queue either to send or to receive, never
+ * both at once: receivers only wait while there is no message and no
+ * k_msgq_get_claim() in progress, senders only while there is no free
+ * slot.  Claims make everyone else fail with -EBUSY instead of waiting
+ * so that this holds.
+ */
+static inline bool receivers_may_wait(struct k_msgq *msgq)
+{
+	return msgq->used_msgs == 0U && msgq->get_held == 0U;
+}
+
+static inline char *ring_next(struct k_msgq *msgq, char *ptr, u32_t num)
+{
+	ptr += num * msgq->msg_size;
+	if (ptr == msgq->buffer_end) {
+		ptr = msgq->buffer_start;
+	}
+	return ptr;
+}
+
+/* Copy @a num messages into the ring, in at most two chunks */
+static void ring_put(struct k_msgq *msgq, const char *data, u32_t num)
+{
+	while (num > 0U) {
+		u32_t chunk = MIN(num, (msgq->buffer_end - msgq->write_ptr) /
+				  msgq->msg_size);
+
+		(void)memcpy(msgq->write_ptr, data, chunk * msgq->msg_size);
+		msgq->write_ptr = ring_next(msgq, msgq->write_ptr, chunk);
+		msgq->used_msgs += chunk;
+		data += chunk * msgq->msg_size;
+		num -= chunk;
+	}
+}
+
+/* Copy @a num messages out of the ring, in at most two chunks */
+static void ring_get(struct k_msgq *msgq, char *data, u32_t num)
+{
+	while (num > 0U) {
+		u32_t chunk = MIN(num, (msgq->buffer_end - msgq->read_ptr) /
+				  msgq->msg_size);
+
+		(void)memcpy(data, msgq->read_ptr, chunk * msgq->msg_size);
+		msgq->read_ptr = ring_next(msgq, msgq->read_ptr, chunk);
+		msgq->used_msgs -= chunk;
+		data += chunk * msgq->msg_size;
+		num -= chunk;
+	}
+}
+
+/* Move the messages of waiting senders into free slots.  Only to be
+ * called once receivers can no longer be waiting.  Returns true if a
+ * thread was readied.
+ */
+static bool ring_refill(struct k_msgq *msgq)
+{
+	struct k_thread *pending_thread;
+	bool woken = false;
+
+	while (z_impl_k_msgq_num_free_get(msgq) > 0U) {
+		pending_thread = z_unpend_first_thread(&msgq->wait_q);
+		if (pending_thread == NULL) {
+			break;
+		}
+
+		ring_put(msgq, pending_thread->base.swap_data, 1);
+		z_set_thread_return_value(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		woken = true;
+	}
+
+	return woken;
+}
 
 int z_impl_k_msgq_put(struct k_msgq *msgq, void *data, s32_t timeout)
 {
@@ -116,7 +191,10 @@ int z_impl_k_msgq_put(struct k_msgq *msgq, void *data, s32_t timeout)
 
 	key = k_spin_lock(&msgq->lock);
 
-	if (msgq->used_msgs < msgq->max_msgs) {
+	if ((msgq->flags & K_MSGQ_FLAG_PUT_CLAIM) != 0U) {
+		/* a claimed slot must be committed first */
+		result = -EBUSY;
+	} else if (z_impl_k_msgq_num_free_get(msgq) > 0U) {
 		/* message queue isn't full */
 		pending_thread = z_unpend_first_thread(&msgq->wait_q);
 		if (pending_thread != NULL) {
@@ -130,12 +208,7 @@ int z_impl_k_msgq_put(struct k_msgq *msgq, void *data, s32_t timeout)
 			return 0;
 		} else {
 			/* put message in queue */
-			(void)memcpy(msgq->write_ptr, data, msgq->msg_size);
-			msgq->write_ptr += msgq->msg_size;
-			if (msgq->write_ptr == msgq->buffer_end) {
-				msgq->write_ptr = msgq->buffer_start;
-			}
-			msgq->used_msgs++;
+			ring_put(msgq, data, 1);
 		}
 		result = 0;
 	} else if (timeout == K_NO_WAIT) {
@@ -188,35 +261,19 @@ int z_impl_k_msgq_get(struct k_msgq *msgq, void *data, s32_t timeout)
 	__ASSERT(!z_is_in_isr() || timeout == K_NO_WAIT, "");
 
 	k_spinlock_key_t key;
-	struct k_thread *pending_thread;
 	int result;
 
 	key = k_spin_lock(&msgq->lock);
 
-	if (msgq->used_msgs > 0) {
+	if (msgq->get_held != 0U) {
+		/* a claimed message must be finished first */
+		result = -EBUSY;
+	} else if (msgq->used_msgs > 0) {
 		/* take first available message from queue */
-		(void)memcpy(data, msgq->read_ptr, msgq->msg_size);
-		msgq->read_ptr += msgq->msg_size;
-		if (msgq->read_ptr == msgq->buffer_end) {
-			msgq->read_ptr = msgq->buffer_start;
-		}
-		msgq->used_msgs--;
+		ring_get(msgq, data, 1);
 
 		/* handle first thread waiting to write (if any) */
-		pending_thread = z_unpend_first_thread(&msgq->wait_q);
-		if (pending_thread != NULL) {
-			/* add thread's message to queue */
-			(void)memcpy(msgq->write_ptr, pending_thread->base.swap_data,
-			       msgq->msg_size);
-			msgq->write_ptr += msgq->msg_size;
-			if (msgq->write_ptr == msgq->buffer_end) {
-				msgq->write_ptr = msgq->buffer_start;
-			}
-			msgq->used_msgs++;
-
-			/* wake up waiting thread */
-			z_set_thread_return_value(pending_thread, 0);
-			z_ready_thread(pending_thread);
+		if (ring_refill(msgq)) {
 			z_reschedule(&msgq->lock, key);
 			return 0;
 		}
@@ -247,6 +304,234 @@ Z_SYSCALL_HANDLER(k_msgq_get, msgq_p, data, timeout)
 }
 #endif
 
+int k_msgq_put_claim(struct k_msgq *msgq, void **data)
+{
+	k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+	int result;
+
+	if ((msgq->flags & K_MSGQ_FLAG_PUT_CLAIM) != 0U) {
+		result = -EBUSY;
+	} else if (z_impl_k_msgq_num_free_get(msgq) == 0U) {
+		result = -ENOMSG;
+	} else {
+		/* write_ptr only moves on commit, nobody else writes */
+		msgq->flags |= K_MSGQ_FLAG_PUT_CLAIM;
+		*data = msgq->write_ptr;
+		result = 0;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return result;
+}
+
+void k_msgq_put_commit(struct k_msgq *msgq)
+{
+	k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+	struct k_thread *pending_thread = NULL;
+
+	__ASSERT((msgq->flags & K_MSGQ_FLAG_PUT_CLAIM) != 0U,
+		 "no claimed slot");
+	msgq->flags &= ~K_MSGQ_FLAG_PUT_CLAIM;
+
+	if (receivers_may_wait(msgq)) {
+		pending_thread = z_unpend_first_thread(&msgq->wait_q);
+	}
+
+	if (pending_thread != NULL) {
+		/* give message to waiting thread */
+		(void)memcpy(pending_thread->base.swap_data, msgq->write_ptr,
+			     msgq->msg_size);
+		z_set_thread_return_value(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		z_reschedule(&msgq->lock, key);
+		return;
+	}
+
+	msgq->write_ptr = ring_next(msgq, msgq->write_ptr, 1);
+	msgq->used_msgs++;
+
+	k_spin_unlock(&msgq->lock, key);
+}
+
+int k_msgq_get_claim(struct k_msgq *msgq, void **data)
+{
+	k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+	int result;
+
+	if (msgq->get_held != 0U) {
+		result = -EBUSY;
+	} else if (msgq->used_msgs == 0U) {
+		result = -ENOMSG;
+	} else {
+		*data = msgq->read_ptr;
+		msgq->read_ptr = ring_next(msgq, msgq->read_ptr, 1);
+		msgq->used_msgs--;
+		msgq->get_held = 1U;
+		result = 0;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return result;
+}
+
+void k_msgq_get_finish(struct k_msgq *msgq)
+{
+	k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+
+	__ASSERT(msgq->get_held != 0U, "no claimed message");
+	msgq->get_held = 0U;
+
+	if (ring_refill(msgq)) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+}
+
+int z_impl_k_msgq_put_n(struct k_msgq *msgq, const void *data, u32_t num,
+			s32_t timeout)
+{
+	__ASSERT(!z_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	const char *src = data;
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+	bool woken = false;
+	u32_t sent = 0U;
+	int result;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if ((msgq->flags & K_MSGQ_FLAG_PUT_CLAIM) != 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EBUSY;
+	}
+
+	/* give the first messages to waiting threads */
+	while (sent < num && receivers_may_wait(msgq)) {
+		pending_thread = z_unpend_first_thread(&msgq->wait_q);
+		if (pending_thread == NULL) {
+			break;
+		}
+
+		(void)memcpy(pending_thread->base.swap_data, src,
+			     msgq->msg_size);
+		z_set_thread_return_value(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		woken = true;
+		src += msgq->msg_size;
+		sent++;
+	}
+
+	/* and queue as many of the others as fit */
+	if (sent < num) {
+		u32_t chunk = MIN(num - sent, z_impl_k_msgq_num_free_get(msgq));
+
+		ring_put(msgq, src, chunk);
+		sent += chunk;
+	}
+
+	if (sent > 0U) {
+		if (woken) {
+			z_reschedule(&msgq->lock, key);
+		} else {
+			k_spin_unlock(&msgq->lock, key);
+		}
+		return sent;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		k_spin_unlock(&msgq->lock, key);
+		return -ENOMSG;
+	}
+
+	/* wait for room for the first message, then send the rest */
+	_current->base.swap_data = (void *)src;
+	result = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+	if (result != 0) {
+		return result;
+	}
+
+	result = (num > 1U) ? z_impl_k_msgq_put_n(msgq, src + msgq->msg_size,
+						  num - 1U, K_NO_WAIT) : 0;
+
+	return (result > 0) ? result + 1 : 1;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_msgq_put_n, msgq_p, data, num, timeout)
+{
+	struct k_msgq *q = (struct k_msgq *)msgq_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_READ(data, num, q->msg_size));
+
+	return z_impl_k_msgq_put_n(q, (const void *)data, num, timeout);
+}
+#endif
+
+int z_impl_k_msgq_get_n(struct k_msgq *msgq, void *data, u32_t num,
+			s32_t timeout)
+{
+	__ASSERT(!z_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	char *dst = data;
+	k_spinlock_key_t key;
+	u32_t received;
+	int result;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if (msgq->get_held != 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EBUSY;
+	}
+
+	received = MIN(num, msgq->used_msgs);
+	if (received > 0U) {
+		ring_get(msgq, dst, received);
+
+		/* let waiting senders fill the space in one go */
+		if (ring_refill(msgq)) {
+			z_reschedule(&msgq->lock, key);
+		} else {
+			k_spin_unlock(&msgq->lock, key);
+		}
+		return received;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		k_spin_unlock(&msgq->lock, key);
+		return -ENOMSG;
+	}
+
+	/* wait for the first message, then take whatever else is there */
+	_current->base.swap_data = dst;
+	result = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+	if (result != 0) {
+		return result;
+	}
+
+	result = (num > 1U) ? z_impl_k_msgq_get_n(msgq, dst + msgq->msg_size,
+						  num - 1U, K_NO_WAIT) : 0;
+
+	return (result > 0) ? result + 1 : 1;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_msgq_get_n, msgq_p, data, num, timeout)
+{
+	struct k_msgq *q = (struct k_msgq *)msgq_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(data, num, q->msg_size));
+
+	return z_impl_k_msgq_get_n(q, (void *)data, num, timeout);
+}
+#endif
+
 int z_impl_k_msgq_peek(struct k_msgq *msgq, void *data)
 {
 	k_spinlock_key_t key;
@@ -293,6 +578,12 @@ void z_impl_k_msgq_purge(struct k_msgq *msgq)
 		z_ready_thread(pending_thread);
 	}
 
+	/* A message being read in place keeps the slots up to the new
+	 * read position until it is finished, the ring stays contiguous.
+	 */
+	if (msgq->get_held != 0U) {
+		msgq->get_held += msgq->used_msgs;
+	}
 	msgq->used_msgs = 0;
 	msgq->read_ptr = msgq->write_ptr;
 
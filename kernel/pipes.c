@@ -14,6 +14,7 @@
 #include <kernel_structs.h>
 #include <debug/object_tracing_common.h>
 #include <toolchain.h>
+#include <string.h>
 #include <linker/sections.h>
 #include <wait_q.h>
 #include <sys/dlist.h>
@@ -21,10 +22,14 @@
 #include <syscall_handler.h>
 #include <sys/__assert.h>
 #include <kernel_internal.h>
+#include <sys/math_extras.h>
 
 struct k_pipe_desc {
 	unsigned char *buffer;           /* Position in src/dest buffer */
+	size_t seg_bytes;                /* # bytes left at buffer */
+	const struct k_pipe_iovec *iov;  /* Next segment, if vectored */
 	size_t bytes_to_xfer;            /* # bytes left to transfer */
+	size_t bytes_optional;           /* # a reader can do without */
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 	struct k_mem_block *block;       /* Pointer to memory block */
 	struct k_mem_block  copy_block;  /* For backwards compatibility */
@@ -184,21 +189,71 @@ void k_pipe_cleanup(struct k_pipe *pipe)
 	}
 }
 
+/* Point @a desc at a single contiguous buffer */
+static void pipe_desc_init(struct k_pipe_desc *desc, void *buffer,
+			   size_t size)
+{
+	desc->buffer = buffer;
+	desc->seg_bytes = size;
+	desc->iov = NULL;
+	desc->bytes_to_xfer = size;
+	desc->bytes_optional = 0;
+}
+
+/* Point @a desc at a list of segments */
+static void pipe_desc_init_iov(struct k_pipe_desc *desc,
+			       const struct k_pipe_iovec *iov, size_t iovcnt)
+{
+	desc->buffer = NULL;
+	desc->seg_bytes = 0;
+	desc->iov = iov;
+	desc->bytes_to_xfer = 0;
+	desc->bytes_optional = 0;
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		desc->bytes_to_xfer += iov[i].len;
+	}
+}
+
 /**
  * @brief Copy bytes from @a src to @a dest
  *
+ * Copies as many bytes as both descriptors allow, one memcpy() per
+ * contiguous run, and advances both past the copied data.
+ *
  * @return Number of bytes copied
  */
-static size_t pipe_xfer(unsigned char *dest, size_t dest_size,
-			 const unsigned char *src, size_t src_size)
+static size_t pipe_xfer(struct k_pipe_desc *dest, struct k_pipe_desc *src)
 {
-	size_t num_bytes = MIN(dest_size, src_size);
-	const unsigned char *end = src + num_bytes;
+	size_t num_bytes = MIN(dest->bytes_to_xfer, src->bytes_to_xfer);
+	size_t bytes_left = num_bytes;
+	size_t run_length;
+
+	while (bytes_left > 0) {
+		/* skip to the next non-empty segment of either side */
+		while (dest->seg_bytes == 0) {
+			dest->buffer = dest->iov->base;
+			dest->seg_bytes = dest->iov->len;
+			dest->iov++;
+		}
+		while (src->seg_bytes == 0) {
+			src->buffer = src->iov->base;
+			src->seg_bytes = src->iov->len;
+			src->iov++;
+		}
 
-	while (src != end) {
-		*dest = *src;
-		dest++;
-		src++;
+		run_length = MIN(bytes_left,
+				 MIN(dest->seg_bytes, src->seg_bytes));
+
+		(void)memcpy(dest->buffer, src->buffer, run_length);
+
+		dest->buffer        += run_length;
+		dest->seg_bytes     -= run_length;
+		dest->bytes_to_xfer -= run_length;
+		src->buffer         += run_length;
+		src->seg_bytes      -= run_length;
+		src->bytes_to_xfer  -= run_length;
+		bytes_left          -= run_length;
 	}
 
 	return num_bytes;
@@ -212,9 +267,9 @@ static size_t pipe_xfer(unsigned char *dest, size_t dest_size,
  *
  * @return Number of bytes written to the pipe's circular buffer
  */
-static size_t pipe_buffer_put(struct k_pipe *pipe,
-			       const unsigned char *src, size_t src_size)
+static size_t pipe_buffer_put(struct k_pipe *pipe, struct k_pipe_desc *src)
 {
+	struct k_pipe_desc ring;
 	size_t  bytes_copied;
 	size_t  run_length;
 	size_t  num_bytes_written = 0;
@@ -225,10 +280,9 @@ static size_t pipe_buffer_put(struct k_pipe *pipe,
 		run_length = MIN(pipe->size - pipe->bytes_used,
 				 pipe->size - pipe->write_index);
 
-		bytes_copied = pipe_xfer(pipe->buffer + pipe->write_index,
-					  run_length,
-					  src + num_bytes_written,
-					  src_size - num_bytes_written);
+		pipe_desc_init(&ring, pipe->buffer + pipe->write_index,
+			       run_length);
+		bytes_copied = pipe_xfer(&ring, src);
 
 		num_bytes_written += bytes_copied;
 		pipe->bytes_used += bytes_copied;
@@ -249,9 +303,9 @@ static size_t pipe_buffer_put(struct k_pipe *pipe,
  *
  * @return Number of bytes read from the pipe's circular buffer
  */
-static size_t pipe_buffer_get(struct k_pipe *pipe,
-			       unsigned char *dest, size_t dest_size)
+static size_t pipe_buffer_get(struct k_pipe *pipe, struct k_pipe_desc *dest)
 {
+	struct k_pipe_desc ring;
 	size_t  bytes_copied;
 	size_t  run_length;
 	size_t  num_bytes_read = 0;
@@ -261,10 +315,9 @@ static size_t pipe_buffer_get(struct k_pipe *pipe,
 		run_length = MIN(pipe->bytes_used,
 				 pipe->size - pipe->read_index);
 
-		bytes_copied = pipe_xfer(dest + num_bytes_read,
-					  dest_size - num_bytes_read,
-					  pipe->buffer + pipe->read_index,
-					  run_length);
+		pipe_desc_init(&ring, pipe->buffer + pipe->read_index,
+			       run_length);
+		bytes_copied = pipe_xfer(dest, &ring);
 
 		num_bytes_read += bytes_copied;
 		pipe->bytes_used -= bytes_copied;
@@ -289,7 +342,9 @@ static size_t pipe_buffer_get(struct k_pipe *pipe,
  *  3. ensure a timeout can not make the request impossible to satisfy
  *
  * The list is populated with previously pended threads that will be ready to
- * run after the pipe call is complete.
+ * run after the pipe call is complete. A reader whose request can only be
+ * partly satisfied joins the list as well, if that part covers the minimum
+ * it is waiting for.
  *
  * Important things to remember when reading from the pipe ...
  * 1. If there are writers int @a wait_q, then the pipe's buffer is full.
@@ -345,15 +400,27 @@ static bool pipe_xfer_prepare(sys_dlist_t      *xfer_list,
 
 	while ((thread = z_waitq_head(wait_q)) != NULL) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		num_bytes += desc->bytes_to_xfer;
 
-		if (num_bytes > bytes_to_xfer) {
+		if (num_bytes + desc->bytes_to_xfer > bytes_to_xfer) {
 			/*
-			 * This request can not be fully satisfied.
-			 * Do not remove it from the wait_q.
-			 * Do not abort its timeout (if applicable).
-			 * Do not add it to the transfer list
+			 * This request can not be fully satisfied. Unless
+			 * what is left covers the minimum the (reader)
+			 * thread asked for, do not remove it from the wait_q,
+			 * do not abort its timeout and do not add it to the
+			 * transfer list.
 			 */
+			size_t share = bytes_to_xfer - num_bytes;
+
+			if ((share == 0) ||
+			    (desc->bytes_to_xfer - share >
+			     desc->bytes_optional)) {
+				*waiter = thread;
+				return true;
+			}
+
+			/* Hand it what there is and let it go */
+			z_unpend_thread(thread);
+			sys_dlist_append(xfer_list, &thread->base.qnode_dlist);
 			break;
 		}
 
@@ -363,11 +430,12 @@ static bool pipe_xfer_prepare(sys_dlist_t      *xfer_list,
 		 * Abort its timeout.
 		 * Add it to the transfer list.
 		 */
+		num_bytes += desc->bytes_to_xfer;
 		z_unpend_thread(thread);
 		sys_dlist_append(xfer_list, &thread->base.qnode_dlist);
 	}
 
-	*waiter = (num_bytes > bytes_to_xfer) ? thread : NULL;
+	*waiter = NULL;
 
 	return true;
 }
@@ -422,15 +490,13 @@ static void pipe_thread_ready(struct k_thread *thread)
  * @brief Internal API used to send data to a pipe
  */
 int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
-			 unsigned char *data, size_t bytes_to_write,
-			 size_t *bytes_written, size_t min_xfer,
-			 s32_t timeout)
+			 struct k_pipe_desc *src, size_t *bytes_written,
+			 size_t min_xfer, s32_t timeout)
 {
 	struct k_thread    *reader;
 	struct k_pipe_desc *desc;
 	sys_dlist_t    xfer_list;
-	size_t         num_bytes_written = 0;
-	size_t         bytes_copied;
+	size_t         bytes_to_write = src->bytes_to_xfer;
 
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS == 0)
 	ARG_UNUSED(async_desc);
@@ -470,13 +536,7 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 				  sys_dlist_get(&xfer_list);
 	while (thread != NULL) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = pipe_xfer(desc->buffer, desc->bytes_to_xfer,
-					  data + num_bytes_written,
-					  bytes_to_write - num_bytes_written);
-
-		num_bytes_written   += bytes_copied;
-		desc->buffer        += bytes_copied;
-		desc->bytes_to_xfer -= bytes_copied;
+		(void)pipe_xfer(desc, src);
 
 		/* The thread's read request has been satisfied. Ready it. */
 		z_ready_thread(thread);
@@ -490,13 +550,7 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	 */
 	if (reader != NULL) {
 		desc = (struct k_pipe_desc *)reader->base.swap_data;
-		bytes_copied = pipe_xfer(desc->buffer, desc->bytes_to_xfer,
-					  data + num_bytes_written,
-					  bytes_to_write - num_bytes_written);
-
-		num_bytes_written   += bytes_copied;
-		desc->buffer        += bytes_copied;
-		desc->bytes_to_xfer -= bytes_copied;
+		(void)pipe_xfer(desc, src);
 	}
 
 	/*
@@ -504,12 +558,10 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	 * readers. Add as much as possible to the pipe's circular buffer.
 	 */
 
-	num_bytes_written +=
-		pipe_buffer_put(pipe, data + num_bytes_written,
-				 bytes_to_write - num_bytes_written);
+	(void)pipe_buffer_put(pipe, src);
 
-	if (num_bytes_written == bytes_to_write) {
-		*bytes_written = num_bytes_written;
+	if (src->bytes_to_xfer == 0) {
+		*bytes_written = bytes_to_write;
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 		if (async_desc != NULL) {
 			pipe_async_finish(async_desc);
@@ -525,15 +577,12 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	if (async_desc != NULL) {
 		/*
 		 * Lock interrupts and unlock the scheduler before
-		 * manipulating the writers wait_q.
+		 * manipulating the writers wait_q. The dummy thread's
+		 * swap_data already points at @a src.
 		 */
 		k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 		z_sched_unlock_no_reschedule();
 
-		async_desc->desc.buffer = data + num_bytes_written;
-		async_desc->desc.bytes_to_xfer =
-			bytes_to_write - num_bytes_written;
-
 		z_pend_thread((struct k_thread *) &async_desc->thread,
 			     &pipe->wait_q.writers, K_FOREVER);
 		z_reschedule(&pipe->lock, key);
@@ -541,13 +590,8 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	}
 #endif
 
-	struct k_pipe_desc  pipe_desc;
-
-	pipe_desc.buffer         = data + num_bytes_written;
-	pipe_desc.bytes_to_xfer  = bytes_to_write - num_bytes_written;
-
 	if (timeout != K_NO_WAIT) {
-		_current->base.swap_data = &pipe_desc;
+		_current->base.swap_data = src;
 		/*
 		 * Lock interrupts and unlock the scheduler before
 		 * manipulating the writers wait_q.
@@ -560,23 +604,26 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 		k_sched_unlock();
 	}
 
-	*bytes_written = bytes_to_write - pipe_desc.bytes_to_xfer;
+	*bytes_written = bytes_to_write - src->bytes_to_xfer;
 
-	return pipe_return_code(min_xfer, pipe_desc.bytes_to_xfer,
+	return pipe_return_code(min_xfer, src->bytes_to_xfer,
 				 bytes_to_write);
 }
 
-int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
-		     size_t *bytes_read, size_t min_xfer, s32_t timeout)
+/*
+ * With @a partial set the read completes as soon as it has @a min_xfer
+ * bytes (and at least one); otherwise it waits for all of them, as
+ * k_pipe_get() always has.
+ */
+static int pipe_get_internal(struct k_pipe *pipe, struct k_pipe_desc *dest,
+			     size_t *bytes_read, size_t min_xfer,
+			     bool partial, s32_t timeout)
 {
 	struct k_thread    *writer;
 	struct k_pipe_desc *desc;
 	sys_dlist_t    xfer_list;
-	size_t         num_bytes_read = 0;
-	size_t         bytes_copied;
-
-	__ASSERT(min_xfer <= bytes_to_read, "");
-	__ASSERT(bytes_read != NULL, "");
+	size_t         bytes_to_read = dest->bytes_to_xfer;
+	size_t         num_bytes_read;
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
@@ -596,7 +643,7 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 	z_sched_lock();
 	k_spin_unlock(&pipe->lock, key);
 
-	num_bytes_read = pipe_buffer_get(pipe, data, bytes_to_read);
+	(void)pipe_buffer_get(pipe, dest);
 
 	/*
 	 * 1. 'xfer_list' currently contains a list of writer threads that can
@@ -614,15 +661,9 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	struct k_thread *thread = (struct k_thread *)
 				  sys_dlist_get(&xfer_list);
-	while ((thread != NULL) && (num_bytes_read < bytes_to_read)) {
+	while ((thread != NULL) && (dest->bytes_to_xfer > 0)) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = pipe_xfer((u8_t *)data + num_bytes_read,
-					  bytes_to_read - num_bytes_read,
-					  desc->buffer, desc->bytes_to_xfer);
-
-		num_bytes_read       += bytes_copied;
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_xfer(dest, desc);
 
 		/*
 		 * It is expected that the write request will be satisfied.
@@ -630,7 +671,7 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		 * write request was satisfied, then the write request must
 		 * finish later when writing to the pipe's circular buffer.
 		 */
-		if (num_bytes_read == bytes_to_read) {
+		if (dest->bytes_to_xfer == 0) {
 			break;
 		}
 		pipe_thread_ready(thread);
@@ -638,15 +679,9 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
 	}
 
-	if ((writer != NULL) && (num_bytes_read < bytes_to_read)) {
+	if ((writer != NULL) && (dest->bytes_to_xfer > 0)) {
 		desc = (struct k_pipe_desc *)writer->base.swap_data;
-		bytes_copied = pipe_xfer((u8_t *)data + num_bytes_read,
-					  bytes_to_read - num_bytes_read,
-					  desc->buffer, desc->bytes_to_xfer);
-
-		num_bytes_read       += bytes_copied;
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_xfer(dest, desc);
 	}
 
 	/*
@@ -656,11 +691,7 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	while (thread != NULL) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
-						desc->bytes_to_xfer);
-
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_buffer_put(pipe, desc);
 
 		/* Write request has been satisfied */
 		pipe_thread_ready(thread);
@@ -670,14 +701,13 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	if (writer != NULL) {
 		desc = (struct k_pipe_desc *)writer->base.swap_data;
-		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
-						desc->bytes_to_xfer);
-
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_buffer_put(pipe, desc);
 	}
 
-	if (num_bytes_read == bytes_to_read) {
+	num_bytes_read = bytes_to_read - dest->bytes_to_xfer;
+	if ((dest->bytes_to_xfer == 0) ||
+	    (partial && (num_bytes_read > 0) &&
+	     (num_bytes_read >= min_xfer))) {
 		k_sched_unlock();
 
 		*bytes_read = num_bytes_read;
@@ -687,13 +717,12 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	/* Not all data was read. */
 
-	struct k_pipe_desc  pipe_desc;
-
-	pipe_desc.buffer        = (u8_t *)data + num_bytes_read;
-	pipe_desc.bytes_to_xfer = bytes_to_read - num_bytes_read;
-
 	if (timeout != K_NO_WAIT) {
-		_current->base.swap_data = &pipe_desc;
+		if (partial) {
+			/* writers may wake us once the minimum is there */
+			dest->bytes_optional = bytes_to_read - min_xfer;
+		}
+		_current->base.swap_data = dest;
 		k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
 		z_sched_unlock_no_reschedule();
@@ -703,12 +732,26 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		k_sched_unlock();
 	}
 
-	*bytes_read = bytes_to_read - pipe_desc.bytes_to_xfer;
+	*bytes_read = bytes_to_read - dest->bytes_to_xfer;
 
-	return pipe_return_code(min_xfer, pipe_desc.bytes_to_xfer,
+	return pipe_return_code(min_xfer, dest->bytes_to_xfer,
 				 bytes_to_read);
 }
 
+int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
+		     size_t *bytes_read, size_t min_xfer, s32_t timeout)
+{
+	struct k_pipe_desc dest;
+
+	__ASSERT(min_xfer <= bytes_to_read, "");
+	__ASSERT(bytes_read != NULL, "");
+
+	pipe_desc_init(&dest, data, bytes_to_read);
+
+	return pipe_get_internal(pipe, &dest, bytes_read, min_xfer, false,
+				 timeout);
+}
+
 #ifdef CONFIG_USERSPACE
 Z_SYSCALL_HANDLER(k_pipe_get,
 		  pipe, data, bytes_to_read, bytes_read_p, min_xfer_p, timeout)
@@ -730,11 +773,14 @@ Z_SYSCALL_HANDLER(k_pipe_get,
 int z_impl_k_pipe_put(struct k_pipe *pipe, void *data, size_t bytes_to_write,
 		     size_t *bytes_written, size_t min_xfer, s32_t timeout)
 {
+	struct k_pipe_desc src;
+
 	__ASSERT(min_xfer <= bytes_to_write, "");
 	__ASSERT(bytes_written != NULL, "");
 
-	return z_pipe_put_internal(pipe, NULL, data,
-				    bytes_to_write, bytes_written,
+	pipe_desc_init(&src, data, bytes_to_write);
+
+	return z_pipe_put_internal(pipe, NULL, &src, bytes_written,
 				    min_xfer, timeout);
 }
 
@@ -756,6 +802,99 @@ Z_SYSCALL_HANDLER(k_pipe_put, pipe, data, bytes_to_write, bytes_written_p,
 }
 #endif
 
+int z_impl_k_pipe_writev(struct k_pipe *pipe, const struct k_pipe_iovec *iov,
+			 size_t iovcnt, size_t *bytes_written,
+			 size_t min_xfer, s32_t timeout)
+{
+	struct k_pipe_desc src;
+
+	__ASSERT(bytes_written != NULL, "");
+
+	pipe_desc_init_iov(&src, iov, iovcnt);
+	__ASSERT(min_xfer <= src.bytes_to_xfer, "");
+
+	return z_pipe_put_internal(pipe, NULL, &src, bytes_written,
+				    min_xfer, timeout);
+}
+
+int z_impl_k_pipe_readv(struct k_pipe *pipe, const struct k_pipe_iovec *iov,
+			size_t iovcnt, size_t *bytes_read,
+			size_t min_xfer, s32_t timeout)
+{
+	struct k_pipe_desc dest;
+
+	__ASSERT(bytes_read != NULL, "");
+
+	pipe_desc_init_iov(&dest, iov, iovcnt);
+	__ASSERT(min_xfer <= dest.bytes_to_xfer, "");
+
+	return pipe_get_internal(pipe, &dest, bytes_read, min_xfer, true,
+				 timeout);
+}
+
+#ifdef CONFIG_USERSPACE
+/*
+ * Copy a user segment list into @a iov and check that the caller may
+ * access every segment. The copy is what the transfer works from, so
+ * the list can not change under our feet.
+ */
+static int pipe_iov_from_user(struct k_pipe_iovec *iov, const void *user_iov,
+			      size_t iovcnt, bool write, size_t *total)
+{
+	*total = 0;
+
+	if (iovcnt > K_PIPE_IOV_MAX ||
+	    z_user_from_copy(iov, user_iov, iovcnt * sizeof(*iov)) != 0) {
+		return -EFAULT;
+	}
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		if (Z_SYSCALL_MEMORY(iov[i].base, iov[i].len, write) != 0 ||
+		    size_add_overflow(*total, iov[i].len, total)) {
+			return -EFAULT;
+		}
+	}
+
+	return 0;
+}
+
+Z_SYSCALL_HANDLER(k_pipe_writev, pipe, iov_p, iovcnt, bytes_written_p,
+		  min_xfer_p, timeout)
+{
+	struct k_pipe_iovec iov[K_PIPE_IOV_MAX];
+	size_t *bytes_written = (size_t *)bytes_written_p;
+	size_t min_xfer = (size_t)min_xfer_p;
+	size_t total;
+
+	Z_OOPS(Z_SYSCALL_OBJ(pipe, K_OBJ_PIPE));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(bytes_written, sizeof(*bytes_written)));
+	Z_OOPS(pipe_iov_from_user(iov, (const void *)iov_p, iovcnt, false,
+				  &total));
+	Z_OOPS(Z_SYSCALL_VERIFY(min_xfer <= total));
+
+	return z_impl_k_pipe_writev((struct k_pipe *)pipe, iov, iovcnt,
+				    bytes_written, min_xfer, timeout);
+}
+
+Z_SYSCALL_HANDLER(k_pipe_readv, pipe, iov_p, iovcnt, bytes_read_p,
+		  min_xfer_p, timeout)
+{
+	struct k_pipe_iovec iov[K_PIPE_IOV_MAX];
+	size_t *bytes_read = (size_t *)bytes_read_p;
+	size_t min_xfer = (size_t)min_xfer_p;
+	size_t total;
+
+	Z_OOPS(Z_SYSCALL_OBJ(pipe, K_OBJ_PIPE));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(bytes_read, sizeof(*bytes_read)));
+	Z_OOPS(pipe_iov_from_user(iov, (const void *)iov_p, iovcnt, true,
+				  &total));
+	Z_OOPS(Z_SYSCALL_VERIFY(min_xfer <= total));
+
+	return z_impl_k_pipe_readv((struct k_pipe *)pipe, iov, iovcnt,
+				   bytes_read, min_xfer, timeout);
+}
+#endif
+
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 		      size_t bytes_to_write, struct k_sem *sem)
@@ -766,13 +905,14 @@ void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 	/* For simplicity, always allocate an asynchronous descriptor */
 	pipe_async_alloc(&async_desc);
 
+	pipe_desc_init(&async_desc->desc, block->data, bytes_to_write);
 	async_desc->desc.block = &async_desc->desc.copy_block;
 	async_desc->desc.copy_block = *block;
 	async_desc->desc.sem = sem;
 	async_desc->thread.prio = k_thread_priority_get(_current);
 
-	(void) z_pipe_put_internal(pipe, async_desc, block->data,
-				    bytes_to_write, &dummy_bytes_written,
-				    bytes_to_write, K_FOREVER);
+	(void) z_pipe_put_internal(pipe, async_desc, &async_desc->desc,
+				    &dummy_bytes_written, bytes_to_write,
+				    K_FOREVER);
 }
 #endif
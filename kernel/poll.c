@@ -84,6 +84,20 @@ static inline bool is_condition_met(struct k_poll_event *event, u32_t *state)
 	return false;
 }
 
+/* Poll sets have no thread of their own: their events queue up behind
+ * those of every thread blocked in k_poll().
+ */
+static inline bool poller_higher_prio(struct _poller *p1, struct _poller *p2)
+{
+	if (p1->is_set) {
+		return false;
+	}
+	if (p2->is_set) {
+		return true;
+	}
+	return z_is_t1_higher_prio_than_t2(p1->thread, p2->thread);
+}
+
 static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 			     struct _poller *poller)
 {
@@ -91,15 +105,13 @@ static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 
 	pending = (struct k_poll_event *)sys_dlist_peek_tail(events);
 	if ((pending == NULL) ||
-		z_is_t1_higher_prio_than_t2(pending->poller->thread,
-					    poller->thread)) {
+		!poller_higher_prio(poller, pending->poller)) {
 		sys_dlist_append(events, &event->_node);
 		return;
 	}
 
 	SYS_DLIST_FOR_EACH_CONTAINER(events, pending, _node) {
-		if (z_is_t1_higher_prio_than_t2(poller->thread,
-						pending->poller->thread)) {
+		if (poller_higher_prio(poller, pending->poller)) {
 			sys_dlist_insert(&pending->_node, &event->_node);
 			return;
 		}
@@ -333,6 +345,29 @@ oops_free:
 }
 #endif
 
+/* must be called with interrupts locked */
+static void signal_set_event(struct k_poll_event *event, u32_t state)
+{
+	struct k_poll_set *set = CONTAINER_OF(event->poller,
+					      struct k_poll_set, poller);
+	struct k_thread *thread;
+
+	event->state |= state;
+
+	/* The object just unlinked the event, it is free to go on the
+	 * ready list; if it is there already, only the state changes.
+	 */
+	if (!sys_dnode_is_linked(&event->_node)) {
+		sys_dlist_append(&set->ready, &event->_node);
+	}
+
+	thread = z_unpend_first_thread(&set->wait_q);
+	if (thread != NULL) {
+		z_set_thread_return_value(thread, 0);
+		z_ready_thread(thread);
+	}
+}
+
 /* must be called with interrupts locked */
 static int signal_poll_event(struct k_poll_event *event, u32_t state)
 {
@@ -340,6 +375,11 @@ static int signal_poll_event(struct k_poll_event *event, u32_t state)
 		goto ready_event;
 	}
 
+	if (event->poller->is_set) {
+		signal_set_event(event, state);
+		return 0;
+	}
+
 	struct k_thread *thread = event->poller->thread;
 
 	__ASSERT(event->poller->thread != NULL,
@@ -447,3 +487,251 @@ Z_SYSCALL_HANDLER1_SIMPLE_VOID(k_poll_signal_reset, K_OBJ_POLL_SIGNAL,
 			       struct k_poll_signal *);
 #endif
 
+
+/* must be called with interrupts locked */
+static void poll_set_arm(struct k_poll_set *set, struct k_poll_event *event)
+{
+	u32_t state;
+
+	if (is_condition_met(event, &state)) {
+		event->poller = &set->poller;
+		signal_set_event(event, state);
+	} else {
+		(void)register_event(event, &set->poller);
+	}
+}
+
+void k_poll_set_init(struct k_poll_set *set, struct k_poll_set_entry *entries,
+		     int max_events)
+{
+	z_waitq_init(&set->wait_q);
+	sys_dlist_init(&set->ready);
+	set->poller.thread = NULL;
+	set->poller.is_polling = false;
+	set->poller.is_set = true;
+	set->entries = entries;
+	set->num_entries = max_events;
+
+	for (int i = 0; i < max_events; i++) {
+		entries[i].event.type = K_POLL_TYPE_IGNORE;
+		entries[i].event.obj = NULL;
+	}
+
+	z_object_init(set);
+}
+
+int z_impl_k_poll_set_add(struct k_poll_set *set, u32_t type, void *obj,
+			  u32_t tag)
+{
+	struct k_poll_set_entry *entry = NULL;
+	struct k_poll_event *event;
+	k_spinlock_key_t key;
+
+	if (obj == NULL || (type != K_POLL_TYPE_SIGNAL &&
+			    type != K_POLL_TYPE_SEM_AVAILABLE &&
+			    type != K_POLL_TYPE_DATA_AVAILABLE)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+
+	for (int i = 0; i < set->num_entries; i++) {
+		struct k_poll_set_entry *e = &set->entries[i];
+
+		if (e->event.obj == obj) {
+			k_spin_unlock(&lock, key);
+			return -EEXIST;
+		}
+		if (e->event.obj == NULL && entry == NULL) {
+			entry = e;
+		}
+	}
+
+	if (entry == NULL) {
+		k_spin_unlock(&lock, key);
+		return -ENOSPC;
+	}
+
+	event = &entry->event;
+	k_poll_event_init(event, type, K_POLL_MODE_NOTIFY_ONLY, obj);
+	entry->tag = tag;
+	sys_dnode_init(&event->_node);
+	poll_set_arm(set, event);
+
+	z_reschedule(&lock, key);
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_poll_set_add, set, type, obj, tag)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(set, K_OBJ_POLL_SET));
+
+	switch (type) {
+	case K_POLL_TYPE_SIGNAL:
+		Z_OOPS(Z_SYSCALL_OBJ(obj, K_OBJ_POLL_SIGNAL));
+		break;
+	case K_POLL_TYPE_SEM_AVAILABLE:
+		Z_OOPS(Z_SYSCALL_OBJ(obj, K_OBJ_SEM));
+		break;
+	case K_POLL_TYPE_DATA_AVAILABLE:
+		Z_OOPS(Z_SYSCALL_OBJ(obj, K_OBJ_QUEUE));
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return z_impl_k_poll_set_add((struct k_poll_set *)set, type,
+				     (void *)obj, tag);
+}
+#endif
+
+int z_impl_k_poll_set_remove(struct k_poll_set *set, void *obj)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (int i = 0; i < set->num_entries; i++) {
+		struct k_poll_event *e = &set->entries[i].event;
+
+		if (e->obj != obj) {
+			continue;
+		}
+
+		/* Linked either on the object or on the ready list */
+		if (sys_dnode_is_linked(&e->_node)) {
+			sys_dlist_remove(&e->_node);
+		}
+		e->poller = NULL;
+		e->type = K_POLL_TYPE_IGNORE;
+		e->obj = NULL;
+
+		k_spin_unlock(&lock, key);
+		return 0;
+	}
+
+	k_spin_unlock(&lock, key);
+	return -ENOENT;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_poll_set_remove, set, obj)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(set, K_OBJ_POLL_SET));
+
+	return z_impl_k_poll_set_remove((struct k_poll_set *)set, (void *)obj);
+}
+#endif
+
+/* Move up to @a max_ready events off the ready list, re-arming each
+ * one.  Conditions are checked again here: an object consumed since it
+ * was signaled is not reported, one that is still ready goes straight
+ * back on the ready list, behind those not yet reported.
+ *
+ * must be called with interrupts locked
+ */
+static int poll_set_collect(struct k_poll_set *set,
+			    struct k_poll_set_event *ready, int max_ready)
+{
+	sys_dlist_t still_ready;
+	sys_dnode_t *node;
+	int n = 0;
+
+	sys_dlist_init(&still_ready);
+
+	while (n < max_ready &&
+	       (node = sys_dlist_get(&set->ready)) != NULL) {
+		struct k_poll_event *e = CONTAINER_OF(node, struct k_poll_event,
+						      _node);
+		u32_t state = e->state & K_POLL_STATE_CANCELLED;
+		u32_t met = K_POLL_STATE_NOT_READY;
+
+		(void)is_condition_met(e, &met);
+		state |= met;
+		e->state = K_POLL_STATE_NOT_READY;
+
+		if (state != K_POLL_STATE_NOT_READY) {
+			ready[n].obj = e->obj;
+			ready[n].tag = CONTAINER_OF(e, struct k_poll_set_entry,
+						    event)->tag;
+			ready[n].state = state;
+			n++;
+		}
+
+		if (met != K_POLL_STATE_NOT_READY) {
+			e->state = met;
+			sys_dlist_append(&still_ready, &e->_node);
+		} else {
+			(void)register_event(e, &set->poller);
+		}
+	}
+
+	while ((node = sys_dlist_get(&still_ready)) != NULL) {
+		sys_dlist_append(&set->ready, node);
+	}
+
+	return n;
+}
+
+int z_impl_k_poll_set_wait(struct k_poll_set *set,
+			   struct k_poll_set_event *ready, int max_ready,
+			   s32_t timeout)
+{
+	__ASSERT(!(z_is_in_isr() && timeout != K_NO_WAIT), "");
+	__ASSERT(max_ready > 0, "zero events\n");
+
+	s64_t end = 0;
+	k_spinlock_key_t key;
+	int ret;
+
+	if (timeout != K_FOREVER && timeout != K_NO_WAIT) {
+		end = z_tick_get() + z_ms_to_ticks(timeout);
+	}
+
+	key = k_spin_lock(&lock);
+
+	while (true) {
+		ret = poll_set_collect(set, ready, max_ready);
+		if (ret > 0 || timeout == K_NO_WAIT) {
+			break;
+		}
+
+		ret = z_pend_curr(&lock, key, &set->wait_q, timeout);
+		key = k_spin_lock(&lock);
+		if (ret != 0) {
+			/* Something may have become ready as we timed out */
+			ret = poll_set_collect(set, ready, max_ready);
+			break;
+		}
+
+		/* Another thread waiting on the set may have collected
+		 * the events we were woken up for; wait out the rest of
+		 * the timeout.
+		 */
+		if (timeout != K_FOREVER) {
+			s64_t left = end - z_tick_get();
+
+			timeout = left > 0 ? (s32_t)__ticks_to_ms(left) :
+					     K_NO_WAIT;
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return ret > 0 ? ret : -EAGAIN;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_poll_set_wait, set, ready, max_ready, timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(set, K_OBJ_POLL_SET));
+	if (Z_SYSCALL_VERIFY(max_ready > 0)) {
+		return -EINVAL;
+	}
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(ready, max_ready,
+					    sizeof(struct k_poll_set_event)));
+
+	return z_impl_k_poll_set_wait((struct k_poll_set *)set,
+				      (struct k_poll_set_event *)ready,
+				      max_ready, timeout);
+}
+#endif
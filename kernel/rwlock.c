@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file @brief reader-writer lock kernel services
+ *
+ * The reader count lives in an atomic word together with two flags, one
+ * set while a writer holds the lock and one set while writers wait for
+ * it.  As long as neither flag is set, readers come and go with a single
+ * compare-and-swap and never touch the spinlock or the scheduler.
+ *
+ * The flags themselves only change with the spinlock held, so a thread
+ * that sees one of them set under the lock can safely go to sleep: the
+ * thread that clears it is guaranteed to find it on a wait queue.
+ *
+ * Writers are preferred: once one is waiting new readers queue up behind
+ * it, and a releasing writer hands the lock to the next writer before
+ * letting readers in.  Threads waiting for a lock held by a writer lend
+ * it their priority following the same nesting rules as k_mutex.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <debug/object_tracing_common.h>
+#include <errno.h>
+#include <init.h>
+#include <syscall_handler.h>
+
+#define WRITER Z_RWLOCK_WRITER
+#define WAITING Z_RWLOCK_WRITERS_WAITING
+#define READERS(state) ((state) & Z_RWLOCK_READERS_MASK)
+
+/* Global for the same reason as the k_mutex one: it also protects the
+ * priority of the writer, which isn't part of the lock.
+ */
+static struct k_spinlock lock;
+
+#ifdef CONFIG_OBJECT_TRACING
+
+struct k_rwlock *_trace_list_k_rwlock;
+
+/*
+ * Complete initialization of statically defined reader-writer locks.
+ */
+static int init_rwlock_module(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	Z_STRUCT_SECTION_FOREACH(k_rwlock, rwlock) {
+		SYS_TRACING_OBJ_INIT(k_rwlock, rwlock);
+	}
+	return 0;
+}
+
+SYS_INIT(init_rwlock_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+#endif /* CONFIG_OBJECT_TRACING */
+
+void z_impl_k_rwlock_init(struct k_rwlock *rwlock)
+{
+	atomic_set(&rwlock->state, 0);
+	rwlock->writer = NULL;
+	rwlock->writer_orig_prio = K_LOWEST_THREAD_PRIO;
+
+	z_waitq_init(&rwlock->rd_wait_q);
+	z_waitq_init(&rwlock->wr_wait_q);
+
+	SYS_TRACING_OBJ_INIT(k_rwlock, rwlock);
+	z_object_init(rwlock);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_init, rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ_INIT(rwlock, K_OBJ_RWLOCK));
+	z_impl_k_rwlock_init((struct k_rwlock *)rwlock);
+
+	return 0;
+}
+#endif
+
+static s32_t new_prio_for_inheritance(s32_t target, s32_t limit)
+{
+	int new_prio = z_is_prio_higher(target, limit) ? target : limit;
+
+	new_prio = z_get_new_prio_with_ceiling(new_prio);
+
+	return new_prio;
+}
+
+static void set_writer_prio(struct k_rwlock *rwlock, s32_t new_prio)
+{
+	if (rwlock->writer->base.prio != new_prio) {
+		z_thread_priority_set(rwlock->writer, new_prio);
+	}
+}
+
+/* Priority the writer deserves given the threads still waiting */
+static s32_t writer_prio(struct k_rwlock *rwlock)
+{
+	s32_t prio = rwlock->writer_orig_prio;
+	struct k_thread *waiter;
+
+	waiter = z_waitq_head(&rwlock->wr_wait_q);
+	if (waiter != NULL) {
+		prio = new_prio_for_inheritance(waiter->base.prio, prio);
+	}
+
+	waiter = z_waitq_head(&rwlock->rd_wait_q);
+	if (waiter != NULL) {
+		prio = new_prio_for_inheritance(waiter->base.prio, prio);
+	}
+
+	return prio;
+}
+
+/* Lend the current thread's priority to the writer before waiting */
+static void boost_writer(struct k_rwlock *rwlock)
+{
+	s32_t new_prio = new_prio_for_inheritance(_current->base.prio,
+						  rwlock->writer->base.prio);
+
+	if (z_is_prio_higher(new_prio, rwlock->writer->base.prio)) {
+		set_writer_prio(rwlock, new_prio);
+	}
+}
+
+/* Pass a lock no writer holds to the threads waiting for it: the first
+ * writer once the last reader has left, otherwise all the readers,
+ * unless some writer is still queued.  Called with the spinlock held.
+ */
+static void handoff(struct k_rwlock *rwlock)
+{
+	struct k_thread *thread;
+
+	if (READERS(atomic_get(&rwlock->state)) == 0) {
+		thread = z_unpend_first_thread(&rwlock->wr_wait_q);
+		if (thread != NULL) {
+			/* WAITING is set while a writer is queued, so
+			 * no reader can sneak in here
+			 */
+			atomic_set(&rwlock->state, WRITER |
+				   (z_waitq_head(&rwlock->wr_wait_q) != NULL ?
+				    WAITING : 0));
+			rwlock->writer = thread;
+			rwlock->writer_orig_prio = thread->base.prio;
+			set_writer_prio(rwlock, writer_prio(rwlock));
+
+			z_set_thread_return_value(thread, 0);
+			z_ready_thread(thread);
+			return;
+		}
+	} else if (z_waitq_head(&rwlock->wr_wait_q) != NULL) {
+		return;
+	}
+
+	while ((thread = z_unpend_first_thread(&rwlock->rd_wait_q)) != NULL) {
+		atomic_inc(&rwlock->state);
+		z_set_thread_return_value(thread, 0);
+		z_ready_thread(thread);
+	}
+
+	atomic_and(&rwlock->state, Z_RWLOCK_READERS_MASK);
+}
+
+static bool read_trylock(struct k_rwlock *rwlock)
+{
+	atomic_val_t old;
+
+	do {
+		old = atomic_get(&rwlock->state);
+		if ((old & (WRITER | WAITING)) != 0) {
+			return false;
+		}
+	} while (!atomic_cas(&rwlock->state, old, old + 1));
+
+	return true;
+}
+
+int z_impl_k_rwlock_read_lock(struct k_rwlock *rwlock, s32_t timeout)
+{
+	k_spinlock_key_t key;
+	int ret;
+
+	if (likely(read_trylock(rwlock))) {
+		return 0;
+	}
+
+	z_sched_lock();
+	key = k_spin_lock(&lock);
+
+	/* The flags may have been cleared since we looked */
+	if (read_trylock(rwlock)) {
+		ret = 0;
+		goto out;
+	}
+
+	if (rwlock->writer == _current) {
+		ret = -EDEADLK;
+		goto out;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	if (rwlock->writer != NULL) {
+		boost_writer(rwlock);
+	}
+
+	/* The thread releasing the lock counts us in as a reader */
+	ret = z_pend_curr(&lock, key, &rwlock->rd_wait_q, timeout);
+	if (ret == 0) {
+		k_sched_unlock();
+		return 0;
+	}
+
+	key = k_spin_lock(&lock);
+	if (rwlock->writer != NULL) {
+		set_writer_prio(rwlock, writer_prio(rwlock));
+	}
+
+out:
+	k_spin_unlock(&lock, key);
+	k_sched_unlock();
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_read_lock, rwlock, timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_read_lock((struct k_rwlock *)rwlock,
+					 (s32_t)timeout);
+}
+#endif
+
+int z_impl_k_rwlock_read_unlock(struct k_rwlock *rwlock)
+{
+	atomic_val_t old;
+	k_spinlock_key_t key;
+
+	do {
+		old = atomic_get(&rwlock->state);
+		if (READERS(old) == 0) {
+			return -EINVAL;
+		}
+		if (READERS(old) == 1 && (old & WAITING) != 0) {
+			goto handoff;
+		}
+	} while (!atomic_cas(&rwlock->state, old, old - 1));
+
+	return 0;
+
+handoff:
+	/* Last reader out with writers waiting */
+	z_sched_lock();
+	key = k_spin_lock(&lock);
+
+	old = atomic_dec(&rwlock->state);
+	if (READERS(old) == 1 && (old & WAITING) != 0) {
+		handoff(rwlock);
+	}
+
+	k_spin_unlock(&lock, key);
+	k_sched_unlock();
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_read_unlock, rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_read_unlock((struct k_rwlock *)rwlock);
+}
+#endif
+
+static bool write_trylock(struct k_rwlock *rwlock)
+{
+	if (!atomic_cas(&rwlock->state, 0, WRITER)) {
+		return false;
+	}
+
+	rwlock->writer = _current;
+	rwlock->writer_orig_prio = _current->base.prio;
+	return true;
+}
+
+int z_impl_k_rwlock_write_lock(struct k_rwlock *rwlock, s32_t timeout)
+{
+	atomic_val_t old;
+	k_spinlock_key_t key;
+	int ret;
+
+	z_sched_lock();
+	key = k_spin_lock(&lock);
+
+	if (write_trylock(rwlock)) {
+		ret = 0;
+		goto out;
+	}
+
+	if (rwlock->writer == _current) {
+		ret = -EDEADLK;
+		goto out;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	/* Raise the flag with a CAS so that the last reader can't slip
+	 * out unnoticed in the meantime
+	 */
+	do {
+		if (write_trylock(rwlock)) {
+			ret = 0;
+			goto out;
+		}
+		old = atomic_get(&rwlock->state);
+	} while (old == 0 || !atomic_cas(&rwlock->state, old, old | WAITING));
+
+	if (rwlock->writer != NULL) {
+		boost_writer(rwlock);
+	}
+
+	ret = z_pend_curr(&lock, key, &rwlock->wr_wait_q, timeout);
+	if (ret == 0) {
+		k_sched_unlock();
+		return 0;
+	}
+
+	/* Timed out: drop the flag if we were the last writer waiting,
+	 * which may let the readers queued behind us in
+	 */
+	key = k_spin_lock(&lock);
+	if (rwlock->writer != NULL) {
+		if (z_waitq_head(&rwlock->wr_wait_q) == NULL) {
+			atomic_and(&rwlock->state, ~(atomic_val_t)WAITING);
+		}
+		set_writer_prio(rwlock, writer_prio(rwlock));
+	} else if ((atomic_get(&rwlock->state) & WAITING) != 0) {
+		handoff(rwlock);
+	}
+
+out:
+	k_spin_unlock(&lock, key);
+	k_sched_unlock();
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_write_lock, rwlock, timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_write_lock((struct k_rwlock *)rwlock,
+					  (s32_t)timeout);
+}
+#endif
+
+int z_impl_k_rwlock_write_unlock(struct k_rwlock *rwlock)
+{
+	k_spinlock_key_t key;
+
+	if (rwlock->writer != _current) {
+		return -EPERM;
+	}
+
+	z_sched_lock();
+	key = k_spin_lock(&lock);
+
+	set_writer_prio(rwlock, rwlock->writer_orig_prio);
+	rwlock->writer = NULL;
+	handoff(rwlock);
+
+	k_spin_unlock(&lock, key);
+	k_sched_unlock();
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_rwlock_write_unlock, rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_write_unlock((struct k_rwlock *)rwlock);
+}
+#endif
@@ -79,17 +79,6 @@ static inline bool is_thread_dummy(struct k_thread *thread)
 }
 #endif
 
-static inline bool is_idle(struct k_thread *thread)
-{
-#ifdef CONFIG_SMP
-	return thread->base.is_idle;
-#else
-	extern k_tid_t const _idle_thread;
-
-	return thread == _idle_thread;
-#endif
-}
-
 bool z_is_t1_higher_prio_than_t2(struct k_thread *t1, struct k_thread *t2)
 {
 	if (t1->base.prio < t2->base.prio) {
@@ -152,7 +141,8 @@ static ALWAYS_INLINE bool should_preempt(struct k_thread *th, int preempt_ok)
 	 * preemptible priorities (this is sort of an API glitch).
 	 * They must always be preemptible.
 	 */
-	if (!IS_ENABLED(CONFIG_PREEMPT_ENABLED) && is_idle(_current)) {
+	if (!IS_ENABLED(CONFIG_PREEMPT_ENABLED) &&
+	    z_is_idle_thread_object(_current)) {
 		return true;
 	}
 
@@ -176,6 +166,293 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+#ifdef CONFIG_SMP
+static inline bool cpu_allowed(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return (thread->base.cpu_mask & BIT(cpu)) != 0;
+#else
+	return true;
+#endif
+}
+
+static inline bool cpu_is_idle(int cpu)
+{
+	struct k_thread *cur = _kernel.cpus[cpu].current;
+
+	return cur != NULL && z_is_idle_thread_object(cur);
+}
+#endif
+
+#ifdef CONFIG_SCHED_READY_IPI
+/* Picks the other CPU that should switch to a newly ready thread: the
+ * preferred one (by default the one it last ran on) or else any CPU
+ * the thread may use if they are idle, otherwise the one running the
+ * lowest priority thread it preempts.  Returns -1 when the thread is
+ * for the current CPU or must wait.
+ * The other CPUs' current threads are only a hint here, they may be
+ * switching already.
+ */
+static int ipi_target_cpu(struct k_thread *thread, int prefer)
+{
+	struct k_thread *victim = NULL;
+	int target = -1;
+
+	if (prefer < 0) {
+		prefer = thread->base.cpu;
+	}
+
+	if (prefer != _current_cpu->id && cpu_allowed(thread, prefer) &&
+	    cpu_is_idle(prefer)) {
+		return prefer;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct k_thread *cur = _kernel.cpus[i].current;
+
+		if (i == _current_cpu->id || cur == NULL ||
+		    !cpu_allowed(thread, i)) {
+			continue;
+		}
+
+		if (z_is_idle_thread_object(cur)) {
+			return i;
+		}
+
+		if ((is_preempt(cur) || is_metairq(thread)) &&
+		    z_is_t1_higher_prio_than_t2(thread, cur) &&
+		    (victim == NULL ||
+		     z_is_t1_higher_prio_than_t2(victim, cur))) {
+			victim = cur;
+			target = i;
+		}
+	}
+
+	return target;
+}
+
+/* Interrupts the CPU picked for a newly ready thread, if any, so it
+ * reschedules now instead of at its next interrupt.
+ */
+static void signal_ready_cpu(struct k_thread *thread, int prefer)
+{
+	int cpu = ipi_target_cpu(thread, prefer);
+
+	if (cpu < 0) {
+		return;
+	}
+
+#ifdef CONFIG_SCHED_IPI_TARGETED
+	z_arch_sched_ipi_cpu(cpu);
+#else
+	z_arch_sched_ipi();
+#endif
+}
+#else
+static inline void signal_ready_cpu(struct k_thread *thread, int prefer)
+{
+	ARG_UNUSED(thread);
+	ARG_UNUSED(prefer);
+}
+#endif /* CONFIG_SCHED_READY_IPI */
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* Per-CPU ready queues.  Each CPU schedules out of its own queue
+ * under its own lock, so readying, blocking and picking the next
+ * thread don't serialize all CPUs on sched_spinlock.  A thread's
+ * base.runq_cpu names the queue which owns it: the one it is queued
+ * in, or the last one it was taken from.  It only changes with the
+ * lock of that queue held, so holding the lock of the queue it names
+ * makes its queued state stable.
+ *
+ * Each queue publishes the priority of its best thread in best_prio.
+ * This is only a hint, read without locks, which a rescheduling CPU
+ * uses to decide whether to pull a thread from another CPU's queue.
+ */
+struct cpu_runq {
+	struct k_spinlock lock;
+	struct _ready_q q;
+	atomic_t best_prio;
+};
+
+static struct cpu_runq cpu_runqs[CONFIG_MP_NUM_CPUS];
+
+#define RUNQ_EMPTY_PRIO INT_MAX
+
+#if defined(CONFIG_SCHED_DUMB) && defined(CONFIG_SCHED_CPU_MASK)
+#define _priq_run_peek		z_priq_dumb_best
+#else
+#define _priq_run_peek		_priq_run_best
+#endif
+
+static inline bool thread_is_running(struct k_thread *thread)
+{
+	return _kernel.cpus[thread->base.cpu].current == thread;
+}
+
+/* Picks the queue for a newly ready thread: the CPU it is still
+ * running on if it was readied before it could switch out, else the
+ * CPU it last ran on unless another CPU it may use is idle.
+ */
+static int runq_target_cpu(struct k_thread *thread)
+{
+	int cpu = thread->base.cpu;
+
+	if (thread_is_running(thread)) {
+		return cpu;
+	}
+
+	if (cpu_allowed(thread, cpu) && cpu_is_idle(cpu)) {
+		return cpu;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (cpu_allowed(thread, i) && cpu_is_idle(i)) {
+			return i;
+		}
+	}
+
+	if (!cpu_allowed(thread, cpu)) {
+		for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+			if (cpu_allowed(thread, i)) {
+				return i;
+			}
+		}
+	}
+
+	return cpu;
+}
+
+/* Locks one or two queues in address order */
+static k_spinlock_key_t runq_lock_pair(struct cpu_runq *a,
+				       struct cpu_runq *b)
+{
+	k_spinlock_key_t key = k_spin_lock(a < b ? &a->lock : &b->lock);
+
+	if (a != b) {
+		(void)k_spin_lock(a < b ? &b->lock : &a->lock);
+	}
+	return key;
+}
+
+static void runq_unlock_pair(struct cpu_runq *a, struct cpu_runq *b,
+			     k_spinlock_key_t key)
+{
+	if (a != b) {
+		k_spin_release(a < b ? &b->lock : &a->lock);
+	}
+	k_spin_unlock(a < b ? &a->lock : &b->lock, key);
+}
+
+/* Locks the owner of thread together with queue rq (which may be the
+ * same), returning the owner.
+ */
+static struct cpu_runq *runq_lock_owner(struct k_thread *thread,
+					struct cpu_runq *rq,
+					k_spinlock_key_t *key)
+{
+	while (true) {
+		struct cpu_runq *owner = &cpu_runqs[thread->base.runq_cpu];
+
+		*key = runq_lock_pair(owner, rq != NULL ? rq : owner);
+		if (owner == &cpu_runqs[thread->base.runq_cpu]) {
+			return owner;
+		}
+		runq_unlock_pair(owner, rq != NULL ? rq : owner, *key);
+	}
+}
+
+static void runq_update_hint(struct cpu_runq *rq)
+{
+	struct k_thread *th = _priq_run_peek(&rq->q.runq);
+
+	(void)atomic_set(&rq->best_prio,
+			 th != NULL ? th->base.prio : RUNQ_EMPTY_PRIO);
+}
+
+/* Moves thread, queued in src, to the queue of dst.  Both locked */
+static void runq_migrate(struct cpu_runq *src, struct cpu_runq *dst,
+			 struct k_thread *thread)
+{
+	_priq_run_remove(&src->q.runq, thread);
+	_priq_run_add(&dst->q.runq, thread);
+	thread->base.runq_cpu = dst - cpu_runqs;
+	runq_update_hint(src);
+	runq_update_hint(dst);
+}
+
+/* Called on a rescheduling CPU: if another CPU's queue advertises a
+ * thread better than anything this CPU has, pull it over.
+ */
+static void runq_steal(struct cpu_runq *rq)
+{
+	struct cpu_runq *victim = NULL;
+	int best = atomic_get(&rq->best_prio);
+
+	if (!z_is_thread_prevented_from_running(_current) &&
+	    !z_is_idle_thread_object(_current)) {
+		best = MIN(best, _current->base.prio);
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		int prio = atomic_get(&cpu_runqs[i].best_prio);
+
+		if (&cpu_runqs[i] != rq && prio < best) {
+			victim = &cpu_runqs[i];
+			best = prio;
+		}
+	}
+
+	if (victim == NULL) {
+		return;
+	}
+
+	k_spinlock_key_t key = runq_lock_pair(rq, victim);
+	struct k_thread *th = _priq_run_best(&victim->q.runq);
+	struct k_thread *mine = _priq_run_peek(&rq->q.runq);
+
+	/* Recheck under the locks: the hints may be stale */
+	if (th != NULL && !thread_is_running(th) &&
+	    (mine == NULL || z_is_t1_higher_prio_than_t2(th, mine))) {
+		runq_migrate(victim, rq, th);
+	}
+
+	runq_unlock_pair(rq, victim, key);
+}
+
+static struct _ready_q *runq_lock(struct k_thread *thread,
+				  k_spinlock_key_t *key)
+{
+	return &runq_lock_owner(thread, NULL, key)->q;
+}
+
+static void runq_unlock(struct _ready_q *q, k_spinlock_key_t *key)
+{
+	struct cpu_runq *rq = CONTAINER_OF(q, struct cpu_runq, q);
+
+	runq_update_hint(rq);
+	k_spin_unlock(&rq->lock, *key);
+}
+#else
+/* There is one global ready queue, and callers of these hold
+ * sched_spinlock already.
+ */
+static inline struct _ready_q *runq_lock(struct k_thread *thread,
+					 k_spinlock_key_t *key)
+{
+	ARG_UNUSED(thread);
+	ARG_UNUSED(key);
+
+	return &_kernel.ready_q;
+}
+
+static inline void runq_unlock(struct _ready_q *q, k_spinlock_key_t *key)
+{
+	ARG_UNUSED(q);
+	ARG_UNUSED(key);
+}
+#endif /* CONFIG_SCHED_CPU_RUNQ */
+
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 #ifndef CONFIG_SMP
@@ -199,11 +476,22 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	 * "ready", it means "is _current already added back to the
 	 * queue such that we don't want to re-add it".
 	 */
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	struct cpu_runq *rq = &cpu_runqs[_current_cpu->id];
+
+	runq_steal(rq);
+
+	k_spinlock_key_t key = k_spin_lock(&rq->lock);
+	struct _ready_q *q = &rq->q;
+#else
+	struct _ready_q *q = &_kernel.ready_q;
+#endif
+
 	int queued = z_is_thread_queued(_current);
 	int active = !z_is_thread_prevented_from_running(_current);
 
 	/* Choose the best thread that is not current */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = _priq_run_best(&q->runq);
 	if (th == NULL) {
 		th = _current_cpu->idle_thread;
 	}
@@ -220,17 +508,24 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	}
 
 	/* Put _current back into the queue */
-	if (th != _current && active && !is_idle(_current) && !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+	if (th != _current && active && !z_is_idle_thread_object(_current) &&
+	    !queued) {
+		_priq_run_add(&q->runq, _current);
 		z_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(th)) {
-		_priq_run_remove(&_kernel.ready_q.runq, th);
+		_priq_run_remove(&q->runq, th);
 	}
 	z_mark_thread_as_not_queued(th);
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	th->base.cpu = _current_cpu->id;
+	runq_update_hint(rq);
+	k_spin_unlock(&rq->lock, key);
+#endif
+
 	return th;
 #endif
 }
@@ -275,7 +570,7 @@ static inline int sliceable(struct k_thread *t)
 {
 	return is_preempt(t)
 		&& !z_is_prio_higher(t->base.prio, slice_max_prio)
-		&& !is_idle(t)
+		&& !z_is_idle_thread_object(t)
 		&& !z_is_thread_timeout_active(t);
 }
 
@@ -330,11 +625,58 @@ static void update_cache(int preempt_ok)
 #endif
 }
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+void z_add_thread_to_ready_q(struct k_thread *thread)
+{
+	struct cpu_runq *rq = &cpu_runqs[runq_target_cpu(thread)];
+	k_spinlock_key_t key;
+	struct cpu_runq *owner = runq_lock_owner(thread, rq, &key);
+
+	_priq_run_add(&rq->q.runq, thread);
+	z_mark_thread_as_queued(thread);
+	thread->base.runq_cpu = rq - cpu_runqs;
+	runq_update_hint(rq);
+	runq_unlock_pair(owner, rq, key);
+
+	signal_ready_cpu(thread, rq - cpu_runqs);
+	update_cache(0);
+}
+
+void z_move_thread_to_end_of_prio_q(struct k_thread *thread)
+{
+	k_spinlock_key_t key;
+	struct _ready_q *q = runq_lock(thread, &key);
+
+	if (z_is_thread_queued(thread)) {
+		_priq_run_remove(&q->runq, thread);
+	}
+	_priq_run_add(&q->runq, thread);
+	z_mark_thread_as_queued(thread);
+	runq_unlock(q, &key);
+
+	update_cache(thread == _current);
+}
+
+void z_remove_thread_from_ready_q(struct k_thread *thread)
+{
+	k_spinlock_key_t key;
+	struct _ready_q *q = runq_lock(thread, &key);
+
+	if (z_is_thread_queued(thread)) {
+		_priq_run_remove(&q->runq, thread);
+		z_mark_thread_as_not_queued(thread);
+	}
+	runq_unlock(q, &key);
+
+	update_cache(thread == _current);
+}
+#else
 void z_add_thread_to_ready_q(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
 		_priq_run_add(&_kernel.ready_q.runq, thread);
 		z_mark_thread_as_queued(thread);
+		signal_ready_cpu(thread, -1);
 		update_cache(0);
 	}
 }
@@ -359,6 +701,7 @@ void z_remove_thread_from_ready_q(struct k_thread *thread)
 		update_cache(thread == _current);
 	}
 }
+#endif /* CONFIG_SCHED_CPU_RUNQ */
 
 static void pend(struct k_thread *thread, _wait_q_t *wait_q, s32_t timeout)
 {
@@ -482,21 +825,28 @@ void z_thread_priority_set(struct k_thread *thread, int prio)
 	bool need_sched = 0;
 
 	LOCKED(&sched_spinlock) {
+		k_spinlock_key_t key;
+		struct _ready_q *q = runq_lock(thread, &key);
+
 		need_sched = z_is_thread_ready(thread);
 
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				_priq_run_remove(&q->runq, thread);
 				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
+				_priq_run_add(&q->runq, thread);
 			} else {
 				thread->base.prio = prio;
 			}
-			update_cache(1);
 		} else {
 			thread->base.prio = prio;
 		}
+		runq_unlock(q, &key);
+
+		if (need_sched) {
+			update_cache(1);
+		}
 	}
 	sys_trace_thread_priority_set(thread);
 
@@ -570,9 +920,13 @@ struct k_thread *z_get_next_ready_thread(void)
 {
 	struct k_thread *ret = 0;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	ret = next_up();
+#else
 	LOCKED(&sched_spinlock) {
 		ret = next_up();
 	}
+#endif
 
 	return ret;
 }
@@ -597,7 +951,15 @@ void *z_get_next_switch_handle(void *interrupted)
 
 	z_check_stack_sentinel();
 
-#ifdef CONFIG_SMP
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	struct k_thread *th = next_up();
+
+	if (_current != th) {
+		reset_time_slice();
+		_current_cpu->swap_ok = 0;
+		set_current(th);
+	}
+#elif defined(CONFIG_SMP)
 	LOCKED(&sched_spinlock) {
 		struct k_thread *th = next_up();
 
@@ -635,7 +997,7 @@ ALWAYS_INLINE void z_priq_dumb_add(sys_dlist_t *pq, struct k_thread *thread)
 {
 	struct k_thread *t;
 
-	__ASSERT_NO_MSG(!is_idle(thread));
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
 
 	SYS_DLIST_FOR_EACH_CONTAINER(pq, t, base.qnode_dlist) {
 		if (z_is_t1_higher_prio_than_t2(thread, t)) {
@@ -657,7 +1019,7 @@ void z_priq_dumb_remove(sys_dlist_t *pq, struct k_thread *thread)
 	}
 #endif
 
-	__ASSERT_NO_MSG(!is_idle(thread));
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
 
 	sys_dlist_remove(&thread->base.qnode_dlist);
 }
@@ -693,7 +1055,7 @@ void z_priq_rb_add(struct _priq_rb *pq, struct k_thread *thread)
 {
 	struct k_thread *t;
 
-	__ASSERT_NO_MSG(!is_idle(thread));
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
 
 	thread->base.order_key = pq->next_order_key++;
 
@@ -720,7 +1082,7 @@ void z_priq_rb_remove(struct _priq_rb *pq, struct k_thread *thread)
 		return;
 	}
 #endif
-	__ASSERT_NO_MSG(!is_idle(thread));
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
 
 	rb_remove(&pq->tree, &thread->base.qnode_rb);
 
@@ -800,14 +1162,14 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -815,10 +1177,29 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
 	}
 #endif
+}
+
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&cpu_runqs[i].q);
+		(void)atomic_set(&cpu_runqs[i].best_prio, RUNQ_EMPTY_PRIO);
+#ifdef CONFIG_SPINLOCK_STATS
+		k_spin_stats_register(&cpu_runqs[i].lock, "runq");
+#endif
+	}
+#else
+	init_ready_q(&_kernel.ready_q);
+#endif
+
+#ifdef CONFIG_SPINLOCK_STATS
+	k_spin_stats_register(&sched_spinlock, "sched");
+#endif
 
 #ifdef CONFIG_TIMESLICING
 	k_sched_time_slice_set(CONFIG_TIMESLICE_SIZE,
@@ -873,11 +1254,15 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	struct k_thread *th = tid;
 
 	LOCKED(&sched_spinlock) {
+		k_spinlock_key_t key;
+		struct _ready_q *q = runq_lock(th, &key);
+
 		th->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(th)) {
-			_priq_run_remove(&_kernel.ready_q.runq, th);
-			_priq_run_add(&_kernel.ready_q.runq, th);
+			_priq_run_remove(&q->runq, th);
+			_priq_run_add(&q->runq, th);
 		}
+		runq_unlock(q, &key);
 	}
 }
 
@@ -901,7 +1286,10 @@ void z_impl_k_yield(void)
 {
 	__ASSERT(!z_is_in_isr(), "");
 
-	if (!is_idle(_current)) {
+	if (!z_is_idle_thread_object(_current)) {
+#ifdef CONFIG_SCHED_CPU_RUNQ
+		z_move_thread_to_end_of_prio_q(_current);
+#else
 		LOCKED(&sched_spinlock) {
 			if (!IS_ENABLED(CONFIG_SMP) ||
 			    z_is_thread_queued(_current)) {
@@ -912,6 +1300,7 @@ void z_impl_k_yield(void)
 			}
 			update_cache(1);
 		}
+#endif
 	}
 	z_swap_unlocked();
 }
@@ -920,6 +1309,37 @@ void z_impl_k_yield(void)
 Z_SYSCALL_HANDLER0_SIMPLE_VOID(k_yield);
 #endif
 
+#ifdef CONFIG_MULTITHREADING
+/* Suspends the current thread until it times out or is woken up.  The
+ * timeout is @a ticks from now, or at @a deadline in cycles when
+ * @a ticks is zero.
+ */
+static void sleep_current(s32_t ticks, u64_t deadline)
+{
+	/* Spinlock purely for local interrupt locking to prevent us
+	 * from being interrupted while _current is in an intermediate
+	 * state.  Should unify this implementation with pend().
+	 */
+	struct k_spinlock local_lock = {};
+	k_spinlock_key_t key = k_spin_lock(&local_lock);
+
+#if defined(CONFIG_TIMESLICING) && defined(CONFIG_SWAP_NONATOMIC)
+	pending_current = _current;
+#endif
+	z_remove_thread_from_ready_q(_current);
+	if (ticks != 0) {
+		z_add_thread_timeout(_current, ticks);
+	} else {
+		z_add_thread_timeout_abs(_current, deadline);
+	}
+	z_mark_thread_as_suspended(_current);
+
+	(void)z_swap(&local_lock, key);
+
+	__ASSERT(!z_is_thread_state_set(_current, _THREAD_SUSPENDED), "");
+}
+#endif
+
 static s32_t z_tick_sleep(s32_t ticks)
 {
 #ifdef CONFIG_MULTITHREADING
@@ -938,23 +1358,7 @@ static s32_t z_tick_sleep(s32_t ticks)
 	ticks += _TICK_ALIGN;
 	expected_wakeup_time = ticks + z_tick_get_32();
 
-	/* Spinlock purely for local interrupt locking to prevent us
-	 * from being interrupted while _current is in an intermediate
-	 * state.  Should unify this implementation with pend().
-	 */
-	struct k_spinlock local_lock = {};
-	k_spinlock_key_t key = k_spin_lock(&local_lock);
-
-#if defined(CONFIG_TIMESLICING) && defined(CONFIG_SWAP_NONATOMIC)
-	pending_current = _current;
-#endif
-	z_remove_thread_from_ready_q(_current);
-	z_add_thread_timeout(_current, ticks);
-	z_mark_thread_as_suspended(_current);
-
-	(void)z_swap(&local_lock, key);
-
-	__ASSERT(!z_is_thread_state_set(_current, _THREAD_SUSPENDED), "");
+	sleep_current(ticks, 0);
 
 	ticks = expected_wakeup_time - z_tick_get_32();
 	if (ticks > 0) {
@@ -997,6 +1401,35 @@ Z_SYSCALL_HANDLER(k_usleep, us)
 }
 #endif
 
+s32_t z_impl_z_sleep_until(u32_t deadline_lo, u32_t deadline_hi)
+{
+#ifdef CONFIG_MULTITHREADING
+	u64_t deadline = ((u64_t)deadline_hi << 32) | deadline_lo;
+
+	__ASSERT(!z_is_in_isr(), "");
+
+	/* a deadline already past is treated as a 'yield' */
+	if (deadline <= z_impl_k_uptime_cycles_get()) {
+		k_yield();
+		return 0;
+	}
+
+	sleep_current(0, deadline);
+
+	if (z_impl_k_uptime_cycles_get() < deadline) {
+		return -EAGAIN;
+	}
+#endif
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(z_sleep_until, deadline_lo, deadline_hi)
+{
+	return z_impl_z_sleep_until(deadline_lo, deadline_hi);
+}
+#endif
+
 void z_impl_k_wakeup(k_tid_t thread)
 {
 	if (z_is_thread_pending(thread)) {
@@ -1029,6 +1462,8 @@ void z_impl_k_wakeup(k_tid_t thread)
  */
 void z_sched_ipi(void)
 {
+	_current_cpu->ipi_count++;
+
 	LOCKED(&sched_spinlock) {
 		if (_current->base.thread_state & _THREAD_ABORTING) {
 			_current->base.thread_state |= _THREAD_DEAD;
@@ -1037,6 +1472,13 @@ void z_sched_ipi(void)
 	}
 }
 
+u32_t k_sched_ipi_count_get(int cpu)
+{
+	__ASSERT(cpu >= 0 && cpu < CONFIG_MP_NUM_CPUS, "invalid cpu %d", cpu);
+
+	return _kernel.cpus[cpu].ipi_count;
+}
+
 void z_sched_abort(struct k_thread *thread)
 {
 	if (thread == _current) {
@@ -1058,11 +1500,15 @@ void z_sched_abort(struct k_thread *thread)
 	 */
 	while ((thread->base.thread_state & _THREAD_DEAD) == 0U) {
 		LOCKED(&sched_spinlock) {
+			k_spinlock_key_t key;
+			struct _ready_q *q = runq_lock(thread, &key);
+
 			if (z_is_thread_queued(thread)) {
 				thread->base.thread_state |= _THREAD_DEAD;
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				_priq_run_remove(&q->runq, thread);
 				z_mark_thread_as_not_queued(thread);
 			}
+			runq_unlock(q, &key);
 		}
 	}
 }
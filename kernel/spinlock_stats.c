@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <spinlock.h>
+
+/* Locks are never taken off the list, so it can be walked without
+ * holding list_lock.
+ */
+static struct k_spinlock list_lock;
+static struct k_spinlock *stats_list;
+
+/* Reading the cycle counter may take a spinlock of its own, whose
+ * statistics calls must not read it again.  Interrupts are locked
+ * whenever these run, so a flag per CPU is enough.
+ */
+static bool in_stats[CONFIG_MP_NUM_CPUS];
+
+static inline u32_t stats_cycles(void)
+{
+	bool *busy = &in_stats[_current_cpu->id];
+	u32_t now;
+
+	*busy = true;
+	now = k_cycle_get_32();
+	*busy = false;
+
+	return now;
+}
+
+void z_spin_stats_acquired(struct k_spinlock *l, u32_t spins)
+{
+	struct k_spinlock_stats *stats = &l->stats;
+
+	stats->acquisitions++;
+	if (spins != 0U) {
+		stats->contended++;
+		stats->spins += spins;
+	}
+
+	if (!in_stats[_current_cpu->id]) {
+		stats->acquired_at = stats_cycles();
+	}
+}
+
+void z_spin_stats_released(struct k_spinlock *l)
+{
+	struct k_spinlock_stats *stats = &l->stats;
+	u32_t held;
+
+	if (in_stats[_current_cpu->id]) {
+		return;
+	}
+
+	held = stats_cycles() - stats->acquired_at;
+	if (held > stats->max_hold) {
+		stats->max_hold = held;
+	}
+}
+
+void k_spin_stats_register(struct k_spinlock *l, const char *name)
+{
+	__ASSERT(name != NULL, "");
+
+	k_spinlock_key_t key = k_spin_lock(&list_lock);
+
+	if (l->stats.name == NULL) {
+		l->stats.next = stats_list;
+		stats_list = l;
+	}
+	l->stats.name = name;
+
+	k_spin_unlock(&list_lock, key);
+}
+
+void k_spin_stats_foreach(k_spin_stats_cb_t user_cb, void *user_data)
+{
+	for (struct k_spinlock *l = stats_list; l != NULL;
+	     l = l->stats.next) {
+		user_cb(l, &l->stats, user_data);
+	}
+}
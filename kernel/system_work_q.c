@@ -14,7 +14,15 @@
 #include <kernel.h>
 #include <init.h>
 
+#if CONFIG_SYSTEM_WORKQUEUE_THREADS > 1
+static K_THREAD_STACK_ARRAY_DEFINE(sys_work_q_stacks,
+				   CONFIG_SYSTEM_WORKQUEUE_THREADS,
+				   CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE);
+static struct k_work_q_worker
+	sys_work_q_workers[CONFIG_SYSTEM_WORKQUEUE_THREADS];
+#else
 K_THREAD_STACK_DEFINE(sys_work_q_stack, CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE);
+#endif
 
 struct k_work_q k_sys_work_q;
 
@@ -22,11 +30,22 @@ static int k_sys_work_q_init(struct device *dev)
 {
 	ARG_UNUSED(dev);
 
+#if CONFIG_SYSTEM_WORKQUEUE_THREADS > 1
+	k_work_q_pool_start(&k_sys_work_q, sys_work_q_workers,
+			    CONFIG_SYSTEM_WORKQUEUE_THREADS,
+			    (k_thread_stack_t *)sys_work_q_stacks,
+			    CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE,
+			    CONFIG_SYSTEM_WORKQUEUE_PRIORITY);
+	for (int i = 0; i < CONFIG_SYSTEM_WORKQUEUE_THREADS; i++) {
+		k_thread_name_set(&sys_work_q_workers[i].thread, "sysworkq");
+	}
+#else
 	k_work_q_start(&k_sys_work_q,
 		       sys_work_q_stack,
 		       K_THREAD_STACK_SIZEOF(sys_work_q_stack),
 		       CONFIG_SYSTEM_WORKQUEUE_PRIORITY);
 	k_thread_name_set(&k_sys_work_q.thread, "sysworkq");
+#endif
 
 	return 0;
 }
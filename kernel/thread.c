@@ -31,9 +31,15 @@
 #include <init.h>
 #include <debug/tracing.h>
 #include <stdbool.h>
+#include <string.h>
+#include <app_memory/app_memdomain.h>
 
 static struct k_spinlock lock;
 
+#ifdef CONFIG_USER_CURRENT_THREAD
+K_APP_DMEM(z_user_ro_partition) struct k_thread *z_user_current;
+#endif
+
 #define _FOREACH_STATIC_THREAD(thread_data)              \
 	Z_STRUCT_SECTION_FOREACH(_static_thread_data, thread_data)
 
@@ -281,6 +287,22 @@ Z_SYSCALL_HANDLER(k_thread_name_copy, thread_id, buf, size)
 }
 #endif /* CONFIG_USERSPACE */
 
+#ifdef CONFIG_TIMEOUT_SLACK
+void z_impl_k_thread_timer_slack_set(k_tid_t thread, s32_t slack)
+{
+	thread->base.timer_slack = z_ms_to_ticks(MAX(slack, 0));
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_thread_timer_slack_set, thread, slack)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(thread, K_OBJ_THREAD));
+	z_impl_k_thread_timer_slack_set((k_tid_t)thread, (s32_t)slack);
+	return 0;
+}
+#endif
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 
 #ifdef CONFIG_STACK_SENTINEL
 /* Check that the stack sentinel is still present
@@ -336,7 +358,7 @@ Z_SYSCALL_HANDLER1_SIMPLE_VOID(k_thread_start, K_OBJ_THREAD, struct k_thread *);
 #endif
 
 #ifdef CONFIG_MULTITHREADING
-static void schedule_new_thread(struct k_thread *thread, s32_t delay)
+void z_schedule_new_thread(struct k_thread *thread, s32_t delay)
 {
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 	if (delay == 0) {
@@ -407,6 +429,10 @@ void z_setup_new_thread(struct k_thread *new_thread,
 	z_object_init(new_thread);
 	z_object_init(stack);
 	new_thread->stack_obj = stack;
+#if CONFIG_KOBJECT_CACHE_SIZE > 0
+	(void)memset(&new_thread->kobject_cache, 0,
+		     sizeof(new_thread->kobject_cache));
+#endif
 
 	/* Any given thread has access to itself */
 	k_object_access_grant(new_thread, new_thread);
@@ -458,6 +484,12 @@ void z_setup_new_thread(struct k_thread *new_thread,
 #ifdef CONFIG_SCHED_CPU_MASK
 	new_thread->base.cpu_mask = -1;
 #endif
+#ifdef CONFIG_THREAD_POOL
+	new_thread->pool = NULL;
+#endif
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	(void)memset(&new_thread->runtime, 0, sizeof(new_thread->runtime));
+#endif
 #ifdef CONFIG_ARCH_HAS_CUSTOM_SWAP_TO_MAIN
 	/* _current may be null if the dummy thread is not used */
 	if (!_current) {
@@ -475,6 +507,9 @@ void z_setup_new_thread(struct k_thread *new_thread,
 	if ((options & K_INHERIT_PERMS) != 0U) {
 		z_thread_perms_inherit(_current, new_thread);
 	}
+#ifdef CONFIG_USER_RO_PARTITION
+	z_mem_domain_default_add(new_thread);
+#endif
 #endif
 #ifdef CONFIG_SCHED_DEADLINE
 	new_thread->base.prio_deadline = 0;
@@ -503,7 +538,7 @@ k_tid_t z_impl_k_thread_create(struct k_thread *new_thread,
 			  prio, options, NULL);
 
 	if (delay != K_FOREVER) {
-		schedule_new_thread(new_thread, delay);
+		z_schedule_new_thread(new_thread, delay);
 	}
 
 	return new_thread;
@@ -577,7 +612,7 @@ Z_SYSCALL_HANDLER(k_thread_create,
 			  options, NULL);
 
 	if (delay != K_FOREVER) {
-		schedule_new_thread(new_thread, delay);
+		z_schedule_new_thread(new_thread, delay);
 	}
 
 	return new_thread_p;
@@ -635,6 +670,10 @@ Z_SYSCALL_HANDLER1_SIMPLE_VOID(k_thread_resume, K_OBJ_THREAD, k_tid_t);
 
 void z_thread_single_abort(struct k_thread *thread)
 {
+#ifdef CONFIG_THREAD_POOL
+	bool was_dead = (thread->base.thread_state & _THREAD_DEAD) != 0U;
+#endif
+
 	if (thread->fn_abort != NULL) {
 		thread->fn_abort();
 	}
@@ -667,6 +706,21 @@ void z_thread_single_abort(struct k_thread *thread)
 
 	/* Revoke permissions on thread's ID so that it may be recycled */
 	z_thread_perms_all_clear(thread);
+
+	/* Unlink it from its domain, which may outlive the thread object */
+	z_mem_domain_thread_exit(thread);
+#endif
+
+	z_thread_monitor_exit(thread);
+
+#ifdef CONFIG_THREAD_POOL
+	/* Drop the reference the thread holds on its pool slot, once, and
+	 * only when nothing above touches the thread any more: the slot
+	 * may be handed out again as soon as it is back in the pool
+	 */
+	if (thread->pool != NULL && !was_dead) {
+		k_thread_pool_put(thread);
+	}
 #endif
 }
 
@@ -719,7 +773,7 @@ void z_init_static_threads(void)
 	k_sched_lock();
 	_FOREACH_STATIC_THREAD(thread_data) {
 		if (thread_data->init_delay != K_FOREVER) {
-			schedule_new_thread(thread_data->init_thread,
+			z_schedule_new_thread(thread_data->init_thread,
 					    thread_data->init_delay);
 		}
 	}
@@ -742,6 +796,9 @@ void z_init_thread_base(struct _thread_base *thread_base, int priority,
 	/* swap_data does not need to be initialized */
 
 	z_init_thread_timeout(thread_base);
+#ifdef CONFIG_TIMEOUT_SLACK
+	thread_base->timer_slack = 0;
+#endif
 }
 
 FUNC_NORETURN void k_thread_user_mode_enter(k_thread_entry_t entry,
@@ -756,6 +813,10 @@ FUNC_NORETURN void k_thread_user_mode_enter(k_thread_entry_t entry,
 	_current->entry.parameter3 = p3;
 #endif
 #ifdef CONFIG_USERSPACE
+#ifdef CONFIG_USER_RO_PARTITION
+	z_mem_domain_default_add(_current);
+#endif
+	z_user_current_set(_current);
 	z_arch_user_mode_enter(entry, p1, p2, p3);
 #else
 	/* XXX In this case we do not reset the stack */
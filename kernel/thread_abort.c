@@ -41,7 +41,6 @@ void z_impl_k_thread_abort(k_tid_t thread)
 		 "essential thread aborted");
 
 	z_thread_single_abort(thread);
-	z_thread_monitor_exit(thread);
 
 	if (thread == _current && !z_is_in_isr()) {
 		z_swap(&lock, key);
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file @brief thread pool kernel services
+ *
+ * A pool is a set of slots, each owning a thread struct and usually a
+ * stack, all statically allocated.  Free slots sit on a list so that
+ * spawning pops one in constant time.  A slot is referenced by its
+ * thread until that thread exits, and by whoever called
+ * k_thread_pool_hold() on it; the last reference returns it to the list.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <kernel_internal.h>
+#include <init.h>
+
+static int statics_init(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	Z_STRUCT_SECTION_FOREACH(k_thread_pool, pool) {
+		sys_slist_init(&pool->free);
+		for (int i = pool->count - 1; i >= 0; i--) {
+			sys_slist_prepend(&pool->free, &pool->slots[i].node);
+		}
+	}
+
+	return 0;
+}
+
+SYS_INIT(statics_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+static inline struct k_thread *slot_thread(struct k_thread_pool *pool,
+					   struct z_thread_pool_slot *slot)
+{
+	return (struct k_thread *)(pool->threads +
+				   (slot - pool->slots) * pool->thread_size);
+}
+
+static struct z_thread_pool_slot *thread_slot(struct k_thread *thread)
+{
+	struct k_thread_pool *pool = thread->pool;
+
+	return &pool->slots[((u8_t *)thread - pool->threads) /
+			    pool->thread_size];
+}
+
+/* Called with the pool lock held */
+static void slot_put(struct k_thread_pool *pool,
+		     struct z_thread_pool_slot *slot)
+{
+	__ASSERT(slot->refs > 0U, "pool slot released too often");
+
+	if (--slot->refs == 0U) {
+		slot_thread(pool, slot)->pool = NULL;
+		sys_slist_prepend(&pool->free, &slot->node);
+	}
+}
+
+k_tid_t k_thread_pool_spawn(struct k_thread_pool *pool,
+			    k_thread_stack_t *stack, size_t stack_size,
+			    k_thread_entry_t entry,
+			    void *p1, void *p2, void *p3,
+			    int prio, u32_t options, s32_t delay)
+{
+	struct z_thread_pool_slot *slot;
+	struct k_thread *thread;
+	k_spinlock_key_t key;
+
+	__ASSERT((options & Z_THREAD_STACK_RECYCLED) == 0U,
+		 "invalid thread options");
+
+	key = k_spin_lock(&pool->lock);
+	slot = (struct z_thread_pool_slot *)sys_slist_get(&pool->free);
+	if (slot != NULL) {
+		slot->refs = 1U;
+	}
+	k_spin_unlock(&pool->lock, key);
+
+	if (slot == NULL) {
+		return NULL;
+	}
+
+	thread = slot_thread(pool, slot);
+
+	if (stack == NULL) {
+		__ASSERT(pool->stacks != NULL, "pool has no stacks");
+
+		stack = (k_thread_stack_t *)((u8_t *)pool->stacks +
+					     (slot - pool->slots) *
+					     pool->stack_stride);
+		stack_size = pool->stack_size;
+
+		/* Only the first thread on a stack needs it filled */
+		if (slot->stack_used) {
+			options |= Z_THREAD_STACK_RECYCLED;
+		}
+		slot->stack_used = true;
+	}
+
+#ifdef CONFIG_SMP
+	/* The previous thread on the slot may still be switching out on
+	 * another CPU after dropping its reference
+	 */
+	while (_kernel.cpus[thread->base.cpu].current == thread) {
+		compiler_barrier();
+	}
+#endif
+
+	z_setup_new_thread(thread, stack, stack_size, entry, p1, p2, p3,
+			   prio, options, NULL);
+
+	/* Set before the thread can run, and so exit */
+	thread->pool = pool;
+
+	if (delay != K_FOREVER) {
+		z_schedule_new_thread(thread, delay);
+	}
+
+	return thread;
+}
+
+void k_thread_pool_hold(k_tid_t thread)
+{
+	struct k_thread_pool *pool = thread->pool;
+	k_spinlock_key_t key;
+
+	__ASSERT(pool != NULL, "thread not from a pool");
+
+	key = k_spin_lock(&pool->lock);
+	thread_slot(thread)->refs++;
+	k_spin_unlock(&pool->lock, key);
+}
+
+void k_thread_pool_put(k_tid_t thread)
+{
+	struct k_thread_pool *pool = thread->pool;
+	k_spinlock_key_t key;
+
+	__ASSERT(pool != NULL, "thread not from a pool");
+
+	key = k_spin_lock(&pool->lock);
+	slot_put(pool, thread_slot(thread));
+	k_spin_unlock(&pool->lock, key);
+}
+
+u32_t k_thread_pool_num_free_get(struct k_thread_pool *pool)
+{
+	sys_snode_t *node;
+	u32_t count = 0U;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&pool->lock);
+	SYS_SLIST_FOR_EACH_NODE(&pool->free, node) {
+		count++;
+	}
+	k_spin_unlock(&pool->lock, key);
+
+	return count;
+}
@@ -9,6 +9,8 @@
 #include <spinlock.h>
 #include <ksched.h>
 #include <syscall_handler.h>
+#include <app_memory/app_memdomain.h>
+#include <init.h>
 
 #define LOCKED(lck) for (k_spinlock_key_t __i = {},			\
 					  __key = k_spin_lock(lck);	\
@@ -17,10 +19,20 @@
 
 static u64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
+#ifdef CONFIG_SPINLOCK_STATS
+static int timeout_stats_init(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	k_spin_stats_register(&timeout_lock, "timeout");
+	return 0;
+}
+
+SYS_INIT(timeout_stats_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+#endif
+
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
 		  ? K_FOREVER : INT_MAX)
 
@@ -38,6 +50,219 @@ Z_SYSCALL_HANDLER(z_clock_hw_cycles_per_sec_runtime_get)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+
+/* Hierarchical timing wheel.  Each level has WHEEL_SLOTS buckets,
+ * and a bucket at level N spans WHEEL_SLOTS^N ticks.  A timeout is
+ * stored (unsorted) in the lowest level whose bucket for its
+ * absolute expiry is less than WHEEL_SLOTS buckets ahead of the
+ * current one, which makes insert and abort O(1).  When time reaches
+ * the start of a bucket above level 0, its contents are cascaded down
+ * into the finer levels.  Timeouts further out than the top level can
+ * represent are parked in its last bucket and re-placed on cascade.
+ *
+ * The "dticks" field of a queued timeout holds the index of the
+ * bucket it lives in, so it can be unlinked without a search.
+ */
+#define WHEEL_BITS 5
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_WHEEL_LEVELS
+
+/* Buckets are initialized lazily: a bucket's list is only valid
+ * while its bit is set in wheel_occupied[]
+ */
+static sys_dlist_t wheel[WHEEL_LEVELS * WHEEL_SLOTS];
+static u32_t wheel_occupied[WHEEL_LEVELS];
+
+/* Absolute bucket number of tick t at the given wheel level */
+static inline u64_t wheel_slot(u64_t t, int lvl)
+{
+	return t >> (lvl * WHEEL_BITS);
+}
+
+/* Places "to" in the wheel relative to curr_tick, returning the
+ * absolute tick at which its bucket becomes due.
+ */
+static u64_t wheel_insert(struct _timeout *to)
+{
+	u64_t now = curr_tick, slot;
+	int lvl, idx;
+
+	for (lvl = 0; lvl < WHEEL_LEVELS - 1; lvl++) {
+		if (wheel_slot(to->expiry, lvl) - wheel_slot(now, lvl)
+		    < WHEEL_SLOTS) {
+			break;
+		}
+	}
+
+	slot = wheel_slot(to->expiry, lvl);
+	if (slot - wheel_slot(now, lvl) >= WHEEL_SLOTS) {
+		slot = wheel_slot(now, lvl) + WHEEL_SLOTS - 1;
+	}
+
+	idx = lvl * WHEEL_SLOTS + (slot & WHEEL_MASK);
+	if ((wheel_occupied[lvl] & BIT(slot & WHEEL_MASK)) == 0U) {
+		sys_dlist_init(&wheel[idx]);
+		wheel_occupied[lvl] |= BIT(slot & WHEEL_MASK);
+	}
+	sys_dlist_append(&wheel[idx], &to->node);
+	to->dticks = idx;
+
+	return lvl == 0 ? to->expiry : slot << (lvl * WHEEL_BITS);
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	int idx = t->dticks;
+
+	sys_dlist_remove(&t->node);
+	if (sys_dlist_is_empty(&wheel[idx])) {
+		wheel_occupied[idx / WHEEL_SLOTS] &= ~BIT(idx & WHEEL_MASK);
+	}
+}
+
+/* Finds the absolute tick of the earliest occupied bucket in the
+ * wheel.  For levels above 0 that is the tick at which the bucket
+ * must be cascaded, which can be earlier than any expiry it holds.
+ */
+static bool wheel_next_event(u64_t *next)
+{
+	bool found = false;
+
+	for (int lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		u32_t occ = wheel_occupied[lvl];
+		u64_t cur = wheel_slot(curr_tick, lvl);
+		u32_t rot = cur & WHEEL_MASK;
+		u64_t t;
+
+		if (occ == 0U) {
+			continue;
+		}
+
+		/* Rotate so that bit 0 is the current bucket */
+		if (rot != 0U) {
+			occ = (occ >> rot) | (occ << (WHEEL_SLOTS - rot));
+		}
+
+		t = (cur + find_lsb_set(occ) - 1) << (lvl * WHEEL_BITS);
+		if (!found || t < *next) {
+			*next = t;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+static void wheel_cascade(int lvl)
+{
+	u32_t slot = wheel_slot(curr_tick, lvl) & WHEEL_MASK;
+	int idx = lvl * WHEEL_SLOTS + slot;
+
+	while ((wheel_occupied[lvl] & BIT(slot)) != 0U) {
+		struct _timeout *t = CONTAINER_OF(
+			sys_dlist_peek_head(&wheel[idx]),
+			struct _timeout, node);
+
+		remove_timeout(t);
+		(void)wheel_insert(t);
+	}
+}
+
+static bool queue_insert(struct _timeout *to, s32_t ticks)
+{
+	u64_t prev, due;
+	bool had_next = wheel_next_event(&prev);
+
+	to->expiry = curr_tick + ticks;
+	due = wheel_insert(to);
+
+	return !had_next || due < prev;
+}
+
+/* Ticks from curr_tick until the wheel next needs service */
+static s32_t queue_first_dticks(void)
+{
+	u64_t next;
+
+	if (!wheel_next_event(&next)) {
+		return K_FOREVER;
+	}
+
+	return (s32_t)MIN(next - curr_tick, (u64_t)INT_MAX);
+}
+
+static s32_t queue_remaining(struct _timeout *timeout)
+{
+	return (s32_t)(timeout->expiry - curr_tick);
+}
+
+/* Advances curr_tick towards curr_tick + announce_remaining,
+ * cascading buckets on the way, and dequeues the next timeout that
+ * expires within that window.
+ */
+static struct _timeout *next_expired(void)
+{
+	u64_t target = curr_tick + announce_remaining;
+	u64_t next;
+
+	while (wheel_next_event(&next) && next <= target) {
+		u32_t idx;
+
+		announce_remaining -= next - curr_tick;
+		curr_tick = next;
+
+		for (int lvl = WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+			u64_t span = 1ULL << (lvl * WHEEL_BITS);
+
+			if ((curr_tick & (span - 1)) == 0U) {
+				wheel_cascade(lvl);
+			}
+		}
+
+		idx = curr_tick & WHEEL_MASK;
+		if ((wheel_occupied[0] & BIT(idx)) != 0U) {
+			struct _timeout *t = CONTAINER_OF(
+				sys_dlist_peek_head(&wheel[idx]),
+				struct _timeout, node);
+
+			remove_timeout(t);
+			return t;
+		}
+	}
+
+	return NULL;
+}
+
+/* Buckets are keyed by absolute tick, so nothing needs adjusting */
+static void queue_advance(void)
+{
+}
+
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Finds the earliest expiry in [lo, hi] ticks from curr_tick.  Only
+ * level 0 buckets hold a single tick each, so expiries further out
+ * than WHEEL_SLOTS ticks are not seen.
+ */
+static bool queue_find(s32_t lo, s32_t hi, s32_t *found)
+{
+	for (s32_t t = lo; t <= hi && t < WHEEL_SLOTS; t++) {
+		if ((wheel_occupied[0] & BIT((curr_tick + t) & WHEEL_MASK))
+		    != 0U) {
+			*found = t;
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
+#else /* !CONFIG_TIMEOUT_QUEUE_WHEEL */
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -61,16 +286,331 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
+static bool queue_insert(struct _timeout *to, s32_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks;
+	for (t = first(); t != NULL; t = next(t)) {
+		__ASSERT(t->dticks >= 0, "");
+
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+
+	return to == first();
+}
+
+static s32_t queue_first_dticks(void)
+{
+	struct _timeout *to = first();
+
+	return to == NULL ? K_FOREVER : to->dticks;
+}
+
+static s32_t queue_remaining(struct _timeout *timeout)
+{
+	s32_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (timeout == t) {
+			break;
+		}
+	}
+
+	return ticks;
+}
+
+static struct _timeout *next_expired(void)
+{
+	struct _timeout *t = first();
+
+	if (t == NULL || t->dticks > announce_remaining) {
+		return NULL;
+	}
+
+	curr_tick += t->dticks;
+	announce_remaining -= t->dticks;
+	t->dticks = 0;
+	remove_timeout(t);
+
+	return t;
+}
+
+/* Charges the ticks left over from z_clock_announce() to the head */
+static void queue_advance(void)
+{
+	if (first() != NULL) {
+		first()->dticks -= announce_remaining;
+	}
+}
+
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Finds the earliest expiry in [lo, hi] ticks from curr_tick */
+static bool queue_find(s32_t lo, s32_t hi, s32_t *found)
+{
+	s32_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (ticks >= lo) {
+			*found = ticks;
+			return ticks <= hi;
+		}
+	}
+
+	return false;
+}
+#endif
+
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 static s32_t elapsed(void)
 {
 	return announce_remaining == 0 ? z_clock_elapsed() : 0;
 }
 
+/* Cycles since boot.  While z_clock_announce() runs, the tick it
+ * announces up to is curr_tick + announce_remaining.
+ */
+static u64_t uptime_cycles(void)
+{
+	u64_t ticks = curr_tick + announce_remaining;
+
+#ifdef CONFIG_TIMEOUT_SUBTICK
+	return ticks * sys_clock_hw_cycles_per_tick() +
+	       z_clock_elapsed_cycles();
+#else
+	return (ticks + elapsed()) * sys_clock_hw_cycles_per_tick();
+#endif
+}
+
+#ifdef CONFIG_TIMEOUT_SUBTICK
+/* Timeouts due later in the tick last announced, sorted by cycles.
+ * Their "dticks" field is set to SUBTICK_QUEUED.
+ */
+static sys_dlist_t subtick_list = SYS_DLIST_STATIC_INIT(&subtick_list);
+
+#define SUBTICK_QUEUED -1
+
+static struct _timeout *subtick_first(void)
+{
+	sys_dnode_t *t = sys_dlist_peek_head(&subtick_list);
+
+	return t == NULL ? NULL : CONTAINER_OF(t, struct _timeout, node);
+}
+
+static void subtick_insert(struct _timeout *to)
+{
+	struct _timeout *t;
+
+	to->dticks = SUBTICK_QUEUED;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&subtick_list, t, node) {
+		if (t->cycles > to->cycles) {
+			sys_dlist_insert(&t->node, &to->node);
+			return;
+		}
+	}
+
+	sys_dlist_append(&subtick_list, &to->node);
+}
+
+/* Dequeues the first timeout of the list that is due: all of them
+ * are once a later tick is being announced
+ */
+static struct _timeout *subtick_expired(void)
+{
+	struct _timeout *t = subtick_first();
+
+	if (t == NULL || (announce_remaining == 0 &&
+			  t->cycles > z_clock_elapsed_cycles())) {
+		return NULL;
+	}
+
+	sys_dlist_remove(&t->node);
+	return t;
+}
+
+static void set_subtick_timeout(void)
+{
+	struct _timeout *t = subtick_first();
+
+	if (t != NULL) {
+		z_clock_set_timeout_cycles(t->cycles);
+	}
+}
+
+/* Queues a timeout due within the tick last announced */
+static void subtick_add(struct _timeout *to)
+{
+	subtick_insert(to);
+	set_subtick_timeout();
+}
+
+static bool is_subtick_queued(struct _timeout *t)
+{
+	return t->dticks == SUBTICK_QUEUED;
+}
+#else
+static void subtick_add(struct _timeout *to)
+{
+}
+
+static bool is_subtick_queued(struct _timeout *t)
+{
+	return false;
+}
+#endif /* CONFIG_TIMEOUT_SUBTICK */
+
+/* Unlinks a queued timeout from wherever it is queued */
+static void dequeue_timeout(struct _timeout *t)
+{
+	if (is_subtick_queued(t)) {
+		sys_dlist_remove(&t->node);
+	} else {
+		remove_timeout(t);
+	}
+}
+
+/* Dequeues the next timeout due in the window being announced.  Ones
+ * due later within the last tick of the window are set aside until
+ * the driver reports their cycle.
+ */
+static struct _timeout *next_due(void)
+{
+#ifdef CONFIG_TIMEOUT_SUBTICK
+	struct _timeout *t;
+
+	while (true) {
+		t = subtick_expired();
+		if (t != NULL) {
+			return t;
+		}
+
+		t = next_expired();
+		if (t == NULL || t->cycles == 0U || announce_remaining > 0) {
+			return t;
+		}
+
+		subtick_insert(t);
+	}
+#else
+	return next_expired();
+#endif
+}
+
+#ifdef CONFIG_TIME_PAGE
+K_APP_DMEM(z_user_ro_partition) struct z_time_page z_time_page;
+
+/* Tick until which a tickless kernel keeps the time page current */
+static u64_t time_page_until;
+
+/* The release ordering pairs with the acquire ordering in
+ * z_time_page_ticks_get(), so that a reader on another CPU never
+ * takes a half written page for a consistent one.
+ */
+static void time_page_update(bool ticking)
+{
+	u32_t seq = z_time_page.seq;
+
+	__atomic_store_n(&z_time_page.seq, seq + 1U, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	z_time_page.ticks = curr_tick + elapsed();
+	z_time_page.ticking = ticking;
+	__atomic_store_n(&z_time_page.seq, seq + 2U, __ATOMIC_RELEASE);
+}
+#endif
+
+/* Programs the next timer interrupt.  The time page is only current
+ * while the timer interrupts every tick, so with a tickless kernel it
+ * is kept ticking for a while after a user thread asked for the time,
+ * but never in idle.  Called with timeout_lock held.
+ */
+static void set_timeout(s32_t ticks, bool idle)
+{
+#ifdef CONFIG_TIME_PAGE
+	if (IS_ENABLED(CONFIG_TICKLESS_KERNEL) && !idle &&
+	    !z_is_idle_thread_object(_current) &&
+	    curr_tick < time_page_until &&
+	    (ticks == K_FOREVER || ticks > 1)) {
+		ticks = 1;
+	}
+
+	time_page_update(!IS_ENABLED(CONFIG_TICKLESS_KERNEL) ||
+			 (ticks != K_FOREVER && ticks <= 1));
+#endif
+	z_clock_set_timeout(ticks, idle);
+}
+
+#ifdef CONFIG_TIMEOUT_SLACK
+static u32_t wakeups_avoided;
+
+s32_t z_timeout_slack(s32_t slack)
+{
+	if (slack < 0) {
+		slack = z_is_in_isr() ? 0 : _current->base.timer_slack;
+	}
+
+	return slack;
+}
+
+/* Picks the expiry, between "ticks" and "ticks + slack" from
+ * curr_tick, that is least likely to need a wakeup of its own.  If
+ * another timeout is already due in that window, share its tick.
+ * Otherwise round up to the coarsest power of two boundary in the
+ * window, so that later timeouts with overlapping windows meet there.
+ */
+static s32_t apply_slack(s32_t ticks, s32_t slack)
+{
+	s32_t end = slack > INT_MAX - ticks ? INT_MAX : ticks + slack;
+	u64_t lo = curr_tick + ticks, hi = curr_tick + end, mask;
+	s32_t t;
+
+	if (queue_find(ticks, end, &t)) {
+		if (t != ticks) {
+			wakeups_avoided++;
+		}
+		return t;
+	}
+
+	if (lo == hi) {
+		return ticks;
+	}
+
+	mask = (1ULL << (63 - __builtin_clzll(lo ^ hi))) - 1;
+
+	return (s32_t)((hi & ~mask) - curr_tick);
+}
+
+u32_t z_impl_k_timer_wakeups_avoided_get(void)
+{
+	return wakeups_avoided;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_timer_wakeups_avoided_get)
+{
+	return z_impl_k_timer_wakeups_avoided_get();
+}
+#endif
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 static s32_t next_timeout(void)
 {
-	struct _timeout *to = first();
+	s32_t dticks = queue_first_dticks();
 	s32_t ticks_elapsed = elapsed();
-	s32_t ret = to == NULL ? MAX_WAIT : MAX(0, to->dticks - ticks_elapsed);
+	s32_t ret = dticks == K_FOREVER ? MAX_WAIT
+		: MAX(0, dticks - ticks_elapsed);
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -80,33 +620,105 @@ static s32_t next_timeout(void)
 	return ret;
 }
 
-void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
+/* Queues "to" "ticks" from curr_tick, plus its slack.  Called with
+ * timeout_lock held.
+ */
+static void add_timeout_locked(struct _timeout *to, s32_t ticks)
+{
+#ifdef CONFIG_TIMEOUT_SLACK
+	if (to->slack > 0) {
+		ticks = apply_slack(ticks, to->slack);
+	}
+#endif
+	if (queue_insert(to, ticks)) {
+		set_timeout(next_timeout(), false);
+	}
+}
+
+u64_t z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
 {
+	u64_t tick = 0U;
+
 	__ASSERT(!sys_dnode_is_linked(&to->node), "");
 	to->fn = fn;
 	ticks = MAX(1, ticks);
+#ifdef CONFIG_TIMEOUT_SUBTICK
+	to->cycles = 0U;
+#endif
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
+		ticks += elapsed();
+		tick = curr_tick + ticks;
+		add_timeout_locked(to, ticks);
+	}
 
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			__ASSERT(t->dticks >= 0, "");
+	return tick;
+}
 
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
+/* Queues a timeout at an absolute tick, e.g. one period after the
+ * nominal expiry of a periodic timeout, so that neither its slack nor
+ * any lateness accumulate.  A tick already past expires at the next
+ * tick, and one beyond INT_MAX ticks away at INT_MAX.
+ */
+void z_add_timeout_tick(struct _timeout *to, _timeout_func_t fn, u64_t tick)
+{
+	__ASSERT(!sys_dnode_is_linked(&to->node), "");
+	to->fn = fn;
+#ifdef CONFIG_TIMEOUT_SUBTICK
+	to->cycles = 0U;
+#endif
+
+	LOCKED(&timeout_lock) {
+		s32_t now = 1 + elapsed();
+		s64_t ticks = (s64_t)(tick - curr_tick);
+
+		ticks = MIN(MAX(ticks, now), INT_MAX);
+		add_timeout_locked(to, (s32_t)ticks);
+	}
+}
+
+/* Queues a timeout at an absolute deadline in cycles.  Without
+ * sub-tick support it expires at the first tick boundary not before
+ * the deadline, and a deadline already past expires at the next tick
+ * like a relative timeout would.
+ */
+void z_add_timeout_abs(struct _timeout *to, _timeout_func_t fn, u64_t cycles)
+{
+	u32_t cyc_per_tick = sys_clock_hw_cycles_per_tick();
+	u64_t tick = cycles / cyc_per_tick;
+	u32_t sub = cycles % cyc_per_tick;
+
+	__ASSERT(!sys_dnode_is_linked(&to->node), "");
+	to->fn = fn;
+
+	if (!IS_ENABLED(CONFIG_TIMEOUT_SUBTICK) && sub != 0U) {
+		tick++;
+		sub = 0U;
+	}
+
+	LOCKED(&timeout_lock) {
+		s64_t ticks = (s64_t)(tick - curr_tick);
+
+		if (cycles <= uptime_cycles()) {
+			ticks = 1 + elapsed();
+			sub = 0U;
 		}
 
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
+		/* The queue only holds INT_MAX ticks, and user threads pick
+		 * the deadline, so one further away expires early
+		 */
+		if (ticks > INT_MAX) {
+			ticks = INT_MAX;
+			sub = 0U;
 		}
 
-		if (to == first()) {
-			z_clock_set_timeout(next_timeout(), false);
+#ifdef CONFIG_TIMEOUT_SUBTICK
+		to->cycles = sub;
+#endif
+		if (IS_ENABLED(CONFIG_TIMEOUT_SUBTICK) && ticks == 0) {
+			subtick_add(to);
+		} else if (queue_insert(to, (s32_t)ticks)) {
+			set_timeout(next_timeout(), false);
 		}
 	}
 }
@@ -117,7 +729,7 @@ int z_abort_timeout(struct _timeout *to)
 
 	LOCKED(&timeout_lock) {
 		if (sys_dnode_is_linked(&to->node)) {
-			remove_timeout(to);
+			dequeue_timeout(to);
 			ret = 0;
 		}
 	}
@@ -134,12 +746,8 @@ s32_t z_timeout_remaining(struct _timeout *timeout)
 	}
 
 	LOCKED(&timeout_lock) {
-		for (struct _timeout *t = first(); t != NULL; t = next(t)) {
-			ticks += t->dticks;
-			if (timeout == t) {
-				break;
-			}
-		}
+		ticks = is_subtick_queued(timeout) ?
+			elapsed() : queue_remaining(timeout);
 	}
 
 	return ticks - elapsed();
@@ -169,7 +777,7 @@ void z_set_timeout_expiry(s32_t ticks, bool idle)
 		 * it's not considered to be settable as directed.
 		 */
 		if (sooner && !imminent) {
-			z_clock_set_timeout(ticks, idle);
+			set_timeout(ticks, idle);
 		}
 	}
 }
@@ -182,30 +790,25 @@ void z_clock_announce(s32_t ticks)
 
 	k_spinlock_key_t key = k_spin_lock(&timeout_lock);
 
-	announce_remaining = ticks;
-
-	while (first() != NULL && first()->dticks <= announce_remaining) {
-		struct _timeout *t = first();
-		int dt = t->dticks;
+	struct _timeout *t;
 
-		curr_tick += dt;
-		announce_remaining -= dt;
-		t->dticks = 0;
-		remove_timeout(t);
+	announce_remaining = ticks;
 
+	while ((t = next_due()) != NULL) {
 		k_spin_unlock(&timeout_lock, key);
 		t->fn(t);
 		key = k_spin_lock(&timeout_lock);
 	}
 
-	if (first() != NULL) {
-		first()->dticks -= announce_remaining;
-	}
+	queue_advance();
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
 
-	z_clock_set_timeout(next_timeout(), false);
+	set_timeout(next_timeout(), false);
+#ifdef CONFIG_TIMEOUT_SUBTICK
+	set_subtick_timeout();
+#endif
 
 	k_spin_unlock(&timeout_lock, key);
 }
@@ -229,30 +832,53 @@ u32_t z_tick_get_32(void)
 #endif
 }
 
-u32_t z_impl_k_uptime_get_32(void)
+u64_t z_impl_k_uptime_cycles_get(void)
 {
-	return __ticks_to_ms(z_tick_get_32());
+	u64_t cycles = 0U;
+
+	LOCKED(&timeout_lock) {
+		cycles = uptime_cycles();
+	}
+	return cycles;
 }
 
 #ifdef CONFIG_USERSPACE
-Z_SYSCALL_HANDLER(k_uptime_get_32)
+Z_SYSCALL_HANDLER(k_uptime_cycles_get, ret_p)
 {
-	return z_impl_k_uptime_get_32();
+	u64_t *ret = (u64_t *)ret_p;
+
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(ret, sizeof(*ret)));
+	*ret = z_impl_k_uptime_cycles_get();
+	return 0;
 }
 #endif
 
-s64_t z_impl_k_uptime_get(void)
+s64_t z_impl_z_uptime_ticks(void)
 {
-	return __ticks_to_ms(z_tick_get());
+	return z_tick_get();
 }
 
 #ifdef CONFIG_USERSPACE
-Z_SYSCALL_HANDLER(k_uptime_get, ret_p)
+Z_SYSCALL_HANDLER(z_uptime_ticks, ret_p)
 {
 	u64_t *ret = (u64_t *)ret_p;
 
 	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(ret, sizeof(*ret)));
-	*ret = z_impl_k_uptime_get();
+#ifdef CONFIG_TIME_PAGE
+	/* The caller found the time page stale: get the tick going
+	 * again, for as long as user threads keep reading the time
+	 */
+	LOCKED(&timeout_lock) {
+#ifdef CONFIG_TICKLESS_KERNEL
+		time_page_until = curr_tick +
+			z_ms_to_ticks(CONFIG_TIME_PAGE_HOLD_MS);
+#endif
+		if (!z_time_page.ticking) {
+			set_timeout(next_timeout(), false);
+		}
+	}
+#endif
+	*ret = z_impl_z_uptime_ticks();
 	return 0;
 }
 #endif
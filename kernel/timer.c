@@ -51,9 +51,26 @@ void z_timer_expiration_handler(struct _timeout *t)
 	 * if the timer is periodic, start it again; don't add _TICK_ALIGN
 	 * since we're already aligned to a tick boundary
 	 */
+#ifdef CONFIG_TIMER_START_AT
+	if (timer->period_cycles > 0U) {
+		/* counted from the deadline, not from now, to not drift */
+		timer->deadline_cycles += timer->period_cycles;
+		z_add_timeout_abs(&timer->timeout, z_timer_expiration_handler,
+				  timer->deadline_cycles);
+	} else
+#endif
 	if (timer->period > 0) {
+#ifdef CONFIG_TIMEOUT_SLACK
+		/* likewise from the nominal expiry tick, so that the slack
+		 * does not carry over to the next period
+		 */
+		timer->deadline_tick += timer->period;
+		z_add_timeout_tick(&timer->timeout, z_timer_expiration_handler,
+				   timer->deadline_tick);
+#else
 		z_add_timeout(&timer->timeout, z_timer_expiration_handler,
-			     timer->period);
+			      timer->period);
+#endif
 	}
 
 	/* update timer's status */
@@ -93,12 +110,18 @@ void k_timer_init(struct k_timer *timer,
 	timer->expiry_fn = expiry_fn;
 	timer->stop_fn = stop_fn;
 	timer->status = 0U;
+#ifdef CONFIG_TIMER_START_AT
+	timer->period_cycles = 0U;
+#endif
 
 	z_waitq_init(&timer->wait_q);
 	z_init_timeout(&timer->timeout, z_timer_expiration_handler);
 	SYS_TRACING_OBJ_INIT(k_timer, timer);
 
 	timer->user_data = NULL;
+#ifdef CONFIG_TIMEOUT_SLACK
+	timer->slack = -1;
+#endif
 
 	z_object_init(timer);
 }
@@ -116,9 +139,19 @@ void z_impl_k_timer_start(struct k_timer *timer, s32_t duration, s32_t period)
 
 	(void)z_abort_timeout(&timer->timeout);
 	timer->period = period_in_ticks;
+#ifdef CONFIG_TIMER_START_AT
+	timer->period_cycles = 0U;
+#endif
 	timer->status = 0U;
-	z_add_timeout(&timer->timeout, z_timer_expiration_handler,
-		     duration_in_ticks);
+#ifdef CONFIG_TIMEOUT_SLACK
+	timer->timeout.slack = z_timeout_slack(timer->slack);
+	timer->deadline_tick = z_add_timeout(&timer->timeout,
+					     z_timer_expiration_handler,
+					     duration_in_ticks);
+#else
+	(void)z_add_timeout(&timer->timeout, z_timer_expiration_handler,
+			    duration_in_ticks);
+#endif
 }
 
 #ifdef CONFIG_USERSPACE
@@ -137,6 +170,53 @@ Z_SYSCALL_HANDLER(k_timer_start, timer, duration_p, period_p)
 }
 #endif
 
+#ifdef CONFIG_TIMER_START_AT
+void z_impl_z_timer_start_at(struct k_timer *timer, u32_t deadline_lo,
+			     u32_t deadline_hi, u32_t period_cycles)
+{
+	(void)z_abort_timeout(&timer->timeout);
+	timer->deadline_cycles = ((u64_t)deadline_hi << 32) | deadline_lo;
+	timer->period = 0;
+	timer->period_cycles = period_cycles;
+	timer->status = 0U;
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* absolute deadlines are kept exactly; don't let the slack of
+	 * an earlier k_timer_start() linger in the timeout
+	 */
+	timer->timeout.slack = 0;
+#endif
+	z_add_timeout_abs(&timer->timeout, z_timer_expiration_handler,
+			  timer->deadline_cycles);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(z_timer_start_at, timer, deadline_lo, deadline_hi,
+		  period_cycles)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(timer, K_OBJ_TIMER));
+	z_impl_z_timer_start_at((struct k_timer *)timer, deadline_lo,
+				deadline_hi, period_cycles);
+	return 0;
+}
+#endif
+#endif /* CONFIG_TIMER_START_AT */
+
+#ifdef CONFIG_TIMEOUT_SLACK
+void z_impl_k_timer_slack_set(struct k_timer *timer, s32_t slack)
+{
+	timer->slack = slack < 0 ? -1 : z_ms_to_ticks(slack);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_timer_slack_set, timer, slack)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(timer, K_OBJ_TIMER));
+	z_impl_k_timer_slack_set((struct k_timer *)timer, (s32_t)slack);
+	return 0;
+}
+#endif
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 void z_impl_k_timer_stop(struct k_timer *timer)
 {
 	int inactive = z_abort_timeout(&timer->timeout) != 0;
@@ -9,7 +9,6 @@
 #include <string.h>
 #include <sys/math_extras.h>
 #include <sys/printk.h>
-#include <sys/rb.h>
 #include <kernel_structs.h>
 #include <sys/sys_io.h>
 #include <ksched.h>
@@ -47,7 +46,7 @@ LOG_MODULE_DECLARE(os);
  * not.
  */
 #ifdef CONFIG_DYNAMIC_OBJECTS
-static struct k_spinlock lists_lock;       /* kobj rbtree/dlist */
+static struct k_spinlock lists_lock;       /* kobj hash/dlist */
 static struct k_spinlock objfree_lock;     /* k_object_free */
 #endif
 static struct k_spinlock obj_lock;         /* kobj struct data */
@@ -90,11 +89,70 @@ struct perm_ctx {
 	struct k_thread *parent;
 };
 
+#if CONFIG_KOBJECT_CACHE_SIZE > 0
+/* Bumped whenever some thread loses a permission or a dynamic object
+ * goes away. A thread seeing a generation different from the one its
+ * cache was filled in throws the whole cache away.
+ */
+static atomic_t cache_gen;
+
+static void cache_invalidate(void)
+{
+	(void)atomic_inc(&cache_gen);
+}
+
+static struct _k_object *cache_find(void *obj)
+{
+	struct _kobject_cache *cache = &_current->kobject_cache;
+	u32_t gen = (u32_t)atomic_get(&cache_gen);
+
+	if (cache->gen != gen) {
+		(void)memset(cache, 0, sizeof(*cache));
+		cache->gen = gen;
+		return NULL;
+	}
+
+	for (int i = 0; i < CONFIG_KOBJECT_CACHE_SIZE; i++) {
+		if (cache->entries[i].obj == obj) {
+			return cache->entries[i].ko;
+		}
+	}
+
+	return NULL;
+}
+
+static void cache_add(void *obj, struct _k_object *ko)
+{
+	struct _kobject_cache *cache = &_current->kobject_cache;
+
+	cache->entries[cache->next].obj = obj;
+	cache->entries[cache->next].ko = ko;
+	cache->next = (cache->next + 1) % CONFIG_KOBJECT_CACHE_SIZE;
+}
+#else
+static inline void cache_invalidate(void)
+{
+}
+
+static inline struct _k_object *cache_find(void *obj)
+{
+	ARG_UNUSED(obj);
+
+	return NULL;
+}
+
+static inline void cache_add(void *obj, struct _k_object *ko)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(ko);
+}
+#endif /* CONFIG_KOBJECT_CACHE_SIZE > 0 */
+
 #ifdef CONFIG_DYNAMIC_OBJECTS
 struct dyn_obj {
 	struct _k_object kobj;
 	sys_dnode_t obj_list;
-	struct rbnode node; /* must be immediately before data member */
+	sys_snode_t hash_node;
 	u8_t data[]; /* The object itself */
 };
 
@@ -102,15 +160,22 @@ extern struct _k_object *z_object_gperf_find(void *obj);
 extern void z_object_gperf_wordlist_foreach(_wordlist_cb_func_t func,
 					     void *context);
 
-static bool node_lessthan(struct rbnode *a, struct rbnode *b);
-
 /*
- * Red/black tree of allocated kernel objects, for reasonably fast lookups
- * based on object pointer values.
+ * Hash table of allocated kernel objects, for constant time lookups
+ * based on object pointer values. It starts out with a static bucket
+ * array and doubles the number of buckets, taking the memory from the
+ * system heap, whenever the chains get longer than OBJ_HASH_MAX_LOAD on
+ * average. Without a system heap, or if that allocation fails, the
+ * table just keeps its current size. It is only ever touched with
+ * lists_lock held.
  */
-static struct rbtree obj_rb_tree = {
-	.lessthan_fn = node_lessthan
-};
+#define OBJ_HASH_MIN_BITS	4
+#define OBJ_HASH_MAX_LOAD	2
+
+static sys_slist_t obj_hash_static[BIT(OBJ_HASH_MIN_BITS)];
+static sys_slist_t *obj_hash = obj_hash_static;
+static unsigned int obj_hash_bits = OBJ_HASH_MIN_BITS;
+static size_t obj_count;
 
 /*
  * Linked list of allocated kernel objects, for iteration over all allocated
@@ -118,11 +183,6 @@ static struct rbtree obj_rb_tree = {
  */
 static sys_dlist_t obj_list = SYS_DLIST_STATIC_INIT(&obj_list);
 
-/*
- * TODO: Write some hash table code that will replace both obj_rb_tree
- * and obj_list.
- */
-
 static size_t obj_size_get(enum k_objects otype)
 {
 	size_t ret;
@@ -137,34 +197,107 @@ static size_t obj_size_get(enum k_objects otype)
 	return ret;
 }
 
-static bool node_lessthan(struct rbnode *a, struct rbnode *b)
+/* Fibonacci hashing: multiply by 2^32 / phi and keep the top bits,
+ * which mixes the low bits of the address, where consecutive objects
+ * differ, into the bucket index.
+ */
+static inline sys_slist_t *obj_hash_bucket(sys_slist_t *table,
+					   unsigned int bits, void *obj)
 {
-	return a < b;
+	u32_t hash = (u32_t)((uintptr_t)obj >> 2) * 2654435769U;
+
+	return &table[hash >> (32 - bits)];
 }
 
-static inline struct dyn_obj *node_to_dyn_obj(struct rbnode *node)
+static void obj_hash_insert(struct dyn_obj *dyn_obj)
 {
-	return CONTAINER_OF(node, struct dyn_obj, node);
+	sys_slist_append(obj_hash_bucket(obj_hash, obj_hash_bits,
+					 dyn_obj->data),
+			 &dyn_obj->hash_node);
+	obj_count++;
 }
 
-static struct dyn_obj *dyn_object_find(void *obj)
+/* Unlinks an object from the hash table and obj_list, with lists_lock
+ * held
+ */
+static void obj_unlink(struct dyn_obj *dyn_obj)
 {
-	struct rbnode *node;
-	struct dyn_obj *ret;
+	sys_slist_find_and_remove(obj_hash_bucket(obj_hash, obj_hash_bits,
+						  dyn_obj->data),
+				  &dyn_obj->hash_node);
+	sys_dlist_remove(&dyn_obj->obj_list);
+	obj_count--;
+}
 
-	/* For any dynamically allocated kernel object, the object
-	 * pointer is just a member of the conatining struct dyn_obj,
-	 * so just a little arithmetic is necessary to locate the
-	 * corresponding struct rbnode
+static void obj_hash_grow(void)
+{
+#if (CONFIG_HEAP_MEM_POOL_SIZE > 0)
+	unsigned int bits = obj_hash_bits + 1;
+	sys_slist_t *table, *old;
+	struct dyn_obj *dyn_obj;
+	k_spinlock_key_t key;
+
+	/* The table is shared by all threads, so it is not charged to
+	 * the resource pool of whichever one happens to grow it
 	 */
-	node = (struct rbnode *)((char *)obj - sizeof(struct rbnode));
+	table = k_malloc(BIT(bits) * sizeof(sys_slist_t));
+	if (table == NULL) {
+		return;
+	}
 
-	k_spinlock_key_t key = k_spin_lock(&lists_lock);
-	if (rb_contains(&obj_rb_tree, node)) {
-		ret = node_to_dyn_obj(node);
-	} else {
-		ret = NULL;
+	for (int i = 0; i < BIT(bits); i++) {
+		sys_slist_init(&table[i]);
 	}
+
+	key = k_spin_lock(&lists_lock);
+
+	if (bits != obj_hash_bits + 1) {
+		/* Someone else got there first */
+		k_spin_unlock(&lists_lock, key);
+		k_free(table);
+		return;
+	}
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&obj_list, dyn_obj, obj_list) {
+		sys_slist_append(obj_hash_bucket(table, bits, dyn_obj->data),
+				 &dyn_obj->hash_node);
+	}
+
+	old = obj_hash;
+	obj_hash = table;
+	obj_hash_bits = bits;
+
+	k_spin_unlock(&lists_lock, key);
+
+	if (old != obj_hash_static) {
+		k_free(old);
+	}
+#endif
+}
+
+/* Looks up an object in the hash table, with lists_lock held */
+static struct dyn_obj *dyn_object_lookup(void *obj)
+{
+	struct dyn_obj *node;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(obj_hash_bucket(obj_hash, obj_hash_bits,
+						     obj),
+				     node, hash_node) {
+		if ((void *)node->data == obj) {
+			return node;
+		}
+	}
+
+	return NULL;
+}
+
+static struct dyn_obj *dyn_object_find(void *obj)
+{
+	struct dyn_obj *ret;
+
+	k_spinlock_key_t key = k_spin_lock(&lists_lock);
+
+	ret = dyn_object_lookup(obj);
 	k_spin_unlock(&lists_lock, key);
 
 	return ret;
@@ -237,6 +370,7 @@ void *z_impl_k_object_alloc(enum k_objects otype)
 {
 	struct dyn_obj *dyn_obj;
 	u32_t tidx;
+	bool grow;
 
 	/* Stacks are not supported, we don't yet have mem pool APIs
 	 * to request memory that is aligned
@@ -273,10 +407,15 @@ void *z_impl_k_object_alloc(enum k_objects otype)
 
 	k_spinlock_key_t key = k_spin_lock(&lists_lock);
 
-	rb_insert(&obj_rb_tree, &dyn_obj->node);
+	obj_hash_insert(dyn_obj);
 	sys_dlist_append(&obj_list, &dyn_obj->obj_list);
+	grow = obj_count > (BIT(obj_hash_bits) * OBJ_HASH_MAX_LOAD);
 	k_spin_unlock(&lists_lock, key);
 
+	if (grow) {
+		obj_hash_grow();
+	}
+
 	return dyn_obj->kobj.name;
 }
 
@@ -290,15 +429,19 @@ void k_object_free(void *obj)
 	 */
 
 	k_spinlock_key_t key = k_spin_lock(&objfree_lock);
+	k_spinlock_key_t lists_key = k_spin_lock(&lists_lock);
 
-	dyn_obj = dyn_object_find(obj);
+	dyn_obj = dyn_object_lookup(obj);
 	if (dyn_obj != NULL) {
-		rb_remove(&obj_rb_tree, &dyn_obj->node);
-		sys_dlist_remove(&dyn_obj->obj_list);
+		obj_unlink(dyn_obj);
+	}
+	k_spin_unlock(&lists_lock, lists_key);
 
+	if (dyn_obj != NULL) {
 		if (dyn_obj->kobj.type == K_OBJ_THREAD) {
 			thread_idx_free(dyn_obj->kobj.data);
 		}
+		cache_invalidate();
 	}
 	k_spin_unlock(&objfree_lock, key);
 
@@ -353,11 +496,13 @@ static int thread_index_get(struct k_thread *t)
 	return ko->data;
 }
 
-static void unref_check(struct _k_object *ko, int index)
+/* Called with lists_lock held, as the object may be unlinked */
+static void unref_check_locked(struct _k_object *ko, int index)
 {
 	k_spinlock_key_t key = k_spin_lock(&obj_lock);
 
 	sys_bitfield_clear_bit((mem_addr_t)&ko->perms, index);
+	cache_invalidate();
 
 #ifdef CONFIG_DYNAMIC_OBJECTS
 	struct dyn_obj *dyn_obj =
@@ -393,14 +538,25 @@ static void unref_check(struct _k_object *ko, int index)
 		break;
 	}
 
-	rb_remove(&obj_rb_tree, &dyn_obj->node);
-	sys_dlist_remove(&dyn_obj->obj_list);
+	obj_unlink(dyn_obj);
 	k_free(dyn_obj);
 out:
 #endif
 	k_spin_unlock(&obj_lock, key);
 }
 
+static void unref_check(struct _k_object *ko, int index)
+{
+#ifdef CONFIG_DYNAMIC_OBJECTS
+	k_spinlock_key_t key = k_spin_lock(&lists_lock);
+
+	unref_check_locked(ko, index);
+	k_spin_unlock(&lists_lock, key);
+#else
+	unref_check_locked(ko, index);
+#endif
+}
+
 static void wordlist_cb(struct _k_object *ko, void *ctx_ptr)
 {
 	struct perm_ctx *ctx = (struct perm_ctx *)ctx_ptr;
@@ -443,11 +599,12 @@ void z_thread_perms_clear(struct _k_object *ko, struct k_thread *thread)
 	}
 }
 
+/* Runs from z_object_wordlist_foreach(), which holds lists_lock */
 static void clear_perms_cb(struct _k_object *ko, void *ctx_ptr)
 {
 	int id = (int)ctx_ptr;
 
-	unref_check(ko, id);
+	unref_check_locked(ko, id);
 }
 
 void z_thread_perms_all_clear(struct k_thread *thread)
@@ -540,6 +697,26 @@ void k_object_access_all_grant(void *object)
 	}
 }
 
+static int init_state_check(struct _k_object *ko, enum _obj_init_check init)
+{
+	/* Initialization state checks. _OBJ_INIT_ANY, we don't care */
+	if (likely(init == _OBJ_INIT_TRUE)) {
+		/* Object MUST be intialized */
+		if (unlikely((ko->flags & K_OBJ_FLAG_INITIALIZED) == 0U)) {
+			return -EINVAL;
+		}
+	} else if (init < _OBJ_INIT_TRUE) { /* _OBJ_INIT_FALSE case */
+		/* Object MUST NOT be initialized */
+		if (unlikely((ko->flags & K_OBJ_FLAG_INITIALIZED) != 0U)) {
+			return -EADDRINUSE;
+		}
+	} else {
+		/* _OBJ_INIT_ANY */
+	}
+
+	return 0;
+}
+
 int z_object_validate(struct _k_object *ko, enum k_objects otype,
 		       enum _obj_init_check init)
 {
@@ -555,22 +732,40 @@ int z_object_validate(struct _k_object *ko, enum k_objects otype,
 		return -EPERM;
 	}
 
-	/* Initialization state checks. _OBJ_INIT_ANY, we don't care */
-	if (likely(init == _OBJ_INIT_TRUE)) {
-		/* Object MUST be intialized */
-		if (unlikely((ko->flags & K_OBJ_FLAG_INITIALIZED) == 0U)) {
-			return -EINVAL;
-		}
-	} else if (init < _OBJ_INIT_TRUE) { /* _OBJ_INIT_FALSE case */
-		/* Object MUST NOT be initialized */
-		if (unlikely((ko->flags & K_OBJ_FLAG_INITIALIZED) != 0U)) {
-			return -EADDRINUSE;
+	return init_state_check(ko, init);
+}
+
+int z_object_check(void *obj, enum k_objects otype,
+		   enum _obj_init_check init)
+{
+	struct _k_object *ko;
+	int ret;
+
+	/* A cache hit means the current thread had permission on the
+	 * object when it was last checked, and hasn't lost it since
+	 */
+	ko = cache_find(obj);
+	if (ko != NULL) {
+		if (unlikely(otype != K_OBJ_ANY && ko->type != otype)) {
+			ret = -EBADF;
+		} else {
+			ret = init_state_check(ko, init);
 		}
 	} else {
-		/* _OBJ_INIT_ANY */
+		ko = z_object_find(obj);
+		ret = z_object_validate(ko, otype, init);
+		if (ret == 0) {
+			cache_add(obj, ko);
+		}
 	}
 
-	return 0;
+#ifdef CONFIG_PRINTK
+	if (ret != 0) {
+		z_dump_object_error(ret, obj, ko, otype);
+	}
+#endif
+
+	return ret;
 }
 
 void z_object_init(void *obj)
@@ -604,6 +799,7 @@ void z_object_recycle(void *obj)
 
 	if (ko != NULL) {
 		(void)memset(ko->perms, 0, sizeof(ko->perms));
+		cache_invalidate();
 		z_thread_perms_set(ko, k_current_get());
 		ko->flags |= K_OBJ_FLAG_INITIALIZED;
 	}
@@ -13,9 +13,11 @@
 
 #include <kernel_structs.h>
 #include <wait_q.h>
+#include <ksched.h>
 #include <spinlock.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <string.h>
 
 #define WORKQUEUE_THREAD_NAME	"workqueue"
 
@@ -29,12 +31,191 @@ void k_work_q_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 		    size_t stack_size, int prio)
 {
 	k_queue_init(&work_q->queue);
+#ifdef CONFIG_WORKQUEUE_POOL
+	work_q->workers = NULL;
+#endif
 	(void)k_thread_create(&work_q->thread, stack, stack_size, z_work_q_main,
 			work_q, NULL, NULL, prio, 0, 0);
 
 	k_thread_name_set(&work_q->thread, WORKQUEUE_THREAD_NAME);
 }
 
+#ifdef CONFIG_WORKQUEUE_POOL
+#ifdef CONFIG_WORKQUEUE_POOL_STATS
+static sys_slist_t pools = SYS_SLIST_STATIC_INIT(&pools);
+static struct k_spinlock pools_lock;
+
+static void pool_record_latency(struct k_work_q *work_q, struct k_work *work)
+{
+	u32_t us = SYS_CLOCK_HW_CYCLES_TO_NS(k_cycle_get_32() -
+					     work->submit_time) / 1000U;
+	int bucket = (us > 1U) ? (int)find_msb_set(us) - 1 : 0;
+
+	work_q->latency[MIN(bucket, K_WORK_Q_LATENCY_BUCKETS - 1)]++;
+}
+#endif
+
+/* The worker running the current thread, if it belongs to @a work_q */
+static struct k_work_q_worker *pool_current_worker(struct k_work_q *work_q)
+{
+	struct k_work_q_worker *w = CONTAINER_OF(_current,
+						 struct k_work_q_worker,
+						 thread);
+
+	if (w >= work_q->workers && w < work_q->workers + work_q->num_workers) {
+		return w;
+	}
+
+	return NULL;
+}
+
+void z_work_q_pool_append(struct k_work_q *work_q, struct k_work *work)
+{
+	k_spinlock_key_t key = k_spin_lock(&work_q->lock);
+	struct k_work_q_worker *w;
+	struct k_thread *thread;
+
+#ifdef CONFIG_WORKQUEUE_POOL_STATS
+	work->submit_time = k_cycle_get_32();
+#endif
+
+	/* Prefer an idle worker, which then finds the work item in its
+	 * own deque. Otherwise keep work submitted by a handler with the
+	 * worker running it, and spread everything else round robin;
+	 * workers that run dry steal from the others.
+	 */
+	thread = z_unpend_first_thread(&work_q->idle);
+	if (thread != NULL) {
+		w = CONTAINER_OF(thread, struct k_work_q_worker, thread);
+	} else {
+		w = z_is_in_isr() ? NULL : pool_current_worker(work_q);
+		if (w == NULL) {
+			w = &work_q->workers[work_q->next_worker];
+			work_q->next_worker = (work_q->next_worker + 1) %
+					      work_q->num_workers;
+		}
+	}
+
+	sys_slist_append(&w->deque, (sys_snode_t *)work);
+
+	if (thread != NULL) {
+		z_ready_thread(thread);
+		z_reschedule(&work_q->lock, key);
+	} else {
+		k_spin_unlock(&work_q->lock, key);
+	}
+}
+
+/* Take the oldest work item of @a self, or steal one from another
+ * worker, starting with the next one along. Called with the pool
+ * lock held.
+ */
+static struct k_work *pool_take(struct k_work_q *work_q,
+				struct k_work_q_worker *self)
+{
+	int n = work_q->num_workers;
+	int first = self - work_q->workers;
+
+	for (int i = 0; i < n; i++) {
+		struct k_work_q_worker *w = &work_q->workers[(first + i) % n];
+		sys_snode_t *node = sys_slist_get(&w->deque);
+
+		if (node != NULL) {
+#ifdef CONFIG_WORKQUEUE_POOL_STATS
+			if (w != self) {
+				work_q->steals++;
+			}
+			pool_record_latency(work_q, (struct k_work *)node);
+#endif
+			return (struct k_work *)node;
+		}
+	}
+
+	return NULL;
+}
+
+static void pool_worker_main(void *p1, void *p2, void *p3)
+{
+	struct k_work_q_worker *self = p1;
+	struct k_work_q *work_q = self->work_q;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_spinlock_key_t key = k_spin_lock(&work_q->lock);
+		struct k_work *work = pool_take(work_q, self);
+
+		if (work == NULL) {
+			(void)z_pend_curr(&work_q->lock, key, &work_q->idle,
+					  K_FOREVER);
+			continue;
+		}
+
+		k_spin_unlock(&work_q->lock, key);
+
+		/* Reset pending state so it can be resubmitted by handler */
+		if (atomic_test_and_clear_bit(work->flags,
+					      K_WORK_STATE_PENDING)) {
+			work->handler(work);
+		}
+
+		/* Don't hog the CPU while there is a backlog */
+		k_yield();
+	}
+}
+
+void k_work_q_pool_start(struct k_work_q *work_q,
+			 struct k_work_q_worker *workers, int num_workers,
+			 k_thread_stack_t *stacks, size_t stack_size, int prio)
+{
+	__ASSERT(num_workers > 0, "");
+
+	k_queue_init(&work_q->queue);
+	z_waitq_init(&work_q->idle);
+	work_q->workers = workers;
+	work_q->num_workers = num_workers;
+	work_q->next_worker = 0;
+
+#ifdef CONFIG_WORKQUEUE_POOL_STATS
+	(void)memset(work_q->latency, 0, sizeof(work_q->latency));
+	work_q->steals = 0U;
+
+	k_spinlock_key_t key = k_spin_lock(&pools_lock);
+
+	sys_slist_append(&pools, &work_q->node);
+	k_spin_unlock(&pools_lock, key);
+#endif
+
+	for (int i = 0; i < num_workers; i++) {
+		k_thread_stack_t *stack = stacks +
+					  i * K_THREAD_STACK_LEN(stack_size);
+
+		workers[i].work_q = work_q;
+		sys_slist_init(&workers[i].deque);
+
+		(void)k_thread_create(&workers[i].thread, stack, stack_size,
+				      pool_worker_main, &workers[i], NULL, NULL,
+				      prio, 0, 0);
+		k_thread_name_set(&workers[i].thread, WORKQUEUE_THREAD_NAME);
+	}
+}
+
+#ifdef CONFIG_WORKQUEUE_POOL_STATS
+void k_work_q_pool_foreach(k_work_q_user_cb_t user_cb, void *user_data)
+{
+	struct k_work_q *work_q;
+
+	/* Pools are never taken off the list, so no need to hold the
+	 * lock while calling out.
+	 */
+	SYS_SLIST_FOR_EACH_CONTAINER(&pools, work_q, node) {
+		user_cb(work_q, user_data);
+	}
+}
+#endif
+#endif /* CONFIG_WORKQUEUE_POOL */
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 static void work_timeout(struct _timeout *t)
 {
@@ -50,6 +231,38 @@ void k_delayed_work_init(struct k_delayed_work *work, k_work_handler_t handler)
 	k_work_init(&work->work, handler);
 	z_init_timeout(&work->timeout, work_timeout);
 	work->work_q = NULL;
+#ifdef CONFIG_TIMEOUT_SLACK
+	work->slack = -1;
+#endif
+}
+
+#ifdef CONFIG_TIMEOUT_SLACK
+void k_delayed_work_slack_set(struct k_delayed_work *work, s32_t slack)
+{
+	work->slack = slack < 0 ? -1 : z_ms_to_ticks(slack);
+}
+#endif
+
+/* Remove a work item that has not been taken by a worker yet */
+static bool work_q_remove(struct k_work_q *work_q, struct k_work *work)
+{
+#ifdef CONFIG_WORKQUEUE_POOL
+	if (work_q->workers != NULL) {
+		k_spinlock_key_t key = k_spin_lock(&work_q->lock);
+		bool found = false;
+
+		for (int i = 0; i < work_q->num_workers && !found; i++) {
+			found = sys_slist_find_and_remove(
+					&work_q->workers[i].deque,
+					(sys_snode_t *)work);
+		}
+
+		k_spin_unlock(&work_q->lock, key);
+		return found;
+	}
+#endif
+
+	return k_queue_remove(&work_q->queue, work);
 }
 
 static int work_cancel(struct k_delayed_work *work)
@@ -58,7 +271,7 @@ static int work_cancel(struct k_delayed_work *work)
 
 	if (k_work_pending(&work->work)) {
 		/* Remove from the queue if already submitted */
-		if (!k_queue_remove(&work->work_q->queue, &work->work)) {
+		if (!work_q_remove(work->work_q, &work->work)) {
 			return -EINVAL;
 		}
 	} else {
@@ -107,6 +320,9 @@ int k_delayed_work_submit_to_queue(struct k_work_q *work_q,
 	}
 
 	/* Add timeout */
+#ifdef CONFIG_TIMEOUT_SLACK
+	work->timeout.slack = z_timeout_slack(work->slack);
+#endif
 	z_add_timeout(&work->timeout, work_timeout,
 		     _TICK_ALIGN + z_ms_to_ticks(delay));
 
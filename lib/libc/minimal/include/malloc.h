@@ -0,0 +1,43 @@
+/* malloc.h */
+
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_LIB_LIBC_MINIMAL_INCLUDE_MALLOC_H_
+#define ZEPHYR_LIB_LIBC_MINIMAL_INCLUDE_MALLOC_H_
+
+#include <stddef.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Statistics of the malloc() arena, named after the fields of glibc's
+ * struct mallinfo.  The "shared heap" is the arena proper; blocks held
+ * in the per-thread caches are allocated from it but not in use by the
+ * application.
+ */
+struct mallinfo {
+	int arena;	/* Size of the arena in bytes */
+	int ordblks;	/* Number of free blocks in the shared heap */
+	int smblks;	/* Number of blocks held in thread caches */
+	int hblks;	/* Unused, always 0 */
+	int hblkhd;	/* Unused, always 0 */
+	int usmblks;	/* Peak of uordblks */
+	int fsmblks;	/* Bytes held in thread caches */
+	int uordblks;	/* Bytes allocated to the application */
+	int fordblks;	/* Bytes in free blocks of the shared heap */
+	int keepcost;	/* Size of the largest free block of the shared heap */
+};
+
+struct mallinfo mallinfo(void);
+int malloc_trim(size_t pad);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* ZEPHYR_LIB_LIBC_MINIMAL_INCLUDE_MALLOC_H_ */
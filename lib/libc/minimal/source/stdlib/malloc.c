@@ -5,11 +5,15 @@
  */
 
 #include <stdlib.h>
+#include <malloc.h>
 #include <zephyr.h>
 #include <init.h>
 #include <errno.h>
+#include <sys/atomic.h>
 #include <sys/math_extras.h>
 #include <sys/mempool.h>
+#include <sys/sys_heap.h>
+#include <sys/mutex.h>
 #include <string.h>
 #include <app_memory/app_memdomain.h>
 
@@ -25,26 +29,539 @@ K_APPMEM_PARTITION_DEFINE(z_malloc_partition);
 #define POOL_SECTION .data
 #endif /* CONFIG_USERSPACE */
 
+/*
+ * The shared heap: shared_alloc(), shared_free(), usable_size() and
+ * shared_stats() on top of either allocator.
+ */
+
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+char __aligned(sizeof(void *)) Z_GENERIC_SECTION(POOL_SECTION)
+	z_malloc_heap_mem[CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE];
+Z_GENERIC_SECTION(POOL_SECTION) struct sys_heap z_malloc_heap;
+Z_GENERIC_SECTION(POOL_SECTION) SYS_MUTEX_DEFINE(z_malloc_heap_mutex);
+
+static void *shared_alloc(size_t size)
+{
+	void *ret;
+
+	sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+	ret = sys_heap_alloc(&z_malloc_heap, size);
+	sys_mutex_unlock(&z_malloc_heap_mutex);
+
+	return ret;
+}
+
+static void shared_free(void *ptr)
+{
+	sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+	sys_heap_free(&z_malloc_heap, ptr);
+	sys_mutex_unlock(&z_malloc_heap_mutex);
+}
+
+static size_t usable_size(void *ptr)
+{
+	return sys_heap_usable_size(&z_malloc_heap, ptr);
+}
+
+static void shared_stats(struct mallinfo *info)
+{
+	struct sys_heap_stats stats;
+
+	sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+	sys_heap_stats_get(&z_malloc_heap, &stats);
+	sys_mutex_unlock(&z_malloc_heap_mutex);
+
+	info->ordblks = stats.free_blocks;
+	info->fordblks = stats.free_bytes;
+	info->keepcost = stats.max_free_bytes;
+}
+
+static void shared_init(void)
+{
+	sys_heap_init(&z_malloc_heap, z_malloc_heap_mem,
+		      CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE);
+}
+#else
 SYS_MEM_POOL_DEFINE(z_malloc_mem_pool, NULL, 16,
 		    CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE, 1, 4, POOL_SECTION);
 
+static void *shared_alloc(size_t size)
+{
+	return sys_mem_pool_alloc(&z_malloc_mem_pool, size);
+}
+
+static void shared_free(void *ptr)
+{
+	sys_mem_pool_free(ptr);
+}
+
+static size_t usable_size(void *ptr)
+{
+	struct sys_mem_pool_block *blk;
+	size_t struct_blk_size = WB_UP(sizeof(struct sys_mem_pool_block));
+	size_t block_size;
+
+	/* Stored right before the pointer passed to the user */
+	blk = (struct sys_mem_pool_block *)((char *)ptr - struct_blk_size);
+
+	/* Determine size of previously allocated block by its level.
+	 * Most likely a bit larger than the original allocation
+	 */
+	block_size = blk->pool->base.max_sz;
+	for (int i = 1; i <= blk->level; i++) {
+		block_size = WB_DN(block_size / 4);
+	}
+
+	return block_size - struct_blk_size;
+}
+
+static void shared_stats(struct mallinfo *info)
+{
+	struct sys_mem_pool_base *base = &z_malloc_mem_pool.base;
+	size_t lsz = base->max_sz;
+	sys_dnode_t *node;
+
+	sys_mutex_lock(&z_malloc_mem_pool.mutex, K_FOREVER);
+
+	for (int l = 0; l < base->n_levels; l++) {
+		if (l > 0) {
+			lsz = WB_DN(lsz / 4);
+		}
+
+		SYS_DLIST_FOR_EACH_NODE(&base->levels[l].free_list, node) {
+			info->ordblks++;
+			info->fordblks += lsz;
+			info->keepcost = MAX((size_t)info->keepcost, lsz);
+		}
+	}
+
+	sys_mutex_unlock(&z_malloc_mem_pool.mutex);
+}
+
+static void shared_init(void)
+{
+	sys_mem_pool_init(&z_malloc_mem_pool);
+}
+#endif /* CONFIG_MEM_POOL_HEAP_BACKEND */
+
+/* Bytes handed to the application by malloc(), and their peak */
+Z_GENERIC_SECTION(POOL_SECTION) atomic_t z_malloc_in_use;
+Z_GENERIC_SECTION(POOL_SECTION) atomic_t z_malloc_peak;
+
+static void account_alloc(size_t size)
+{
+	atomic_val_t in_use = atomic_add(&z_malloc_in_use, size) + size;
+	atomic_val_t peak = atomic_get(&z_malloc_peak);
+
+	while (in_use > peak && !atomic_cas(&z_malloc_peak, peak, in_use)) {
+		peak = atomic_get(&z_malloc_peak);
+	}
+}
+
+static void account_free(size_t size)
+{
+	(void)atomic_sub(&z_malloc_in_use, size);
+}
+
+#ifdef CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHE
+/*
+ * Thread caches.  This tree has no thread-local storage, so each thread
+ * uses the cache its thread ID hashes to; with enough caches, threads
+ * rarely share one, and the per-cache sys_mutex is then uncontended.
+ *
+ * A cache holds freed blocks in one bin per power-of-two size class up
+ * to CACHE_MAX_SIZE, linked through their first word.  A block is
+ * binned by its usable size, so a bin only ever hands out blocks at
+ * least as large as its class; misses allocate exactly the class size
+ * from the shared heap, so the blocks are reused.  Blocks larger than
+ * the shared heap returns for CACHE_MAX_SIZE go straight back to it.
+ *
+ * Memory goes back to the shared heap when a bin overflows (half of
+ * it), when the shared heap runs out (everything), on malloc_trim()
+ * and on periodic trims.  Rather than reading the clock, each cache
+ * counts its operations, and every
+ * CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHE_TRIM_OPS of them the thread
+ * that reached the count trims all caches, idle ones included: each
+ * bin gives back the blocks it did not need since the previous trim.
+ * The caches' locks are never held while taking the shared heap's.
+ */
+
+#define CACHE_MIN_SHIFT 4
+#define CACHE_CLASSES 5
+#define CACHE_MAX_SIZE BIT(CACHE_MIN_SHIFT + CACHE_CLASSES - 1)
+#define CLASS_SIZE(c) BIT(CACHE_MIN_SHIFT + (c))
+
+#define CACHE_BLOCKS CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHE_BLOCKS
+#define NUM_CACHES CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHES
+#define TRIM_OPS CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHE_TRIM_OPS
+
+BUILD_ASSERT(CLASS_SIZE(0) >= sizeof(void *));
+
+struct cache_bin {
+	void *head;
+	u8_t count;
+	/* Fewest blocks held since the last trim */
+	u8_t low;
+};
+
+struct malloc_cache {
+	struct sys_mutex mutex;
+	/* Operations since this cache last started a trim */
+	u32_t ops;
+	struct cache_bin bins[CACHE_CLASSES];
+};
+
+Z_GENERIC_SECTION(POOL_SECTION)
+	struct malloc_cache z_malloc_caches[NUM_CACHES];
+
+/* Usable size of the blocks the shared heap hands out for the largest
+ * class; larger blocks are never cached
+ */
+Z_GENERIC_SECTION(POOL_SECTION) size_t z_malloc_cache_max_usable;
+
+/* Smallest class holding @a size bytes; size <= CACHE_MAX_SIZE */
+static inline int alloc_class(size_t size)
+{
+	if (size <= CLASS_SIZE(0)) {
+		return 0;
+	}
+
+	return find_msb_set(size - 1) - CACHE_MIN_SHIFT;
+}
+
+/* Largest class a block of @a size usable bytes can serve, or -1 */
+static inline int free_class(size_t size)
+{
+	if (size < CLASS_SIZE(0) || size > z_malloc_cache_max_usable) {
+		return -1;
+	}
+
+	return MIN(find_msb_set(size) - 1 - CACHE_MIN_SHIFT,
+		   CACHE_CLASSES - 1);
+}
+
+static struct malloc_cache *current_cache(void)
+{
+	u32_t tid;
+
+	/* User threads can name themselves without a syscall */
+#ifdef CONFIG_USER_CURRENT_THREAD
+	if (_is_user_context()) {
+		tid = (u32_t)(uintptr_t)z_user_current;
+	} else
+#endif
+	{
+		tid = (u32_t)(uintptr_t)k_current_get();
+	}
+
+	/* Thread structs are large and often adjacent, so spread the
+	 * whole address instead of taking its low bits
+	 */
+	return &z_malloc_caches[((tid * 2654435761U) >> 16) % NUM_CACHES];
+}
+
+static inline void *bin_pop(struct cache_bin *bin)
+{
+	void *block = bin->head;
+
+	bin->head = *(void **)block;
+	bin->count--;
+	if (bin->count < bin->low) {
+		bin->low = bin->count;
+	}
+
+	return block;
+}
+
+static inline void bin_push(struct cache_bin *bin, void *block)
+{
+	*(void **)block = bin->head;
+	bin->head = block;
+	bin->count++;
+}
+
+/* Moves @a n blocks of @a bin onto the list at @a released */
+static void bin_release(struct cache_bin *bin, int n, void **released)
+{
+	while (n-- > 0) {
+		void *block = bin_pop(bin);
+
+		*(void **)block = *released;
+		*released = block;
+	}
+}
+
+static void release(void *released)
+{
+	while (released != NULL) {
+		void *next = *(void **)released;
+
+		shared_free(released);
+		released = next;
+	}
+}
+
+/* Counts an operation on @a cache, returning true when it is time to
+ * trim.  Called with the cache locked.
+ */
+static inline bool cache_count_op(struct malloc_cache *cache)
+{
+	if (++cache->ops < TRIM_OPS) {
+		return false;
+	}
+
+	cache->ops = 0U;
+
+	return true;
+}
+
+/* Releases the blocks each bin of each cache kept unused since the
+ * last trim
+ */
+static void cache_trim_all(void)
+{
+	for (int i = 0; i < NUM_CACHES; i++) {
+		struct malloc_cache *cache = &z_malloc_caches[i];
+		void *released = NULL;
+
+		sys_mutex_lock(&cache->mutex, K_FOREVER);
+		for (int c = 0; c < CACHE_CLASSES; c++) {
+			struct cache_bin *bin = &cache->bins[c];
+
+			bin_release(bin, bin->low, &released);
+			bin->low = bin->count;
+		}
+		sys_mutex_unlock(&cache->mutex);
+
+		release(released);
+	}
+}
+
+static void *cache_alloc(int c)
+{
+	struct malloc_cache *cache = current_cache();
+	struct cache_bin *bin = &cache->bins[c];
+	void *ret = NULL;
+	bool trim;
+
+	sys_mutex_lock(&cache->mutex, K_FOREVER);
+	if (bin->head != NULL) {
+		ret = bin_pop(bin);
+	}
+	trim = cache_count_op(cache);
+	sys_mutex_unlock(&cache->mutex);
+
+	if (trim) {
+		cache_trim_all();
+	}
+
+	return ret;
+}
+
+static bool cache_free(void *ptr, size_t size)
+{
+	int c = free_class(size);
+	struct malloc_cache *cache;
+	struct cache_bin *bin;
+	void *released = NULL;
+	bool trim;
+
+	if (c < 0) {
+		return false;
+	}
+
+	cache = current_cache();
+	bin = &cache->bins[c];
+
+	sys_mutex_lock(&cache->mutex, K_FOREVER);
+	if (bin->count >= CACHE_BLOCKS) {
+		bin_release(bin, CACHE_BLOCKS / 2, &released);
+	}
+	bin_push(bin, ptr);
+	trim = cache_count_op(cache);
+	sys_mutex_unlock(&cache->mutex);
+
+	release(released);
+
+	if (trim) {
+		cache_trim_all();
+	}
+
+	return true;
+}
+
+static void cache_flush_all(void)
+{
+	for (int i = 0; i < NUM_CACHES; i++) {
+		struct malloc_cache *cache = &z_malloc_caches[i];
+		void *released = NULL;
+
+		sys_mutex_lock(&cache->mutex, K_FOREVER);
+		for (int c = 0; c < CACHE_CLASSES; c++) {
+			struct cache_bin *bin = &cache->bins[c];
+
+			bin_release(bin, bin->count, &released);
+			bin->low = 0U;
+		}
+		sys_mutex_unlock(&cache->mutex);
+
+		release(released);
+	}
+}
+
+static void cache_stats(struct mallinfo *info)
+{
+	for (int i = 0; i < NUM_CACHES; i++) {
+		struct malloc_cache *cache = &z_malloc_caches[i];
+
+		sys_mutex_lock(&cache->mutex, K_FOREVER);
+		for (int c = 0; c < CACHE_CLASSES; c++) {
+			info->smblks += cache->bins[c].count;
+			info->fsmblks += cache->bins[c].count * CLASS_SIZE(c);
+		}
+		sys_mutex_unlock(&cache->mutex);
+	}
+}
+
+static void cache_init(void)
+{
+	void *probe;
+
+	for (int i = 0; i < NUM_CACHES; i++) {
+		sys_mutex_init(&z_malloc_caches[i].mutex);
+	}
+
+	/* The backends round requests up, so measure how far */
+	probe = shared_alloc(CACHE_MAX_SIZE);
+	if (probe != NULL) {
+		z_malloc_cache_max_usable = usable_size(probe);
+		shared_free(probe);
+	}
+}
+
+static void *shared_alloc_or_flush(size_t size)
+{
+	void *ret = shared_alloc(size);
+
+	if (ret == NULL) {
+		cache_flush_all();
+		ret = shared_alloc(size);
+	}
+
+	return ret;
+}
+
 void *malloc(size_t size)
 {
 	void *ret;
 
-	ret = sys_mem_pool_alloc(&z_malloc_mem_pool, size);
+	if (size <= CACHE_MAX_SIZE) {
+		int c = alloc_class(size);
+
+		ret = cache_alloc(c);
+		if (ret == NULL) {
+			ret = shared_alloc_or_flush(CLASS_SIZE(c));
+		}
+	} else {
+		ret = shared_alloc_or_flush(size);
+	}
+
 	if (ret == NULL) {
 		errno = ENOMEM;
+		return NULL;
 	}
 
+	account_alloc(usable_size(ret));
+
 	return ret;
 }
 
+void free(void *ptr)
+{
+	size_t size;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	size = usable_size(ptr);
+	account_free(size);
+
+	if (!cache_free(ptr, size)) {
+		shared_free(ptr);
+	}
+}
+
+int malloc_trim(size_t pad)
+{
+	ARG_UNUSED(pad);
+
+	cache_flush_all();
+
+	return 1;
+}
+#else
+static inline void cache_stats(struct mallinfo *info)
+{
+	ARG_UNUSED(info);
+}
+
+static inline void cache_init(void)
+{
+}
+
+void *malloc(size_t size)
+{
+	void *ret;
+
+	ret = shared_alloc(size);
+	if (ret == NULL) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	account_alloc(usable_size(ret));
+
+	return ret;
+}
+
+void free(void *ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+
+	account_free(usable_size(ptr));
+	shared_free(ptr);
+}
+
+int malloc_trim(size_t pad)
+{
+	ARG_UNUSED(pad);
+
+	return 0;
+}
+#endif /* CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHE */
+
+struct mallinfo mallinfo(void)
+{
+	struct mallinfo info = { 0 };
+
+	info.arena = CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE;
+	info.uordblks = atomic_get(&z_malloc_in_use);
+	info.usmblks = atomic_get(&z_malloc_peak);
+	shared_stats(&info);
+	cache_stats(&info);
+
+	return info;
+}
+
 static int malloc_prepare(struct device *unused)
 {
 	ARG_UNUSED(unused);
 
-	sys_mem_pool_init(&z_malloc_mem_pool);
+	shared_init();
+	cache_init();
 
 	return 0;
 }
@@ -60,13 +577,34 @@ void *malloc(size_t size)
 
 	return NULL;
 }
-#endif
 
 void free(void *ptr)
 {
-	sys_mem_pool_free(ptr);
+	ARG_UNUSED(ptr);
+}
+
+static size_t usable_size(void *ptr)
+{
+	ARG_UNUSED(ptr);
+
+	return 0;
 }
 
+struct mallinfo mallinfo(void)
+{
+	struct mallinfo info = { 0 };
+
+	return info;
+}
+
+int malloc_trim(size_t pad)
+{
+	ARG_UNUSED(pad);
+
+	return 0;
+}
+#endif
+
 void *calloc(size_t nmemb, size_t size)
 {
 	void *ret;
@@ -87,9 +625,7 @@ void *calloc(size_t nmemb, size_t size)
 
 void *realloc(void *ptr, size_t requested_size)
 {
-	struct sys_mem_pool_block *blk;
-	size_t struct_blk_size = WB_UP(sizeof(struct sys_mem_pool_block));
-	size_t block_size, total_requested_size;
+	size_t block_size;
 	void *new_ptr;
 
 	if (ptr == NULL) {
@@ -101,21 +637,9 @@ void *realloc(void *ptr, size_t requested_size)
 		return NULL;
 	}
 
-	/* Stored right before the pointer passed to the user */
-	blk = (struct sys_mem_pool_block *)((char *)ptr - struct_blk_size);
-
-	/* Determine size of previously allocated block by its level.
-	 * Most likely a bit larger than the original allocation
-	 */
-	block_size = blk->pool->base.max_sz;
-	for (int i = 1; i <= blk->level; i++) {
-		block_size = WB_DN(block_size / 4);
-	}
-
-	/* We really need this much memory */
-	total_requested_size = requested_size + struct_blk_size;
+	block_size = usable_size(ptr);
 
-	if (block_size >= total_requested_size) {
+	if (block_size >= requested_size) {
 		/* Existing block large enough, nothing to do */
 		return ptr;
 	}
@@ -125,13 +649,12 @@ void *realloc(void *ptr, size_t requested_size)
 		return NULL;
 	}
 
-	memcpy(new_ptr, ptr, block_size - struct_blk_size);
+	memcpy(new_ptr, ptr, block_size);
 	free(ptr);
 
 	return new_ptr;
 }
 
-
 void *reallocarray(void *ptr, size_t nmemb, size_t size)
 {
 	if (size_mul_overflow(nmemb, size, &size)) {
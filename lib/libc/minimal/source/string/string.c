@@ -10,6 +10,37 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+/*
+ * Word-at-a-time helpers.  Strings and buffers are read one aligned
+ * mem_word_t at a time where possible; an aligned word never straddles
+ * a page or MPU region boundary, so reading a whole word that holds the
+ * terminating byte is safe even if the bytes after it are not part of
+ * the object.
+ */
+
+typedef mem_word_t __attribute__((__may_alias__)) word_t;
+
+#define WORD_SIZE sizeof(mem_word_t)
+#define WORD_MASK ((uintptr_t)(WORD_SIZE - 1))
+
+/* 0x01 and 0x80 repeated in every byte of a word */
+#define ONES ((mem_word_t)-1 / 0xFF)
+#define HIGHS (ONES << 7)
+
+/* Non-zero iff some byte of w is zero */
+#define HAS_ZERO(w) (((w) - ONES) & ~(w) & HIGHS)
+
+#if defined(CONFIG_MINIMAL_LIBC_STRING_ASM) && defined(CONFIG_X86)
+#define STRING_REP_MOVSB
+#elif defined(CONFIG_MINIMAL_LIBC_STRING_ASM) && defined(CONFIG_ARM)
+#define STRING_LDM_STM
+#endif
+
+static inline mem_word_t word_repeat(unsigned char c)
+{
+	return ONES * c;
+}
+
 /**
  *
  * @brief Copy a string
@@ -106,14 +137,31 @@ char *strrchr(const char *s, int c)
 
 size_t strlen(const char *s)
 {
-	size_t n = 0;
+	const char *p = s;
+	const word_t *w;
 
-	while (*s != '\0') {
-		s++;
-		n++;
+	/* do byte-sized scanning until word-aligned */
+
+	while (((uintptr_t)p & WORD_MASK) != 0) {
+		if (*p == '\0') {
+			return p - s;
+		}
+		p++;
 	}
 
-	return n;
+	/* do word-sized scanning until a word holds the terminator */
+
+	w = (const word_t *)p;
+	while (!HAS_ZERO(*w)) {
+		w++;
+	}
+
+	p = (const char *)w;
+	while (*p != '\0') {
+		p++;
+	}
+
+	return p - s;
 }
 
 /**
@@ -144,6 +192,32 @@ size_t strnlen(const char *s, size_t maxlen)
 
 int strcmp(const char *s1, const char *s2)
 {
+	/* compare word by word only if both strings have identical alignment */
+
+	if ((((uintptr_t)s1 ^ (uintptr_t)s2) & WORD_MASK) == 0) {
+		const word_t *w1, *w2;
+
+		while (((uintptr_t)s1 & WORD_MASK) != 0) {
+			if ((*s1 != *s2) || (*s1 == '\0')) {
+				return *s1 - *s2;
+			}
+			s1++;
+			s2++;
+		}
+
+		w1 = (const word_t *)s1;
+		w2 = (const word_t *)s2;
+		while ((*w1 == *w2) && !HAS_ZERO(*w1)) {
+			w1++;
+			w2++;
+		}
+
+		/* the differing or terminating byte is in this word */
+
+		s1 = (const char *)w1;
+		s2 = (const char *)w2;
+	}
+
 	while ((*s1 == *s2) && (*s1 != '\0')) {
 		s1++;
 		s2++;
@@ -236,6 +310,9 @@ void *memmove(void *d, const void *s, size_t n)
 			n--;
 			dest[n] = src[n];
 		}
+	} else if ((size_t) (src - dest) >= n) {
+		/* The buffers do not overlap at all */
+		(void)memcpy(dest, src, n);
 	} else {
 		/* It is safe to perform a forward-copy */
 		while (n > 0) {
@@ -249,6 +326,98 @@ void *memmove(void *d, const void *s, size_t n)
 	return d;
 }
 
+#ifdef STRING_LDM_STM
+/* Copy 16 bytes at a time through r3-r6, which are low registers and in
+ * ascending order as ldm/stm require, so this also assembles for Thumb-1.
+ */
+static inline void copy_blocks(word_t **d_word, const word_t **s_word,
+			       size_t *n)
+{
+	word_t *dst = *d_word;
+	const word_t *src = *s_word;
+
+	while (*n >= 4 * WORD_SIZE) {
+		__asm__ volatile("ldmia %1!, {r3-r6}\n\t"
+				 "stmia %0!, {r3-r6}"
+				 : "+l" (dst), "+l" (src)
+				 :
+				 : "r3", "r4", "r5", "r6", "memory");
+		*n -= 4 * WORD_SIZE;
+	}
+
+	*d_word = dst;
+	*s_word = src;
+}
+
+static inline void fill_blocks(word_t **d_word, mem_word_t c_word, size_t *n)
+{
+	word_t *dst = *d_word;
+
+	while (*n >= 4 * WORD_SIZE) {
+		__asm__ volatile("mov r3, %1\n\t"
+				 "mov r4, %1\n\t"
+				 "mov r5, %1\n\t"
+				 "mov r6, %1\n\t"
+				 "stmia %0!, {r3-r6}"
+				 : "+l" (dst)
+				 : "l" (c_word)
+				 : "r3", "r4", "r5", "r6", "memory");
+		*n -= 4 * WORD_SIZE;
+	}
+
+	*d_word = dst;
+}
+#else
+static inline void copy_blocks(word_t **d_word, const word_t **s_word,
+			       size_t *n)
+{
+	word_t *dst = *d_word;
+	const word_t *src = *s_word;
+
+	while (*n >= 4 * WORD_SIZE) {
+		dst[0] = src[0];
+		dst[1] = src[1];
+		dst[2] = src[2];
+		dst[3] = src[3];
+		dst += 4;
+		src += 4;
+		*n -= 4 * WORD_SIZE;
+	}
+
+	*d_word = dst;
+	*s_word = src;
+}
+
+static inline void fill_blocks(word_t **d_word, mem_word_t c_word, size_t *n)
+{
+	word_t *dst = *d_word;
+
+	while (*n >= 4 * WORD_SIZE) {
+		dst[0] = c_word;
+		dst[1] = c_word;
+		dst[2] = c_word;
+		dst[3] = c_word;
+		dst += 4;
+		*n -= 4 * WORD_SIZE;
+	}
+
+	*d_word = dst;
+}
+#endif /* STRING_LDM_STM */
+
+/* Combine the tail of word <lo> and the head of word <hi>, <shift> bits
+ * into <lo>, giving the word that starts that many bits into <lo>.
+ */
+static inline mem_word_t merge_words(mem_word_t lo, mem_word_t hi,
+				     unsigned int shift)
+{
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	return (lo << shift) | (hi >> (Z_MEM_WORD_T_WIDTH - shift));
+#else
+	return (lo >> shift) | (hi << (Z_MEM_WORD_T_WIDTH - shift));
+#endif
+}
+
 /**
  *
  * @brief Copy bytes in memory
@@ -258,36 +427,68 @@ void *memmove(void *d, const void *s, size_t n)
 
 void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 {
-	/* attempt word-sized copying only if buffers have identical alignment */
+#ifdef STRING_REP_MOVSB
+	void *dest = d;
+
+	__asm__ volatile("rep movsb"
+			 : "+D" (dest), "+S" (s), "+c" (n)
+			 :
+			 : "memory");
 
+	return d;
+#else
 	unsigned char *d_byte = (unsigned char *)d;
 	const unsigned char *s_byte = (const unsigned char *)s;
-	const uintptr_t mask = sizeof(mem_word_t) - 1;
 
-	if ((((uintptr_t)d ^ (uintptr_t)s_byte) & mask) == 0) {
+	/* short copies are not worth aligning for */
 
-		/* do byte-sized copying until word-aligned or finished */
+	if (n >= 2 * WORD_SIZE) {
 
-		while (((uintptr_t)d_byte) & mask) {
-			if (n == 0) {
-				return d;
-			}
+		/* do byte-sized copying until the destination is word-aligned */
+
+		while (((uintptr_t)d_byte) & WORD_MASK) {
 			*(d_byte++) = *(s_byte++);
 			n--;
-		};
+		}
+
+		word_t *d_word = (word_t *)d_byte;
+		uintptr_t offset = (uintptr_t)s_byte & WORD_MASK;
+
+		if (offset == 0) {
+			/* identical alignment: copy whole words */
 
-		/* do word-sized copying as long as possible */
+			const word_t *s_word = (const word_t *)s_byte;
 
-		mem_word_t *d_word = (mem_word_t *)d_byte;
-		const mem_word_t *s_word = (const mem_word_t *)s_byte;
+			copy_blocks(&d_word, &s_word, &n);
 
-		while (n >= sizeof(mem_word_t)) {
-			*(d_word++) = *(s_word++);
-			n -= sizeof(mem_word_t);
+			while (n >= WORD_SIZE) {
+				*(d_word++) = *(s_word++);
+				n -= WORD_SIZE;
+			}
+
+			s_byte = (const unsigned char *)s_word;
+		} else {
+			/*
+			 * Read aligned source words and shift each pair into
+			 * one destination word.  Only the words holding the
+			 * bytes being copied are read.
+			 */
+
+			const word_t *s_word = (const word_t *)(s_byte - offset);
+			unsigned int shift = offset * 8U;
+			mem_word_t lo = *s_word, hi;
+
+			while (n >= WORD_SIZE) {
+				hi = *(++s_word);
+				*(d_word++) = merge_words(lo, hi, shift);
+				lo = hi;
+				n -= WORD_SIZE;
+			}
+
+			s_byte = (const unsigned char *)s_word + offset;
 		}
 
 		d_byte = (unsigned char *)d_word;
-		s_byte = (unsigned char *)s_word;
 	}
 
 	/* do byte-sized copying until finished */
@@ -298,6 +499,7 @@ void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 	}
 
 	return d;
+#endif /* STRING_REP_MOVSB */
 }
 
 /**
@@ -309,45 +511,52 @@ void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 
 void *memset(void *buf, int c, size_t n)
 {
-	/* do byte-sized initialization until word-aligned or finished */
+#ifdef STRING_REP_MOVSB
+	void *dest = buf;
+
+	__asm__ volatile("rep stosb"
+			 : "+D" (dest), "+c" (n)
+			 : "a" (c)
+			 : "memory");
 
+	return buf;
+#else
 	unsigned char *d_byte = (unsigned char *)buf;
 	unsigned char c_byte = (unsigned char)c;
 
-	while (((uintptr_t)d_byte) & (sizeof(mem_word_t) - 1)) {
-		if (n == 0) {
-			return buf;
+	if (n >= 2 * WORD_SIZE) {
+
+		/* do byte-sized initialization until word-aligned */
+
+		while (((uintptr_t)d_byte) & WORD_MASK) {
+			*(d_byte++) = c_byte;
+			n--;
 		}
-		*(d_byte++) = c_byte;
-		n--;
-	};
 
-	/* do word-sized initialization as long as possible */
+		/* do word-sized initialization as long as possible */
 
-	mem_word_t *d_word = (mem_word_t *)d_byte;
-	mem_word_t c_word = (mem_word_t)c_byte;
+		word_t *d_word = (word_t *)d_byte;
+		mem_word_t c_word = word_repeat(c_byte);
 
-	c_word |= c_word << 8;
-	c_word |= c_word << 16;
-#if Z_MEM_WORD_T_WIDTH > 32
-	c_word |= c_word << 32;
-#endif
+		fill_blocks(&d_word, c_word, &n);
 
-	while (n >= sizeof(mem_word_t)) {
-		*(d_word++) = c_word;
-		n -= sizeof(mem_word_t);
+		while (n >= WORD_SIZE) {
+			*(d_word++) = c_word;
+			n -= WORD_SIZE;
+		}
+
+		d_byte = (unsigned char *)d_word;
 	}
 
 	/* do byte-sized initialization until finished */
 
-	d_byte = (unsigned char *)d_word;
-
 	while (n > 0) {
 		*(d_byte++) = c_byte;
 		n--;
 	}
 
 	return buf;
+#endif /* STRING_REP_MOVSB */
 }
 
 /**
@@ -359,15 +568,36 @@ void *memset(void *buf, int c, size_t n)
 
 void *memchr(const void *s, int c, size_t n)
 {
-	if (n != 0) {
-		const unsigned char *p = s;
+	const unsigned char *p = s;
+	unsigned char c_byte = (unsigned char)c;
 
-		do {
-			if (*p++ == (unsigned char)c) {
-				return ((void *)(p - 1));
-			}
+	/* do byte-sized scanning until word-aligned */
 
-		} while (--n != 0);
+	while ((((uintptr_t)p) & WORD_MASK) && (n > 0)) {
+		if (*p == c_byte) {
+			return (void *)p;
+		}
+		p++;
+		n--;
+	}
+
+	/* do word-sized scanning until a word holds the byte */
+
+	const word_t *w = (const word_t *)p;
+	mem_word_t c_word = word_repeat(c_byte);
+
+	while ((n >= WORD_SIZE) && !HAS_ZERO(*w ^ c_word)) {
+		w++;
+		n -= WORD_SIZE;
+	}
+
+	p = (const unsigned char *)w;
+	while (n > 0) {
+		if (*p == c_byte) {
+			return (void *)p;
+		}
+		p++;
+		n--;
 	}
 
 	return NULL;
@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/sys_heap.h>
+#include <sys/__assert.h>
+#include <sys/util.h>
+#include <string.h>
+#include <toolchain.h>
+#include <arch/cpu.h>
+
+/* Two-Level Segregated Fit allocator.
+ *
+ * Every block starts with a header holding its payload size, with
+ * the two low bits (always zero, since sizes are word multiples)
+ * used as "this block is free" and "previous physical block is
+ * free" flags.  Free blocks additionally store their free list
+ * links in the first two payload words, and the last payload word
+ * of a free block doubles as the prev_phys pointer of the next
+ * header, which is what makes merging with the left neighbour
+ * O(1).  The effective overhead of an allocated block is therefore
+ * just the size word.
+ *
+ * Free blocks are binned by size: the first level is the power of
+ * two class (find_msb_set() of the size), the second level splits
+ * each class linearly into Z_HEAP_SL_COUNT lists.  Sizes below
+ * SMALL_BLOCK all live in first-level list 0 with a fixed step.  A
+ * bitmap per level records which lists are non-empty so that
+ * finding a suitable list is two bit scans.
+ */
+
+#define ALIGN_SIZE	sizeof(void *)
+#define ALIGN_LOG2	(sizeof(void *) == 8 ? 3 : 2)
+#define SL_LOG2		Z_HEAP_SL_LOG2
+#define SL_COUNT	Z_HEAP_SL_COUNT
+#define FL_SHIFT	(SL_LOG2 + ALIGN_LOG2)
+#define SMALL_BLOCK	(1 << FL_SHIFT)
+
+#define BLOCK_FREE	BIT(0)
+#define BLOCK_PREV_FREE	BIT(1)
+#define BLOCK_FLAGS	(BLOCK_FREE | BLOCK_PREV_FREE)
+
+struct block {
+	/* Valid only if BLOCK_PREV_FREE is set; lives in the last
+	 * payload word of the previous block.
+	 */
+	struct block *prev_phys;
+	size_t size;
+	/* Valid only if BLOCK_FREE is set */
+	struct block *next_free;
+	struct block *prev_free;
+};
+
+#define BLOCK_OVERHEAD	sizeof(size_t)
+#define BLOCK_START	offsetof(struct block, next_free)
+#define BLOCK_SIZE_MIN	(sizeof(struct block) - sizeof(struct block *))
+
+struct z_heap {
+	u32_t fl_bitmap;
+	u32_t fl_count;
+	size_t allocated_bytes;
+	size_t max_allocated_bytes;
+	struct block *first;
+	/* followed by u32_t sl_bitmap[fl_count] and
+	 * struct block *free[fl_count][SL_COUNT]
+	 */
+};
+
+static inline u32_t *sl_bitmap(struct z_heap *z)
+{
+	return (u32_t *)(z + 1);
+}
+
+static inline struct block **free_list(struct z_heap *z, int fl, int sl)
+{
+	struct block **lists =
+		(struct block **)ROUND_UP(&sl_bitmap(z)[z->fl_count],
+					  sizeof(void *));
+
+	return &lists[fl * SL_COUNT + sl];
+}
+
+static inline size_t block_size(struct block *b)
+{
+	return b->size & ~(size_t)BLOCK_FLAGS;
+}
+
+static inline bool block_is_free(struct block *b)
+{
+	return (b->size & BLOCK_FREE) != 0;
+}
+
+static inline bool block_prev_is_free(struct block *b)
+{
+	return (b->size & BLOCK_PREV_FREE) != 0;
+}
+
+static inline void *block_to_ptr(struct block *b)
+{
+	return (u8_t *)b + BLOCK_START;
+}
+
+static inline struct block *block_from_ptr(void *ptr)
+{
+	return (struct block *)((u8_t *)ptr - BLOCK_START);
+}
+
+static inline struct block *block_next(struct block *b)
+{
+	return (struct block *)((u8_t *)block_to_ptr(b) + block_size(b)
+				- BLOCK_OVERHEAD);
+}
+
+static struct block *block_link_next(struct block *b)
+{
+	struct block *next = block_next(b);
+
+	next->prev_phys = b;
+	return next;
+}
+
+static void block_mark_free(struct block *b)
+{
+	struct block *next = block_link_next(b);
+
+	next->size |= BLOCK_PREV_FREE;
+	b->size |= BLOCK_FREE;
+}
+
+static void block_mark_used(struct block *b)
+{
+	struct block *next = block_next(b);
+
+	next->size &= ~(size_t)BLOCK_PREV_FREE;
+	b->size &= ~(size_t)BLOCK_FREE;
+}
+
+/* Size class containing a block of exactly @a size bytes */
+static void mapping_insert(size_t size, int *fl, int *sl)
+{
+	if (size < SMALL_BLOCK) {
+		*fl = 0;
+		*sl = size / (SMALL_BLOCK / SL_COUNT);
+	} else {
+		int msb = find_msb_set(size) - 1;
+
+		*sl = (size >> (msb - SL_LOG2)) ^ SL_COUNT;
+		*fl = msb - (FL_SHIFT - 1);
+	}
+}
+
+/* First size class whose every block can hold @a size bytes */
+static void mapping_search(size_t size, int *fl, int *sl)
+{
+	if (size >= SMALL_BLOCK) {
+		int msb = find_msb_set(size) - 1;
+
+		size += (1 << (msb - SL_LOG2)) - 1;
+	}
+	mapping_insert(size, fl, sl);
+}
+
+static struct block *find_suitable(struct z_heap *z, int *fl, int *sl)
+{
+	u32_t sl_map = sl_bitmap(z)[*fl] & (~0U << *sl);
+
+	if (sl_map == 0U) {
+		u32_t fl_map = *fl + 1 < 32 ? z->fl_bitmap & (~0U << (*fl + 1))
+					    : 0U;
+
+		if (fl_map == 0U) {
+			return NULL;
+		}
+
+		*fl = find_lsb_set(fl_map) - 1;
+		sl_map = sl_bitmap(z)[*fl];
+	}
+
+	*sl = find_lsb_set(sl_map) - 1;
+
+	return *free_list(z, *fl, *sl);
+}
+
+static void remove_free_block(struct z_heap *z, struct block *b,
+			      int fl, int sl)
+{
+	struct block *prev = b->prev_free;
+	struct block *next = b->next_free;
+	struct block **head = free_list(z, fl, sl);
+
+	if (next != NULL) {
+		next->prev_free = prev;
+	}
+	if (prev != NULL) {
+		prev->next_free = next;
+	}
+
+	if (*head == b) {
+		*head = next;
+		if (next == NULL) {
+			sl_bitmap(z)[fl] &= ~BIT(sl);
+			if (sl_bitmap(z)[fl] == 0U) {
+				z->fl_bitmap &= ~BIT(fl);
+			}
+		}
+	}
+}
+
+static void insert_free_block(struct z_heap *z, struct block *b,
+			      int fl, int sl)
+{
+	struct block **head = free_list(z, fl, sl);
+
+	b->next_free = *head;
+	b->prev_free = NULL;
+	if (*head != NULL) {
+		(*head)->prev_free = b;
+	}
+	*head = b;
+
+	sl_bitmap(z)[fl] |= BIT(sl);
+	z->fl_bitmap |= BIT(fl);
+}
+
+static void block_remove(struct z_heap *z, struct block *b)
+{
+	int fl, sl;
+
+	mapping_insert(block_size(b), &fl, &sl);
+	remove_free_block(z, b, fl, sl);
+}
+
+static void block_insert(struct z_heap *z, struct block *b)
+{
+	int fl, sl;
+
+	mapping_insert(block_size(b), &fl, &sl);
+	insert_free_block(z, b, fl, sl);
+}
+
+/* Absorb @a b into its left neighbour @a prev */
+static struct block *block_absorb(struct block *prev, struct block *b)
+{
+	prev->size += block_size(b) + BLOCK_OVERHEAD;
+	(void)block_link_next(prev);
+
+	return prev;
+}
+
+static struct block *merge_prev(struct z_heap *z, struct block *b)
+{
+	if (block_prev_is_free(b)) {
+		struct block *prev = b->prev_phys;
+
+		block_remove(z, prev);
+		b = block_absorb(prev, b);
+	}
+
+	return b;
+}
+
+static struct block *merge_next(struct z_heap *z, struct block *b)
+{
+	struct block *next = block_next(b);
+
+	if (block_is_free(next)) {
+		block_remove(z, next);
+		b = block_absorb(b, next);
+	}
+
+	return b;
+}
+
+/* Give back the tail of free block @a b beyond @a size bytes */
+static void trim_free(struct z_heap *z, struct block *b, size_t size)
+{
+	struct block *rest;
+
+	if (block_size(b) < size + sizeof(struct block)) {
+		return;
+	}
+
+	rest = (struct block *)((u8_t *)block_to_ptr(b) + size
+				- BLOCK_OVERHEAD);
+	rest->size = block_size(b) - (size + BLOCK_OVERHEAD);
+	b->size = size | (b->size & BLOCK_FLAGS);
+
+	/* @a b is still marked free here; the caller marks it used,
+	 * which clears BLOCK_PREV_FREE on @a rest again.
+	 */
+	block_mark_free(rest);
+	(void)block_link_next(b);
+	rest->size |= BLOCK_PREV_FREE;
+	block_insert(z, rest);
+}
+
+static size_t adjust_request(size_t bytes)
+{
+	size_t size = ROUND_UP(bytes, ALIGN_SIZE);
+
+	return MAX(size, BLOCK_SIZE_MIN);
+}
+
+void *sys_heap_alloc(struct sys_heap *h, size_t bytes)
+{
+	struct z_heap *z = h->heap;
+	struct block *b;
+	size_t size;
+	int fl, sl;
+
+	/* Size classes are computed on 32 bits; anything this large
+	 * can't fit anyway.
+	 */
+	if (bytes > (UINT32_MAX >> 1)) {
+		return NULL;
+	}
+
+	size = adjust_request(bytes);
+	mapping_search(size, &fl, &sl);
+	if (fl >= z->fl_count) {
+		return NULL;
+	}
+
+	b = find_suitable(z, &fl, &sl);
+	if (b == NULL) {
+		return NULL;
+	}
+
+	remove_free_block(z, b, fl, sl);
+	trim_free(z, b, size);
+	block_mark_used(b);
+
+	z->allocated_bytes += block_size(b);
+	if (z->allocated_bytes > z->max_allocated_bytes) {
+		z->max_allocated_bytes = z->allocated_bytes;
+	}
+
+	return block_to_ptr(b);
+}
+
+void sys_heap_free(struct sys_heap *h, void *mem)
+{
+	struct z_heap *z = h->heap;
+	struct block *b;
+
+	if (mem == NULL) {
+		return;
+	}
+
+	b = block_from_ptr(mem);
+	__ASSERT(!block_is_free(b), "double free of %p", mem);
+
+	z->allocated_bytes -= block_size(b);
+
+	block_mark_free(b);
+	b = merge_prev(z, b);
+	b = merge_next(z, b);
+	block_insert(z, b);
+}
+
+size_t sys_heap_usable_size(struct sys_heap *h, void *mem)
+{
+	ARG_UNUSED(h);
+
+	return block_size(block_from_ptr(mem));
+}
+
+void sys_heap_init(struct sys_heap *h, void *mem, size_t bytes)
+{
+	uintptr_t addr = ROUND_UP(mem, ALIGN_SIZE);
+	uintptr_t end = ROUND_DOWN((uintptr_t)mem + bytes, ALIGN_SIZE);
+	struct z_heap *z = (struct z_heap *)addr;
+	struct block *b, *sentinel;
+	uintptr_t start;
+	int fl, sl;
+
+	__ASSERT(bytes <= UINT32_MAX, "heap too large");
+
+	mapping_insert(end - addr, &fl, &sl);
+	z->fl_bitmap = 0U;
+	z->fl_count = fl + 1;
+	z->allocated_bytes = 0;
+	z->max_allocated_bytes = 0;
+
+	start = (uintptr_t)free_list(z, z->fl_count, 0);
+	(void)memset(sl_bitmap(z), 0, start - (uintptr_t)sl_bitmap(z));
+
+	__ASSERT(end > start && end - start >= 2 * BLOCK_OVERHEAD
+		 + BLOCK_SIZE_MIN, "heap buffer too small");
+
+	/* The first header's prev_phys overlaps the free list index,
+	 * which is fine: BLOCK_PREV_FREE is never set on it.
+	 */
+	b = (struct block *)(start - BLOCK_OVERHEAD);
+	b->size = ROUND_DOWN(end - start - 2 * BLOCK_OVERHEAD, ALIGN_SIZE);
+	z->first = b;
+
+	/* Zero-sized, permanently used sentinel terminating the
+	 * physical block chain, so merge_next() needs no bounds check.
+	 */
+	sentinel = block_link_next(b);
+	sentinel->size = 0;
+
+	block_mark_free(b);
+	block_insert(z, b);
+
+	h->heap = z;
+	h->init_mem = mem;
+	h->init_bytes = bytes;
+}
+
+void sys_heap_stats_get(struct sys_heap *h, struct sys_heap_stats *stats)
+{
+	struct z_heap *z = h->heap;
+
+	(void)memset(stats, 0, sizeof(*stats));
+	stats->allocated_bytes = z->allocated_bytes;
+	stats->max_allocated_bytes = z->max_allocated_bytes;
+
+	for (struct block *b = z->first; block_size(b) != 0;
+	     b = block_next(b)) {
+		if (block_is_free(b)) {
+			stats->free_bytes += block_size(b);
+			stats->max_free_bytes = MAX(stats->max_free_bytes,
+						    block_size(b));
+			stats->free_blocks++;
+		}
+	}
+}
+
+static bool in_free_list(struct z_heap *z, struct block *b)
+{
+	int fl, sl;
+
+	mapping_insert(block_size(b), &fl, &sl);
+	for (struct block *f = *free_list(z, fl, sl); f != NULL;
+	     f = f->next_free) {
+		if (f == b) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool sys_heap_validate(struct sys_heap *h)
+{
+	struct z_heap *z = h->heap;
+	u32_t nfree = 0U, nlisted = 0U;
+	size_t allocated = 0;
+	bool prev_free = false;
+	struct block *b;
+
+	for (b = z->first; block_size(b) != 0; b = block_next(b)) {
+		if (block_prev_is_free(b) != prev_free) {
+			return false;
+		}
+		if (block_is_free(b)) {
+			/* Free neighbours must always have been merged */
+			if (prev_free || !in_free_list(z, b)) {
+				return false;
+			}
+			if (block_next(b)->prev_phys != b) {
+				return false;
+			}
+			nfree++;
+		} else {
+			allocated += block_size(b);
+		}
+		prev_free = block_is_free(b);
+	}
+
+	if (block_prev_is_free(b) != prev_free ||
+	    allocated != z->allocated_bytes) {
+		return false;
+	}
+
+	for (int fl = 0; fl < z->fl_count; fl++) {
+		for (int sl = 0; sl < SL_COUNT; sl++) {
+			struct block *f = *free_list(z, fl, sl);
+			bool bit = (sl_bitmap(z)[fl] & BIT(sl)) != 0U;
+
+			if (bit != (f != NULL)) {
+				return false;
+			}
+			for (; f != NULL; f = f->next_free) {
+				nlisted++;
+			}
+		}
+		if (((z->fl_bitmap & BIT(fl)) != 0U) !=
+		    (sl_bitmap(z)[fl] != 0U)) {
+			return false;
+		}
+	}
+
+	return nfree == nlisted;
+}
@@ -0,0 +1,973 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Incremental JSON parser and writer.
+ *
+ * The parser is a state machine driven one character at a time, whose
+ * whole state lives in struct json_stream, so input can be split
+ * anywhere, even within a token.  The lexer state tells what kind of
+ * token is being read; the grammar state tells what token may come
+ * next.  Strings and numbers are gathered in the caller's buffer, other
+ * tokens are reported as soon as they are read.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/util.h>
+#include <zephyr/types.h>
+
+#include <data/json.h>
+
+#ifdef CONFIG_NET_BUF
+#include <net/buf.h>
+#endif
+
+enum lex_state {
+	LEX_VALUE,
+	LEX_STRING,
+	LEX_ESCAPE,
+	LEX_UNICODE,
+	LEX_NUMBER,
+	LEX_LITERAL,
+};
+
+enum expect_state {
+	EXPECT_VALUE,
+	EXPECT_VALUE_OR_END,
+	EXPECT_KEY,
+	EXPECT_KEY_OR_END,
+	EXPECT_COLON,
+	EXPECT_COMMA_OR_END,
+	EXPECT_DONE,
+};
+
+void json_stream_init(struct json_stream *js, json_stream_cb_t cb,
+		      void *user_data, char *buf, size_t buf_size)
+{
+	(void)memset(js, 0, sizeof(*js));
+	js->cb = cb;
+	js->user_data = user_data;
+	js->buf = buf;
+	js->buf_size = buf_size;
+	js->lex = LEX_VALUE;
+	js->expect = EXPECT_VALUE;
+}
+
+static bool in_object(struct json_stream *js)
+{
+	return (js->objects & BIT(js->depth - 1)) != 0U;
+}
+
+static void value_done(struct json_stream *js)
+{
+	js->expect = js->depth == 0U ? EXPECT_DONE : EXPECT_COMMA_OR_END;
+}
+
+static int open_container(struct json_stream *js, bool object)
+{
+	if (js->depth == JSON_STREAM_MAX_DEPTH) {
+		return -ENOMEM;
+	}
+
+	if (object) {
+		js->objects |= BIT(js->depth);
+		js->expect = EXPECT_KEY_OR_END;
+	} else {
+		js->objects &= ~BIT(js->depth);
+		js->expect = EXPECT_VALUE_OR_END;
+	}
+
+	js->depth++;
+
+	return 0;
+}
+
+static int close_container(struct json_stream *js, enum json_tokens type)
+{
+	if (js->depth == 0U ||
+	    type != (in_object(js) ? JSON_TOK_OBJECT_END : JSON_TOK_LIST_END)) {
+		return -EINVAL;
+	}
+
+	js->depth--;
+	value_done(js);
+
+	return 0;
+}
+
+/* Check a token against the grammar and move on to the next state */
+static int grammar(struct json_stream *js, enum json_tokens type, bool *key)
+{
+	switch (js->expect) {
+	case EXPECT_KEY_OR_END:
+		if (type == JSON_TOK_OBJECT_END) {
+			return close_container(js, type);
+		}
+
+		/* fallthrough */
+	case EXPECT_KEY:
+		if (type != JSON_TOK_STRING) {
+			return -EINVAL;
+		}
+
+		*key = true;
+		js->expect = EXPECT_COLON;
+		return 0;
+	case EXPECT_COLON:
+		if (type != JSON_TOK_COLON) {
+			return -EINVAL;
+		}
+
+		js->expect = EXPECT_VALUE;
+		return 0;
+	case EXPECT_VALUE_OR_END:
+		if (type == JSON_TOK_LIST_END) {
+			return close_container(js, type);
+		}
+
+		/* fallthrough */
+	case EXPECT_VALUE:
+		switch (type) {
+		case JSON_TOK_OBJECT_START:
+			return open_container(js, true);
+		case JSON_TOK_LIST_START:
+			return open_container(js, false);
+		case JSON_TOK_STRING:
+		case JSON_TOK_NUMBER:
+		case JSON_TOK_TRUE:
+		case JSON_TOK_FALSE:
+		case JSON_TOK_NULL:
+			value_done(js);
+			return 0;
+		default:
+			return -EINVAL;
+		}
+	case EXPECT_COMMA_OR_END:
+		if (type == JSON_TOK_COMMA) {
+			js->expect = in_object(js) ? EXPECT_KEY : EXPECT_VALUE;
+			return 0;
+		}
+
+		return close_container(js, type);
+	default:
+		return -EINVAL;
+	}
+}
+
+/* Scale by a power of 10, one bit of the exponent at a time */
+static int scale_pow10(double *val, int exp10)
+{
+	static const double pow10[] = {
+		1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64, 1e128, 1e256
+	};
+	unsigned int exp = exp10 < 0 ? -exp10 : exp10;
+	size_t i;
+
+	for (i = 0; exp != 0U && i < ARRAY_SIZE(pow10); i++, exp >>= 1) {
+		if (exp & 1U) {
+			*val = exp10 < 0 ? *val / pow10[i] : *val * pow10[i];
+		}
+	}
+
+	if (exp != 0U || __builtin_isinf(*val)) {
+		return -ERANGE;
+	}
+
+	return 0;
+}
+
+static int decode_number(const char *str, struct json_stream_token *token)
+{
+	const char *pos = str;
+	bool neg = false, is_float = false, truncated = false;
+	u64_t mant = 0U;
+	int exp10 = 0, exp = 0, exp_sign = 1;
+
+	if (*pos == '-') {
+		neg = true;
+		pos++;
+	}
+
+	if (!isdigit((unsigned char)*pos) ||
+	    (pos[0] == '0' && isdigit((unsigned char)pos[1]))) {
+		return -EINVAL;
+	}
+
+	/* Digits beyond what the mantissa holds only scale it */
+	for (; isdigit((unsigned char)*pos); pos++) {
+		if (mant <= (UINT64_MAX - 9U) / 10U) {
+			mant = mant * 10U + (*pos - '0');
+		} else {
+			truncated = true;
+			exp10++;
+		}
+	}
+
+	if (*pos == '.') {
+		is_float = true;
+		pos++;
+		if (!isdigit((unsigned char)*pos)) {
+			return -EINVAL;
+		}
+
+		for (; isdigit((unsigned char)*pos); pos++) {
+			if (mant <= (UINT64_MAX - 9U) / 10U) {
+				mant = mant * 10U + (*pos - '0');
+				exp10--;
+			}
+		}
+	}
+
+	if (*pos == 'e' || *pos == 'E') {
+		is_float = true;
+		pos++;
+		if (*pos == '-' || *pos == '+') {
+			exp_sign = *pos == '-' ? -1 : 1;
+			pos++;
+		}
+
+		if (!isdigit((unsigned char)*pos)) {
+			return -EINVAL;
+		}
+
+		for (; isdigit((unsigned char)*pos); pos++) {
+			if (exp < 10000) {
+				exp = exp * 10 + (*pos - '0');
+			}
+		}
+		exp10 += exp_sign * exp;
+	}
+
+	if (*pos != '\0') {
+		return -EINVAL;
+	}
+
+	if (!is_float && !truncated &&
+	    mant <= (neg ? (u64_t)INT64_MAX + 1U : (u64_t)INT64_MAX)) {
+		token->integer = true;
+		token->i64 = neg ? (s64_t)(0U - mant) : (s64_t)mant;
+		token->dbl = (double)token->i64;
+
+		return 0;
+	}
+
+	token->dbl = (double)mant;
+	if (mant != 0U && scale_pow10(&token->dbl, exp10) < 0) {
+		return -ERANGE;
+	}
+
+	if (neg) {
+		token->dbl = -token->dbl;
+	}
+
+	return 0;
+}
+
+/* A complete token: check it, and report it unless within a skipped
+ * value
+ */
+static int token(struct json_stream *js, enum json_tokens type)
+{
+	struct json_stream_token token = { .type = type, .depth = js->depth };
+	bool key = false;
+	int ret;
+
+	ret = grammar(js, type, &key);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (js->skipping) {
+		/* Done once back where the skipped value started */
+		if (js->depth == js->skip_from &&
+		    (js->expect == EXPECT_COMMA_OR_END ||
+		     js->expect == EXPECT_DONE)) {
+			js->skipping = false;
+		}
+
+		return 0;
+	}
+
+	switch (type) {
+	case JSON_TOK_COLON:
+	case JSON_TOK_COMMA:
+		return 0;
+	case JSON_TOK_OBJECT_END:
+	case JSON_TOK_LIST_END:
+		token.depth = js->depth;
+		break;
+	case JSON_TOK_STRING:
+		token.key = key;
+		token.str = js->buf;
+		token.len = js->len;
+		break;
+	case JSON_TOK_NUMBER:
+		token.str = js->buf;
+		token.len = js->len;
+		ret = decode_number(js->buf, &token);
+		if (ret < 0) {
+			return ret;
+		}
+		break;
+	default:
+		break;
+	}
+
+	ret = js->cb(&token, js->user_data);
+	if (ret != JSON_STREAM_SKIP) {
+		return MIN(ret, 0);
+	}
+
+	if (key) {
+		js->skipping = true;
+		js->skip_from = js->depth;
+	} else if (type == JSON_TOK_OBJECT_START ||
+		   type == JSON_TOK_LIST_START) {
+		js->skipping = true;
+		js->skip_from = js->depth - 1U;
+	}
+
+	return 0;
+}
+
+static int append(struct json_stream *js, const char *bytes, size_t len)
+{
+	if (js->skipping || len == 0) {
+		return 0;
+	}
+
+	/* Keep room for the NUL */
+	if (len >= js->buf_size - js->len) {
+		return -ENOMEM;
+	}
+
+	memcpy(js->buf + js->len, bytes, len);
+	js->len += len;
+	js->buf[js->len] = '\0';
+	js->high_surrogate = 0U;
+
+	return 0;
+}
+
+/* Encode an escaped code point as UTF-8, joining surrogate pairs */
+static int append_code_point(struct json_stream *js, u32_t cp)
+{
+	char utf8[4];
+	u16_t high = 0U;
+	size_t len;
+	int ret;
+
+	if (js->skipping) {
+		return 0;
+	}
+
+	if (cp >= 0xdc00 && cp <= 0xdfff && js->high_surrogate != 0U) {
+		cp = 0x10000 + ((js->high_surrogate - 0xd800) << 10) +
+		     (cp - 0xdc00);
+		/* Replace the high surrogate */
+		js->len -= 3;
+	} else if (cp >= 0xd800 && cp <= 0xdbff) {
+		high = cp;
+	}
+
+	if (cp < 0x80) {
+		utf8[0] = cp;
+		len = 1;
+	} else if (cp < 0x800) {
+		utf8[0] = 0xc0 | (cp >> 6);
+		utf8[1] = 0x80 | (cp & 0x3f);
+		len = 2;
+	} else if (cp < 0x10000) {
+		utf8[0] = 0xe0 | (cp >> 12);
+		utf8[1] = 0x80 | ((cp >> 6) & 0x3f);
+		utf8[2] = 0x80 | (cp & 0x3f);
+		len = 3;
+	} else {
+		utf8[0] = 0xf0 | (cp >> 18);
+		utf8[1] = 0x80 | ((cp >> 12) & 0x3f);
+		utf8[2] = 0x80 | ((cp >> 6) & 0x3f);
+		utf8[3] = 0x80 | (cp & 0x3f);
+		len = 4;
+	}
+
+	ret = append(js, utf8, len);
+	js->high_surrogate = high;
+
+	return ret;
+}
+
+static int lex_value(struct json_stream *js, char chr)
+{
+	switch (chr) {
+	case ' ':
+	case '\t':
+	case '\n':
+	case '\r':
+		return 0;
+	case '{':
+	case '}':
+	case '[':
+	case ']':
+	case ',':
+	case ':':
+		return token(js, (enum json_tokens)chr);
+	case '"':
+		js->lex = LEX_STRING;
+		js->len = 0;
+		return 0;
+	case 't':
+		js->literal = "true";
+		break;
+	case 'f':
+		js->literal = "false";
+		break;
+	case 'n':
+		js->literal = "null";
+		break;
+	default:
+		if (chr != '-' && !isdigit((unsigned char)chr)) {
+			return -EINVAL;
+		}
+
+		js->lex = LEX_NUMBER;
+		js->len = 0;
+		return append(js, &chr, 1);
+	}
+
+	js->lex = LEX_LITERAL;
+	js->pos = 1U;
+
+	return 0;
+}
+
+/* Gather a run of plain characters at once */
+static int lex_string(struct json_stream *js, const char **pos,
+		      const char *end)
+{
+	const char *start = *pos;
+	const char *cur = start;
+	int ret;
+
+	while (cur < end && *cur != '"' && *cur != '\\' &&
+	       (unsigned char)*cur >= 0x20) {
+		cur++;
+	}
+
+	ret = append(js, start, cur - start);
+	if (ret < 0 || cur == end) {
+		*pos = cur;
+		return ret;
+	}
+
+	*pos = cur + 1;
+
+	if (*cur == '\\') {
+		js->lex = LEX_ESCAPE;
+		return 0;
+	}
+
+	if (*cur == '"') {
+		js->lex = LEX_VALUE;
+		js->high_surrogate = 0U;
+		if (!js->skipping) {
+			js->buf[js->len] = '\0';
+		}
+		return token(js, JSON_TOK_STRING);
+	}
+
+	/* Control characters must be escaped */
+	return -EINVAL;
+}
+
+static int lex_escape(struct json_stream *js, char chr)
+{
+	char unescaped;
+
+	switch (chr) {
+	case '"':
+	case '\\':
+	case '/':
+		unescaped = chr;
+		break;
+	case 'b':
+		unescaped = '\b';
+		break;
+	case 'f':
+		unescaped = '\f';
+		break;
+	case 'n':
+		unescaped = '\n';
+		break;
+	case 'r':
+		unescaped = '\r';
+		break;
+	case 't':
+		unescaped = '\t';
+		break;
+	case 'u':
+		js->lex = LEX_UNICODE;
+		js->unicode = 0U;
+		js->pos = 0U;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+
+	js->lex = LEX_STRING;
+
+	return append(js, &unescaped, 1);
+}
+
+static int lex_unicode(struct json_stream *js, char chr)
+{
+	int digit;
+
+	if (chr >= '0' && chr <= '9') {
+		digit = chr - '0';
+	} else if (chr >= 'a' && chr <= 'f') {
+		digit = chr - 'a' + 10;
+	} else if (chr >= 'A' && chr <= 'F') {
+		digit = chr - 'A' + 10;
+	} else {
+		return -EINVAL;
+	}
+
+	js->unicode = (js->unicode << 4) | digit;
+	if (++js->pos < 4U) {
+		return 0;
+	}
+
+	js->lex = LEX_STRING;
+
+	return append_code_point(js, js->unicode);
+}
+
+static bool number_char(char chr)
+{
+	return isdigit((unsigned char)chr) || chr == '-' || chr == '+' ||
+	       chr == '.' || chr == 'e' || chr == 'E';
+}
+
+static int lex_literal(struct json_stream *js, char chr)
+{
+	if (chr != js->literal[js->pos]) {
+		return -EINVAL;
+	}
+
+	if (js->literal[++js->pos] != '\0') {
+		return 0;
+	}
+
+	js->lex = LEX_VALUE;
+
+	/* The tokens of literals are their first letter */
+	return token(js, (enum json_tokens)js->literal[0]);
+}
+
+int json_stream_feed(struct json_stream *js, const char *data, size_t len)
+{
+	const char *pos = data;
+	const char *end = data + len;
+	int ret = js->err;
+
+	while (ret == 0 && pos < end) {
+		switch (js->lex) {
+		case LEX_VALUE:
+			ret = lex_value(js, *pos++);
+			break;
+		case LEX_STRING:
+			ret = lex_string(js, &pos, end);
+			break;
+		case LEX_ESCAPE:
+			ret = lex_escape(js, *pos++);
+			break;
+		case LEX_UNICODE:
+			ret = lex_unicode(js, *pos++);
+			break;
+		case LEX_NUMBER:
+			/* A number ends at the first character not in it */
+			if (number_char(*pos)) {
+				ret = append(js, pos++, 1);
+			} else {
+				js->lex = LEX_VALUE;
+				ret = token(js, JSON_TOK_NUMBER);
+			}
+			break;
+		default:
+			ret = lex_literal(js, *pos++);
+			break;
+		}
+	}
+
+	js->err = ret;
+
+	return ret;
+}
+
+int json_stream_finish(struct json_stream *js)
+{
+	int ret = js->err;
+
+	if (ret == 0 && js->lex == LEX_NUMBER) {
+		js->lex = LEX_VALUE;
+		ret = token(js, JSON_TOK_NUMBER);
+	}
+
+	if (ret == 0 &&
+	    (js->lex != LEX_VALUE || js->expect != EXPECT_DONE)) {
+		ret = -EINVAL;
+	}
+
+	js->err = ret;
+
+	return ret;
+}
+
+#ifdef CONFIG_NET_BUF
+int json_stream_feed_net_buf(struct json_stream *js, struct net_buf *frags)
+{
+	int ret = js->err;
+
+	for (; ret == 0 && frags != NULL; frags = frags->frags) {
+		ret = json_stream_feed(js, (const char *)frags->data,
+				       frags->len);
+	}
+
+	return ret;
+}
+#endif
+
+void json_writer_init(struct json_writer *jw,
+		      json_append_bytes_t append_bytes, void *data)
+{
+	(void)memset(jw, 0, sizeof(*jw));
+	jw->append_bytes = append_bytes;
+	jw->data = data;
+}
+
+/* Separate a value from the previous member of its object or array */
+static int separate(struct json_writer *jw)
+{
+	u32_t bit;
+
+	if (jw->after_key) {
+		jw->after_key = false;
+		return 0;
+	}
+
+	if (jw->depth == 0U) {
+		return 0;
+	}
+
+	bit = BIT(jw->depth - 1);
+	if ((jw->has_members & bit) != 0U) {
+		return jw->append_bytes(",", 1, jw->data);
+	}
+
+	jw->has_members |= bit;
+
+	return 0;
+}
+
+static int write_open(struct json_writer *jw, const char *chr)
+{
+	int ret;
+
+	if (jw->depth == JSON_STREAM_MAX_DEPTH) {
+		return -ENOMEM;
+	}
+
+	ret = separate(jw);
+	if (ret < 0) {
+		return ret;
+	}
+
+	jw->has_members &= ~BIT(jw->depth);
+	jw->depth++;
+
+	return jw->append_bytes(chr, 1, jw->data);
+}
+
+static int write_close(struct json_writer *jw, const char *chr)
+{
+	if (jw->depth == 0U) {
+		return -EINVAL;
+	}
+
+	jw->depth--;
+
+	return jw->append_bytes(chr, 1, jw->data);
+}
+
+int json_writer_obj_start(struct json_writer *jw)
+{
+	return write_open(jw, "{");
+}
+
+int json_writer_obj_end(struct json_writer *jw)
+{
+	return write_close(jw, "}");
+}
+
+int json_writer_arr_start(struct json_writer *jw)
+{
+	return write_open(jw, "[");
+}
+
+int json_writer_arr_end(struct json_writer *jw)
+{
+	return write_close(jw, "]");
+}
+
+/* Write a quoted string, escaping runs at once */
+static int write_str(struct json_writer *jw, const char *str)
+{
+	static const char hex[] = "0123456789abcdef";
+	const char *run = str;
+	char esc[6] = { '\\', 'u', '0', '0' };
+	size_t esc_len;
+	int ret;
+
+	ret = jw->append_bytes("\"", 1, jw->data);
+
+	for (; ret == 0; str++) {
+		unsigned char chr = *str;
+
+		if (chr >= 0x20 && chr != '"' && chr != '\\') {
+			continue;
+		}
+
+		ret = jw->append_bytes(run, str - run, jw->data);
+		if (ret < 0 || chr == '\0') {
+			break;
+		}
+
+		run = str + 1;
+		esc_len = 2;
+
+		switch (chr) {
+		case '"':
+		case '\\':
+			esc[1] = chr;
+			break;
+		case '\b':
+			esc[1] = 'b';
+			break;
+		case '\f':
+			esc[1] = 'f';
+			break;
+		case '\n':
+			esc[1] = 'n';
+			break;
+		case '\r':
+			esc[1] = 'r';
+			break;
+		case '\t':
+			esc[1] = 't';
+			break;
+		default:
+			esc[1] = 'u';
+			esc[4] = hex[chr >> 4];
+			esc[5] = hex[chr & 0xf];
+			esc_len = 6;
+			break;
+		}
+
+		ret = jw->append_bytes(esc, esc_len, jw->data);
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return jw->append_bytes("\"", 1, jw->data);
+}
+
+int json_writer_key(struct json_writer *jw, const char *key)
+{
+	int ret;
+
+	ret = separate(jw);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = write_str(jw, key);
+	if (ret < 0) {
+		return ret;
+	}
+
+	jw->after_key = true;
+
+	return jw->append_bytes(":", 1, jw->data);
+}
+
+int json_writer_str(struct json_writer *jw, const char *str)
+{
+	int ret = separate(jw);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return write_str(jw, str);
+}
+
+/* Format a number's digits backwards, from the end of buf */
+static char *format_u64(char *end, u64_t num, int min_digits)
+{
+	do {
+		*--end = '0' + num % 10U;
+		num /= 10U;
+		min_digits--;
+	} while (num != 0U || min_digits > 0);
+
+	return end;
+}
+
+int json_writer_int64(struct json_writer *jw, s64_t num)
+{
+	char buf[21];
+	char *start;
+	int ret;
+
+	ret = separate(jw);
+	if (ret < 0) {
+		return ret;
+	}
+
+	start = format_u64(buf + sizeof(buf),
+			   num < 0 ? 0U - (u64_t)num : (u64_t)num, 1);
+	if (num < 0) {
+		*--start = '-';
+	}
+
+	return jw->append_bytes(start, buf + sizeof(buf) - start, jw->data);
+}
+
+#define FRAC_DIGITS 9
+#define FRAC_SCALE 1000000000U
+
+int json_writer_double(struct json_writer *jw, double num)
+{
+	char buf[40];
+	char *start = buf + sizeof(buf);
+	bool neg = num < 0;
+	int exp10 = 0, digits = FRAC_DIGITS;
+	u64_t ipart, frac;
+	int ret;
+
+	if (__builtin_isinf(num) || __builtin_isnan(num)) {
+		return -EINVAL;
+	}
+
+	ret = separate(jw);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (neg) {
+		num = -num;
+	}
+
+	/* Bring very large or small values within [1, 10) */
+	if (num >= 1e15 || (num != 0 && num < 1e-5)) {
+		while (num >= 10) {
+			num /= 10;
+			exp10++;
+		}
+		while (num < 1) {
+			num *= 10;
+			exp10--;
+		}
+	}
+
+	ipart = (u64_t)num;
+	frac = (u64_t)((num - ipart) * FRAC_SCALE + 0.5);
+	if (frac >= FRAC_SCALE) {
+		ipart++;
+		frac -= FRAC_SCALE;
+	}
+
+	if (exp10 != 0 && ipart == 10U) {
+		ipart = 1U;
+		exp10++;
+	}
+
+	if (exp10 != 0) {
+		start = format_u64(start, exp10 < 0 ? -exp10 : exp10, 1);
+		*--start = exp10 < 0 ? '-' : '+';
+		*--start = 'e';
+	}
+
+	if (frac != 0U) {
+		while (frac % 10U == 0U) {
+			frac /= 10U;
+			digits--;
+		}
+		start = format_u64(start, frac, digits);
+		*--start = '.';
+	}
+
+	start = format_u64(start, ipart, 1);
+	if (neg) {
+		*--start = '-';
+	}
+
+	return jw->append_bytes(start, buf + sizeof(buf) - start, jw->data);
+}
+
+int json_writer_bool(struct json_writer *jw, bool value)
+{
+	int ret = separate(jw);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (value) {
+		return jw->append_bytes("true", 4, jw->data);
+	}
+
+	return jw->append_bytes("false", 5, jw->data);
+}
+
+int json_writer_null(struct json_writer *jw)
+{
+	int ret = separate(jw);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return jw->append_bytes("null", 4, jw->data);
+}
+
+#ifdef CONFIG_NET_BUF
+static struct net_buf *alloc_frag(s32_t timeout, void *user_data)
+{
+	struct net_buf *buf = user_data;
+
+	return net_buf_alloc_len(net_buf_pool_get(buf->pool_id), buf->size,
+				 timeout);
+}
+
+int json_append_bytes_net_buf(const char *bytes, size_t len, void *data)
+{
+	struct net_buf *buf = data;
+
+	if (net_buf_append_bytes(buf, len, bytes, K_NO_WAIT, alloc_frag,
+				 buf) != len) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+#endif
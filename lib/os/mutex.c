@@ -8,6 +8,9 @@
 #include <sys/mutex.h>
 #include <syscall_handler.h>
 #include <kernel_structs.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <spinlock.h>
 
 static struct k_mutex *get_k_mutex(struct sys_mutex *mutex)
 {
@@ -23,32 +26,230 @@ static struct k_mutex *get_k_mutex(struct sys_mutex *mutex)
 
 static bool check_sys_mutex_addr(u32_t addr)
 {
-	/* sys_mutex memory is never touched, just used to lookup the
-	 * underlying k_mutex, but we don't want threads using mutexes
-	 * that are outside their memory domain
+	/* Unless CONFIG_SYS_MUTEX_FUTEX is enabled, sys_mutex memory is
+	 * never touched, just used to lookup the underlying k_mutex, but
+	 * either way we don't want threads using mutexes that are outside
+	 * their memory domain
 	 */
 	return Z_SYSCALL_MEMORY_WRITE(addr, sizeof(struct sys_mutex));
 }
 
+#ifdef CONFIG_SYS_MUTEX_FUTEX
+
+/* Slow paths of the futex protocol described in sys/mutex.h.  The
+ * sys_mutex's kernel k_mutex supplies the wait queue and remembers
+ * which thread it boosted and from which priority; its lock_count is
+ * unused, the owner's recursion count lives in the sys_mutex itself.
+ */
+
+BUILD_ASSERT(sizeof(atomic_val_t) >= sizeof(struct k_thread *));
+
+static struct k_spinlock lock;
+
+static struct k_thread *owner_thread(atomic_val_t val)
+{
+	struct k_thread *thread;
+	struct _k_object *obj;
+
+	thread = (struct k_thread *)(uintptr_t)(val & ~Z_SYS_MUTEX_WAITERS);
+	obj = z_object_find(thread);
+	if (obj == NULL || obj->type != K_OBJ_THREAD ||
+	    (obj->flags & K_OBJ_FLAG_INITIALIZED) == 0U) {
+		return NULL;
+	}
+
+	return thread;
+}
+
+static s32_t new_prio_for_inheritance(s32_t target, s32_t limit)
+{
+	int new_prio = z_is_prio_higher(target, limit) ? target : limit;
+
+	return z_get_new_prio_with_ceiling(new_prio);
+}
+
+static void adjust_owner_prio(struct k_mutex *kernel_mutex, s32_t new_prio)
+{
+	if (kernel_mutex->owner->base.prio != new_prio) {
+		z_thread_priority_set(kernel_mutex->owner, new_prio);
+	}
+}
+
+/* Sets the waiters bit, unless the mutex could be taken instead.
+ * Returns 1 if the caller must wait for the mutex, 0 if it now owns
+ * it, or a negative error code.
+ */
+static int mark_contended(struct sys_mutex *mutex, s32_t timeout)
+{
+	atomic_val_t self = (atomic_val_t)(uintptr_t)_current;
+
+	while (true) {
+		atomic_val_t val = atomic_get(&mutex->val);
+
+		if (val == 0) {
+			if (atomic_cas(&mutex->val, 0, self)) {
+				mutex->lock_count = 0U;
+				return 0;
+			}
+		} else if ((val & ~Z_SYS_MUTEX_WAITERS) == self) {
+			mutex->lock_count++;
+			return 0;
+		} else if (timeout == K_NO_WAIT) {
+			return -EBUSY;
+		} else if ((val & Z_SYS_MUTEX_WAITERS) != 0 ||
+			   atomic_cas(&mutex->val, val,
+				      val | Z_SYS_MUTEX_WAITERS)) {
+			return 1;
+		}
+	}
+}
+
 int z_impl_z_sys_mutex_kernel_lock(struct sys_mutex *mutex, s32_t timeout)
 {
 	struct k_mutex *kernel_mutex = get_k_mutex(mutex);
+	struct k_thread *owner, *waiter;
+	k_spinlock_key_t key;
+	int ret;
 
 	if (kernel_mutex == NULL) {
 		return -EINVAL;
 	}
 
-	return k_mutex_lock(kernel_mutex, timeout);
+	z_sched_lock();
+	key = k_spin_lock(&lock);
+
+	ret = mark_contended(mutex, timeout);
+	if (ret <= 0) {
+		goto out;
+	}
+
+	owner = owner_thread(atomic_get(&mutex->val));
+	if (owner == NULL) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	/* The owner took the mutex in user space, so the kernel only
+	 * learns about it now.  With nobody waiting it cannot have been
+	 * boosted through this mutex, so its current priority is the
+	 * one to restore on unlock.
+	 */
+	if (kernel_mutex->owner != owner ||
+	    z_waitq_head(&kernel_mutex->wait_q) == NULL) {
+		kernel_mutex->owner = owner;
+		kernel_mutex->owner_orig_prio = owner->base.prio;
+	}
+
+	adjust_owner_prio(kernel_mutex,
+			  new_prio_for_inheritance(_current->base.prio,
+						   owner->base.prio));
+
+	/* The unlocker hands the mutex over, value and all */
+	ret = z_pend_curr(&lock, key, &kernel_mutex->wait_q, timeout);
+	if (ret == 0) {
+		k_sched_unlock();
+		return 0;
+	}
+
+	/* Timed out: drop the waiters bit if we were the last one and
+	 * give back whatever boost we lent the owner
+	 */
+	key = k_spin_lock(&lock);
+
+	waiter = z_waitq_head(&kernel_mutex->wait_q);
+	if (waiter == NULL) {
+		atomic_and(&mutex->val, ~Z_SYS_MUTEX_WAITERS);
+	}
+
+	if (kernel_mutex->owner != NULL) {
+		s32_t new_prio = kernel_mutex->owner_orig_prio;
+
+		if (waiter != NULL) {
+			new_prio = new_prio_for_inheritance(waiter->base.prio,
+							    new_prio);
+		}
+		adjust_owner_prio(kernel_mutex, new_prio);
+	}
+
+out:
+	k_spin_unlock(&lock, key);
+	k_sched_unlock();
+
+	return ret;
 }
 
-Z_SYSCALL_HANDLER(z_sys_mutex_kernel_lock, mutex, timeout)
+int z_impl_z_sys_mutex_kernel_unlock(struct sys_mutex *mutex)
 {
-	if (check_sys_mutex_addr(mutex)) {
-		return -EACCES;
+	struct k_mutex *kernel_mutex = get_k_mutex(mutex);
+	atomic_val_t val, self = (atomic_val_t)_current;
+	struct k_thread *new_owner;
+	k_spinlock_key_t key;
+
+	if (kernel_mutex == NULL) {
+		return -EINVAL;
 	}
 
-	return z_impl_z_sys_mutex_kernel_lock((struct sys_mutex *)mutex,
-					      timeout);
+	key = k_spin_lock(&lock);
+
+	val = atomic_get(&mutex->val);
+	if (val == 0) {
+		k_spin_unlock(&lock, key);
+		return -EINVAL;
+	}
+
+	if ((val & ~Z_SYS_MUTEX_WAITERS) != self) {
+		k_spin_unlock(&lock, key);
+		return -EPERM;
+	}
+
+	if (mutex->lock_count != 0U) {
+		mutex->lock_count--;
+		k_spin_unlock(&lock, key);
+		return 0;
+	}
+
+	z_sched_lock();
+
+	if (kernel_mutex->owner == _current) {
+		adjust_owner_prio(kernel_mutex, kernel_mutex->owner_orig_prio);
+	}
+
+	new_owner = z_unpend_first_thread(&kernel_mutex->wait_q);
+	kernel_mutex->owner = new_owner;
+
+	if (new_owner == NULL) {
+		atomic_set(&mutex->val, 0);
+		k_spin_unlock(&lock, key);
+		k_sched_unlock();
+		return 0;
+	}
+
+	val = (atomic_val_t)(uintptr_t)new_owner;
+	if (z_waitq_head(&kernel_mutex->wait_q) != NULL) {
+		val |= Z_SYS_MUTEX_WAITERS;
+	}
+	atomic_set(&mutex->val, val);
+	kernel_mutex->owner_orig_prio = new_owner->base.prio;
+
+	z_set_thread_return_value(new_owner, 0);
+	z_ready_thread(new_owner);
+	k_spin_unlock(&lock, key);
+	k_sched_unlock();
+
+	return 0;
+}
+
+#else
+
+int z_impl_z_sys_mutex_kernel_lock(struct sys_mutex *mutex, s32_t timeout)
+{
+	struct k_mutex *kernel_mutex = get_k_mutex(mutex);
+
+	if (kernel_mutex == NULL) {
+		return -EINVAL;
+	}
+
+	return k_mutex_lock(kernel_mutex, timeout);
 }
 
 int z_impl_z_sys_mutex_kernel_unlock(struct sys_mutex *mutex)
@@ -67,6 +268,18 @@ int z_impl_z_sys_mutex_kernel_unlock(struct sys_mutex *mutex)
 	return 0;
 }
 
+#endif /* CONFIG_SYS_MUTEX_FUTEX */
+
+Z_SYSCALL_HANDLER(z_sys_mutex_kernel_lock, mutex, timeout)
+{
+	if (check_sys_mutex_addr(mutex)) {
+		return -EACCES;
+	}
+
+	return z_impl_z_sys_mutex_kernel_lock((struct sys_mutex *)mutex,
+					      timeout);
+}
+
 Z_SYSCALL_HANDLER(z_sys_mutex_kernel_unlock, mutex)
 {
 	if (check_sys_mutex_addr(mutex)) {
@@ -217,3 +217,192 @@ u32_t ring_buf_get(struct ring_buf *buf, u8_t *data, u32_t size)
 
 	return total_size;
 }
+
+/* Lock-free variants. Each index is written by one side only, and read by
+ * the other with acquire semantics, pairing with the release store that
+ * publishes it: the data covered by an index is then visible once the
+ * index is.
+ */
+static inline u32_t load_acquire(u32_t *idx)
+{
+	return __atomic_load_n(idx, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_release(u32_t *idx, u32_t val)
+{
+	__atomic_store_n(idx, val, __ATOMIC_RELEASE);
+}
+
+static u32_t segs_fill(struct ring_buf_segs *segs, u8_t *buf, u32_t mask,
+		       u32_t idx, u32_t size)
+{
+	u32_t offset = idx & mask;
+	u32_t first = MIN(size, mask + 1 - offset);
+
+	segs->data[0] = buf + offset;
+	segs->size[0] = first;
+	segs->data[1] = buf;
+	segs->size[1] = size - first;
+
+	return size;
+}
+
+u32_t ring_buf_spsc_space_get(struct ring_buf_spsc *rb)
+{
+	return rb->mask + 1 - (rb->tail - load_acquire(&rb->head));
+}
+
+u32_t ring_buf_spsc_size_get(struct ring_buf_spsc *rb)
+{
+	return load_acquire(&rb->tail) - rb->head;
+}
+
+u32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *rb,
+			      struct ring_buf_segs *segs, u32_t size)
+{
+	/* Read once: MIN() evaluates its arguments twice, and the
+	 * other side may move the ring in between
+	 */
+	u32_t avail = ring_buf_spsc_space_get(rb);
+
+	size = MIN(size, avail);
+
+	return segs_fill(segs, rb->buf, rb->mask, rb->tail, size);
+}
+
+int ring_buf_spsc_put_finish(struct ring_buf_spsc *rb, u32_t size)
+{
+	if (size > ring_buf_spsc_space_get(rb)) {
+		return -EINVAL;
+	}
+
+	store_release(&rb->tail, rb->tail + size);
+
+	return 0;
+}
+
+u32_t ring_buf_spsc_put(struct ring_buf_spsc *rb, const u8_t *data,
+			u32_t size)
+{
+	struct ring_buf_segs segs;
+
+	size = ring_buf_spsc_put_claim(rb, &segs, size);
+	memcpy(segs.data[0], data, segs.size[0]);
+	memcpy(segs.data[1], data + segs.size[0], segs.size[1]);
+	store_release(&rb->tail, rb->tail + size);
+
+	return size;
+}
+
+u32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *rb,
+			      struct ring_buf_segs *segs, u32_t size)
+{
+	/* Read once, as in ring_buf_spsc_put_claim() */
+	u32_t avail = ring_buf_spsc_size_get(rb);
+
+	size = MIN(size, avail);
+
+	return segs_fill(segs, rb->buf, rb->mask, rb->head, size);
+}
+
+int ring_buf_spsc_get_finish(struct ring_buf_spsc *rb, u32_t size)
+{
+	if (size > ring_buf_spsc_size_get(rb)) {
+		return -EINVAL;
+	}
+
+	store_release(&rb->head, rb->head + size);
+
+	return 0;
+}
+
+u32_t ring_buf_spsc_get(struct ring_buf_spsc *rb, u8_t *data, u32_t size)
+{
+	struct ring_buf_segs segs;
+
+	size = ring_buf_spsc_get_claim(rb, &segs, size);
+	memcpy(data, segs.data[0], segs.size[0]);
+	memcpy(data + segs.size[0], segs.data[1], segs.size[1]);
+	store_release(&rb->head, rb->head + size);
+
+	return size;
+}
+
+/* An MPSC item is a commit word, a header word and the data. Free room is
+ * kept zeroed by the consumer, so the commit word only becomes non-zero
+ * once the producer stores it, last.
+ */
+#define MPSC_COMMITTED BIT(31)
+#define MPSC_HDR_WORDS 2U
+
+int ring_buf_mpsc_item_put(struct ring_buf_mpsc *rb, u16_t type, u8_t value,
+			   const u32_t *data, u8_t size32)
+{
+	u32_t need = size32 + MPSC_HDR_WORDS;
+	u32_t start, used;
+
+	for (;;) {
+		start = (u32_t)atomic_get(&rb->reserve);
+		used = start - load_acquire(&rb->head);
+
+		/* The consumer went past a stale reserve index */
+		if (used > rb->mask + 1) {
+			continue;
+		}
+
+		if (rb->mask + 1 - used < need) {
+			atomic_inc(&rb->dropped_put_count);
+			return -EMSGSIZE;
+		}
+
+		if (atomic_cas(&rb->reserve, (atomic_val_t)start,
+			       (atomic_val_t)(start + need))) {
+			break;
+		}
+	}
+
+	rb->buf[(start + 1) & rb->mask] = ((u32_t)type << 8) | value;
+	for (u32_t i = 0; i < size32; i++) {
+		rb->buf[(start + MPSC_HDR_WORDS + i) & rb->mask] = data[i];
+	}
+
+	store_release(&rb->buf[start & rb->mask], MPSC_COMMITTED | size32);
+
+	return 0;
+}
+
+int ring_buf_mpsc_item_get(struct ring_buf_mpsc *rb, u16_t *type,
+			   u8_t *value, u32_t *data, u8_t *size32)
+{
+	u32_t head = rb->head;
+	u32_t commit = load_acquire(&rb->buf[head & rb->mask]);
+	u32_t hdr, len;
+
+	if ((commit & MPSC_COMMITTED) == 0U) {
+		return -EAGAIN;
+	}
+
+	len = commit & 0xffU;
+	if (len > *size32) {
+		*size32 = len;
+		return -EMSGSIZE;
+	}
+
+	hdr = rb->buf[(head + 1) & rb->mask];
+	*type = hdr >> 8;
+	*value = hdr & 0xffU;
+	*size32 = len;
+
+	for (u32_t i = 0; i < len; i++) {
+		data[i] = rb->buf[(head + MPSC_HDR_WORDS + i) & rb->mask];
+	}
+
+	/* Zeroed before the room is handed back to the producers */
+	for (u32_t i = 0; i < len + MPSC_HDR_WORDS; i++) {
+		rb->buf[(head + i) & rb->mask] = 0U;
+	}
+
+	store_release(&rb->head, head + len + MPSC_HDR_WORDS);
+
+	return 0;
+}
@@ -35,7 +35,17 @@ static const pthread_attr_t init_pthread_attrs = {
 };
 
 static struct posix_thread posix_thread_pool[CONFIG_MAX_PTHREAD_COUNT];
-PTHREAD_MUTEX_DEFINE(pthread_pool_lock);
+
+#if CONFIG_PTHREAD_POOL_STACK_SIZE > 0
+static K_THREAD_STACK_ARRAY_DEFINE(posix_thread_stacks,
+				   CONFIG_MAX_PTHREAD_COUNT,
+				   CONFIG_PTHREAD_POOL_STACK_SIZE);
+Z_THREAD_POOL_DEFINE(posix_threads, posix_thread_pool, posix_thread_stacks,
+		     sizeof(posix_thread_stacks[0]),
+		     CONFIG_PTHREAD_POOL_STACK_SIZE);
+#else
+Z_THREAD_POOL_DEFINE(posix_threads, posix_thread_pool, NULL, 0, 0);
+#endif
 
 static bool is_posix_prio_valid(u32_t priority, int policy)
 {
@@ -123,8 +133,8 @@ static void zephyr_thread_wrapper(void *arg1, void *arg2, void *arg3)
 /**
  * @brief Create a new thread.
  *
- * Pthread attribute should not be NULL. API will return Error on NULL
- * attribute value.
+ * Pthread attribute may only be NULL, and its stack unset, when
+ * CONFIG_PTHREAD_POOL_STACK_SIZE provides stacks for the threads.
  *
  * See IEEE 1003.1
  */
@@ -132,38 +142,37 @@ int pthread_create(pthread_t *newthread, const pthread_attr_t *attr,
 		   void *(*threadroutine)(void *), void *arg)
 {
 	s32_t prio;
-	u32_t pthread_num;
 	pthread_condattr_t cond_attr;
 	struct posix_thread *thread;
 
-	/*
-	 * FIXME: Pthread attribute must be non-null and it provides stack
-	 * pointer and stack size. So even though POSIX 1003.1 spec accepts
-	 * attrib as NULL but zephyr needs it initialized with valid stack.
+	if (attr == NULL && CONFIG_PTHREAD_POOL_STACK_SIZE > 0) {
+		attr = &init_pthread_attrs;
+	}
+
+	/* Without stacks of its own, the pool needs one from the
+	 * attribute
 	 */
 	if ((attr == NULL) || (attr->initialized == 0U)
-	    || (attr->stack == NULL) || (attr->stacksize == 0)) {
+	    || (attr->stack == NULL && CONFIG_PTHREAD_POOL_STACK_SIZE == 0)
+	    || (attr->stack != NULL && attr->stacksize == 0)) {
 		return EINVAL;
 	}
 
-	pthread_mutex_lock(&pthread_pool_lock);
-	for (pthread_num = 0;
-	    pthread_num < CONFIG_MAX_PTHREAD_COUNT; pthread_num++) {
-		thread = &posix_thread_pool[pthread_num];
-		if (thread->state == PTHREAD_TERMINATED) {
-			thread->state = PTHREAD_JOINABLE;
-			break;
-		}
-	}
-	pthread_mutex_unlock(&pthread_pool_lock);
+	prio = posix_to_zephyr_priority(attr->priority, attr->schedpolicy);
 
-	if (pthread_num >= CONFIG_MAX_PTHREAD_COUNT) {
+	/* Not started yet, so that it can't exit and free its slot
+	 * before it is set up
+	 */
+	thread = (struct posix_thread *)
+		k_thread_pool_spawn(&posix_threads, attr->stack,
+				    attr->stacksize,
+				    (k_thread_entry_t)zephyr_thread_wrapper,
+				    (void *)arg, NULL, threadroutine, prio,
+				    (~K_ESSENTIAL & attr->flags), K_FOREVER);
+	if (thread == NULL) {
 		return EAGAIN;
 	}
 
-	prio = posix_to_zephyr_priority(attr->priority, attr->schedpolicy);
-
-	thread = &posix_thread_pool[pthread_num];
 	pthread_mutex_init(&thread->state_lock, NULL);
 	pthread_mutex_init(&thread->cancel_lock, NULL);
 
@@ -179,14 +188,13 @@ int pthread_create(pthread_t *newthread, const pthread_attr_t *attr,
 	pthread_cond_init(&thread->state_cond, &cond_attr);
 	sys_slist_init(&thread->key_list);
 
-	*newthread = (pthread_t) k_thread_create(&thread->thread, attr->stack,
-						 attr->stacksize,
-						 (k_thread_entry_t)
-						 zephyr_thread_wrapper,
-						 (void *)arg, NULL,
-						 threadroutine, prio,
-						 (~K_ESSENTIAL & attr->flags),
-						 attr->delayedstart);
+	/* A joinable thread's slot outlives it until it is joined */
+	if (thread->state == PTHREAD_JOINABLE) {
+		k_thread_pool_hold(&thread->thread);
+	}
+
+	*newthread = (pthread_t)thread;
+	k_thread_start(&thread->thread);
 	return 0;
 }
 
@@ -393,6 +401,7 @@ void pthread_exit(void *retval)
 int pthread_join(pthread_t thread, void **status)
 {
 	struct posix_thread *pthread = (struct posix_thread *) thread;
+	bool put = false;
 	int ret = 0;
 
 	if (pthread == NULL) {
@@ -413,6 +422,8 @@ int pthread_join(pthread_t thread, void **status)
 		if (status != NULL) {
 			*status = pthread->retval;
 		}
+		pthread->state = PTHREAD_TERMINATED;
+		put = true;
 	} else if (pthread->state == PTHREAD_DETACHED) {
 		ret = EINVAL;
 	} else {
@@ -420,6 +431,11 @@ int pthread_join(pthread_t thread, void **status)
 	}
 
 	pthread_mutex_unlock(&pthread->state_lock);
+
+	/* Unlock first: the slot, state_lock included, may be reused at once */
+	if (put) {
+		k_thread_pool_put(&pthread->thread);
+	}
 	return ret;
 }
 
@@ -431,6 +447,7 @@ int pthread_join(pthread_t thread, void **status)
 int pthread_detach(pthread_t thread)
 {
 	struct posix_thread *pthread = (struct posix_thread *) thread;
+	bool put = false;
 	int ret = 0;
 
 	if (pthread == NULL) {
@@ -446,12 +463,15 @@ int pthread_detach(pthread_t thread)
 		 * This will make threads waiting to join this thread continue.
 		 */
 		pthread_cond_broadcast(&pthread->state_cond);
+		/* The slot now goes back to the pool when the thread exits */
+		put = true;
 		break;
 	case PTHREAD_EXITED:
 		pthread->state = PTHREAD_TERMINATED;
 		/* THREAD has already exited.
 		 * Pthread remained to provide exit status.
 		 */
+		put = true;
 		break;
 	case PTHREAD_TERMINATED:
 		ret = ESRCH;
@@ -462,6 +482,10 @@ int pthread_detach(pthread_t thread)
 	}
 
 	pthread_mutex_unlock(&pthread->state_lock);
+
+	if (put) {
+		k_thread_pool_put(&pthread->thread);
+	}
 	return ret;
 }
 
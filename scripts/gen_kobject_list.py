@@ -77,9 +77,11 @@ kobjects = OrderedDict ([
     ("k_mem_slab", (None, False)),
     ("k_msgq", (None, False)),
     ("k_mutex", (None, False)),
+    ("k_rwlock", (None, False)),
     ("k_pipe", (None, False)),
     ("k_queue", (None, False)),
     ("k_poll_signal", (None, False)),
+    ("k_poll_set", (None, False)),
     ("k_sem", (None, False)),
     ("k_stack", (None, False)),
     ("k_thread", (None, False)),
@@ -6,6 +6,7 @@
 
 #include <tracing_cpu_stats.h>
 #include <sys/printk.h>
+#include <errno.h>
 
 enum cpu_state {
 	CPU_STATE_IDLE,
@@ -21,6 +22,14 @@ static struct cpu_stats stats_hw_tick;
 static int nested_interrupts;
 static struct k_thread *current_thread;
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/* Thread the elapsed time is charged to: none in the scheduler or in
+ * interrupts
+ */
+static struct k_thread *charged_thread;
+static struct k_thread *charged_before_interrupts;
+#endif
+
 #ifndef CONFIG_SMP
 extern k_tid_t const _idle_thread;
 #endif
@@ -34,38 +43,52 @@ static int is_idle_thread(struct k_thread *thread)
 #endif
 }
 
-void update_counter(volatile u64_t *cnt)
+u32_t update_counter(volatile u64_t *cnt)
 {
 	u32_t time = k_cycle_get_32();
+	u32_t elapsed;
 
 	if (time >= last_time) {
-		(*cnt) += (time - last_time);
+		elapsed = time - last_time;
 	} else {
-		(*cnt) += (UINT32_MAX - last_time + 1 + time);
+		elapsed = UINT32_MAX - last_time + 1 + time;
 	}
+	(*cnt) += elapsed;
 	last_time = time;
+
+	return elapsed;
 }
 
 static void cpu_stats_update_counters(void)
 {
+	u32_t elapsed;
+
 	switch (last_cpu_state) {
 	case CPU_STATE_IDLE:
-		update_counter(&stats_hw_tick.idle);
+		elapsed = update_counter(&stats_hw_tick.idle);
 		break;
 
 	case CPU_STATE_NON_IDLE:
-		update_counter(&stats_hw_tick.non_idle);
+		elapsed = update_counter(&stats_hw_tick.non_idle);
 		break;
 
 	case CPU_STATE_SCHEDULER:
-		update_counter(&stats_hw_tick.sched);
+		elapsed = update_counter(&stats_hw_tick.sched);
 		break;
 
 	default:
 		/* Invalid CPU state */
 		__ASSERT_NO_MSG(false);
-		break;
+		return;
 	}
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	if (charged_thread != NULL) {
+		charged_thread->runtime.stats.execution_cycles += elapsed;
+	}
+#else
+	ARG_UNUSED(elapsed);
+#endif
 }
 
 void cpu_stats_get_ns(struct cpu_stats *cpu_stats_ns)
@@ -102,6 +125,81 @@ void cpu_stats_reset_counters(void)
 	irq_unlock(key);
 }
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+static void record_latency(struct _thread_runtime *rt)
+{
+	u32_t cycles = k_cycle_get_32() - rt->ready_since;
+	u32_t us = SYS_CLOCK_HW_CYCLES_TO_NS(cycles) / 1000U;
+	int bucket = (us > 1U) ? (int)find_msb_set(us) - 1 : 0;
+
+	rt->stats.latency[MIN(bucket, K_THREAD_LATENCY_BUCKETS - 1)]++;
+	rt->stats.max_latency = MAX(rt->stats.max_latency, cycles);
+	rt->readied = false;
+}
+
+static void thread_stats_switched_in(struct k_thread *thread)
+{
+	/* Some architectures report the same switch twice */
+	if (thread != current_thread) {
+		thread->runtime.stats.switches++;
+	}
+
+	if (thread->runtime.readied) {
+		record_latency(&thread->runtime);
+	}
+
+	charged_thread = thread;
+}
+
+void sys_trace_thread_ready(struct k_thread *thread)
+{
+	struct _thread_runtime *rt = &thread->runtime;
+	int key = irq_lock();
+	u32_t now = k_cycle_get_32();
+
+	if (rt->blocked_on != NULL) {
+		u32_t blocked = now - rt->blocked_since;
+
+		rt->stats.blocked_cycles += blocked;
+		rt->blocked_on->blocked_cycles += blocked;
+		rt->blocked_on = NULL;
+	}
+
+	/* Only count the wait of threads not already running */
+	if (!rt->readied && thread != k_current_get()) {
+		rt->readied = true;
+		rt->ready_since = now;
+	}
+	irq_unlock(key);
+}
+
+void sys_trace_thread_pend(struct k_thread *thread)
+{
+	int key = irq_lock();
+
+	thread->runtime.blocked_on = thread->base.pended_on;
+	thread->runtime.blocked_since = k_cycle_get_32();
+	irq_unlock(key);
+}
+
+int k_thread_runtime_stats_get(k_tid_t thread,
+			       struct k_thread_runtime_stats *stats)
+{
+	int key;
+
+	if (thread == NULL || stats == NULL) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+	cpu_stats_update_counters();
+	*stats = thread->runtime.stats;
+	irq_unlock(key);
+
+	return 0;
+}
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
 void sys_trace_thread_switched_in(void)
 {
 	int key = irq_lock();
@@ -109,6 +207,9 @@ void sys_trace_thread_switched_in(void)
 	__ASSERT_NO_MSG(nested_interrupts == 0);
 
 	cpu_stats_update_counters();
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	thread_stats_switched_in(k_current_get());
+#endif
 	current_thread = k_current_get();
 	if (is_idle_thread(current_thread)) {
 		last_cpu_state = CPU_STATE_IDLE;
@@ -127,6 +228,9 @@ void sys_trace_thread_switched_out(void)
 
 	cpu_stats_update_counters();
 	last_cpu_state = CPU_STATE_SCHEDULER;
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	charged_thread = NULL;
+#endif
 	irq_unlock(key);
 }
 
@@ -138,6 +242,10 @@ void sys_trace_isr_enter(void)
 		cpu_stats_update_counters();
 		cpu_state_before_interrupts = last_cpu_state;
 		last_cpu_state = CPU_STATE_NON_IDLE;
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+		charged_before_interrupts = charged_thread;
+		charged_thread = NULL;
+#endif
 	}
 	nested_interrupts++;
 	irq_unlock(key);
@@ -151,6 +259,9 @@ void sys_trace_isr_exit(void)
 	if (nested_interrupts == 0) {
 		cpu_stats_update_counters();
 		last_cpu_state = cpu_state_before_interrupts;
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+		charged_thread = charged_before_interrupts;
+#endif
 	}
 	irq_unlock(key);
 }
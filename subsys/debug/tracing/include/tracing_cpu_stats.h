@@ -34,8 +34,14 @@ void cpu_stats_reset_counters(void);
 #define sys_trace_thread_abort(thread)
 #define sys_trace_thread_suspend(thread)
 #define sys_trace_thread_resume(thread)
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+void sys_trace_thread_ready(struct k_thread *thread);
+void sys_trace_thread_pend(struct k_thread *thread);
+#else
 #define sys_trace_thread_ready(thread)
 #define sys_trace_thread_pend(thread)
+#endif
 
 #define sys_trace_void(id)
 #define sys_trace_end_call(id)
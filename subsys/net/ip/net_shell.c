@@ -3221,9 +3221,11 @@ static int cmd_net_route(const struct shell *shell, size_t argc, char *argv[])
 #if defined(CONFIG_INIT_STACKS)
 extern K_THREAD_STACK_DEFINE(_main_stack, CONFIG_MAIN_STACK_SIZE);
 extern K_THREAD_STACK_DEFINE(_interrupt_stack, CONFIG_ISR_STACK_SIZE);
+#if CONFIG_SYSTEM_WORKQUEUE_THREADS == 1
 extern K_THREAD_STACK_DEFINE(sys_work_q_stack,
 			     CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE);
 #endif
+#endif
 
 static int cmd_net_stacks(const struct shell *shell, size_t argc,
 			  char *argv[])
@@ -3281,6 +3283,7 @@ static int cmd_net_stacks(const struct shell *shell, size_t argc,
 	   CONFIG_ISR_STACK_SIZE, unused,
 	   CONFIG_ISR_STACK_SIZE - unused, CONFIG_ISR_STACK_SIZE, pcnt);
 
+#if CONFIG_SYSTEM_WORKQUEUE_THREADS == 1
 	net_analyze_stack_get_values(Z_THREAD_STACK_BUFFER(sys_work_q_stack),
 				     K_THREAD_STACK_SIZEOF(sys_work_q_stack),
 				     &pcnt, &unused);
@@ -3290,6 +3293,7 @@ static int cmd_net_stacks(const struct shell *shell, size_t argc,
 	   CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE, unused,
 	   CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE - unused,
 	   CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE, pcnt);
+#endif
 #else
 	PR_INFO("Enable CONFIG_INIT_STACKS to see usage information.\n");
 #endif
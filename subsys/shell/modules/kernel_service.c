@@ -123,6 +123,152 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_WORKQUEUE_POOL_STATS)
+static void shell_work_q_dump(const struct k_work_q *work_q, void *user_data)
+{
+	const struct shell *shell = (const struct shell *)user_data;
+	struct k_thread *thread = &work_q->workers[0].thread;
+	const char *tname = k_thread_name_get(thread);
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "%p %-10s workers %d\tsteals %u\n",
+		      work_q, tname ? tname : "NA",
+		      work_q->num_workers, work_q->steals);
+
+	for (int i = 0; i < K_WORK_Q_LATENCY_BUCKETS; i++) {
+		if (work_q->latency[i] == 0U) {
+			continue;
+		}
+
+		if (i == K_WORK_Q_LATENCY_BUCKETS - 1) {
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "  >= %6u us:\t%u\n", 1U << i,
+				      work_q->latency[i]);
+		} else {
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "  < %7u us:\t%u\n", 2U << i,
+				      work_q->latency[i]);
+		}
+	}
+}
+
+static int cmd_kernel_workq(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "Workqueue pools (submit to start latency):\n");
+	k_work_q_pool_foreach(shell_work_q_dump, (void *)shell);
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+static u32_t cycles_to_us(u64_t cycles)
+{
+	return (u32_t)(k_cycles_to_ns(cycles) / NSEC_PER_USEC);
+}
+
+static void shell_runtime_dump(const struct k_thread *thread, void *user_data)
+{
+	const struct shell *shell = (const struct shell *)user_data;
+	struct k_thread_runtime_stats stats;
+	const char *tname = k_thread_name_get((struct k_thread *)thread);
+	_wait_q_t *wait_q = thread->base.pended_on;
+	u64_t uptime = k_uptime_cycles_get();
+
+	(void)k_thread_runtime_stats_get((k_tid_t)thread, &stats);
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "%s%p %-10s %12u %3u %% %10u %12u %10u\n",
+		      (thread == k_current_get()) ? "*" : " ",
+		      thread, tname ? tname : "NA",
+		      cycles_to_us(stats.execution_cycles),
+		      (u32_t)(stats.execution_cycles * 100U / MAX(uptime, 1)),
+		      stats.switches, cycles_to_us(stats.blocked_cycles),
+		      cycles_to_us(stats.max_latency));
+
+	if (wait_q != NULL) {
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "  pended on %p, %u us blocked there in total\n",
+			      wait_q, cycles_to_us(wait_q->blocked_cycles));
+	}
+
+	for (int i = 0; i < K_THREAD_LATENCY_BUCKETS; i++) {
+		if (stats.latency[i] == 0U) {
+			continue;
+		}
+
+		if (i == K_THREAD_LATENCY_BUCKETS - 1) {
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "  >= %6u us:\t%u\n", 1U << i,
+				      stats.latency[i]);
+		} else {
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "  < %7u us:\t%u\n", 2U << i,
+				      stats.latency[i]);
+		}
+	}
+}
+
+static int cmd_kernel_stats(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      " %-10s %-10s %12s %5s %10s %12s %10s\n", "thread",
+		      "name", "run us", "cpu", "switches", "blocked us",
+		      "max lat us");
+	k_thread_foreach(shell_runtime_dump, (void *)shell);
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_SPINLOCK_STATS)
+static void shell_spinlock_dump(const struct k_spinlock *l,
+				const struct k_spinlock_stats *stats,
+				void *user_data)
+{
+	shell_fprintf((const struct shell *)user_data, SHELL_NORMAL,
+		      "%p %-10s %10u %10u %10u %10u\n",
+		      l, stats->name, stats->acquisitions, stats->contended,
+		      stats->spins, stats->max_hold);
+}
+
+static int cmd_kernel_spinlocks(const struct shell *shell,
+				size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "%-10s %-10s %10s %10s %10s %10s\n", "lock", "name",
+		      "taken", "contended", "spins", "max hold");
+	k_spin_stats_foreach(shell_spinlock_dump, (void *)shell);
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_SMP)
+static int cmd_kernel_ipis(const struct shell *shell,
+			   size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_fprintf(shell, SHELL_NORMAL, "%-4s %10s\n", "cpu", "ipis");
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, "%-4d %10u\n", i,
+			      k_sched_ipi_count_get(i));
+	}
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -151,16 +297,33 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_reboot,
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 	SHELL_CMD(cycles, NULL, "Kernel cycles.", cmd_kernel_cycles),
+#if defined(CONFIG_SMP)
+	SHELL_CMD(ipis, NULL, "Scheduler IPIs taken per CPU.",
+		  cmd_kernel_ipis),
+#endif
 #if defined(CONFIG_REBOOT)
 	SHELL_CMD(reboot, &sub_kernel_reboot, "Reboot.", NULL),
 #endif
+#if defined(CONFIG_SPINLOCK_STATS)
+	SHELL_CMD(spinlocks, NULL, "Spinlock contention statistics.",
+		  cmd_kernel_spinlocks),
+#endif
 #if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_MONITOR) \
 				&& defined(CONFIG_THREAD_STACK_INFO)
 	SHELL_CMD(stacks, NULL, "List threads stack usage.", cmd_kernel_stacks),
+#endif
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+	SHELL_CMD(stats, NULL, "Thread runtime statistics.", cmd_kernel_stats),
+#endif
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_MONITOR) \
+				&& defined(CONFIG_THREAD_STACK_INFO)
 	SHELL_CMD(threads, NULL, "List kernel threads.", cmd_kernel_threads),
 #endif
 	SHELL_CMD(uptime, NULL, "Kernel uptime.", cmd_kernel_uptime),
 	SHELL_CMD(version, NULL, "Kernel version.", cmd_kernel_version),
+#if defined(CONFIG_WORKQUEUE_POOL_STATS)
+	SHELL_CMD(workq, NULL, "Workqueue pool statistics.", cmd_kernel_workq),
+#endif
 	SHELL_SUBCMD_SET_END /* Array terminated. */
 );
 
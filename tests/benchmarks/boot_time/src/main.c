@@ -14,9 +14,11 @@
  *  2. From __start to main()
  *  3. From __start to task
  *  4. From __start to idle
+ *  5. In each init function, with CONFIG_DEVICE_INIT_TIMING
  */
 
 #include <zephyr.h>
+#include <device.h>
 
 #include <tc_util.h>
 
@@ -25,6 +27,46 @@ extern u64_t __start_time_stamp;    /* timestamp when kernel begins executing */
 extern u64_t __main_time_stamp;     /* timestamp when main() begins executing */
 extern u64_t __idle_time_stamp;     /* timestamp when CPU went idle */
 
+#ifdef CONFIG_DEVICE_INIT_TIMING
+static const char *const level_names[] = {
+	"PRE_KERNEL_1", "PRE_KERNEL_2", "POST_KERNEL", "APPLICATION"
+};
+
+static void print_init_entry(struct device *dev, int level, u32_t cycles,
+			     void *user_data)
+{
+	u32_t *total = user_data;
+	int freq = sys_clock_hw_cycles_per_sec() / 1000000;
+	const char *name = dev->config->name;
+	char fn_name[24];
+
+	total[level] += cycles;
+
+	/* SYS_INIT() entries have no name, show their function */
+	if (name[0] == '\0') {
+		snprintk(fn_name, sizeof(fn_name), "%p", dev->config->init);
+		name = fn_name;
+	}
+
+	TC_PRINT("%-12s %-24s: %u cycles, %u us\n", level_names[level],
+		 name, cycles, cycles / freq);
+}
+
+static void print_init_entries(void)
+{
+	u32_t total[ARRAY_SIZE(level_names)] = { 0 };
+	int freq = sys_clock_hw_cycles_per_sec() / 1000000;
+
+	TC_PRINT("Init functions:\n");
+	device_init_timing_foreach(print_init_entry, total);
+
+	for (int i = 0; i < ARRAY_SIZE(level_names); i++) {
+		TC_PRINT("%-12s total: %u cycles, %u us\n", level_names[i],
+			 total[i], total[i] / freq);
+	}
+}
+#endif
+
 void main(void)
 {
 	u64_t task_time_stamp;      /* timestamp at beginning of first task  */
@@ -72,6 +114,10 @@ void main(void)
 		 (u32_t)(s_idle_time_stamp & 0xFFFFFFFFULL),
 		 (u32_t)  (idle_us  & 0xFFFFFFFFULL));
 
+#ifdef CONFIG_DEVICE_INIT_TIMING
+	print_init_entries();
+#endif
+
 	TC_PRINT("Boot Time Measurement finished\n");
 
 	/* for sanity regression test utility. */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/crc.h>
+
+#ifdef CONFIG_ARCH_POSIX
+#include <time.h>
+#endif
+
+/* This benchmark computes each CRC of a BUF_LEN byte buffer N_ROUNDS
+ * times and prints the throughput, for the implementation selected
+ * with the CRC_IMPLEMENTATION choice.
+ *
+ * Simulated time does not advance while the native application
+ * computes, so on native_posix the host's monotonic clock is used
+ * instead of the cycle counter.
+ */
+
+#define BUF_LEN 4096
+#define N_ROUNDS 64
+
+static u8_t buf[BUF_LEN];
+
+/* Keeps the results from being optimized out */
+static volatile u32_t result;
+
+static u64_t now_ns(void)
+{
+#ifdef CONFIG_ARCH_POSIX
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (u64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+#else
+	return k_cycles_to_ns(k_uptime_cycles_get());
+#endif
+}
+
+/* The CRCs under a common signature, each continuing from @a crc */
+static u32_t crc32_ieee_fn(u32_t crc)
+{
+	return crc32_ieee_update(crc, buf, BUF_LEN);
+}
+
+static u32_t crc16_ccitt_fn(u32_t crc)
+{
+	return crc16_ccitt(crc, buf, BUF_LEN);
+}
+
+static u32_t crc16_itu_t_fn(u32_t crc)
+{
+	return crc16_itu_t(crc, buf, BUF_LEN);
+}
+
+static u32_t crc8_ccitt_fn(u32_t crc)
+{
+	return crc8_ccitt(crc, buf, BUF_LEN);
+}
+
+static const struct {
+	const char *name;
+	u32_t (*fn)(u32_t crc);
+} crcs[] = {
+	{ "crc32_ieee", crc32_ieee_fn },
+	{ "crc16_ccitt", crc16_ccitt_fn },
+	{ "crc16_itu_t", crc16_itu_t_fn },
+	{ "crc8_ccitt", crc8_ccitt_fn },
+};
+
+void main(void)
+{
+	for (int i = 0; i < BUF_LEN; i++) {
+		buf[i] = i * 7U + 3U;
+	}
+
+	printk("%s, carry-less multiply %s\n",
+	       CONFIG_CRC_SLICES == 0 ? "bitwise" :
+	       CONFIG_CRC_SLICES == 4 ? "slice-by-4" : "slice-by-8",
+	       IS_ENABLED(CONFIG_CRC32_IEEE_PCLMUL) ? "on" : "off");
+
+	for (int i = 0; i < ARRAY_SIZE(crcs); i++) {
+		u32_t crc = 0U;
+		u64_t start, ns;
+
+		start = now_ns();
+		for (int round = 0; round < N_ROUNDS; round++) {
+			crc = crcs[i].fn(crc);
+		}
+		ns = MAX(now_ns() - start, 1U);
+		result = crc;
+
+		printk("%-12s %8u KB/s\n", crcs[i].name,
+		       (u32_t)((u64_t)BUF_LEN * N_ROUNDS * NSEC_PER_SEC /
+			       1024U / ns));
+	}
+
+	printk("fin\n");
+}
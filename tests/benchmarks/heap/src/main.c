@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This benchmark runs the same pseudo-random allocation workload
+ * against a k_mem_pool and a k_heap of equal usable size and reports
+ * how much of the arena each manages to hand out, and what alloc and
+ * free cost on average and in the worst case.
+ *
+ * With CONFIG_MEM_POOL_HEAP_BACKEND the pool is itself a k_heap, so
+ * both rows measure the TLSF allocator (plus the pool wrapper).
+ */
+
+#define ARENA_SIZE 16384
+#define MIN_ALLOC 8
+#define MAX_ALLOC 512
+#define N_SLOTS 64
+#define N_CHURN 20000
+
+K_MEM_POOL_DEFINE(bench_pool, 16, ARENA_SIZE, 1, 4);
+K_HEAP_DEFINE(bench_heap, ARENA_SIZE + Z_HEAP_CTL_SIZE(ARENA_SIZE));
+
+struct allocator {
+	const char *name;
+	void *(*alloc)(size_t bytes);
+	void (*free)(void *mem);
+};
+
+static void *pool_alloc(size_t bytes)
+{
+	return k_mem_pool_malloc(&bench_pool, bytes);
+}
+
+static void *heap_alloc(size_t bytes)
+{
+	return k_heap_alloc(&bench_heap, bytes, K_NO_WAIT);
+}
+
+static void heap_free(void *mem)
+{
+	k_heap_free(&bench_heap, mem);
+}
+
+static const struct allocator allocators[] = {
+	{ "pool", pool_alloc, k_free },
+	{ "heap", heap_alloc, heap_free },
+};
+
+static void *fill_ptrs[ARENA_SIZE / MIN_ALLOC];
+
+static struct {
+	void *mem;
+	size_t bytes;
+} slots[N_SLOTS];
+
+static u32_t lcg_state;
+
+/* Deterministic so that every allocator sees the same sequence */
+static u32_t lcg(void)
+{
+	lcg_state = lcg_state * 1103515245U + 12345U;
+	return lcg_state >> 8;
+}
+
+static size_t rand_size(void)
+{
+	return MIN_ALLOC + lcg() % (MAX_ALLOC - MIN_ALLOC + 1);
+}
+
+/* Allocate until the first failure, return the percentage of the
+ * arena that was handed out in requested bytes.
+ */
+static u32_t fill(const struct allocator *a)
+{
+	size_t total = 0;
+	int i, n;
+
+	lcg_state = 1U;
+
+	for (n = 0; n < ARRAY_SIZE(fill_ptrs); n++) {
+		size_t bytes = rand_size();
+
+		fill_ptrs[n] = a->alloc(bytes);
+		if (fill_ptrs[n] == NULL) {
+			break;
+		}
+		total += bytes;
+	}
+
+	for (i = 0; i < n; i++) {
+		a->free(fill_ptrs[i]);
+	}
+
+	return (u32_t)(total * 100U / ARENA_SIZE);
+}
+
+static void churn(const struct allocator *a)
+{
+	u32_t alloc_sum = 0U, alloc_max = 0U, n_alloc = 0U;
+	u32_t free_sum = 0U, free_max = 0U, n_free = 0U;
+	u32_t failures = 0U;
+	int i;
+
+	lcg_state = 2U;
+
+	for (i = 0; i < N_CHURN; i++) {
+		int s = lcg() % N_SLOTS;
+		u32_t start, dt;
+
+		if (slots[s].mem != NULL) {
+			start = k_cycle_get_32();
+			a->free(slots[s].mem);
+			dt = k_cycle_get_32() - start;
+
+			slots[s].mem = NULL;
+			free_sum += dt;
+			free_max = MAX(free_max, dt);
+			n_free++;
+			continue;
+		}
+
+		slots[s].bytes = rand_size();
+
+		start = k_cycle_get_32();
+		slots[s].mem = a->alloc(slots[s].bytes);
+		dt = k_cycle_get_32() - start;
+
+		alloc_sum += dt;
+		alloc_max = MAX(alloc_max, dt);
+		n_alloc++;
+
+		if (slots[s].mem == NULL) {
+			failures++;
+		}
+	}
+
+	for (i = 0; i < N_SLOTS; i++) {
+		if (slots[i].mem != NULL) {
+			a->free(slots[i].mem);
+			slots[i].mem = NULL;
+		}
+	}
+
+	printk("%s alloc avg %5u max %6u free avg %5u max %6u"
+	       " failures %u (cycles)\n", a->name,
+	       alloc_sum / MAX(n_alloc, 1U), alloc_max,
+	       free_sum / MAX(n_free, 1U), free_max, failures);
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(allocators); i++) {
+		const struct allocator *a = &allocators[i];
+
+		printk("%s fill %3u%%\n", a->name, fill(a));
+		churn(a);
+	}
+
+	printk("fin\n");
+}
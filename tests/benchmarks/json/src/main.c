@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <data/json.h>
+
+/* This benchmark parses PAYLOAD N_ROUNDS times with json_obj_parse()
+ * and with the incremental parser, fed all at once or in CHUNK byte
+ * pieces, and with the values of most keys skipped, and prints the
+ * average cycles per parse and the throughput.  All variants but the
+ * skipping one fill the whole struct report; that one only extracts
+ * "device" and "seq".
+ */
+
+#define N_ROUNDS 200
+#define CHUNK 64
+#define MAX_SAMPLES 16
+#define MAX_HISTORY 4
+
+#define SAMPLE "{\"ts\":1565000000,\"temp\":2150,\"hum\":4312,\"ok\":true," \
+	       "\"values\":[12,15,17,21,25,19,16,14,13,12,11,10,9,8,7,6]}"
+
+static const char payload[] =
+	"{\"device\":\"sensor-0042\",\"seq\":123456,\"online\":true,"
+	"\"fw\":\"v1.14.99\",\"location\":{\"lat\":52520008,"
+	"\"lon\":13404954,\"alt\":34},\"history\":["
+	SAMPLE "," SAMPLE "," SAMPLE "," SAMPLE "]}";
+
+struct sample {
+	int ts;
+	int temp;
+	int hum;
+	bool ok;
+	int values[MAX_SAMPLES];
+	size_t values_len;
+};
+
+struct location {
+	int lat;
+	int lon;
+	int alt;
+};
+
+struct report {
+	const char *device;
+	int seq;
+	bool online;
+	const char *fw;
+	struct location location;
+	struct sample history[MAX_HISTORY];
+	size_t history_len;
+};
+
+static const struct json_obj_descr sample_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct sample, ts, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct sample, temp, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct sample, hum, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct sample, ok, JSON_TOK_TRUE),
+	JSON_OBJ_DESCR_ARRAY(struct sample, values, MAX_SAMPLES, values_len,
+			     JSON_TOK_NUMBER),
+};
+
+static const struct json_obj_descr location_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct location, lat, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct location, lon, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct location, alt, JSON_TOK_NUMBER),
+};
+
+static const struct json_obj_descr report_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct report, device, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct report, seq, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct report, online, JSON_TOK_TRUE),
+	JSON_OBJ_DESCR_PRIM(struct report, fw, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_OBJECT(struct report, location, location_descr),
+	JSON_OBJ_DESCR_OBJ_ARRAY(struct report, history, MAX_HISTORY,
+				 history_len, sample_descr,
+				 ARRAY_SIZE(sample_descr)),
+};
+
+static char work[sizeof(payload)];
+static char device[32];
+static char fw[16];
+static struct report report;
+
+/* Keys of the payload, as the incremental parser's callback knows
+ * them
+ */
+enum field {
+	F_NONE,
+	F_DEVICE,
+	F_SEQ,
+	F_ONLINE,
+	F_FW,
+	F_LOCATION,
+	F_LAT,
+	F_LON,
+	F_ALT,
+	F_HISTORY,
+	F_TS,
+	F_TEMP,
+	F_HUM,
+	F_OK,
+	F_VALUES,
+};
+
+static const char *const field_names[] = {
+	[F_DEVICE] = "device",
+	[F_SEQ] = "seq",
+	[F_ONLINE] = "online",
+	[F_FW] = "fw",
+	[F_LOCATION] = "location",
+	[F_LAT] = "lat",
+	[F_LON] = "lon",
+	[F_ALT] = "alt",
+	[F_HISTORY] = "history",
+	[F_TS] = "ts",
+	[F_TEMP] = "temp",
+	[F_HUM] = "hum",
+	[F_OK] = "ok",
+	[F_VALUES] = "values",
+};
+
+static enum field lookup(const char *key)
+{
+	for (int f = F_NONE + 1; f < ARRAY_SIZE(field_names); f++) {
+		if (!strcmp(key, field_names[f])) {
+			return f;
+		}
+	}
+
+	return F_NONE;
+}
+
+/* What the incremental parser's callback gathers, into the same
+ * struct report as json_obj_parse()
+ */
+struct stream_state {
+	struct report *report;
+	/* key[d]: last key seen within d objects and arrays */
+	enum field key[4];
+	bool skip;
+};
+
+static void copy_str(char *dst, size_t size, const char *src)
+{
+	strncpy(dst, src, size - 1);
+	dst[size - 1] = '\0';
+}
+
+/* Values directly in the report object */
+static void top_value(struct stream_state *state,
+		      const struct json_stream_token *token)
+{
+	struct report *r = state->report;
+
+	switch (state->key[1]) {
+	case F_DEVICE:
+		copy_str(device, sizeof(device), token->str);
+		r->device = device;
+		break;
+	case F_SEQ:
+		r->seq = token->i64;
+		break;
+	case F_ONLINE:
+		r->online = token->type == JSON_TOK_TRUE;
+		break;
+	case F_FW:
+		copy_str(fw, sizeof(fw), token->str);
+		r->fw = fw;
+		break;
+	default:
+		break;
+	}
+}
+
+/* Values in "location" or in a sample of "history" */
+static void nested_value(struct stream_state *state,
+			 const struct json_stream_token *token)
+{
+	struct report *r = state->report;
+	struct sample *s;
+
+	if (token->depth == 2 && state->key[1] == F_LOCATION) {
+		switch (state->key[2]) {
+		case F_LAT:
+			r->location.lat = token->i64;
+			break;
+		case F_LON:
+			r->location.lon = token->i64;
+			break;
+		case F_ALT:
+			r->location.alt = token->i64;
+			break;
+		default:
+			break;
+		}
+	} else if (token->depth == 3 && state->key[1] == F_HISTORY) {
+		s = &r->history[r->history_len - 1];
+
+		switch (state->key[3]) {
+		case F_TS:
+			s->ts = token->i64;
+			break;
+		case F_TEMP:
+			s->temp = token->i64;
+			break;
+		case F_HUM:
+			s->hum = token->i64;
+			break;
+		case F_OK:
+			s->ok = token->type == JSON_TOK_TRUE;
+			break;
+		default:
+			break;
+		}
+	} else if (token->depth == 4 && state->key[1] == F_HISTORY &&
+		   state->key[3] == F_VALUES) {
+		s = &r->history[r->history_len - 1];
+
+		if (s->values_len < MAX_SAMPLES) {
+			s->values[s->values_len++] = token->i64;
+		}
+	}
+}
+
+static int on_token(const struct json_stream_token *token, void *user_data)
+{
+	struct stream_state *state = user_data;
+	struct report *r = state->report;
+
+	if (token->key) {
+		enum field f = lookup(token->str);
+
+		/* the payload has no keys deeper than this */
+		if (token->depth >= ARRAY_SIZE(state->key)) {
+			return JSON_STREAM_SKIP;
+		}
+
+		if (state->skip && token->depth == 1 &&
+		    f != F_SEQ && f != F_DEVICE) {
+			return JSON_STREAM_SKIP;
+		}
+
+		state->key[token->depth] = f;
+		return 0;
+	}
+
+	switch (token->type) {
+	case JSON_TOK_OBJECT_START:
+		/* a new sample of "history" */
+		if (token->depth == 2 && state->key[1] == F_HISTORY) {
+			if (r->history_len == MAX_HISTORY) {
+				return JSON_STREAM_SKIP;
+			}
+			r->history[r->history_len++].values_len = 0;
+		}
+		break;
+	case JSON_TOK_OBJECT_END:
+	case JSON_TOK_LIST_START:
+	case JSON_TOK_LIST_END:
+		break;
+	default:
+		if (token->depth == 1) {
+			top_value(state, token);
+		} else {
+			nested_value(state, token);
+		}
+		break;
+	}
+
+	return 0;
+}
+
+static int parse_obj(void)
+{
+	size_t len = sizeof(payload) - 1;
+	int ret;
+
+	/* json_obj_parse() works in place */
+	memcpy(work, payload, len);
+	ret = json_obj_parse(work, len, report_descr,
+			     ARRAY_SIZE(report_descr), &report);
+
+	return ret == BIT_MASK(ARRAY_SIZE(report_descr)) ? 0 : -EINVAL;
+}
+
+static int parse_stream(size_t chunk, bool skip)
+{
+	static char buf[32];
+	struct stream_state state = { .report = &report, .skip = skip };
+	struct json_stream js;
+	size_t len = sizeof(payload) - 1;
+	int ret = 0;
+
+	report.history_len = 0;
+	json_stream_init(&js, on_token, &state, buf, sizeof(buf));
+
+	for (size_t off = 0; off < len && ret == 0; off += chunk) {
+		ret = json_stream_feed(&js, payload + off,
+				       MIN(chunk, len - off));
+	}
+
+	if (ret == 0) {
+		ret = json_stream_finish(&js);
+	}
+
+	if (ret == 0 && (report.seq != 123456 ||
+			 report.history_len != (skip ? 0 : MAX_HISTORY))) {
+		ret = -EINVAL;
+	}
+
+	return ret;
+}
+
+static int parse_whole(void)
+{
+	return parse_stream(sizeof(payload), false);
+}
+
+static int parse_chunked(void)
+{
+	return parse_stream(CHUNK, false);
+}
+
+static int parse_skip(void)
+{
+	return parse_stream(sizeof(payload), true);
+}
+
+static void time_parser(const char *name, int (*parse)(void))
+{
+	u32_t start, cycles;
+	u64_t kbps;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < N_ROUNDS; i++) {
+		if (parse() < 0) {
+			printk("%s failed\n", name);
+			return;
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	kbps = (u64_t)(sizeof(payload) - 1) * N_ROUNDS *
+	       sys_clock_hw_cycles_per_sec() / 1024U / MAX(cycles, 1U);
+	printk("%-16s %8u cycles %6u KB/s\n", name, cycles / N_ROUNDS,
+	       (u32_t)kbps);
+}
+
+void main(void)
+{
+	printk("payload %u bytes, chunks of %u bytes\n",
+	       (u32_t)sizeof(payload) - 1, CHUNK);
+
+	time_parser("json_obj_parse", parse_obj);
+	time_parser("stream", parse_whole);
+	time_parser("stream_chunked", parse_chunked);
+	time_parser("stream_skip", parse_skip);
+
+	printk("fin\n");
+}
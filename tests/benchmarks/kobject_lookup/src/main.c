@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <app_memory/app_memdomain.h>
+
+/* This benchmark reports the average cost, in cycles, of a system call
+ * on a semaphore made from a user thread: a statically defined one, a
+ * single dynamically allocated one, and N_OBJECTS dynamically allocated
+ * ones in turn.  Each call has the kernel look up the semaphore and
+ * check the thread's permission on it.
+ *
+ * Build it with CONFIG_KOBJECT_CACHE_SIZE=0 to measure every call going
+ * through the full lookup.
+ */
+
+#define N_OBJECTS 1000
+#define N_ROUNDS 10
+#define STACK_SIZE 1024
+
+enum bench_op {
+	OP_STATIC,
+	OP_DYNAMIC_ONE,
+	OP_DYNAMIC_ALL,
+	OP_COUNT,
+};
+
+static const char *const op_names[OP_COUNT] = {
+	"static", "dynamic, one object", "dynamic, all objects"
+};
+
+K_APPMEM_PARTITION_DEFINE(bench_partition);
+#define BENCH_BMEM K_APP_BMEM(bench_partition)
+
+static struct k_mem_domain bench_domain;
+
+K_SEM_DEFINE(bench_sem, 0, 1);
+BENCH_BMEM struct k_sem *dyn_sem[N_OBJECTS];
+
+static K_THREAD_STACK_DEFINE(bench_stack, STACK_SIZE);
+static struct k_thread bench_thread;
+
+static void bench_loop(void *p1, void *p2, void *p3)
+{
+	enum bench_op op = POINTER_TO_INT(p1);
+	struct k_sem *sem;
+
+	for (int r = 0; r < N_ROUNDS; r++) {
+		for (int i = 0; i < N_OBJECTS; i++) {
+			switch (op) {
+			case OP_STATIC:
+				sem = &bench_sem;
+				break;
+			case OP_DYNAMIC_ONE:
+				sem = dyn_sem[0];
+				break;
+			default:
+				sem = dyn_sem[i];
+				break;
+			}
+
+			k_sem_give(sem);
+			(void)k_sem_take(sem, K_NO_WAIT);
+		}
+	}
+}
+
+/* The loop runs in a thread of higher priority than main, so it is
+ * done by the time k_thread_start() returns.  Creating and exiting
+ * the thread is amortized over all the calls.
+ */
+static void measure(enum bench_op op)
+{
+	u32_t start, cycles;
+
+	k_thread_create(&bench_thread, bench_stack, STACK_SIZE, bench_loop,
+			INT_TO_POINTER(op), NULL, NULL, K_PRIO_PREEMPT(0),
+			K_USER | K_INHERIT_PERMS, K_FOREVER);
+	k_mem_domain_add_thread(&bench_domain, &bench_thread);
+
+	start = k_cycle_get_32();
+	k_thread_start(&bench_thread);
+	cycles = k_cycle_get_32() - start;
+
+	printk("%-22s %6u cycles\n", op_names[op],
+	       cycles / (2 * N_ROUNDS * N_OBJECTS));
+}
+
+void main(void)
+{
+	struct k_mem_partition *parts[] = { &bench_partition };
+
+	k_mem_domain_init(&bench_domain, ARRAY_SIZE(parts), parts);
+	k_thread_system_pool_assign(k_current_get());
+	k_object_access_grant(&bench_sem, k_current_get());
+
+	/* The allocating thread gets permission on the objects, and the
+	 * benchmark thread inherits it
+	 */
+	for (int i = 0; i < N_OBJECTS; i++) {
+		dyn_sem[i] = k_object_alloc(K_OBJ_SEM);
+		if (dyn_sem[i] == NULL) {
+			printk("could only allocate %d objects\n", i);
+			return;
+		}
+		k_sem_init(dyn_sem[i], 0, 1);
+	}
+
+	for (int op = 0; op < OP_COUNT; op++) {
+		measure(op);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* The main thread writes fixed size chunks into a pipe that a higher
+ * priority thread drains, and reports how many bytes per second get
+ * through, with single buffers and with four segment vectors.
+ */
+
+#define MAX_CHUNK 4096
+#define TOTAL_BYTES (256 * 1024)
+#define N_SEGS 4
+#define STACK_SIZE 1024
+
+static const size_t chunk_sizes[] = { 16, 256, MAX_CHUNK };
+
+K_PIPE_DEFINE(bench_pipe, 1024, 4);
+
+static u8_t tx_buf[MAX_CHUNK];
+static u8_t rx_buf[MAX_CHUNK];
+
+static K_THREAD_STACK_DEFINE(reader_stack, STACK_SIZE);
+static struct k_thread reader_thread;
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+/* Split @a buf into N_SEGS segments of @a chunk bytes in total */
+static void make_iov(struct k_pipe_iovec *iov, u8_t *buf, size_t chunk)
+{
+	for (int i = 0; i < N_SEGS; i++) {
+		iov[i].base = buf + i * (chunk / N_SEGS);
+		iov[i].len = chunk / N_SEGS;
+	}
+}
+
+static void reader(void *p1, void *p2, void *p3)
+{
+	size_t chunk = POINTER_TO_INT(p1);
+	bool vectored = POINTER_TO_INT(p2);
+	struct k_pipe_iovec iov[N_SEGS];
+	size_t bytes;
+
+	make_iov(iov, rx_buf, chunk);
+
+	for (size_t total = 0; total < TOTAL_BYTES; total += bytes) {
+		if (vectored) {
+			(void)k_pipe_readv(&bench_pipe, iov, N_SEGS, &bytes,
+					   chunk, K_FOREVER);
+		} else {
+			(void)k_pipe_get(&bench_pipe, rx_buf, chunk, &bytes,
+					 chunk, K_FOREVER);
+		}
+	}
+
+	k_sem_give(&done_sem);
+}
+
+static void run(size_t chunk, bool vectored)
+{
+	struct k_pipe_iovec iov[N_SEGS];
+	u32_t start, cycles;
+	u64_t ns;
+	size_t bytes;
+
+	make_iov(iov, tx_buf, chunk);
+
+	k_thread_create(&reader_thread, reader_stack, STACK_SIZE, reader,
+			INT_TO_POINTER(chunk), INT_TO_POINTER(vectored), NULL,
+			K_PRIO_PREEMPT(5), 0, 0);
+
+	start = k_cycle_get_32();
+
+	for (size_t total = 0; total < TOTAL_BYTES; total += bytes) {
+		if (vectored) {
+			(void)k_pipe_writev(&bench_pipe, iov, N_SEGS, &bytes,
+					    chunk, K_FOREVER);
+		} else {
+			(void)k_pipe_put(&bench_pipe, tx_buf, chunk, &bytes,
+					 chunk, K_FOREVER);
+		}
+	}
+	k_sem_take(&done_sem, K_FOREVER);
+
+	cycles = k_cycle_get_32() - start;
+	ns = MAX(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles), 1ULL);
+
+	/* bytes per microsecond is MB/s */
+	printk("%-12s %4u B: %6u MB/s (%u cycles)\n",
+	       vectored ? "writev/readv" : "put/get", (u32_t)chunk,
+	       (u32_t)((u64_t)TOTAL_BYTES * 1000U / ns), cycles);
+
+	k_thread_abort(&reader_thread);
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(chunk_sizes); i++) {
+		run(chunk_sizes[i], false);
+		run(chunk_sizes[i], true);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* A high priority thread waits on N semaphores, the main thread gives
+ * them in turn and times how long it takes until the waiter is back
+ * to waiting, once with k_poll() and once with a k_poll_set.
+ */
+
+#define MAX_OBJS 512
+#define ITERATIONS 1000
+#define STACK_SIZE 1024
+
+static const int n_objs[] = { 8, 64, 512 };
+
+static struct k_sem sems[MAX_OBJS];
+static struct k_poll_event events[MAX_OBJS];
+K_POLL_SET_DEFINE(bench_set, MAX_OBJS);
+
+static K_THREAD_STACK_DEFINE(waiter_stack, STACK_SIZE);
+static struct k_thread waiter_thread;
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+static void poll_waiter(void *p1, void *p2, void *p3)
+{
+	int n = POINTER_TO_INT(p1);
+
+	for (int i = 0; i < n; i++) {
+		k_poll_event_init(&events[i], K_POLL_TYPE_SEM_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &sems[i]);
+	}
+
+	for (int iter = 0; iter < ITERATIONS; iter++) {
+		(void)k_poll(events, n, K_FOREVER);
+
+		/* Finding the ready event is part of the k_poll() cost */
+		for (int i = 0; i < n; i++) {
+			if (events[i].state != K_POLL_STATE_NOT_READY) {
+				events[i].state = K_POLL_STATE_NOT_READY;
+				k_sem_take(&sems[i], K_NO_WAIT);
+			}
+		}
+	}
+
+	k_sem_give(&done_sem);
+}
+
+static void set_waiter(void *p1, void *p2, void *p3)
+{
+	int n = POINTER_TO_INT(p1);
+	struct k_poll_set_event ready[4];
+
+	for (int i = 0; i < n; i++) {
+		(void)k_poll_set_add(&bench_set, K_POLL_TYPE_SEM_AVAILABLE,
+				     &sems[i], i);
+	}
+
+	for (int iter = 0; iter < ITERATIONS; iter++) {
+		int ret = k_poll_set_wait(&bench_set, ready, ARRAY_SIZE(ready),
+					  K_FOREVER);
+
+		for (int i = 0; i < ret; i++) {
+			k_sem_take(ready[i].obj, K_NO_WAIT);
+		}
+	}
+
+	for (int i = 0; i < n; i++) {
+		(void)k_poll_set_remove(&bench_set, &sems[i]);
+	}
+
+	k_sem_give(&done_sem);
+}
+
+static void run(const char *name, k_thread_entry_t waiter, int n)
+{
+	u32_t sum = 0U, max = 0U;
+
+	for (int i = 0; i < n; i++) {
+		k_sem_init(&sems[i], 0, 1);
+	}
+
+	k_thread_create(&waiter_thread, waiter_stack, STACK_SIZE, waiter,
+			INT_TO_POINTER(n), NULL, NULL, K_PRIO_PREEMPT(5), 0, 0);
+
+	/* Let the waiter set up and block */
+	k_sleep(10);
+
+	for (int iter = 0; iter < ITERATIONS; iter++) {
+		u32_t start = k_cycle_get_32();
+		u32_t dt;
+
+		/* Preempted by the waiter until it blocks again */
+		k_sem_give(&sems[iter % n]);
+		dt = k_cycle_get_32() - start;
+
+		sum += dt;
+		max = MAX(max, dt);
+	}
+
+	k_sem_take(&done_sem, K_FOREVER);
+
+	printk("%-8s N=%-3d wakeup avg %6u max %7u (cycles)\n", name, n,
+	       sum / ITERATIONS, max);
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(n_objs); i++) {
+		run("k_poll", poll_waiter, n_objs[i]);
+		run("poll_set", set_waiter, n_objs[i]);
+	}
+
+	printk("fin\n");
+}
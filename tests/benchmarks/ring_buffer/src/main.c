@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/ring_buffer.h>
+
+/* This benchmark moves TOTAL_BYTES from producers to a consumer through
+ * each kind of ring buffer, and prints the throughput.  Producers and
+ * consumer poll, yielding when the buffer is full or empty, so with
+ * CONFIG_SMP they run at the same time on different CPUs and the
+ * numbers reflect the cost of the synchronization between them.
+ */
+
+#define BUF_POW 10
+#define CHUNK 64
+#define ITEM_WORDS 16
+#define TOTAL_BYTES (4 * 1024 * 1024)
+#define N_PRODUCERS CONFIG_MP_NUM_CPUS
+#define STACK_SIZE 1024
+
+RING_BUF_DECLARE(locked_buf, BIT(BUF_POW));
+RING_BUF_SPSC_DECLARE_POW2(spsc_buf, BUF_POW);
+RING_BUF_MPSC_DECLARE_POW2(mpsc_buf, BUF_POW - 2);
+
+static struct k_thread threads[N_PRODUCERS + 1];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, N_PRODUCERS + 1, STACK_SIZE);
+static K_SEM_DEFINE(done_sem, 0, N_PRODUCERS + 1);
+
+static u8_t src_data[CHUNK];
+
+static void locked_producer(u32_t bytes)
+{
+	unsigned int key;
+	u32_t len;
+
+	while (bytes > 0U) {
+		key = irq_lock();
+		len = ring_buf_put(&locked_buf, src_data, MIN(bytes, CHUNK));
+		irq_unlock(key);
+
+		if (len == 0U) {
+			k_yield();
+		}
+		bytes -= len;
+	}
+}
+
+static void locked_consumer(u32_t bytes)
+{
+	u8_t data[CHUNK];
+	unsigned int key;
+	u32_t len;
+
+	while (bytes > 0U) {
+		key = irq_lock();
+		len = ring_buf_get(&locked_buf, data, sizeof(data));
+		irq_unlock(key);
+
+		if (len == 0U) {
+			k_yield();
+		}
+		bytes -= len;
+	}
+}
+
+static void spsc_producer(u32_t bytes)
+{
+	struct ring_buf_segs segs;
+	u32_t len;
+
+	while (bytes > 0U) {
+		len = ring_buf_spsc_put_claim(&spsc_buf, &segs,
+					      MIN(bytes, CHUNK));
+		if (len == 0U) {
+			k_yield();
+			continue;
+		}
+
+		memcpy(segs.data[0], src_data, segs.size[0]);
+		memcpy(segs.data[1], src_data + segs.size[0], segs.size[1]);
+		ring_buf_spsc_put_finish(&spsc_buf, len);
+		bytes -= len;
+	}
+}
+
+static void spsc_consumer(u32_t bytes)
+{
+	struct ring_buf_segs segs;
+	u8_t data[CHUNK];
+	u32_t len;
+
+	while (bytes > 0U) {
+		/* Take whatever is there, in up to two areas at once */
+		len = ring_buf_spsc_get_claim(&spsc_buf, &segs, bytes);
+		if (len == 0U) {
+			k_yield();
+			continue;
+		}
+
+		for (int s = 0; s < 2; s++) {
+			for (u32_t off = 0; off < segs.size[s]; off += CHUNK) {
+				memcpy(data, segs.data[s] + off,
+				       MIN(CHUNK, segs.size[s] - off));
+			}
+		}
+		ring_buf_spsc_get_finish(&spsc_buf, len);
+		bytes -= len;
+	}
+}
+
+static void mpsc_producer(u32_t bytes)
+{
+	while (bytes > 0U) {
+		if (ring_buf_mpsc_item_put(&mpsc_buf, 0, 0,
+					   (const u32_t *)src_data,
+					   ITEM_WORDS) != 0) {
+			k_yield();
+			continue;
+		}
+		bytes -= MIN(bytes, ITEM_WORDS * sizeof(u32_t));
+	}
+}
+
+static void mpsc_consumer(u32_t bytes)
+{
+	u32_t data[ITEM_WORDS];
+	u16_t type;
+	u8_t value, size32;
+
+	while (bytes > 0U) {
+		size32 = ITEM_WORDS;
+		if (ring_buf_mpsc_item_get(&mpsc_buf, &type, &value, data,
+					   &size32) != 0) {
+			k_yield();
+			continue;
+		}
+		bytes -= MIN(bytes, size32 * sizeof(u32_t));
+	}
+}
+
+struct ring_bench {
+	const char *name;
+	void (*producer)(u32_t bytes);
+	void (*consumer)(u32_t bytes);
+	/* Only the MPSC ring buffer takes several producers, the others
+	 * get all the data from one
+	 */
+	int n_producers;
+};
+
+static const struct ring_bench benches[] = {
+	{ "locked", locked_producer, locked_consumer, 1 },
+	{ "spsc", spsc_producer, spsc_consumer, 1 },
+	{ "mpsc", mpsc_producer, mpsc_consumer, N_PRODUCERS },
+};
+
+static void run(void *p1, void *p2, void *p3)
+{
+	void (*fn)(u32_t bytes) = p1;
+
+	fn(POINTER_TO_UINT(p2));
+	k_sem_give(&done_sem);
+}
+
+/* Streams TOTAL_BYTES through the ring buffer, returns the KB/s */
+static u32_t stream(const struct ring_bench *b)
+{
+	int n = b->n_producers;
+	u32_t start, cycles;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < n; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, run,
+				b->producer,
+				UINT_TO_POINTER(TOTAL_BYTES / n), NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+	k_thread_create(&threads[n], stacks[n], STACK_SIZE, run,
+			b->consumer, UINT_TO_POINTER(TOTAL_BYTES), NULL,
+			K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+
+	for (int i = 0; i <= n; i++) {
+		k_sem_take(&done_sem, K_FOREVER);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	/* Make sure the threads are gone before their structs are reused */
+	for (int i = 0; i <= n; i++) {
+		k_thread_abort(&threads[i]);
+	}
+
+	return (u64_t)TOTAL_BYTES * sys_clock_hw_cycles_per_sec() /
+	       1024U / MAX(cycles, 1U);
+}
+
+void main(void)
+{
+	printk("cpus %d, %u bytes per run, ring buffers of %u bytes\n",
+	       CONFIG_MP_NUM_CPUS, TOTAL_BYTES, (u32_t)BIT(BUF_POW));
+
+	for (int i = 0; i < ARRAY_SIZE(benches); i++) {
+		printk("%-8s %8u KB/s\n", benches[i].name,
+		       stream(&benches[i]));
+	}
+
+	printk("fin\n");
+}
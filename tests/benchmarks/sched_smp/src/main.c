@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This is a scheduler scalability benchmark for SMP.  It creates two
+ * threads per CPU, organized in pairs which ping-pong a pair of
+ * semaphores as fast as they can: every handoff blocks one thread and
+ * readies its partner, so each one costs a context switch on some
+ * CPU.  With enough pairs to keep every CPU busy, the aggregate
+ * switch rate should grow with the CPU count until contention in the
+ * scheduler (e.g. on a single global ready queue) flattens it.
+ *
+ * The main thread samples the handoff counters once per interval and
+ * prints the switch rate.  Build it with different CONFIG_MP_NUM_CPUS
+ * values, with and without CONFIG_SCHED_CPU_RUNQ, to compare.
+ */
+
+#define N_PAIRS CONFIG_MP_NUM_CPUS
+#define N_INTERVALS 5
+#define INTERVAL_MS 1000
+#define STACK_SIZE 1024
+
+struct pair {
+	struct k_sem ping;
+	struct k_sem pong;
+	volatile u32_t handoffs;
+};
+
+static struct pair pairs[N_PAIRS];
+
+static struct k_thread threads[2 * N_PAIRS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, 2 * N_PAIRS, STACK_SIZE);
+
+static void pinger(void *p1, void *p2, void *p3)
+{
+	struct pair *p = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_give(&p->ping);
+		k_sem_take(&p->pong, K_FOREVER);
+		p->handoffs += 2U;
+	}
+}
+
+static void ponger(void *p1, void *p2, void *p3)
+{
+	struct pair *p = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&p->ping, K_FOREVER);
+		k_sem_give(&p->pong);
+	}
+}
+
+static u32_t total_handoffs(void)
+{
+	u32_t sum = 0U;
+
+	for (int i = 0; i < N_PAIRS; i++) {
+		sum += pairs[i].handoffs;
+	}
+	return sum;
+}
+
+void main(void)
+{
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+	u32_t last, now;
+
+	for (int i = 0; i < N_PAIRS; i++) {
+		k_sem_init(&pairs[i].ping, 0, 1);
+		k_sem_init(&pairs[i].pong, 0, 1);
+
+		k_thread_create(&threads[2 * i], stacks[2 * i], STACK_SIZE,
+				pinger, &pairs[i], NULL, NULL, prio, 0,
+				K_NO_WAIT);
+		k_thread_create(&threads[2 * i + 1], stacks[2 * i + 1],
+				STACK_SIZE, ponger, &pairs[i], NULL, NULL, prio,
+				0, K_NO_WAIT);
+	}
+
+	/* Let everything get going before sampling */
+	k_sleep(100);
+	last = total_handoffs();
+
+	for (int i = 0; i < N_INTERVALS; i++) {
+		k_sleep(INTERVAL_MS);
+		now = total_handoffs();
+
+		printk("cpus %d pairs %d switches/s %u\n",
+		       CONFIG_MP_NUM_CPUS, N_PAIRS,
+		       (now - last) * 1000U / INTERVAL_MS);
+		last = now;
+	}
+
+	printk("fin\n");
+}
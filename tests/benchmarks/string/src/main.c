@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+
+/* This benchmark calls each string routine on buffers of 1 byte to
+ * MAX_LEN bytes, enough times to process about BYTES_PER_RUN bytes,
+ * and prints a table of the throughput with a row per routine and a
+ * column per size, for whichever C library was built.
+ */
+
+#define MAX_LEN 4096
+#define BYTES_PER_RUN (64 * 1024)
+#define MIN_ROUNDS 256
+
+static const size_t sizes[] = { 1, 4, 16, 64, 256, 1024, 4096 };
+
+static char buf_a[MAX_LEN + 8] __aligned(8);
+static char buf_b[MAX_LEN + 8] __aligned(8);
+
+/* Hides the sizes from the compiler, so that it cannot expand the calls
+ * inline, and keeps the results from being optimized out.
+ */
+static volatile size_t len_var;
+static volatile size_t result;
+
+static size_t run_memcpy(size_t len)
+{
+	return (size_t)memcpy(buf_b, buf_a, len);
+}
+
+static size_t run_memcpy_unaligned(size_t len)
+{
+	return (size_t)memcpy(buf_b, buf_a + 1, len);
+}
+
+static size_t run_memset(size_t len)
+{
+	return (size_t)memset(buf_b, 'b', len);
+}
+
+static size_t run_strlen(size_t len)
+{
+	ARG_UNUSED(len);
+
+	return strlen(buf_a);
+}
+
+static size_t run_strcmp(size_t len)
+{
+	ARG_UNUSED(len);
+
+	return strcmp(buf_a, buf_b);
+}
+
+static size_t run_memchr(size_t len)
+{
+	return (size_t)memchr(buf_a, 'z', len);
+}
+
+static const struct {
+	const char *name;
+	size_t (*run)(size_t len);
+} routines[] = {
+	{ "memcpy", run_memcpy },
+	{ "memcpy+1", run_memcpy_unaligned },
+	{ "memset", run_memset },
+	{ "strlen", run_strlen },
+	{ "strcmp", run_strcmp },
+	{ "memchr", run_memchr },
+};
+
+/* Equal strings of @a len bytes, ending with the only 'z' in them */
+static void prepare(size_t len)
+{
+	(void)memset(buf_a, 'a', sizeof(buf_a));
+	(void)memset(buf_b, 'a', sizeof(buf_b));
+	buf_a[len - 1] = buf_b[len - 1] = 'z';
+	buf_a[len] = buf_b[len] = '\0';
+}
+
+static u32_t kbps(size_t (*run)(size_t len), size_t size)
+{
+	u32_t rounds = MAX(BYTES_PER_RUN / size, MIN_ROUNDS);
+	size_t len, acc = 0;
+	u64_t start, ns;
+
+	prepare(size);
+	len_var = size;
+	len = len_var;
+
+	start = k_cycles_to_ns(k_uptime_cycles_get());
+	for (u32_t i = 0; i < rounds; i++) {
+		acc += run(len);
+	}
+	ns = MAX(k_cycles_to_ns(k_uptime_cycles_get()) - start, 1U);
+	result = acc;
+
+	return (u64_t)size * rounds * NSEC_PER_SEC / 1024U / ns;
+}
+
+void main(void)
+{
+	printk("%s, assembly %s, KB/s\n",
+	       IS_ENABLED(CONFIG_NEWLIB_LIBC) ? "newlib" : "minimal libc",
+	       IS_ENABLED(CONFIG_MINIMAL_LIBC_STRING_ASM) ? "on" : "off");
+
+	printk("%-10s", "");
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		printk(" %8zu", sizes[i]);
+	}
+	printk("\n");
+
+	for (int r = 0; r < ARRAY_SIZE(routines); r++) {
+		printk("%-10s", routines[r].name);
+		for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+			printk(" %8u", kbps(routines[r].run, sizes[i]));
+		}
+		printk("\n");
+	}
+
+	printk("fin\n");
+}
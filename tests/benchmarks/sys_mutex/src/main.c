@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/mutex.h>
+#include <app_memory/app_memdomain.h>
+
+/* This benchmark reports the average cost, in cycles, of locking and
+ * unlocking an uncontended mutex: a k_mutex, a sys_mutex, and a
+ * sys_mutex locked twice before being unlocked twice.  Each is run
+ * from a supervisor thread and, when userspace is enabled, from a
+ * user thread, where every k_mutex operation is a syscall.
+ *
+ * Build it with and without CONFIG_SYS_MUTEX_FUTEX to compare the
+ * syscall based sys_mutex with the user space fast path.
+ */
+
+#define N_ITER 10000
+#define STACK_SIZE 1024
+
+enum bench_op {
+	OP_K_MUTEX,
+	OP_SYS_MUTEX,
+	OP_SYS_MUTEX_RECURSIVE,
+	OP_COUNT,
+};
+
+static const char *const op_names[OP_COUNT] = {
+	"k_mutex", "sys_mutex", "sys_mutex recursive"
+};
+
+#ifdef CONFIG_USERSPACE
+K_APPMEM_PARTITION_DEFINE(bench_partition);
+#define BENCH_BMEM K_APP_BMEM(bench_partition)
+
+static struct k_mem_domain bench_domain;
+#else
+#define BENCH_BMEM
+#endif
+
+K_MUTEX_DEFINE(bench_kmutex);
+BENCH_BMEM SYS_MUTEX_DEFINE(bench_mutex);
+
+static K_THREAD_STACK_DEFINE(bench_stack, STACK_SIZE);
+static struct k_thread bench_thread;
+
+static void bench_loop(void *p1, void *p2, void *p3)
+{
+	enum bench_op op = POINTER_TO_INT(p1);
+
+	for (int i = 0; i < N_ITER; i++) {
+		switch (op) {
+		case OP_K_MUTEX:
+			k_mutex_lock(&bench_kmutex, K_FOREVER);
+			k_mutex_unlock(&bench_kmutex);
+			break;
+		case OP_SYS_MUTEX:
+			sys_mutex_lock(&bench_mutex, K_FOREVER);
+			sys_mutex_unlock(&bench_mutex);
+			break;
+		default:
+			sys_mutex_lock(&bench_mutex, K_FOREVER);
+			sys_mutex_lock(&bench_mutex, K_FOREVER);
+			sys_mutex_unlock(&bench_mutex);
+			sys_mutex_unlock(&bench_mutex);
+			break;
+		}
+	}
+}
+
+/* The loop runs in a thread of higher priority than main, so it is
+ * done by the time k_thread_start() returns.  Creating and exiting
+ * the thread is amortized over N_ITER iterations.
+ */
+static void measure(enum bench_op op, u32_t options)
+{
+	u32_t start, cycles;
+
+	k_thread_create(&bench_thread, bench_stack, STACK_SIZE, bench_loop,
+			INT_TO_POINTER(op), NULL, NULL, K_PRIO_PREEMPT(0),
+			options | K_INHERIT_PERMS, K_FOREVER);
+#ifdef CONFIG_USERSPACE
+	k_mem_domain_add_thread(&bench_domain, &bench_thread);
+#endif
+
+	start = k_cycle_get_32();
+	k_thread_start(&bench_thread);
+	cycles = k_cycle_get_32() - start;
+
+	printk("%-10s %-20s %6u cycles\n",
+	       (options & K_USER) != 0U ? "user" : "supervisor",
+	       op_names[op], cycles / N_ITER);
+}
+
+void main(void)
+{
+#ifdef CONFIG_USERSPACE
+	struct k_mem_partition *parts[] = { &bench_partition };
+
+	k_mem_domain_init(&bench_domain, ARRAY_SIZE(parts), parts);
+	k_object_access_grant(&bench_kmutex, k_current_get());
+#endif
+
+	for (int op = 0; op < OP_COUNT; op++) {
+		measure(op, 0);
+	}
+
+#ifdef CONFIG_USERSPACE
+	for (int op = 0; op < OP_COUNT; op++) {
+		measure(op, K_USER);
+	}
+#endif
+
+	printk("fin\n");
+}
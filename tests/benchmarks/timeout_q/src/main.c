@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+
+/* This is a timeout queue microbenchmark.  It arms N timeouts with
+ * pseudo-random expiries directly through z_add_timeout(), then
+ * aborts them all with z_abort_timeout(), and reports the average
+ * cycle cost of each operation.  The expiries are far enough out
+ * that nothing fires while a pass is running, so the numbers reflect
+ * queue manipulation only and not callback overhead.
+ *
+ * Run it once with CONFIG_TIMEOUT_QUEUE_LIST and once with
+ * CONFIG_TIMEOUT_QUEUE_WHEEL to compare the backends.
+ */
+
+#define MAX_TIMEOUTS 10000
+#define N_RUNS 3
+
+/* Keep all expiries between one and ~100 minutes out (at 100 Hz) */
+#define MIN_TICKS 100000
+#define SPAN_TICKS 500000
+
+static struct _timeout timeouts[MAX_TIMEOUTS];
+
+static const int counts[] = { 10, 100, 1000, 10000 };
+
+static u32_t lcg_state = 1U;
+
+/* Deterministic so that every backend sees the same sequence */
+static u32_t lcg(void)
+{
+	lcg_state = lcg_state * 1103515245U + 12345U;
+	return lcg_state >> 8;
+}
+
+static void dummy_fn(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+	printk("unexpected timeout expiry\n");
+}
+
+static void run(int n)
+{
+	u32_t start, insert, abort;
+	int i;
+
+	lcg_state = n;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < n; i++) {
+		z_add_timeout(&timeouts[i], dummy_fn,
+			      MIN_TICKS + (lcg() % SPAN_TICKS));
+	}
+	insert = k_cycle_get_32() - start;
+
+	/* Abort in a scattered order rather than queue order */
+	start = k_cycle_get_32();
+	for (i = 0; i < n; i++) {
+		z_abort_timeout(&timeouts[(i * 7919) % n]);
+	}
+	abort = k_cycle_get_32() - start;
+
+	printk("timeouts %5d insert %6u abort %6u (cycles/op)\n",
+	       n, insert / n, abort / n);
+}
+
+void main(void)
+{
+	int i, j;
+
+	for (i = 0; i < MAX_TIMEOUTS; i++) {
+		z_init_timeout(&timeouts[i], dummy_fn);
+	}
+
+	for (j = 0; j < N_RUNS; j++) {
+		for (i = 0; i < ARRAY_SIZE(counts); i++) {
+			run(counts[i]);
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This benchmark runs a periodic loop N_ROUNDS times with three ways
+ * of waiting for the next period, and reports how late each wakeup is
+ * relative to when it was wanted, on average and at worst, and how far
+ * the last wakeup is from where N_ROUNDS exact periods would end.
+ *
+ * PERIOD_US is deliberately not a whole number of ticks.  Build with
+ * CONFIG_TIMEOUT_SUBTICK=y, where the timer driver supports it, to
+ * have the absolute deadlines expire within the tick.
+ */
+
+#define PERIOD_US 12345
+#define N_ROUNDS 50
+
+enum bench_op {
+	OP_USLEEP,
+	OP_SLEEP_UNTIL,
+	OP_TIMER_START_AT,
+	OP_COUNT,
+};
+
+static const char *const op_names[OP_COUNT] = {
+	"usleep", "sleep_until", "timer_start_at"
+};
+
+static struct k_timer bench_timer;
+
+static void measure(enum bench_op op)
+{
+	u32_t period = k_ns_to_cycles(PERIOD_US * 1000ULL);
+	u64_t start, wanted, now;
+	u64_t late, late_sum = 0U, late_max = 0U;
+	s64_t drift, drift_ns;
+
+	/* Start right after a tick boundary */
+	k_sleep(1);
+	start = k_uptime_cycles_get();
+	wanted = start;
+
+	if (op == OP_TIMER_START_AT) {
+		k_timer_start_at(&bench_timer, start + period, period);
+	}
+
+	for (int i = 0; i < N_ROUNDS; i++) {
+		wanted += period;
+
+		switch (op) {
+		case OP_USLEEP:
+			k_usleep(PERIOD_US);
+			break;
+		case OP_SLEEP_UNTIL:
+			k_sleep_until(wanted);
+			break;
+		default:
+			k_timer_status_sync(&bench_timer);
+			break;
+		}
+
+		now = k_uptime_cycles_get();
+		late = now > wanted ? now - wanted : 0U;
+		late_sum += late;
+		late_max = MAX(late_max, late);
+
+		/* A relative sleep counts from when it is made */
+		if (op == OP_USLEEP) {
+			wanted = now;
+		}
+	}
+
+	k_timer_stop(&bench_timer);
+	drift = (s64_t)(now - (start + (u64_t)N_ROUNDS * period));
+	drift_ns = drift < 0 ? -(s64_t)k_cycles_to_ns(-drift) :
+		   (s64_t)k_cycles_to_ns(drift);
+
+	printk("%-16s late avg %8u ns max %8u ns, drift %10d ns\n",
+	       op_names[op], (u32_t)k_cycles_to_ns(late_sum / N_ROUNDS),
+	       (u32_t)k_cycles_to_ns(late_max), (s32_t)drift_ns);
+}
+
+void main(void)
+{
+	k_timer_init(&bench_timer, NULL, NULL);
+
+	printk("period %u us, tick %u us, sub-tick expiry %s\n", PERIOD_US,
+	       USEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC,
+	       IS_ENABLED(CONFIG_TIMEOUT_SUBTICK) ? "on" : "off");
+
+	for (int op = 0; op < OP_COUNT; op++) {
+		measure(op);
+	}
+
+	printk("fin\n");
+}
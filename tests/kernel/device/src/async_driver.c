@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <init.h>
+#include <string.h>
+
+#define ASYNC_SLOW_NAME		"async_slow"
+#define ASYNC_DEP_NAME		"async_dep"
+#define ASYNC_FAIL_NAME		"async_fail"
+#define ASYNC_DEP_FAIL_NAME	"async_dep_fail"
+#define DEFERRED_NAME		"deferred"
+
+#define SLOW_INIT_MS		50
+#define DEFERRED_INIT_MS	500
+
+/* Order in which the init functions of the test devices completed,
+ * counting from 1
+ */
+atomic_t async_init_seq;
+int async_slow_done, async_dep_done, sync_done, deferred_done;
+
+static int async_slow_init(struct device *dev)
+{
+	k_sleep(SLOW_INIT_MS);
+	async_slow_done = atomic_inc(&async_init_seq) + 1;
+	return 0;
+}
+
+static int async_dep_init(struct device *dev)
+{
+	async_dep_done = atomic_inc(&async_init_seq) + 1;
+	return 0;
+}
+
+static int sync_init(struct device *dev)
+{
+	sync_done = atomic_inc(&async_init_seq) + 1;
+	return 0;
+}
+
+static int async_fail_init(struct device *dev)
+{
+	return -EIO;
+}
+
+static int async_dep_fail_init(struct device *dev)
+{
+	/* Never called, its dependency failed */
+	return 0;
+}
+
+static int deferred_init(struct device *dev)
+{
+	k_sleep(DEFERRED_INIT_MS);
+	deferred_done = atomic_inc(&async_init_seq) + 1;
+	return 0;
+}
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+DEVICE_INIT(async_slow, ASYNC_SLOW_NAME, async_slow_init, NULL, NULL,
+	    POST_KERNEL, 60);
+DEVICE_INIT_ASYNC(async_slow);
+
+DEVICE_INIT(async_dep, ASYNC_DEP_NAME, async_dep_init, NULL, NULL,
+	    POST_KERNEL, 61);
+DEVICE_INIT_ASYNC(async_dep, ASYNC_SLOW_NAME);
+
+SYS_INIT(sync_init, POST_KERNEL, 62);
+
+DEVICE_INIT(async_fail, ASYNC_FAIL_NAME, async_fail_init, NULL, NULL,
+	    POST_KERNEL, 63);
+DEVICE_INIT_ASYNC(async_fail);
+
+DEVICE_INIT(async_dep_fail, ASYNC_DEP_FAIL_NAME, async_dep_fail_init,
+	    NULL, NULL, POST_KERNEL, 64);
+DEVICE_INIT_ASYNC(async_dep_fail, ASYNC_SLOW_NAME, ASYNC_FAIL_NAME);
+
+DEVICE_INIT(deferred, DEFERRED_NAME, deferred_init, NULL, NULL,
+	    APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+DEVICE_INIT_DEFERRED(deferred);
+
+/**
+ * @endcond
+ */
+
+struct device *async_device_get(const char *name)
+{
+	static struct device *const devices[] = {
+		DEVICE_GET(async_slow), DEVICE_GET(async_dep),
+		DEVICE_GET(async_fail), DEVICE_GET(async_dep_fail),
+		DEVICE_GET(deferred),
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(devices); i++) {
+		if (strcmp(devices[i]->config->name, name) == 0) {
+			return devices[i];
+		}
+	}
+
+	return NULL;
+}
@@ -8,6 +8,7 @@
 #include <device.h>
 #include <ztest.h>
 #include <sys/printk.h>
+#include <init.h>
 
 
 #define DUMMY_PORT_1    "dummy"
@@ -166,6 +167,125 @@ void test_dummy_device_pm(void)
 }
 #endif
 
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+extern atomic_t async_init_seq;
+extern int async_slow_done, async_dep_done, sync_done, deferred_done;
+struct device *async_device_get(const char *name);
+
+/**
+ * @brief Test deferred device initialization
+ *
+ * Validates that a device marked with DEVICE_INIT_DEFERRED() still
+ * initializes in the background after main() started, and that
+ * device_init_wait() waits for it.
+ *
+ * @see DEVICE_INIT_DEFERRED(), device_init_wait()
+ */
+void test_device_init_deferred(void)
+{
+	struct device *dev = async_device_get("deferred");
+
+	zassert_equal(deferred_done, 0, "deferred init already done");
+	zassert_equal(device_init_wait(dev), 0, NULL);
+	zassert_true(deferred_done > async_dep_done, NULL);
+}
+
+/**
+ * @brief Test asynchronous device initialization
+ *
+ * Validates that the init functions of devices marked with
+ * DEVICE_INIT_ASYNC() run in parallel with the synchronous ones of
+ * their level, after those of their dependencies, and that the level
+ * waits for them.
+ *
+ * @see DEVICE_INIT_ASYNC(), device_init_wait()
+ */
+void test_device_init_async(void)
+{
+	zassert_true(sync_done != 0 && async_slow_done != 0 &&
+		     async_dep_done != 0, "init functions missing");
+
+	/* TESTPOINT: the slow entry didn't hold up the level */
+	zassert_true(sync_done < async_slow_done, NULL);
+
+	/* TESTPOINT: a dependency completes first */
+	zassert_true(async_slow_done < async_dep_done, NULL);
+
+	zassert_equal(device_init_wait(async_device_get("async_slow")), 0,
+		      NULL);
+	zassert_equal(device_init_wait(async_device_get("async_dep")), 0,
+		      NULL);
+}
+
+/**
+ * @brief Test failed asynchronous device initialization
+ *
+ * Validates that a failed asynchronous init is reported, and fails
+ * the devices that depend on it without calling their init function.
+ *
+ * @see DEVICE_INIT_ASYNC(), device_init_wait()
+ */
+void test_device_init_async_fail(void)
+{
+	struct device *dev = async_device_get("async_dep_fail");
+
+	zassert_equal(device_init_wait(async_device_get("async_fail")),
+		      -ENODEV, NULL);
+	zassert_equal(device_init_wait(dev), -ENODEV, NULL);
+#ifdef CONFIG_DEVICE_INIT_TIMING
+	zassert_equal(dev->init_cycles, 0, "init function called");
+#endif
+}
+#else
+void test_device_init_deferred(void)
+{
+	ztest_test_skip();
+}
+
+void test_device_init_async(void)
+{
+	ztest_test_skip();
+}
+
+void test_device_init_async_fail(void)
+{
+	ztest_test_skip();
+}
+#endif
+
+#if defined(CONFIG_DEVICE_INIT_ASYNC) && defined(CONFIG_DEVICE_INIT_TIMING)
+static void find_slow_init(struct device *dev, int level, u32_t cycles,
+			   void *user_data)
+{
+	if (dev == async_device_get("async_slow")) {
+		zassert_equal(level, _SYS_INIT_LEVEL_POST_KERNEL, NULL);
+		*(u32_t *)user_data = cycles;
+	}
+}
+
+/**
+ * @brief Test the per entry init timing
+ *
+ * Validates that the time an asynchronous init function sleeps is
+ * accounted to it.
+ *
+ * @see device_init_timing_foreach()
+ */
+void test_device_init_timing(void)
+{
+	u32_t cycles = 0U;
+
+	device_init_timing_foreach(find_slow_init, &cycles);
+	zassert_true(cycles >= sys_clock_hw_cycles_per_sec() / MSEC_PER_SEC *
+		     40U, "%u cycles", cycles);
+}
+#else
+void test_device_init_timing(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 /**
  * @}
  */
@@ -173,6 +293,10 @@ void test_dummy_device_pm(void)
 void test_main(void)
 {
 	ztest_test_suite(device,
+			 ztest_unit_test(test_device_init_deferred),
+			 ztest_unit_test(test_device_init_async),
+			 ztest_unit_test(test_device_init_async_fail),
+			 ztest_unit_test(test_device_init_timing),
 			 ztest_unit_test(test_dummy_device_pm),
 			 ztest_unit_test(build_suspend_device_list),
 			 ztest_unit_test(test_dummy_device),
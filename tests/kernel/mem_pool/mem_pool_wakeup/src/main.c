@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define BLK_SIZE_MIN 64
+#define BLK_SIZE_MAX 256
+#define N_SMALL (BLK_SIZE_MAX / BLK_SIZE_MIN)
+#define N_STRESS 8
+#define ROUNDS 50
+
+K_MEM_POOL_DEFINE(wpool, BLK_SIZE_MIN, BLK_SIZE_MAX, 1, 4);
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, N_STRESS, STACK_SIZE);
+static struct k_thread tdata[N_STRESS];
+static struct k_sem done_sema;
+
+static volatile bool big_done, small_done;
+static struct k_mem_block small_blk;
+
+static void big_waiter(void *p1, void *p2, void *p3)
+{
+	struct k_mem_block blk;
+
+	zassert_equal(k_mem_pool_alloc(&wpool, &blk, BLK_SIZE_MAX,
+				       K_FOREVER), 0, NULL);
+	big_done = true;
+	k_mem_pool_free(&blk);
+}
+
+static void small_waiter(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_mem_pool_alloc(&wpool, &small_blk, BLK_SIZE_MIN,
+				       K_FOREVER), 0, NULL);
+	small_done = true;
+}
+
+static void reset_stats(void)
+{
+	wpool.n_blocked = 0U;
+	wpool.n_wakeups = 0U;
+}
+
+/**
+ * @brief Test that a free only wakes waiters it can satisfy
+ *
+ * @ingroup kernel_memory_pool_tests
+ *
+ * @details With the pool fully allocated as minimum size blocks, a
+ * high priority thread waits for the whole pool and a lower priority
+ * one for a single minimum size block.  Freeing one block must wake
+ * the small waiter only, with its memory already allocated; the big
+ * waiter is woken exactly once, when the last block is returned.
+ */
+void test_mpool_wakeup_targeted(void)
+{
+	struct k_mem_block blk[N_SMALL];
+
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(5));
+	reset_stats();
+
+	for (int i = 0; i < N_SMALL; i++) {
+		zassert_equal(k_mem_pool_alloc(&wpool, &blk[i], BLK_SIZE_MIN,
+					       K_NO_WAIT), 0, NULL);
+	}
+
+	k_thread_create(&tdata[0], tstack[0], STACK_SIZE, big_waiter,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, 0);
+	k_thread_create(&tdata[1], tstack[1], STACK_SIZE, small_waiter,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(2), 0, 0);
+	zassert_equal(wpool.n_blocked, 2, NULL);
+
+	/* TESTPOINT: one block freed, only the small waiter runs */
+	k_mem_pool_free(&blk[0]);
+	zassert_true(small_done, NULL);
+	zassert_false(big_done, NULL);
+	zassert_equal(wpool.n_wakeups, 1, NULL);
+
+	/* TESTPOINT: big waiter stays asleep until everything is back */
+	k_mem_pool_free(&small_blk);
+	for (int i = 1; i < N_SMALL; i++) {
+		zassert_false(big_done, NULL);
+		k_mem_pool_free(&blk[i]);
+	}
+	zassert_true(big_done, NULL);
+	zassert_equal(wpool.n_wakeups, 2, NULL);
+	zassert_equal(wpool.n_blocked, 2, NULL);
+
+	k_thread_abort(&tdata[0]);
+	k_thread_abort(&tdata[1]);
+}
+
+static void stress_thread(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+	struct k_mem_block blk;
+	size_t size = BLK_SIZE_MIN << (2 * (id % 2));
+
+	for (int i = 0; i < ROUNDS; i++) {
+		zassert_equal(k_mem_pool_alloc(&wpool, &blk, size, K_FOREVER),
+			      0, NULL);
+		k_sleep(1);
+		k_mem_pool_free(&blk);
+	}
+
+	k_sem_give(&done_sema);
+}
+
+/**
+ * @brief Count wakeups under allocation pressure
+ *
+ * @ingroup kernel_memory_pool_tests
+ *
+ * @details Threads of different priorities hammer a pool too small
+ * for all of them, mixing minimum and whole-pool requests.  Every
+ * wakeup must deliver memory: the number of wakeups may not exceed
+ * the number of blocked allocations.
+ */
+void test_mpool_wakeup_stress(void)
+{
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(10));
+	k_sem_init(&done_sema, 0, N_STRESS);
+	reset_stats();
+
+	for (int i = 0; i < N_STRESS; i++) {
+		k_thread_create(&tdata[i], tstack[i], STACK_SIZE,
+				stress_thread, INT_TO_POINTER(i), NULL, NULL,
+				K_PRIO_PREEMPT(1 + i % 3), 0, 0);
+	}
+
+	for (int i = 0; i < N_STRESS; i++) {
+		k_sem_take(&done_sema, K_FOREVER);
+	}
+
+	TC_PRINT("%u allocations blocked, %u wakeups\n",
+		 wpool.n_blocked, wpool.n_wakeups);
+
+	/* TESTPOINT: no spurious wakeups */
+	zassert_true(wpool.n_blocked > 0, NULL);
+	zassert_equal(wpool.n_wakeups, wpool.n_blocked, NULL);
+
+	for (int i = 0; i < N_STRESS; i++) {
+		k_thread_abort(&tdata[i]);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mpool_wakeup,
+			 ztest_unit_test(test_mpool_wakeup_targeted),
+			 ztest_unit_test(test_mpool_wakeup_stress));
+	ztest_run_test_suite(mpool_wakeup);
+}
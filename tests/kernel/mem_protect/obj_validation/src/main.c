@@ -9,6 +9,7 @@
 #include <ztest.h>
 
 #define SEM_ARRAY_SIZE	16
+#define DYN_SEM_COUNT	100
 
 /* Show that extern declarations don't interfere with detecting kernel
  * objects, this was at one point a problem.
@@ -17,6 +18,7 @@ extern struct k_sem sem1;
 
 static struct k_sem semarray[SEM_ARRAY_SIZE];
 static struct k_sem *dyn_sem[SEM_ARRAY_SIZE];
+static struct k_sem *many_sem[DYN_SEM_COUNT];
 
 K_SEM_DEFINE(sem1, 0, 1);
 static struct k_sem sem2;
@@ -107,10 +109,91 @@ void test_generic_object(void)
 	}
 }
 
+/**
+ * @brief Test lookups in a growing table of dynamic objects
+ *
+ * @ingroup kernel_memprotect_tests
+ *
+ * @details Allocates enough objects for the dynamic object table to
+ * grow several times, checks that every one of them can still be
+ * found, then that each stops being found once freed while the
+ * others remain.
+ *
+ * @see k_object_alloc(), k_object_free()
+ */
+void test_dynamic_object_table(void)
+{
+	for (int i = 0; i < DYN_SEM_COUNT; i++) {
+		many_sem[i] = k_object_alloc(K_OBJ_SEM);
+		zassert_not_null(many_sem[i], "couldn't allocate semaphore");
+	}
+
+	for (int i = 0; i < DYN_SEM_COUNT; i++) {
+		zassert_equal(z_object_find(many_sem[i])->name,
+			      (char *)many_sem[i], NULL);
+	}
+
+	for (int i = 0; i < DYN_SEM_COUNT; i += 2) {
+		k_object_free(many_sem[i]);
+		zassert_is_null(z_object_find(many_sem[i]), NULL);
+	}
+
+	for (int i = 1; i < DYN_SEM_COUNT; i += 2) {
+		zassert_not_null(z_object_find(many_sem[i]), NULL);
+		k_object_free(many_sem[i]);
+		zassert_is_null(z_object_find(many_sem[i]), NULL);
+	}
+}
+
+/**
+ * @brief Test that cached validations don't outlive permissions
+ *
+ * @ingroup kernel_memprotect_tests
+ *
+ * @details Once an object passed z_object_check() it is served from
+ * the calling thread's cache, which must be discarded as soon as the
+ * thread's permission on the object is revoked or the object is freed.
+ * The type and initialization state are checked even on a cache hit.
+ *
+ * @see z_object_check(), k_object_access_revoke(), k_object_free()
+ */
+void test_object_cache(void)
+{
+	struct k_sem *sem = k_object_alloc(K_OBJ_SEM);
+
+	zassert_not_null(sem, "couldn't allocate semaphore");
+	k_object_access_grant(sem, _main_thread);
+	k_sem_init(sem, 0, 1);
+
+	zassert_equal(z_object_check(sem, K_OBJ_SEM, _OBJ_INIT_TRUE), 0, NULL);
+	zassert_equal(z_object_check(sem, K_OBJ_SEM, _OBJ_INIT_TRUE), 0, NULL);
+
+	/* TESTPOINT: a cached object still has its type checked */
+	zassert_equal(z_object_check(sem, K_OBJ_MUTEX, _OBJ_INIT_TRUE),
+		      -EBADF, NULL);
+	zassert_equal(z_object_check(sem, K_OBJ_SEM, _OBJ_INIT_FALSE),
+		      -EADDRINUSE, NULL);
+
+	/* TESTPOINT: revoking permission is seen straight away */
+	k_object_access_revoke(sem, k_current_get());
+	zassert_equal(z_object_check(sem, K_OBJ_SEM, _OBJ_INIT_TRUE),
+		      -EPERM, NULL);
+
+	k_object_access_grant(sem, k_current_get());
+	zassert_equal(z_object_check(sem, K_OBJ_SEM, _OBJ_INIT_TRUE), 0, NULL);
+
+	/* TESTPOINT: so is freeing the object */
+	k_object_free(sem);
+	zassert_equal(z_object_check(sem, K_OBJ_SEM, _OBJ_INIT_TRUE),
+		      -EBADF, NULL);
+}
+
 void test_main(void)
 {
 	k_thread_system_pool_assign(k_current_get());
 	ztest_test_suite(object_validation,
-			 ztest_unit_test(test_generic_object));
+			 ztest_unit_test(test_generic_object),
+			 ztest_unit_test(test_dynamic_object_table),
+			 ztest_unit_test(test_object_cache));
 	ztest_run_test_suite(object_validation);
 }
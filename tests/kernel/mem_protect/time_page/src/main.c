@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define N_READS 1000
+#define IDLE_MS 100
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+K_THREAD_STACK_DEFINE(no_domain_stack, STACK_SIZE);
+static struct k_thread no_domain_thread;
+K_SEM_DEFINE(no_domain_sem, 0, 1);
+
+ZTEST_BMEM static volatile bool expect_fault;
+
+void k_sys_fatal_error_handler(unsigned int reason, const z_arch_esf_t *pEsf)
+{
+	if (expect_fault) {
+		expect_fault = false;
+		ztest_test_pass();
+	} else {
+		printk("Unexpected fault during test\n");
+		k_fatal_halt(reason);
+	}
+}
+
+/**
+ * @brief Test that user mode reads the time from the page
+ *
+ * @details The uptime read from the page never goes backwards, and
+ * lags the kernel's by at most a tick.
+ */
+void test_time_page_read(void)
+{
+	s64_t last = 0, page, kernel;
+
+	zassert_true(_is_user_context(), NULL);
+
+	for (int i = 0; i < N_READS; i++) {
+		page = z_uptime_ticks_get();
+		kernel = z_uptime_ticks();
+
+		/* TESTPOINT: monotonic and close to the kernel's count */
+		zassert_true(page >= last, "went back from %lld to %lld",
+			     last, page);
+		zassert_true(page <= kernel && page + 1 >= kernel,
+			     "page %lld kernel %lld", page, kernel);
+		last = page;
+	}
+
+	k_sleep(IDLE_MS);
+	zassert_true(k_uptime_get() >= __ticks_to_ms(last) + IDLE_MS, NULL);
+}
+
+/**
+ * @brief Test that the page is current again after idle
+ *
+ * @details With a tickless kernel the tick stops while the system
+ * idles.  The first read afterwards goes to the kernel, which gets the
+ * tick going again so that later reads don't need a system call.
+ */
+void test_time_page_after_idle(void)
+{
+	if (!IS_ENABLED(CONFIG_TICKLESS_KERNEL)) {
+		ztest_test_skip();
+	}
+
+	k_sleep(IDLE_MS);
+	(void)k_uptime_get();
+
+	/* TESTPOINT: the page is live again */
+	zassert_true(z_time_page.ticking, NULL);
+}
+
+static void no_domain_entry(void *p1, void *p2, void *p3)
+{
+	(void)z_uptime_ticks_get();
+	k_sem_give(&no_domain_sem);
+}
+
+/**
+ * @brief Test that user threads in no memory domain can read the page
+ *
+ * @details The kernel puts them in a domain of its own, holding only
+ * the time page, until they join another one.
+ */
+void test_time_page_no_domain(void)
+{
+	k_thread_create(&no_domain_thread, no_domain_stack, STACK_SIZE,
+			no_domain_entry, NULL, NULL, NULL, K_PRIO_PREEMPT(0),
+			K_USER, K_FOREVER);
+	k_mem_domain_remove_thread(&no_domain_thread);
+	k_object_access_grant(&no_domain_sem, &no_domain_thread);
+	k_thread_start(&no_domain_thread);
+
+	/* TESTPOINT: the thread read the page without faulting */
+	zassert_equal(k_sem_take(&no_domain_sem, 1000), 0, NULL);
+}
+
+/**
+ * @brief Test that user mode can't write the time page
+ */
+void test_time_page_read_only(void)
+{
+	expect_fault = true;
+	z_time_page.ticks = 0U;
+	zassert_unreachable("Write to the time page did not fault");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(time_page,
+			 ztest_user_unit_test(test_time_page_read),
+			 ztest_user_unit_test(test_time_page_after_idle),
+			 ztest_unit_test(test_time_page_no_domain),
+			 ztest_user_unit_test(test_time_page_read_only));
+	ztest_run_test_suite(time_page);
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include "test_mslab.h"
+
+#define BULK_NUM 8
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+K_MEM_SLAB_DEFINE(bslab, BLK_SIZE, BULK_NUM, BLK_ALIGN);
+
+static K_THREAD_STACK_DEFINE(waiter_stack, STACK_SIZE);
+static struct k_thread waiter_thread;
+static void *waiter_block;
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_mem_slab_alloc(&bslab, &waiter_block, K_FOREVER), 0,
+		      NULL);
+}
+
+/**
+ * @brief Verify bulk allocation is all or nothing
+ *
+ * @details Allocate and free single blocks first so that some of
+ * them may be sitting in a per-CPU cache, then check that a bulk
+ * allocation of the whole slab still succeeds and that one block
+ * more than is free fails without allocating anything.
+ *
+ * @ingroup kernel_memory_slab_tests
+ */
+void test_mslab_alloc_bulk(void)
+{
+	void *block[BULK_NUM];
+
+	for (int i = 0; i < BULK_NUM / 2; i++) {
+		zassert_equal(k_mem_slab_alloc(&bslab, &block[i], K_NO_WAIT),
+			      0, NULL);
+	}
+	for (int i = 0; i < BULK_NUM / 2; i++) {
+		k_mem_slab_free(&bslab, &block[i]);
+	}
+	zassert_equal(k_mem_slab_num_used_get(&bslab), 0, NULL);
+
+	/** TESTPOINT: every free block is available to a bulk request */
+	zassert_equal(k_mem_slab_alloc_bulk(&bslab, block, BULK_NUM), 0, NULL);
+	zassert_equal(k_mem_slab_num_used_get(&bslab), BULK_NUM, NULL);
+	for (int i = 0; i < BULK_NUM; i++) {
+		zassert_true((uintptr_t)block[i] % BLK_ALIGN == 0U, NULL);
+		for (int j = 0; j < i; j++) {
+			zassert_not_equal(block[i], block[j], NULL);
+		}
+	}
+	k_mem_slab_free_bulk(&bslab, block, BULK_NUM);
+	zassert_equal(k_mem_slab_num_free_get(&bslab), BULK_NUM, NULL);
+
+	/** TESTPOINT: a request that can't be met leaves the slab alone */
+	zassert_equal(k_mem_slab_alloc(&bslab, &block[0], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_mem_slab_alloc_bulk(&bslab, &block[1], BULK_NUM),
+		      -ENOMEM, NULL);
+	zassert_equal(k_mem_slab_num_used_get(&bslab), 1, NULL);
+	zassert_equal(k_mem_slab_alloc_bulk(&bslab, &block[1], BULK_NUM - 1),
+		      0, NULL);
+	k_mem_slab_free_bulk(&bslab, block, BULK_NUM);
+	zassert_equal(k_mem_slab_num_used_get(&bslab), 0, NULL);
+}
+
+/**
+ * @brief Verify bulk free hands blocks to waiting threads
+ *
+ * @details With the slab exhausted a higher priority thread blocks
+ * on it.  Freeing the whole slab in bulk must give that thread one
+ * of the blocks and return the rest.
+ *
+ * @ingroup kernel_memory_slab_tests
+ */
+void test_mslab_free_bulk_wakeup(void)
+{
+	void *block[BULK_NUM];
+
+	zassert_equal(k_mem_slab_alloc_bulk(&bslab, block, BULK_NUM), 0, NULL);
+
+	k_thread_create(&waiter_thread, waiter_stack, STACK_SIZE, waiter,
+			NULL, NULL, NULL, K_PRIO_COOP(0), 0, 0);
+	k_sleep(10);
+	zassert_is_null(waiter_block, NULL);
+
+	k_mem_slab_free_bulk(&bslab, block, BULK_NUM);
+	k_yield();
+
+	/** TESTPOINT: the waiter got one of the freed blocks */
+	zassert_not_null(waiter_block, NULL);
+	zassert_equal(k_mem_slab_num_used_get(&bslab), 1, NULL);
+
+	k_mem_slab_free(&bslab, &waiter_block);
+	zassert_equal(k_mem_slab_num_used_get(&bslab), 0, NULL);
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+#define CLAIM_LEN 4
+#define PEER_BLOCKED 0x7fff
+
+K_MSGQ_DEFINE(cmsgq, sizeof(u32_t), CLAIM_LEN, 4);
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+
+static u32_t peer_msg[CLAIM_LEN];
+static volatile int peer_ret;
+
+static void put_msgs(u32_t first, int num)
+{
+	for (u32_t i = first; i < first + num; i++) {
+		zassert_equal(k_msgq_put(&cmsgq, &i, K_NO_WAIT), 0, NULL);
+	}
+}
+
+static void get_msgs(u32_t first, int num)
+{
+	u32_t msg;
+
+	for (u32_t i = first; i < first + num; i++) {
+		zassert_equal(k_msgq_get(&cmsgq, &msg, K_NO_WAIT), 0, NULL);
+		zassert_equal(msg, i, NULL);
+	}
+}
+
+static void getter(void *p1, void *p2, void *p3)
+{
+	peer_ret = k_msgq_get_n(&cmsgq, peer_msg, POINTER_TO_INT(p1),
+				K_FOREVER);
+}
+
+static void putter(void *p1, void *p2, void *p3)
+{
+	peer_msg[0] = POINTER_TO_INT(p1);
+	peer_ret = k_msgq_put(&cmsgq, &peer_msg[0], K_FOREVER);
+}
+
+static void start_peer(k_thread_entry_t entry, int arg)
+{
+	peer_ret = PEER_BLOCKED;
+	k_thread_create(&tdata, tstack, STACK_SIZE, entry,
+			INT_TO_POINTER(arg), NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test writing and reading messages in place
+ * @see k_msgq_put_claim(), k_msgq_put_commit(), k_msgq_get_claim(),
+ * k_msgq_get_finish()
+ */
+void test_msgq_claim(void)
+{
+	u32_t *slot, *msg;
+
+	k_msgq_purge(&cmsgq);
+
+	/* wrap the ring once so that claims cross its end */
+	put_msgs(0, 3);
+	get_msgs(0, 3);
+
+	for (u32_t i = 0; i < CLAIM_LEN; i++) {
+		zassert_equal(k_msgq_put_claim(&cmsgq, (void **)&slot), 0,
+			      NULL);
+		/**TESTPOINT: one claim at a time, other writers are refused*/
+		zassert_equal(k_msgq_put_claim(&cmsgq, (void **)&msg), -EBUSY,
+			      NULL);
+		zassert_equal(k_msgq_put(&cmsgq, &i, K_NO_WAIT), -EBUSY, NULL);
+		/**TESTPOINT: nothing is visible before the commit*/
+		zassert_equal(k_msgq_num_used_get(&cmsgq), i, NULL);
+		*slot = 100 + i;
+		k_msgq_put_commit(&cmsgq);
+	}
+	zassert_equal(k_msgq_put_claim(&cmsgq, (void **)&slot), -ENOMSG, NULL);
+
+	/**TESTPOINT: messages are read in place and in order*/
+	zassert_equal(k_msgq_get_claim(&cmsgq, (void **)&msg), 0, NULL);
+	zassert_equal(*msg, 100, NULL);
+	zassert_equal(k_msgq_get_claim(&cmsgq, (void **)&slot), -EBUSY, NULL);
+	zassert_equal(k_msgq_get(&cmsgq, &peer_msg[0], K_NO_WAIT), -EBUSY,
+		      NULL);
+
+	/**TESTPOINT: the slot being read can't be reused yet*/
+	zassert_equal(k_msgq_num_free_get(&cmsgq), 0, NULL);
+	zassert_equal(k_msgq_put(&cmsgq, &peer_msg[0], K_NO_WAIT), -ENOMSG,
+		      NULL);
+	zassert_equal(*msg, 100, NULL);
+	k_msgq_get_finish(&cmsgq);
+	zassert_equal(k_msgq_num_free_get(&cmsgq), 1, NULL);
+
+	for (u32_t i = 1; i < CLAIM_LEN; i++) {
+		zassert_equal(k_msgq_get_claim(&cmsgq, (void **)&msg), 0, NULL);
+		zassert_equal(*msg, 100 + i, NULL);
+		k_msgq_get_finish(&cmsgq);
+	}
+	zassert_equal(k_msgq_get_claim(&cmsgq, (void **)&msg), -ENOMSG, NULL);
+
+	/**TESTPOINT: purging keeps the message being read*/
+	put_msgs(0, 2);
+	zassert_equal(k_msgq_get_claim(&cmsgq, (void **)&msg), 0, NULL);
+	k_msgq_purge(&cmsgq);
+	zassert_equal(k_msgq_num_used_get(&cmsgq), 0, NULL);
+	zassert_equal(k_msgq_num_free_get(&cmsgq), CLAIM_LEN - 2, NULL);
+	put_msgs(10, CLAIM_LEN - 2);
+	zassert_equal(*msg, 0, NULL);
+	k_msgq_get_finish(&cmsgq);
+	get_msgs(10, CLAIM_LEN - 2);
+}
+
+/**
+ * @brief Test that claims wake up waiting threads
+ * @see k_msgq_put_commit(), k_msgq_get_finish()
+ */
+void test_msgq_claim_wakeup(void)
+{
+	u32_t *slot, *msg;
+
+	k_msgq_purge(&cmsgq);
+
+	/**TESTPOINT: a commit goes straight to a waiting reader*/
+	start_peer(getter, 1);
+	zassert_equal(k_msgq_put_claim(&cmsgq, (void **)&slot), 0, NULL);
+	*slot = MSG0;
+	k_msgq_put_commit(&cmsgq);
+	k_sleep(1);
+	zassert_equal(peer_ret, 1, NULL);
+	zassert_equal(peer_msg[0], MSG0, NULL);
+	zassert_equal(k_msgq_num_used_get(&cmsgq), 0, NULL);
+	k_thread_abort(&tdata);
+
+	/**TESTPOINT: finishing a read lets a waiting writer in*/
+	put_msgs(0, CLAIM_LEN);
+	zassert_equal(k_msgq_get_claim(&cmsgq, (void **)&msg), 0, NULL);
+	start_peer(putter, MSG1);
+	zassert_equal(peer_ret, PEER_BLOCKED, NULL);
+	k_msgq_get_finish(&cmsgq);
+	k_sleep(1);
+	zassert_equal(peer_ret, 0, NULL);
+	k_thread_abort(&tdata);
+
+	get_msgs(1, CLAIM_LEN - 1);
+	zassert_equal(k_msgq_get(&cmsgq, &peer_msg[1], K_NO_WAIT), 0, NULL);
+	zassert_equal(peer_msg[1], MSG1, NULL);
+}
+
+/**
+ * @brief Test sending and receiving messages in batches
+ * @see k_msgq_put_n(), k_msgq_get_n()
+ */
+void test_msgq_batch(void)
+{
+	u32_t in[CLAIM_LEN + 2], out[CLAIM_LEN + 2];
+
+	for (int i = 0; i < ARRAY_SIZE(in); i++) {
+		in[i] = 200 + i;
+	}
+
+	k_msgq_purge(&cmsgq);
+	put_msgs(0, 1);
+	get_msgs(0, 1);
+
+	/**TESTPOINT: a batch stops when the queue is full*/
+	zassert_equal(k_msgq_put_n(&cmsgq, in, ARRAY_SIZE(in), K_NO_WAIT),
+		      CLAIM_LEN, NULL);
+	zassert_equal(k_msgq_put_n(&cmsgq, in, 1, K_NO_WAIT), -ENOMSG, NULL);
+
+	/**TESTPOINT: batches come out in order across the end of the ring*/
+	zassert_equal(k_msgq_get_n(&cmsgq, out, ARRAY_SIZE(out), K_NO_WAIT),
+		      CLAIM_LEN, NULL);
+	zassert_mem_equal(out, in, CLAIM_LEN * sizeof(u32_t), NULL);
+	zassert_equal(k_msgq_get_n(&cmsgq, out, 1, K_NO_WAIT), -ENOMSG, NULL);
+
+	/**TESTPOINT: a batch feeds a waiting reader first, which then
+	 * takes what else was queued
+	 */
+	start_peer(getter, CLAIM_LEN);
+	zassert_equal(peer_ret, PEER_BLOCKED, NULL);
+	zassert_equal(k_msgq_put_n(&cmsgq, in, 3, K_NO_WAIT), 3, NULL);
+	k_sleep(1);
+	zassert_equal(peer_ret, 3, NULL);
+	zassert_mem_equal(peer_msg, in, 3 * sizeof(u32_t), NULL);
+	k_thread_abort(&tdata);
+	zassert_equal(k_msgq_num_used_get(&cmsgq), 0, NULL);
+
+	/**TESTPOINT: draining a full queue lets a waiting writer in*/
+	put_msgs(0, CLAIM_LEN);
+	start_peer(putter, MSG1);
+	zassert_equal(peer_ret, PEER_BLOCKED, NULL);
+	zassert_equal(k_msgq_get_n(&cmsgq, out, 2, K_NO_WAIT), 2, NULL);
+	k_sleep(1);
+	zassert_equal(peer_ret, 0, NULL);
+	k_thread_abort(&tdata);
+	zassert_equal(k_msgq_num_used_get(&cmsgq), CLAIM_LEN - 1, NULL);
+	get_msgs(2, CLAIM_LEN - 2);
+	zassert_equal(k_msgq_get(&cmsgq, &out[0], K_NO_WAIT), 0, NULL);
+	zassert_equal(out[0], MSG1, NULL);
+}
+
+/**
+ * @}
+ */
@@ -62,11 +62,12 @@ ZTEST_BMEM SYS_MUTEX_DEFINE(mutex_2);
 ZTEST_BMEM SYS_MUTEX_DEFINE(mutex_3);
 ZTEST_BMEM SYS_MUTEX_DEFINE(mutex_4);
 
-#ifdef CONFIG_USERSPACE
+#if defined(CONFIG_USERSPACE) && !defined(CONFIG_SYS_MUTEX_FUTEX)
 static SYS_MUTEX_DEFINE(no_access_mutex);
 #endif
 static ZTEST_BMEM SYS_MUTEX_DEFINE(not_my_mutex);
 static ZTEST_BMEM SYS_MUTEX_DEFINE(bad_count_mutex);
+static ZTEST_BMEM SYS_MUTEX_DEFINE(fast_mutex);
 
 /**
  *
@@ -365,8 +366,10 @@ void test_supervisor_access(void)
 {
 	int rv;
 
-#ifdef CONFIG_USERSPACE
-	/* coverage for get_k_mutex checks */
+#if defined(CONFIG_USERSPACE) && !defined(CONFIG_SYS_MUTEX_FUTEX)
+	/* coverage for get_k_mutex checks; with the futex fast path the
+	 * caller dereferences the mutex itself
+	 */
 	rv = sys_mutex_lock((struct sys_mutex *)NULL, K_NO_WAIT);
 	zassert_true(rv == -EINVAL, "accepted bad mutex pointer");
 	rv = sys_mutex_lock((struct sys_mutex *)k_current_get(), K_NO_WAIT);
@@ -385,7 +388,7 @@ void test_supervisor_access(void)
 
 void test_user_access(void)
 {
-#ifdef CONFIG_USERSPACE
+#if defined(CONFIG_USERSPACE) && !defined(CONFIG_SYS_MUTEX_FUTEX)
 	int rv;
 
 	rv = sys_mutex_lock(&no_access_mutex, K_NO_WAIT);
@@ -397,6 +400,41 @@ void test_user_access(void)
 #endif /* CONFIG_USERSPACE */
 }
 
+/**
+ * @brief Test the user space fast path of futex backed mutexes
+ *
+ * @details An uncontended lock stores the owner in the mutex value and
+ * recursive locks only bump the count kept next to it; the final
+ * unlock clears the value again, all without the kernel ever seeing
+ * the mutex locked.
+ */
+void test_mutex_fast_path(void)
+{
+#ifdef CONFIG_SYS_MUTEX_FUTEX
+	atomic_val_t self = (atomic_val_t)(uintptr_t)k_current_get();
+
+#ifdef CONFIG_USER_CURRENT_THREAD
+	/* TESTPOINT: a thread finds itself without the syscall */
+	zassert_equal_ptr(z_user_current, k_current_get(), NULL);
+#endif
+
+	zassert_equal(sys_mutex_lock(&fast_mutex, K_NO_WAIT), 0, NULL);
+	zassert_equal(atomic_get(&fast_mutex.val), self, NULL);
+
+	zassert_equal(sys_mutex_lock(&fast_mutex, K_NO_WAIT), 0, NULL);
+	zassert_equal(fast_mutex.lock_count, 1, NULL);
+
+	zassert_equal(sys_mutex_unlock(&fast_mutex), 0, NULL);
+	zassert_equal(atomic_get(&fast_mutex.val), self, NULL);
+	zassert_equal(sys_mutex_unlock(&fast_mutex), 0, NULL);
+	zassert_equal(atomic_get(&fast_mutex.val), 0, NULL);
+
+	zassert_equal(sys_mutex_unlock(&fast_mutex), -EINVAL, NULL);
+#else
+	ztest_test_skip();
+#endif
+}
+
 K_THREAD_DEFINE(THREAD_05, STACKSIZE, thread_05, NULL, NULL, NULL,
 		5, K_USER, K_NO_WAIT);
 
@@ -441,6 +479,7 @@ void test_main(void)
 	ztest_test_suite(mutex_complex,
 			 ztest_user_unit_test(test_mutex),
 			 ztest_user_unit_test(test_user_access),
+			 ztest_user_unit_test(test_mutex_fast_path),
 			 ztest_unit_test(test_supervisor_access));
 
 	ztest_run_test_suite(mutex_complex);
@@ -448,6 +487,7 @@ void test_main(void)
 	ztest_test_suite(mutex_complex,
 			 ztest_unit_test(test_mutex),
 			 ztest_unit_test(test_user_access),
+			 ztest_unit_test(test_mutex_fast_path),
 			 ztest_unit_test(test_supervisor_access));
 
 	ztest_run_test_suite(mutex_complex);
@@ -24,6 +24,8 @@ extern void test_half_pipe_block_put_sema(void);
 extern void test_pipe_alloc(void);
 extern void test_pipe_reader_wait(void);
 extern void test_pipe_block_writer_wait(void);
+extern void test_pipe_writev_readv(void);
+extern void test_pipe_reader_handoff(void);
 #ifdef CONFIG_USERSPACE
 extern void test_pipe_user_thread2thread(void);
 extern void test_pipe_user_put_fail(void);
@@ -32,7 +34,7 @@ extern void test_resource_pool_auto_free(void);
 #endif
 
 /* k objects */
-extern struct k_pipe pipe, kpipe, khalfpipe, put_get_pipe;
+extern struct k_pipe pipe, kpipe, khalfpipe, put_get_pipe, iov_pipe;
 extern struct k_sem end_sema;
 extern struct k_stack tstack;
 extern struct k_thread tdata;
@@ -56,7 +58,7 @@ void test_main(void)
 {
 	k_thread_access_grant(k_current_get(), &pipe,
 			      &kpipe, &end_sema, &tdata, &tstack,
-			      &khalfpipe, &put_get_pipe);
+			      &khalfpipe, &put_get_pipe, &iov_pipe);
 
 	k_thread_resource_pool_assign(k_current_get(), &test_pool);
 
@@ -75,6 +77,8 @@ void test_main(void)
 			 ztest_unit_test(test_half_pipe_get_put),
 			 ztest_unit_test(test_pipe_alloc),
 			 ztest_unit_test(test_pipe_reader_wait),
-			 ztest_unit_test(test_pipe_block_writer_wait));
+			 ztest_unit_test(test_pipe_block_writer_wait),
+			 ztest_user_unit_test(test_pipe_writev_readv),
+			 ztest_unit_test(test_pipe_reader_handoff));
 	ztest_run_test_suite(pipe_api);
 }
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE	(1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define IOV_PIPE_LEN	16
+#define TIMEOUT		100
+
+static ZTEST_DMEM unsigned char tx[] = "0123456789abcdefghijklmnopqrstuv";
+static ZTEST_BMEM unsigned char rx[2 * IOV_PIPE_LEN];
+static ZTEST_BMEM size_t peer_read;
+static ZTEST_BMEM int peer_ret;
+
+K_PIPE_DEFINE(iov_pipe, IOV_PIPE_LEN, 4);
+K_SEM_DEFINE(iov_sema, 0, 1);
+
+extern struct k_thread tdata2;
+extern k_thread_stack_t tstack2[];
+
+/**
+ * @brief Test gathering writes and scattering reads
+ * @ingroup kernel_pipe_tests
+ * @see k_pipe_writev(), k_pipe_readv()
+ */
+void test_pipe_writev_readv(void)
+{
+	struct k_pipe_iovec wv[] = {
+		{ &tx[0], 5 }, { &tx[5], 0 }, { &tx[5], 7 },
+	};
+	struct k_pipe_iovec rv[] = {
+		{ &rx[0], 4 }, { &rx[4], 8 },
+	};
+	size_t bytes;
+
+	(void)memset(rx, 0, sizeof(rx));
+
+	/**TESTPOINT: segments are written back to back*/
+	zassert_equal(k_pipe_writev(&iov_pipe, wv, ARRAY_SIZE(wv), &bytes,
+				    12, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, 12, NULL);
+
+	/**TESTPOINT: and read back across segment boundaries*/
+	zassert_equal(k_pipe_readv(&iov_pipe, rv, ARRAY_SIZE(rv), &bytes,
+				   12, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, 12, NULL);
+	zassert_mem_equal(rx, tx, 12, NULL);
+
+	/**TESTPOINT: wrap around the end of the ring buffer*/
+	wv[0].base = &tx[12];
+	wv[2].base = &tx[17];
+	zassert_equal(k_pipe_writev(&iov_pipe, wv, ARRAY_SIZE(wv), &bytes,
+				    12, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_pipe_readv(&iov_pipe, rv, ARRAY_SIZE(rv), &bytes,
+				   12, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, 12, NULL);
+	zassert_mem_equal(rx, &tx[12], 12, NULL);
+
+	/**TESTPOINT: a full pipe takes only what fits*/
+	wv[0].base = &tx[0];
+	wv[0].len = 20;
+	zassert_equal(k_pipe_writev(&iov_pipe, wv, 1, &bytes, 1, K_NO_WAIT),
+		      0, NULL);
+	zassert_equal(bytes, IOV_PIPE_LEN, NULL);
+	zassert_equal(k_pipe_writev(&iov_pipe, wv, 1, &bytes, 1, K_NO_WAIT),
+		      -EIO, NULL);
+	zassert_equal(k_pipe_readv(&iov_pipe, rv, ARRAY_SIZE(rv), &bytes,
+				   1, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, 12, NULL);
+	zassert_equal(k_pipe_readv(&iov_pipe, rv, ARRAY_SIZE(rv), &bytes,
+				   1, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, IOV_PIPE_LEN - 12, NULL);
+	zassert_mem_equal(rx, &tx[12], IOV_PIPE_LEN - 12, NULL);
+}
+
+static void tThread_readv(void *p1, void *p2, void *p3)
+{
+	struct k_pipe_iovec rv[] = {
+		{ &rx[0], IOV_PIPE_LEN }, { &rx[IOV_PIPE_LEN], IOV_PIPE_LEN },
+	};
+
+	peer_ret = k_pipe_readv(&iov_pipe, rv, ARRAY_SIZE(rv), &peer_read,
+				1, K_FOREVER);
+	k_sem_give(&iov_sema);
+}
+
+/**
+ * @brief Test that data goes straight to a waiting reader
+ * @ingroup kernel_pipe_tests
+ * @details A reader blocked for more data than is written is woken as
+ * soon as what it got covers its minimum, and a reader finding less
+ * than it asked for in the pipe does not block once it has its minimum.
+ * k_pipe_get() keeps waiting for everything it asked for.
+ * @see k_pipe_readv(), k_pipe_put(), k_pipe_get()
+ */
+void test_pipe_reader_handoff(void)
+{
+	struct k_pipe_iovec rv[] = { { rx, sizeof(rx) } };
+	size_t bytes;
+	s64_t start;
+
+	(void)memset(rx, 0, sizeof(rx));
+
+	k_thread_create(&tdata2, tstack2, STACK_SIZE, tThread_readv,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT);
+
+	/**TESTPOINT: a short write completes the blocked read*/
+	zassert_equal(k_pipe_put(&iov_pipe, tx, 3, &bytes, 3, K_NO_WAIT), 0,
+		      NULL);
+	zassert_equal(k_sem_take(&iov_sema, TIMEOUT), 0, NULL);
+	zassert_equal(peer_ret, 0, NULL);
+	zassert_equal(peer_read, 3, NULL);
+	zassert_mem_equal(rx, tx, 3, NULL);
+	zassert_equal(iov_pipe.bytes_used, 0, NULL);
+
+	/**TESTPOINT: a read with its minimum at hand does not block*/
+	zassert_equal(k_pipe_put(&iov_pipe, tx, 5, &bytes, 5, K_NO_WAIT), 0,
+		      NULL);
+	zassert_equal(k_pipe_readv(&iov_pipe, rv, ARRAY_SIZE(rv), &bytes, 1,
+				   K_FOREVER), 0, NULL);
+	zassert_equal(bytes, 5, NULL);
+
+	/**TESTPOINT: k_pipe_get() still waits for all it asked for*/
+	zassert_equal(k_pipe_put(&iov_pipe, tx, 5, &bytes, 5, K_NO_WAIT), 0,
+		      NULL);
+	start = k_uptime_get();
+	zassert_equal(k_pipe_get(&iov_pipe, rx, sizeof(rx), &bytes, 1,
+				 TIMEOUT), 0, NULL);
+	zassert_equal(bytes, 5, NULL);
+	zassert_true(k_uptime_delta(&start) >= TIMEOUT, NULL);
+
+	k_thread_abort(&tdata2);
+}
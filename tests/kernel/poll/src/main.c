@@ -12,6 +12,9 @@ extern void test_poll_cancel_main_high_prio(void);
 extern void test_poll_multi(void);
 extern void test_poll_threadstate(void);
 extern void test_poll_grant_access(void);
+extern void test_poll_set_ready(void);
+extern void test_poll_set_wait(void);
+extern void test_poll_set_grant_access(void);
 
 K_MEM_POOL_DEFINE(test_pool, 128, 128, 4, 4);
 
@@ -19,6 +22,7 @@ K_MEM_POOL_DEFINE(test_pool, 128, 128, 4, 4);
 void test_main(void)
 {
 	test_poll_grant_access();
+	test_poll_set_grant_access();
 
 	k_thread_resource_pool_assign(k_current_get(), &test_pool);
 
@@ -28,6 +32,8 @@ void test_main(void)
 			 ztest_unit_test(test_poll_cancel_main_low_prio),
 			 ztest_unit_test(test_poll_cancel_main_high_prio),
 			 ztest_unit_test(test_poll_multi),
-			 ztest_unit_test(test_poll_threadstate));
+			 ztest_unit_test(test_poll_threadstate),
+			 ztest_user_unit_test(test_poll_set_ready),
+			 ztest_unit_test(test_poll_set_wait));
 	ztest_run_test_suite(poll_api);
 }
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define SET_SIZE 4
+#define N_SEMS 8
+#define WAIT_MS 50
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+K_POLL_SET_DEFINE(test_set, SET_SIZE);
+K_POLL_SET_DEFINE(wait_set, N_SEMS);
+K_SEM_DEFINE(set_sem, 0, 1);
+static struct k_poll_signal set_signal;
+static struct k_sem sems[N_SEMS];
+
+static struct k_thread give_thread;
+static K_THREAD_STACK_DEFINE(give_stack, STACK_SIZE);
+
+/**
+ * @brief Test adding, removing and reporting objects of a poll set
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_add(), k_poll_set_remove(), k_poll_set_wait()
+ */
+void test_poll_set_ready(void)
+{
+	struct k_poll_set_event ready[SET_SIZE];
+
+	k_poll_signal_init(&set_signal);
+	for (int i = 0; i < SET_SIZE - 1; i++) {
+		k_sem_init(&sems[i], 0, 1);
+	}
+
+	zassert_equal(k_poll_set_add(&test_set, K_POLL_TYPE_SEM_AVAILABLE,
+				     &set_sem, 1), 0, NULL);
+	zassert_equal(k_poll_set_add(&test_set, K_POLL_TYPE_SIGNAL,
+				     &set_signal, 0x10002), 0, NULL);
+	zassert_equal(k_poll_set_add(&test_set, K_POLL_TYPE_SEM_AVAILABLE,
+				     &set_sem, 3), -EEXIST, NULL);
+	zassert_equal(k_poll_set_wait(&test_set, ready, SET_SIZE, K_NO_WAIT),
+		      -EAGAIN, NULL);
+
+	/* TESTPOINT: only the ready object is reported */
+	k_sem_give(&set_sem);
+	zassert_equal(k_poll_set_wait(&test_set, ready, SET_SIZE, K_NO_WAIT),
+		      1, NULL);
+	zassert_equal_ptr(ready[0].obj, &set_sem, NULL);
+	zassert_equal(ready[0].tag, 1, NULL);
+	zassert_equal(ready[0].state, K_POLL_STATE_SEM_AVAILABLE, NULL);
+
+	/* TESTPOINT: an object that wasn't consumed is reported again */
+	zassert_equal(k_poll_set_wait(&test_set, ready, SET_SIZE, K_NO_WAIT),
+		      1, NULL);
+	zassert_equal(k_sem_take(&set_sem, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_poll_set_wait(&test_set, ready, SET_SIZE, K_NO_WAIT),
+		      -EAGAIN, NULL);
+
+	k_poll_signal_raise(&set_signal, 0);
+	zassert_equal(k_poll_set_wait(&test_set, ready, SET_SIZE, K_NO_WAIT),
+		      1, NULL);
+	/* TESTPOINT: tags keep all their 32 bits */
+	zassert_equal_ptr(ready[0].obj, &set_signal, NULL);
+	zassert_equal(ready[0].tag, 0x10002, NULL);
+	zassert_equal(ready[0].state, K_POLL_STATE_SIGNALED, NULL);
+	k_poll_signal_reset(&set_signal);
+
+	/* TESTPOINT: removed objects are no longer reported */
+	zassert_equal(k_poll_set_remove(&test_set, &set_signal), 0, NULL);
+	zassert_equal(k_poll_set_remove(&test_set, &set_signal), -ENOENT,
+		      NULL);
+	k_poll_signal_raise(&set_signal, 0);
+	zassert_equal(k_poll_set_wait(&test_set, ready, SET_SIZE, K_NO_WAIT),
+		      -EAGAIN, NULL);
+	k_poll_signal_reset(&set_signal);
+
+	/* TESTPOINT: adding to a full set fails */
+	for (int i = 0; i < SET_SIZE - 1; i++) {
+		zassert_equal(k_poll_set_add(&test_set,
+					     K_POLL_TYPE_SEM_AVAILABLE,
+					     &sems[i], 0), 0, NULL);
+	}
+	zassert_equal(k_poll_set_add(&test_set, K_POLL_TYPE_SIGNAL,
+				     &set_signal, 0), -ENOSPC, NULL);
+	for (int i = 0; i < SET_SIZE - 1; i++) {
+		zassert_equal(k_poll_set_remove(&test_set, &sems[i]), 0, NULL);
+	}
+	zassert_equal(k_poll_set_remove(&test_set, &set_sem), 0, NULL);
+}
+
+static void give_later(void *p1, void *p2, void *p3)
+{
+	k_sleep(WAIT_MS / 2);
+	k_sem_give(&sems[POINTER_TO_INT(p1)]);
+}
+
+/**
+ * @brief Test waiting on a poll set
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @details Wait on a set of semaphores with a timeout, then have
+ * another thread give one of them while blocked, and check that
+ * ready objects beyond the size of the output array are reported by
+ * the next call.
+ *
+ * @see k_poll_set_wait()
+ */
+void test_poll_set_wait(void)
+{
+	struct k_poll_set_event ready[2];
+	s64_t start;
+
+	for (int i = 0; i < N_SEMS; i++) {
+		k_sem_init(&sems[i], 0, 1);
+		zassert_equal(k_poll_set_add(&wait_set,
+					     K_POLL_TYPE_SEM_AVAILABLE,
+					     &sems[i], i), 0, NULL);
+	}
+
+	start = k_uptime_get();
+	zassert_equal(k_poll_set_wait(&wait_set, ready, 1, WAIT_MS), -EAGAIN,
+		      NULL);
+	zassert_true(k_uptime_get() - start >= WAIT_MS, NULL);
+
+	/* TESTPOINT: a blocked waiter is woken by one object */
+	k_thread_create(&give_thread, give_stack, STACK_SIZE, give_later,
+			INT_TO_POINTER(5), NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	zassert_equal(k_poll_set_wait(&wait_set, ready, 2, K_FOREVER), 1,
+		      NULL);
+	zassert_equal_ptr(ready[0].obj, &sems[5], NULL);
+	zassert_equal(ready[0].tag, 5, NULL);
+	k_sem_take(&sems[5], K_NO_WAIT);
+	k_thread_abort(&give_thread);
+
+	/* TESTPOINT: more ready objects than room for them */
+	k_sem_give(&sems[1]);
+	k_sem_give(&sems[3]);
+	k_sem_give(&sems[7]);
+	zassert_equal(k_poll_set_wait(&wait_set, ready, 2, K_NO_WAIT), 2,
+		      NULL);
+	zassert_equal(ready[0].tag, 1, NULL);
+	zassert_equal(ready[1].tag, 3, NULL);
+	k_sem_take(&sems[1], K_NO_WAIT);
+	k_sem_take(&sems[3], K_NO_WAIT);
+	zassert_equal(k_poll_set_wait(&wait_set, ready, 2, K_NO_WAIT), 1,
+		      NULL);
+	zassert_equal(ready[0].tag, 7, NULL);
+	k_sem_take(&sems[7], K_NO_WAIT);
+	zassert_equal(k_poll_set_wait(&wait_set, ready, 2, K_NO_WAIT), -EAGAIN,
+		      NULL);
+
+	for (int i = 0; i < N_SEMS; i++) {
+		zassert_equal(k_poll_set_remove(&wait_set, &sems[i]), 0, NULL);
+	}
+}
+
+void test_poll_set_grant_access(void)
+{
+	k_thread_access_grant(k_current_get(), &test_set, &set_sem,
+			      &set_signal, &sems[0], &sems[1], &sems[2]);
+}
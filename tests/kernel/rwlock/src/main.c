@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define MAIN_PRIO K_PRIO_PREEMPT(5)
+#define LOW_PRIO K_PRIO_PREEMPT(10)
+#define HIGH_PRIO K_PRIO_PREEMPT(1)
+#define HOLD_MS 20
+
+K_RWLOCK_DEFINE(rwlock);
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, 2, STACK_SIZE);
+static struct k_thread tdata[2];
+static K_SEM_DEFINE(locked_sema, 0, 1);
+
+static volatile int seq, writer_seq, reader_seq;
+static volatile int held_prio;
+
+/**
+ * @brief Test the uncontended lock and unlock paths
+ *
+ * @details Readers share the lock and keep writers out, a writer keeps
+ * everybody out, and releasing a lock one does not hold is refused.
+ */
+void test_rwlock_basic(void)
+{
+	zassert_equal(k_rwlock_read_unlock(&rwlock), -EINVAL, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), -EPERM, NULL);
+
+	/* TESTPOINT: readers share the lock */
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), -EPERM, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), -EINVAL, NULL);
+
+	/* TESTPOINT: a writer is exclusive and can't recurse */
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), -EDEADLK,
+		      NULL);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_FOREVER), -EDEADLK,
+		      NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), -EINVAL, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+
+	zassert_equal(k_rwlock_write_lock(&rwlock, HOLD_MS), 0, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+}
+
+static void writer(void *p1, void *p2, void *p3)
+{
+	s32_t timeout = POINTER_TO_INT(p1);
+
+	if (k_rwlock_write_lock(&rwlock, timeout) != 0) {
+		writer_seq = -1;
+		return;
+	}
+
+	writer_seq = ++seq;
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+}
+
+static void reader(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_FOREVER), 0, NULL);
+	reader_seq = ++seq;
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+}
+
+static void spawn(int i, k_thread_entry_t entry, s32_t timeout, int prio)
+{
+	k_thread_create(&tdata[i], tstack[i], STACK_SIZE, entry,
+			INT_TO_POINTER(timeout), NULL, NULL, prio, 0, 0);
+}
+
+/**
+ * @brief Test that waiting writers go before new readers
+ *
+ * @details While a reader holds the lock, a writer starts waiting for
+ * it.  New readers must now wait too, even a higher priority one, and
+ * get the lock only after the writer has had it.
+ */
+void test_rwlock_writer_preference(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	seq = writer_seq = reader_seq = 0;
+
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	spawn(0, writer, K_FOREVER, HIGH_PRIO);
+	zassert_equal(writer_seq, 0, NULL);
+
+	/* TESTPOINT: the waiting writer holds back new readers */
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+	spawn(1, reader, 0, HIGH_PRIO);
+	zassert_equal(reader_seq, 0, NULL);
+
+	/* TESTPOINT: last reader out hands over to the writer */
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(writer_seq, 1, NULL);
+	zassert_equal(reader_seq, 2, NULL);
+	zassert_equal(atomic_get(&rwlock.state), 0, NULL);
+
+	k_thread_abort(&tdata[0]);
+	k_thread_abort(&tdata[1]);
+}
+
+/**
+ * @brief Test that readers come back once a waiting writer gives up
+ */
+void test_rwlock_writer_timeout(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	writer_seq = 0;
+
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	spawn(0, writer, HOLD_MS, HIGH_PRIO);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+
+	/* TESTPOINT: a reader blocked behind the writer gets in when
+	 * the writer times out
+	 */
+	zassert_equal(k_rwlock_read_lock(&rwlock, 2 * HOLD_MS), 0, NULL);
+	zassert_equal(writer_seq, -1, NULL);
+
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(atomic_get(&rwlock.state), 0, NULL);
+
+	k_thread_abort(&tdata[0]);
+}
+
+static void low_writer(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	k_sem_give(&locked_sema);
+	k_sleep(HOLD_MS);
+	held_prio = k_thread_priority_get(k_current_get());
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+}
+
+/**
+ * @brief Test priority inheritance for the writer
+ *
+ * @details A low priority writer holds the lock while a higher priority
+ * reader waits for it.  The writer runs at the reader's priority until
+ * it releases the lock.
+ */
+void test_rwlock_priority_inheritance(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	held_prio = 0;
+
+	spawn(0, low_writer, 0, LOW_PRIO);
+	k_sem_take(&locked_sema, K_FOREVER);
+
+	/* TESTPOINT: writer boosted, then restored */
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_FOREVER), 0, NULL);
+	zassert_equal(held_prio, MAIN_PRIO, NULL);
+	zassert_equal(k_thread_priority_get(&tdata[0]), LOW_PRIO, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+
+	k_thread_abort(&tdata[0]);
+}
+
+/**
+ * @brief Test the lock from user mode
+ */
+void test_rwlock_user(void)
+{
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_FOREVER), 0, NULL);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), -EDEADLK,
+		      NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+}
+
+void test_main(void)
+{
+	k_thread_access_grant(k_current_get(), &rwlock);
+
+	ztest_test_suite(rwlock_api,
+			 ztest_unit_test(test_rwlock_basic),
+			 ztest_unit_test(test_rwlock_writer_preference),
+			 ztest_unit_test(test_rwlock_writer_timeout),
+			 ztest_unit_test(test_rwlock_priority_inheritance),
+			 ztest_user_unit_test(test_rwlock_user));
+	ztest_run_test_suite(rwlock_api);
+}
@@ -430,6 +430,72 @@ void test_wakeup_threads(void)
 	cleanup_resources();
 }
 
+#ifdef CONFIG_SCHED_READY_IPI
+static u32_t ipis_taken(void)
+{
+	u32_t n = 0U;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		n += k_sched_ipi_count_get(i);
+	}
+
+	return n;
+}
+
+static void thread_ready_ipi_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_take(&sema, K_FOREVER);
+	tinfo[0].executed = 1;
+}
+
+/**
+ * @brief Test that an idle CPU runs a newly ready thread at once
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details A cooperative thread readies a thread and then keeps its
+ * own CPU busy for less than a tick.  The other CPU is idle, so it
+ * must be interrupted and run the new thread before the busy wait
+ * ends.
+ */
+void test_ready_ipi(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	u32_t ipis;
+
+	k_sem_reset(&sema);
+	spawn_threads(K_PRIO_COOP(10), 1, !EQUAL_PRIORITY,
+		      &thread_ready_ipi_entry, !THREAD_DELAY);
+
+	k_sleep(TIMEOUT);
+	zassert_true(z_is_thread_prevented_from_running(tinfo[0].tid),
+		     "thread did not block");
+
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(10));
+	ipis = ipis_taken();
+
+	k_sem_give(&sema);
+	k_busy_wait(USEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC / 2);
+
+	/* TESTPOINT: the thread ran without waiting for a tick */
+	zassert_equal(tinfo[0].executed, 1, "thread did not run");
+	zassert_true(ipis_taken() > ipis, "no scheduler IPI taken");
+
+	k_thread_priority_set(k_current_get(), prio);
+	abort_threads(1);
+	cleanup_resources();
+}
+#else
+void test_ready_ipi(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	/* Sleep a bit to guarantee that both CPUs enter an idle
@@ -445,7 +511,8 @@ void test_main(void)
 			 ztest_unit_test(test_preempt_resched_threads),
 			 ztest_unit_test(test_yield_threads),
 			 ztest_unit_test(test_sleep_threads),
-			 ztest_unit_test(test_wakeup_threads)
+			 ztest_unit_test(test_wakeup_threads),
+			 ztest_unit_test(test_ready_ipi)
 			 );
 	ztest_run_test_suite(smp);
 }
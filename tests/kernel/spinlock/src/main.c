@@ -8,6 +8,7 @@
 #include <ztest.h>
 #include <kernel.h>
 #include <spinlock.h>
+#include <string.h>
 
 #define CPU1_STACK_SIZE 1024
 
@@ -17,6 +18,12 @@ static struct k_spinlock bounce_lock;
 
 volatile int bounce_owner, bounce_done;
 
+#ifdef CONFIG_SPINLOCK_TICKET
+#define LOCK_HELD(l) ((l).next != (l).owner)
+#else
+#define LOCK_HELD(l) ((l).locked)
+#endif
+
 /**
  * @brief Tests for spinlock
  *
@@ -40,15 +47,15 @@ void test_spinlock_basic(void)
 	k_spinlock_key_t key;
 	static struct k_spinlock l;
 
-	zassert_true(!l.locked, "Spinlock initialized to locked");
+	zassert_true(!LOCK_HELD(l), "Spinlock initialized to locked");
 
 	key = k_spin_lock(&l);
 
-	zassert_true(l.locked, "Spinlock failed to lock");
+	zassert_true(LOCK_HELD(l), "Spinlock failed to lock");
 
 	k_spin_unlock(&l, key);
 
-	zassert_true(!l.locked, "Spinlock failed to unlock");
+	zassert_true(!LOCK_HELD(l), "Spinlock failed to unlock");
 }
 
 void bounce_once(int id)
@@ -123,10 +130,54 @@ void test_spinlock_bounce(void)
 	bounce_done = 1;
 }
 
+#ifdef CONFIG_SPINLOCK_STATS
+static void stats_cb(const struct k_spinlock *l,
+		     const struct k_spinlock_stats *stats, void *user_data)
+{
+	if (l == &bounce_lock) {
+		*(bool *)user_data = true;
+	}
+}
+
+/**
+ * @brief Test spinlock contention statistics
+ *
+ * @ingroup kernel_spinlock_tests
+ *
+ * @details The bounce test leaves both CPUs fighting over
+ * bounce_lock, so it must have been taken, found contended and spun
+ * on, and once registered it must be reported along with the
+ * kernel's own locks.
+ *
+ * @see k_spin_stats_register(), k_spin_stats_foreach()
+ */
+void test_spinlock_stats(void)
+{
+	struct k_spinlock_stats *stats = &bounce_lock.stats;
+	bool found = false;
+
+	zassert_true(stats->acquisitions >= 10000, NULL);
+	zassert_true(stats->contended > 0, NULL);
+	zassert_true(stats->spins >= stats->contended, NULL);
+	zassert_true(stats->max_hold > 0, NULL);
+
+	k_spin_stats_register(&bounce_lock, "bounce");
+	k_spin_stats_foreach(stats_cb, &found);
+	zassert_true(found, "registered lock not reported");
+	zassert_equal(strcmp(stats->name, "bounce"), 0, NULL);
+}
+#else
+void test_spinlock_stats(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(spinlock,
 			 ztest_unit_test(test_spinlock_basic),
-			 ztest_unit_test(test_spinlock_bounce));
+			 ztest_unit_test(test_spinlock_bounce),
+			 ztest_unit_test(test_spinlock_stats));
 	ztest_run_test_suite(spinlock);
 }
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define BUSY_US 10000
+#define BUSY_MS (BUSY_US / USEC_PER_MSEC)
+#define BLOCKED_MS 20
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+static K_SEM_DEFINE(wake_sem, 0, 1);
+
+static u64_t us_to_cycles(u32_t us)
+{
+	return k_ns_to_cycles((u64_t)us * NSEC_PER_USEC);
+}
+
+static void busy(void *p1, void *p2, void *p3)
+{
+	k_busy_wait(BUSY_US);
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	k_sem_take(&wake_sem, K_FOREVER);
+}
+
+/**
+ * @brief Test the execution time and switches of a thread
+ *
+ * @details A thread busy for some time has at least that time counted,
+ * and was switched in at least once.
+ */
+void test_runtime_stats_execution(void)
+{
+	struct k_thread_runtime_stats stats;
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, busy, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	/* Long enough for it to finish without this thread preempting it */
+	k_sleep(2 * BUSY_MS);
+
+	zassert_equal(k_thread_runtime_stats_get(&tdata, &stats), 0, NULL);
+	zassert_true(stats.execution_cycles >= us_to_cycles(BUSY_US), NULL);
+	zassert_true(stats.switches >= 1U, NULL);
+
+	/* TESTPOINT: the running thread's current slice is included */
+	k_busy_wait(BUSY_US);
+	zassert_equal(k_thread_runtime_stats_get(k_current_get(), &stats), 0,
+		      NULL);
+	zassert_true(stats.execution_cycles >= us_to_cycles(BUSY_US), NULL);
+
+	/* TESTPOINT: invalid parameters */
+	zassert_equal(k_thread_runtime_stats_get(NULL, &stats), -EINVAL, NULL);
+	zassert_equal(k_thread_runtime_stats_get(&tdata, NULL), -EINVAL, NULL);
+}
+
+/**
+ * @brief Test the time spent blocked on a wait queue
+ *
+ * @details The time a thread spends pended on a semaphore is counted
+ * for the thread and for the semaphore's wait queue.
+ */
+void test_runtime_stats_blocked(void)
+{
+	struct k_thread_runtime_stats stats;
+	u64_t min = us_to_cycles((BLOCKED_MS - 1) * USEC_PER_MSEC);
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, waiter, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(BLOCKED_MS);
+	k_sem_give(&wake_sem);
+
+	zassert_equal(k_thread_runtime_stats_get(&tdata, &stats), 0, NULL);
+	zassert_true(stats.blocked_cycles >= min, NULL);
+	zassert_true(wake_sem.wait_q.blocked_cycles >= min, NULL);
+
+	/* Let it exit */
+	k_sleep(1);
+}
+
+/**
+ * @brief Test the wake to run latency histogram
+ *
+ * @details A thread made ready while a higher priority thread keeps
+ * the CPU busy waits that long before running.
+ */
+void test_runtime_stats_latency(void)
+{
+	struct k_thread_runtime_stats stats;
+	int bucket = find_msb_set(BUSY_US) - 1;
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, waiter, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	k_sleep(1);
+
+	/* This thread is cooperative, the waiter can't run meanwhile */
+	k_sem_give(&wake_sem);
+	k_busy_wait(BUSY_US);
+	k_sleep(1);
+
+	zassert_equal(k_thread_runtime_stats_get(&tdata, &stats), 0, NULL);
+	zassert_true(stats.max_latency >= us_to_cycles(BUSY_US), NULL);
+	zassert_equal(stats.latency[bucket], 1, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(runtime_stats,
+			 ztest_unit_test(test_runtime_stats_execution),
+			 ztest_unit_test(test_runtime_stats_blocked),
+			 ztest_unit_test(test_runtime_stats_latency));
+	ztest_run_test_suite(runtime_stats);
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define POOL_SIZE 3
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+K_THREAD_POOL_DEFINE(test_pool, POOL_SIZE, STACK_SIZE);
+
+static K_THREAD_STACK_DEFINE(own_stack, STACK_SIZE);
+static K_SEM_DEFINE(start_sem, 0, POOL_SIZE);
+static K_SEM_DEFINE(done_sem, 0, POOL_SIZE);
+static void worker(void *p1, void *p2, void *p3)
+{
+	k_sem_take(&start_sem, K_FOREVER);
+	k_sem_give(&done_sem);
+}
+
+/* Stack buffer the pool keeps for a thread */
+static char *pool_stack(k_tid_t tid)
+{
+	size_t idx = ((u8_t *)tid - test_pool.threads) / test_pool.thread_size;
+
+	return Z_THREAD_STACK_BUFFER((k_thread_stack_t *)
+				     ((u8_t *)test_pool.stacks +
+				      idx * test_pool.stack_stride));
+}
+
+static k_tid_t spawn(k_thread_stack_t *stack, s32_t delay)
+{
+	return k_thread_pool_spawn(&test_pool, stack, STACK_SIZE, worker,
+				   NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0,
+				   delay);
+}
+
+/* Let the workers run to completion */
+static void finish(int count)
+{
+	for (int i = 0; i < count; i++) {
+		k_sem_give(&start_sem);
+		zassert_equal(k_sem_take(&done_sem, 100), 0, NULL);
+	}
+
+	/* Have them exit after signaling */
+	k_sleep(1);
+}
+
+/**
+ * @brief Test spawning threads from a pool until it is empty
+ *
+ * @details Each thread gets a distinct struct from the pool; once all
+ * are in use spawning fails, and they return to the pool as the
+ * threads exit.
+ */
+void test_pool_spawn(void)
+{
+	k_tid_t tid[POOL_SIZE];
+
+	zassert_equal(k_thread_pool_num_free_get(&test_pool), POOL_SIZE, NULL);
+
+	for (int i = 0; i < POOL_SIZE; i++) {
+		tid[i] = spawn(NULL, K_NO_WAIT);
+		zassert_not_null(tid[i], NULL);
+		for (int j = 0; j < i; j++) {
+			zassert_not_equal(tid[i], tid[j], NULL);
+		}
+	}
+
+	/* TESTPOINT: pool exhausted */
+	zassert_is_null(spawn(NULL, K_NO_WAIT), NULL);
+	zassert_equal(k_thread_pool_num_free_get(&test_pool), 0, NULL);
+
+	/* TESTPOINT: exited threads return to the pool */
+	finish(POOL_SIZE);
+	zassert_equal(k_thread_pool_num_free_get(&test_pool), POOL_SIZE, NULL);
+
+	/* TESTPOINT: a stack given by the caller still takes a struct */
+	tid[0] = spawn(own_stack, K_NO_WAIT);
+	zassert_not_null(tid[0], NULL);
+	zassert_equal(k_thread_pool_num_free_get(&test_pool), POOL_SIZE - 1,
+		      NULL);
+	finish(1);
+}
+
+/**
+ * @brief Test keeping a pool thread's struct after it exits
+ *
+ * @details A reference taken before the thread starts keeps its struct
+ * out of the pool until it is released.
+ */
+void test_pool_hold(void)
+{
+	k_tid_t tid = spawn(NULL, K_FOREVER);
+
+	zassert_not_null(tid, NULL);
+	k_thread_pool_hold(tid);
+	k_thread_start(tid);
+	finish(1);
+
+	/* TESTPOINT: still allocated after exit */
+	zassert_equal(k_thread_pool_num_free_get(&test_pool), POOL_SIZE - 1,
+		      NULL);
+
+	/* TESTPOINT: back in the pool once released */
+	k_thread_pool_put(tid);
+	zassert_equal(k_thread_pool_num_free_get(&test_pool), POOL_SIZE, NULL);
+}
+
+/**
+ * @brief Test that recycled stacks are not filled again
+ *
+ * @details With CONFIG_INIT_STACKS, only the first thread spawned on a
+ * stack of the pool fills it.
+ */
+void test_pool_stack_recycle(void)
+{
+	k_tid_t tid;
+	char *buf;
+
+	if (!IS_ENABLED(CONFIG_INIT_STACKS)) {
+		ztest_test_skip();
+	}
+
+	tid = spawn(NULL, K_NO_WAIT);
+	zassert_not_null(tid, NULL);
+	buf = pool_stack(tid);
+	zassert_equal(buf[STACK_SIZE / 2], (char)0xaa, NULL);
+	finish(1);
+
+	/* The last struct freed is the first one spawned again */
+	buf[STACK_SIZE / 2] = 0x55;
+	zassert_equal(spawn(NULL, K_FOREVER), tid, NULL);
+
+	/* TESTPOINT: the stack was left as the last thread left it */
+	zassert_equal(buf[STACK_SIZE / 2], 0x55, NULL);
+	k_thread_start(tid);
+	finish(1);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(thread_pool,
+			 ztest_unit_test(test_pool_spawn),
+			 ztest_unit_test(test_pool_hold),
+			 ztest_unit_test(test_pool_stack_recycle));
+	ztest_run_test_suite(thread_pool);
+}
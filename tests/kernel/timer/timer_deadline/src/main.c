@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define N_PERIODS 20
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+static struct k_timer deadline_timer;
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+/* How late a wakeup may come: up to the next tick boundary, or only
+ * by the interrupt latency when timeouts expire within the tick
+ */
+static u32_t max_late(void)
+{
+	u32_t cyc_per_tick = sys_clock_hw_cycles_per_tick();
+
+	return IS_ENABLED(CONFIG_TIMEOUT_SUBTICK) ?
+	       cyc_per_tick / 4 : cyc_per_tick;
+}
+
+/* A duration of a few ticks and a fraction of one */
+static u32_t odd_cycles(void)
+{
+	return 3 * sys_clock_hw_cycles_per_tick() +
+	       sys_clock_hw_cycles_per_tick() / 3;
+}
+
+static void check_on_time(u64_t deadline)
+{
+	u64_t now = k_uptime_cycles_get();
+
+	zassert_true(now >= deadline, "woke %u cycles early",
+		     (u32_t)(deadline - now));
+	zassert_true(now - deadline < max_late(), "woke %u cycles late",
+		     (u32_t)(now - deadline));
+}
+
+/**
+ * @brief Test sleeping until an absolute deadline
+ *
+ * @details The thread must not wake before the deadline, nor later
+ * than the next tick boundary, or than the interrupt latency with
+ * CONFIG_TIMEOUT_SUBTICK.  A deadline already past returns at once.
+ */
+void test_sleep_until(void)
+{
+	u64_t deadline;
+
+	/* Start in the middle of a tick */
+	k_sleep(1);
+	k_busy_wait(k_cycles_to_ns(sys_clock_hw_cycles_per_tick()) / 2000);
+
+	/* TESTPOINT: wakeup right at the deadline */
+	deadline = k_uptime_cycles_get() + odd_cycles();
+	zassert_equal(k_sleep_until(deadline), 0, NULL);
+	check_on_time(deadline);
+
+	/* TESTPOINT: deadline already past */
+	deadline = k_uptime_cycles_get();
+	zassert_equal(k_sleep_until(deadline - 1), 0, NULL);
+	zassert_true(k_uptime_cycles_get() - deadline < max_late(), NULL);
+}
+
+static void sleeper(void *p1, void *p2, void *p3)
+{
+	u64_t deadline = k_uptime_cycles_get() + 100 * odd_cycles();
+
+	zassert_equal(k_sleep_until(deadline), -EAGAIN, NULL);
+	k_sem_give(&done_sem);
+}
+
+/**
+ * @brief Test waking up a thread sleeping until a deadline
+ *
+ * @details k_wakeup() ends the sleep early, which the thread is told
+ * about.
+ */
+void test_sleep_until_wakeup(void)
+{
+	k_thread_create(&tdata, tstack, STACK_SIZE, sleeper, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+
+	k_sleep(1);
+	k_wakeup(&tdata);
+	zassert_equal(k_sem_take(&done_sem, 100), 0, NULL);
+	k_thread_abort(&tdata);
+}
+
+/**
+ * @brief Test a periodic timer started at an absolute deadline
+ *
+ * @details Each expiry follows from the previous deadline, so after
+ * many periods of a length that isn't a whole number of ticks the
+ * timer is still no later than a single expiry can be.
+ */
+void test_timer_start_at(void)
+{
+	u32_t period = odd_cycles();
+	u64_t start = k_uptime_cycles_get() + period;
+
+	k_timer_init(&deadline_timer, NULL, NULL);
+	k_timer_start_at(&deadline_timer, start, period);
+
+	/* TESTPOINT: first expiry at the deadline */
+	zassert_equal(k_timer_status_sync(&deadline_timer), 1, NULL);
+	check_on_time(start);
+
+	/* TESTPOINT: no drift over the following periods */
+	for (int i = 1; i < N_PERIODS; i++) {
+		zassert_equal(k_timer_status_sync(&deadline_timer), 1, NULL);
+	}
+	check_on_time(start + (u64_t)(N_PERIODS - 1) * period);
+
+	k_timer_stop(&deadline_timer);
+
+	/* TESTPOINT: a relative start makes the timer relative again */
+	k_timer_start(&deadline_timer, 1, 1);
+	zassert_equal(deadline_timer.period_cycles, 0, NULL);
+	k_timer_stop(&deadline_timer);
+}
+
+/**
+ * @brief Test the conversions between nanoseconds and cycles
+ */
+void test_ns_cycles(void)
+{
+	u64_t cyc = sys_clock_hw_cycles_per_sec();
+
+	zassert_equal(k_ns_to_cycles(NSEC_PER_SEC), cyc, NULL);
+	zassert_equal(k_cycles_to_ns(cyc), NSEC_PER_SEC, NULL);
+
+	/* TESTPOINT: rounded up to cycles, down to nanoseconds */
+	zassert_equal(k_ns_to_cycles(1), 1, NULL);
+	zassert_true(k_cycles_to_ns(k_ns_to_cycles(12345)) >= 12345, NULL);
+
+	/* TESTPOINT: no overflow for ten years */
+	zassert_equal(k_ns_to_cycles(3600ULL * 24 * 3650 * NSEC_PER_SEC),
+		      3600ULL * 24 * 3650 * cyc, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(timer_deadline,
+			 ztest_unit_test(test_sleep_until),
+			 ztest_unit_test(test_sleep_until_wakeup),
+			 ztest_unit_test(test_timer_start_at),
+			 ztest_unit_test(test_ns_cycles));
+	ztest_run_test_suite(timer_deadline);
+}
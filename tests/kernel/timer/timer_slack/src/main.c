@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define EXACT_MS 100
+#define EARLY_MS 70
+#define SLACK_MS 50
+
+static struct k_timer exact_timer;
+static struct k_timer slack_timer;
+static struct k_delayed_work slack_work;
+
+static void work_handler(struct k_work *work)
+{
+}
+
+static void timers_init(void)
+{
+	k_timer_init(&exact_timer, NULL, NULL);
+	k_timer_init(&slack_timer, NULL, NULL);
+	k_thread_timer_slack_set(k_current_get(), 0);
+}
+
+/**
+ * @brief Test that a timer with slack joins a pending expiry
+ *
+ * @details A timer whose slack window covers the expiry of an
+ * already running timer must be moved onto it, expire in the same
+ * wakeup and be counted as an avoided wakeup.
+ */
+void test_timer_slack_coalesce(void)
+{
+	u32_t avoided;
+
+	timers_init();
+	k_timer_slack_set(&slack_timer, SLACK_MS);
+	avoided = k_timer_wakeups_avoided_get();
+
+	k_timer_start(&exact_timer, EXACT_MS, 0);
+	k_timer_start(&slack_timer, EARLY_MS, 0);
+
+	/* TESTPOINT: both timers now expire on the same tick */
+	zassert_equal(k_timer_remaining_get(&slack_timer),
+		      k_timer_remaining_get(&exact_timer), NULL);
+	zassert_equal(k_timer_wakeups_avoided_get(), avoided + 1, NULL);
+
+	zassert_equal(k_timer_status_sync(&slack_timer), 1, NULL);
+	zassert_equal(k_timer_status_get(&exact_timer), 1, NULL);
+}
+
+/**
+ * @brief Test the expiry chosen when there is nothing to join
+ *
+ * @details With no other timeout due in its window, a timer with
+ * slack still expires inside that window, and no wakeup is counted
+ * as avoided.
+ */
+void test_timer_slack_window(void)
+{
+	u32_t avoided, remaining;
+
+	timers_init();
+	k_timer_slack_set(&slack_timer, SLACK_MS);
+	avoided = k_timer_wakeups_avoided_get();
+
+	k_timer_start(&slack_timer, EARLY_MS, 0);
+	remaining = k_timer_remaining_get(&slack_timer);
+
+	/* TESTPOINT: expiry deferred by no more than the slack */
+	zassert_true(remaining >= EARLY_MS - 1 &&
+		     remaining <= EARLY_MS + SLACK_MS,
+		     "remaining %u", remaining);
+	zassert_equal(k_timer_wakeups_avoided_get(), avoided, NULL);
+
+	zassert_equal(k_timer_status_sync(&slack_timer), 1, NULL);
+}
+
+/**
+ * @brief Test the per-thread default slack
+ *
+ * @details A thread's default slack applies to its own sleeps and to
+ * delayed work it submits, while a timer with an explicit slack of
+ * zero keeps an exact expiry.
+ */
+void test_thread_timer_slack(void)
+{
+	u32_t avoided;
+
+	timers_init();
+	k_delayed_work_init(&slack_work, work_handler);
+	k_thread_timer_slack_set(k_current_get(), SLACK_MS);
+
+	/* TESTPOINT: explicit zero slack overrides the thread default */
+	k_timer_slack_set(&slack_timer, 0);
+	avoided = k_timer_wakeups_avoided_get();
+	k_timer_start(&exact_timer, EXACT_MS, 0);
+	k_timer_start(&slack_timer, EARLY_MS, 0);
+	zassert_true(k_timer_remaining_get(&slack_timer) <
+		     k_timer_remaining_get(&exact_timer), NULL);
+	zassert_equal(k_timer_wakeups_avoided_get(), avoided, NULL);
+	k_timer_stop(&slack_timer);
+
+	/* TESTPOINT: delayed work inherits the submitter's slack */
+	zassert_equal(k_delayed_work_submit(&slack_work, EARLY_MS), 0, NULL);
+	zassert_equal(k_delayed_work_remaining_get(&slack_work),
+		      k_timer_remaining_get(&exact_timer), NULL);
+	zassert_equal(k_timer_wakeups_avoided_get(), avoided + 1, NULL);
+	k_delayed_work_cancel(&slack_work);
+
+	/* TESTPOINT: so does the thread's own sleep */
+	k_sleep(EARLY_MS);
+	zassert_equal(k_timer_status_get(&exact_timer), 1, NULL);
+	zassert_equal(k_timer_wakeups_avoided_get(), avoided + 2, NULL);
+
+	k_thread_timer_slack_set(k_current_get(), 0);
+}
+
+/**
+ * @brief Test that slack does not accumulate over periods
+ *
+ * @details Each period of a periodic timer with slack counts from
+ * the nominal expiry, so after N periods it has expired N times
+ * even if every expiry was deferred.
+ */
+void test_timer_slack_periodic(void)
+{
+	timers_init();
+	k_timer_slack_set(&slack_timer, SLACK_MS);
+
+	k_timer_start(&slack_timer, EXACT_MS, EXACT_MS);
+	k_sleep(10 * EXACT_MS + EXACT_MS * 3 / 4);
+
+	/* TESTPOINT: ten nominal expiries, none lost to drift */
+	zassert_equal(k_timer_status_get(&slack_timer), 10, NULL);
+	k_timer_stop(&slack_timer);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(timer_slack,
+			 ztest_unit_test(test_timer_slack_coalesce),
+			 ztest_unit_test(test_timer_slack_window),
+			 ztest_unit_test(test_thread_timer_slack),
+			 ztest_unit_test(test_timer_slack_periodic));
+	ztest_run_test_suite(timer_slack);
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define TIMEOUT 100
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_WORKERS 2
+#define NUM_OF_WORK 6
+
+static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks, NUM_WORKERS, STACK_SIZE);
+static struct k_work_q_worker pool_workers[NUM_WORKERS];
+static struct k_work_q pool;
+
+static struct k_work block_work;
+static struct k_work work[NUM_OF_WORK];
+static struct k_delayed_work delayed_work;
+
+static K_SEM_DEFINE(block_sema, 0, 1);
+static K_SEM_DEFINE(sync_sema, 0, NUM_OF_WORK);
+static atomic_t done;
+
+static void block_handler(struct k_work *w)
+{
+	k_sem_take(&block_sema, K_FOREVER);
+	k_sem_give(&sync_sema);
+}
+
+static void work_handler(struct k_work *w)
+{
+	atomic_inc(&done);
+	k_sem_give(&sync_sema);
+}
+
+static u32_t executed(void)
+{
+	u32_t n = 0U;
+
+	for (int i = 0; i < K_WORK_Q_LATENCY_BUCKETS; i++) {
+		n += pool.latency[i];
+	}
+
+	return n;
+}
+
+/**
+ * @brief Test that a blocked handler does not stall the pool
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details One work item blocks its worker. Work items submitted
+ * afterwards, including those queued for the blocked worker, must all
+ * be processed by the other worker.
+ */
+void test_pool_no_head_of_line_blocking(void)
+{
+	u32_t steals = pool.steals;
+
+	atomic_clear(&done);
+	k_work_init(&block_work, block_handler);
+	k_work_submit_to_queue(&pool, &block_work);
+
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		k_work_init(&work[i], work_handler);
+		k_work_submit_to_queue(&pool, &work[i]);
+	}
+
+	/**TESTPOINT: everything but the blocked item completes*/
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	}
+	zassert_equal(atomic_get(&done), NUM_OF_WORK, NULL);
+
+	/**TESTPOINT: items queued behind the blocked one were stolen*/
+	zassert_true(pool.steals > steals, NULL);
+
+	k_sem_give(&block_sema);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+}
+
+static void isr_submit(void *data)
+{
+	k_work_submit_to_queue(&pool, (struct k_work *)data);
+}
+
+/**
+ * @brief Test submitting to a pool from an ISR
+ *
+ * @ingroup kernel_workqueue_tests
+ */
+void test_pool_isr_submit(void)
+{
+	k_work_init(&work[0], work_handler);
+	irq_offload(isr_submit, &work[0]);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+}
+
+/**
+ * @brief Test delayed work on a pool, including cancellation
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details Cancelling a delayed work item once it has been handed to a
+ * busy worker must take it off that worker's queue.
+ */
+void test_pool_delayed_work(void)
+{
+	k_delayed_work_init(&delayed_work, work_handler);
+
+	/**TESTPOINT: delayed work runs on the pool*/
+	zassert_equal(k_delayed_work_submit_to_queue(&pool, &delayed_work,
+						     TIMEOUT / 2), 0, NULL);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+
+	/* keep both workers busy so the item stays queued */
+	k_work_init(&block_work, block_handler);
+	k_work_init(&work[0], block_handler);
+	k_work_submit_to_queue(&pool, &block_work);
+	k_work_submit_to_queue(&pool, &work[0]);
+	k_sleep(1);
+
+	/**TESTPOINT: a queued delayed work item can be cancelled*/
+	zassert_equal(k_delayed_work_submit_to_queue(&pool, &delayed_work,
+						     K_NO_WAIT), 0, NULL);
+	zassert_true(k_work_pending(&delayed_work.work), NULL);
+	zassert_equal(k_delayed_work_cancel(&delayed_work), 0, NULL);
+	zassert_false(k_work_pending(&delayed_work.work), NULL);
+
+	k_sem_give(&block_sema);
+	k_sem_give(&block_sema);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+
+	/* nothing else may run */
+	zassert_not_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+}
+
+/**
+ * @brief Test k_work_submit_to_user_queue() on a pool
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details A supervisor thread submitting with the user queue API must
+ * have the work item handed to the pool's workers, which never read
+ * the workqueue's k_queue.
+ */
+void test_pool_user_queue_submit(void)
+{
+	k_work_init(&work[0], work_handler);
+
+	/**TESTPOINT: the work item runs on the pool*/
+	zassert_equal(k_work_submit_to_user_queue(&pool, &work[0]), 0, NULL);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+}
+
+/**
+ * @brief Test the pool latency histogram
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details Every work item that ran is accounted for in exactly one
+ * bucket.
+ */
+void test_pool_latency_stats(void)
+{
+	u32_t before = executed();
+
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		k_work_init(&work[i], work_handler);
+		k_work_submit_to_queue(&pool, &work[i]);
+	}
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	}
+
+	zassert_equal(executed() - before, NUM_OF_WORK, NULL);
+}
+
+void test_main(void)
+{
+	k_work_q_pool_start(&pool, pool_workers, NUM_WORKERS,
+			    (k_thread_stack_t *)pool_stacks, STACK_SIZE,
+			    K_PRIO_PREEMPT(1));
+
+	ztest_test_suite(workqueue_pool,
+			 ztest_unit_test(test_pool_no_head_of_line_blocking),
+			 ztest_unit_test(test_pool_isr_submit),
+			 ztest_unit_test(test_pool_delayed_work),
+			 ztest_unit_test(test_pool_user_queue_submit),
+			 ztest_unit_test(test_pool_latency_stats));
+	ztest_run_test_suite(workqueue_pool);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * The string routines work a word at a time once aligned, so check them
+ * at every source and destination offset within a word and for lengths
+ * on both sides of the block sizes, against byte by byte references.
+ */
+
+#include <ztest.h>
+#include <string.h>
+
+#define MAX_OFFSET 8
+#define MAX_LEN 80
+#define BUF_LEN (MAX_LEN + 2 * MAX_OFFSET)
+
+/* Guard bytes around the area written must survive */
+#define GUARD 0xA5
+
+static u8_t src[BUF_LEN] __aligned(8);
+static u8_t dst[BUF_LEN] __aligned(8);
+static u8_t ref[BUF_LEN] __aligned(8);
+
+static void fill(u8_t *data, size_t len, u8_t seed)
+{
+	for (size_t i = 0; i < len; i++) {
+		data[i] = i * 13U + seed;
+	}
+}
+
+void test_memcpy_alignment(void)
+{
+	fill(src, BUF_LEN, 1U);
+
+	for (int so = 0; so < MAX_OFFSET; so++) {
+		for (int d_off = 0; d_off < MAX_OFFSET; d_off++) {
+			for (size_t n = 0; n <= MAX_LEN; n++) {
+				(void)memset(dst, GUARD, BUF_LEN);
+				(void)memset(ref, GUARD, BUF_LEN);
+				for (size_t i = 0; i < n; i++) {
+					ref[d_off + i] = src[so + i];
+				}
+
+				zassert_equal(memcpy(dst + d_off, src + so, n),
+					      dst + d_off, NULL);
+				zassert_mem_equal(dst, ref, BUF_LEN,
+						  "offsets %d %d len %zu",
+						  so, d_off, n);
+			}
+		}
+	}
+}
+
+void test_memmove_alignment(void)
+{
+	for (int so = 0; so < MAX_OFFSET; so++) {
+		for (int d_off = 0; d_off < MAX_OFFSET; d_off++) {
+			for (size_t n = 0; n <= MAX_LEN; n++) {
+				fill(dst, BUF_LEN, 5U);
+				fill(ref, BUF_LEN, 5U);
+				fill(src, BUF_LEN, 5U);
+				for (size_t i = 0; i < n; i++) {
+					ref[d_off + i] = src[so + i];
+				}
+
+				(void)memmove(dst + d_off, dst + so, n);
+				zassert_mem_equal(dst, ref, BUF_LEN,
+						  "offsets %d %d len %zu",
+						  so, d_off, n);
+			}
+		}
+	}
+}
+
+void test_memset_alignment(void)
+{
+	for (int off = 0; off < MAX_OFFSET; off++) {
+		for (size_t n = 0; n <= MAX_LEN; n++) {
+			(void)memset(dst, GUARD, BUF_LEN);
+			for (size_t i = 0; i < BUF_LEN; i++) {
+				ref[i] = (i >= (size_t)off && i < off + n) ?
+					 0x3C : GUARD;
+			}
+
+			zassert_equal(memset(dst + off, 0x13C, n), dst + off,
+				      NULL);
+			zassert_mem_equal(dst, ref, BUF_LEN,
+					  "offset %d len %zu", off, n);
+		}
+	}
+}
+
+void test_strlen_alignment(void)
+{
+	(void)memset(src, 'x', BUF_LEN);
+
+	for (int off = 0; off < MAX_OFFSET; off++) {
+		for (size_t n = 0; n < MAX_LEN; n++) {
+			src[off + n] = '\0';
+			zassert_equal(strlen((char *)src + off), n,
+				      "offset %d len %zu", off, n);
+			src[off + n] = 0x80;
+		}
+	}
+}
+
+void test_strcmp_alignment(void)
+{
+	char *s1 = (char *)src, *s2 = (char *)dst;
+
+	for (int o1 = 0; o1 < MAX_OFFSET; o1++) {
+		for (int o2 = 0; o2 < MAX_OFFSET; o2++) {
+			for (size_t n = 0; n < MAX_LEN; n++) {
+				(void)memset(src, 'a', BUF_LEN);
+				(void)memset(dst, 'a', BUF_LEN);
+				s1[o1 + n] = '\0';
+				s2[o2 + n] = '\0';
+				zassert_equal(strcmp(s1 + o1, s2 + o2), 0,
+					      "offsets %d %d len %zu",
+					      o1, o2, n);
+
+				if (n == 0) {
+					continue;
+				}
+
+				/* differ in the last byte only */
+				s2[o2 + n - 1] = 'b';
+				zassert_true(strcmp(s1 + o1, s2 + o2) < 0,
+					     "offsets %d %d len %zu",
+					     o1, o2, n);
+				zassert_true(strcmp(s2 + o2, s1 + o1) > 0,
+					     "offsets %d %d len %zu",
+					     o1, o2, n);
+
+				/* one string is a prefix of the other */
+				s2[o2 + n - 1] = '\0';
+				zassert_true(strcmp(s1 + o1, s2 + o2) > 0,
+					     "offsets %d %d len %zu",
+					     o1, o2, n);
+			}
+		}
+	}
+}
+
+void test_memchr_alignment(void)
+{
+	(void)memset(src, 'x', BUF_LEN);
+
+	for (int off = 0; off < MAX_OFFSET; off++) {
+		for (size_t n = 0; n <= MAX_LEN; n++) {
+			u8_t *p = src + off;
+
+			zassert_is_null(memchr(p, 'y', n), NULL);
+
+			for (size_t at = 0; at < n; at++) {
+				p[at] = 'y';
+				zassert_equal(memchr(p, 'y', n), p + at,
+					      "offset %d len %zu at %zu",
+					      off, n, at);
+				zassert_is_null(memchr(p, 'y', at), NULL);
+				p[at] = 'x';
+			}
+
+			/* a match just past the end is not found */
+			p[n] = 'y';
+			zassert_is_null(memchr(p, 'y', n), NULL);
+			p[n] = 'x';
+		}
+	}
+}
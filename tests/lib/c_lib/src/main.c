@@ -27,6 +27,13 @@
 #include <string.h>
 #include <stdlib.h>
 
+extern void test_memcpy_alignment(void);
+extern void test_memmove_alignment(void);
+extern void test_memset_alignment(void);
+extern void test_strlen_alignment(void);
+extern void test_strcmp_alignment(void);
+extern void test_memchr_alignment(void);
+
 /* Recent GCC's are issuing a warning for the truncated strncpy()
  * below (the static source string is longer than the locally-defined
  * destination array).  That's exactly the case we're testing, so turn
@@ -335,7 +342,13 @@ void test_main(void)
 			 ztest_unit_test(test_strlen),
 			 ztest_unit_test(test_strcmp),
 			 ztest_unit_test(test_strxspn),
-			 ztest_unit_test(test_bsearch)
+			 ztest_unit_test(test_bsearch),
+			 ztest_unit_test(test_memcpy_alignment),
+			 ztest_unit_test(test_memmove_alignment),
+			 ztest_unit_test(test_memset_alignment),
+			 ztest_unit_test(test_strlen_alignment),
+			 ztest_unit_test(test_strcmp_alignment),
+			 ztest_unit_test(test_memchr_alignment)
 			 );
 	ztest_run_test_suite(test_c_lib);
 }
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/crc.h>
+
+#define BUF_LEN 1000
+#define MAX_OFFSET 8
+#define MAX_LEN 200
+
+static u8_t buf[BUF_LEN + MAX_OFFSET];
+
+static void fill(u8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		data[i] = i * 7U + 3U;
+	}
+}
+
+/* Bit by bit references, whatever implementation was built */
+static u32_t ref_crc32_ieee(const u8_t *data, size_t len)
+{
+	u32_t crc = ~0U;
+
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc >> 1) ^ ((crc & 1U) ? 0xEDB88320U : 0U);
+		}
+	}
+
+	return ~crc;
+}
+
+static u16_t ref_crc16_ccitt(u16_t crc, const u8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc >> 1) ^ ((crc & 1U) ? 0x8408U : 0U);
+		}
+	}
+
+	return crc;
+}
+
+static u16_t ref_crc16_itu_t(u16_t crc, const u8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i] << 8;
+		for (int b = 0; b < 8; b++) {
+			crc = (crc << 1) ^ ((crc & 0x8000U) ? 0x1021U : 0U);
+		}
+	}
+
+	return crc;
+}
+
+static u8_t ref_crc8_ccitt(u8_t crc, const u8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc << 1) ^ ((crc & 0x80U) ? 0x07U : 0U);
+		}
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Test the CRCs of a long buffer
+ *
+ * @details Long enough to go through the slices of table-driven
+ * implementations and the folding of accelerated ones.
+ */
+void test_crc_long_buffer(void)
+{
+	fill(buf, BUF_LEN);
+
+	zassert_equal(crc32_ieee(buf, BUF_LEN), 0x17bc2a46, NULL);
+	zassert_equal(crc16_ccitt(0xffff, buf, BUF_LEN), 0x95d1, NULL);
+	zassert_equal(crc16_itu_t(0, buf, BUF_LEN), 0xa791, NULL);
+	zassert_equal(crc8_ccitt(CRC8_CCITT_INITIAL_VALUE, buf, BUF_LEN),
+		      0x24, NULL);
+}
+
+/**
+ * @brief Test the CRCs of every short length at unaligned addresses
+ *
+ * @details Each length and start offset is checked against a bit by
+ * bit reference, to cover the bytes left over after the last slice.
+ */
+void test_crc_lengths_offsets(void)
+{
+	for (size_t off = 0; off < MAX_OFFSET; off++) {
+		u8_t *data = buf + off;
+
+		fill(data, MAX_LEN);
+
+		for (size_t len = 0; len <= MAX_LEN; len++) {
+			zassert_equal(crc32_ieee(data, len),
+				      ref_crc32_ieee(data, len),
+				      "offset %u length %u", off, len);
+			zassert_equal(crc16_ccitt(0x1d0f, data, len),
+				      ref_crc16_ccitt(0x1d0f, data, len),
+				      "offset %u length %u", off, len);
+			zassert_equal(crc16_itu_t(0x1d0f, data, len),
+				      ref_crc16_itu_t(0x1d0f, data, len),
+				      "offset %u length %u", off, len);
+			zassert_equal(crc8_ccitt(0x5a, data, len),
+				      ref_crc8_ccitt(0x5a, data, len),
+				      "offset %u length %u", off, len);
+		}
+	}
+}
+
+/**
+ * @brief Test computing a CRC-32 in pieces
+ *
+ * @details Updating the CRC with a buffer split anywhere gives the CRC
+ * of the whole buffer.
+ */
+void test_crc32_ieee_update_split(void)
+{
+	u32_t whole, crc;
+
+	fill(buf, BUF_LEN);
+	whole = crc32_ieee(buf, BUF_LEN);
+
+	for (size_t split = 0; split <= BUF_LEN; split += 37) {
+		crc = crc32_ieee(buf, split);
+		crc = crc32_ieee_update(crc, buf + split, BUF_LEN - split);
+		zassert_equal(crc, whole, "split at %u", split);
+	}
+}
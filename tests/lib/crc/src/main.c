@@ -7,6 +7,10 @@
 #include <ztest.h>
 #include <sys/crc.h>
 
+extern void test_crc_long_buffer(void);
+extern void test_crc_lengths_offsets(void);
+extern void test_crc32_ieee_update_split(void);
+
 void test_crc32_ieee(void)
 {
 	u8_t test1[] = { 'A' };
@@ -127,6 +131,9 @@ void test_main(void)
 			 ztest_unit_test(test_crc16_ccitt_for_ppp),
 			 ztest_unit_test(test_crc16_itu_t),
 			 ztest_unit_test(test_crc8_ccitt),
-			 ztest_unit_test(test_crc7_be));
+			 ztest_unit_test(test_crc7_be),
+			 ztest_unit_test(test_crc_long_buffer),
+			 ztest_unit_test(test_crc_lengths_offsets),
+			 ztest_unit_test(test_crc32_ieee_update_split));
 	ztest_run_test_suite(test_crc);
 }
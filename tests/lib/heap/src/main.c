@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+#include <sys/sys_heap.h>
+
+#define HEAP_SZ 8192
+#define MAX_LIVE 128
+#define N_OPS 4000
+#define K_HEAP_SZ 1024
+#define WAIT_MS 50
+
+/* One extra byte so the heap can be handed a misaligned buffer */
+static char heap_mem[HEAP_SZ + 1];
+static struct sys_heap heap;
+
+static struct {
+	u8_t *mem;
+	size_t bytes;
+} live[MAX_LIVE];
+
+K_HEAP_DEFINE(test_kheap, SYS_HEAP_BUF_SIZE(K_HEAP_SZ, 2));
+
+static struct k_thread free_thread;
+static K_THREAD_STACK_DEFINE(free_stack, 1024);
+
+static u32_t lcg_state = 1U;
+
+static u32_t lcg(void)
+{
+	lcg_state = lcg_state * 1103515245U + 12345U;
+	return lcg_state >> 8;
+}
+
+static void check_pattern(int i)
+{
+	for (size_t b = 0; b < live[i].bytes; b++) {
+		zassert_equal(live[i].mem[b], (u8_t)(i + b),
+			      "block %d corrupted at %d", i, (int)b);
+	}
+}
+
+/**
+ * @brief Random alloc/free with full consistency checks
+ *
+ * Allocates and frees blocks of random sizes, filling each with a
+ * pattern that is verified on free, and validates the heap after
+ * every operation.
+ */
+void test_heap_spam(void)
+{
+	struct sys_heap_stats stats;
+	size_t initial;
+
+	sys_heap_init(&heap, heap_mem + 1, HEAP_SZ);
+	zassert_true(sys_heap_validate(&heap), NULL);
+
+	sys_heap_stats_get(&heap, &stats);
+	zassert_equal(stats.free_blocks, 1, NULL);
+	zassert_true(stats.free_bytes > HEAP_SZ * 8 / 10, NULL);
+	initial = stats.free_bytes;
+
+	for (int op = 0; op < N_OPS; op++) {
+		int i = lcg() % MAX_LIVE;
+
+		if (live[i].mem != NULL) {
+			check_pattern(i);
+			sys_heap_free(&heap, live[i].mem);
+			live[i].mem = NULL;
+		} else {
+			live[i].bytes = lcg() % 300;
+			live[i].mem = sys_heap_alloc(&heap, live[i].bytes);
+			if (live[i].mem != NULL) {
+				zassert_true(((uintptr_t)live[i].mem &
+					      (sizeof(void *) - 1)) == 0,
+					     "misaligned block");
+				zassert_true(sys_heap_usable_size(&heap,
+							live[i].mem)
+					     >= live[i].bytes, NULL);
+				for (size_t b = 0; b < live[i].bytes; b++) {
+					live[i].mem[b] = (u8_t)(i + b);
+				}
+			}
+		}
+
+		zassert_true(sys_heap_validate(&heap), "op %d", op);
+	}
+
+	for (int i = 0; i < MAX_LIVE; i++) {
+		if (live[i].mem != NULL) {
+			check_pattern(i);
+			sys_heap_free(&heap, live[i].mem);
+			live[i].mem = NULL;
+		}
+	}
+
+	/* Everything must have coalesced back into one block */
+	zassert_true(sys_heap_validate(&heap), NULL);
+	sys_heap_stats_get(&heap, &stats);
+	zassert_equal(stats.free_blocks, 1, NULL);
+	zassert_equal(stats.free_bytes, initial, NULL);
+	zassert_equal(stats.allocated_bytes, 0, NULL);
+	zassert_true(stats.max_allocated_bytes > 0, NULL);
+}
+
+/**
+ * @brief Heap edge cases: oversized requests and exhaustion
+ */
+void test_heap_limits(void)
+{
+	void *p, *q;
+	int n = 0;
+
+	sys_heap_init(&heap, heap_mem, HEAP_SZ);
+
+	zassert_is_null(sys_heap_alloc(&heap, HEAP_SZ), NULL);
+	zassert_is_null(sys_heap_alloc(&heap, (size_t)-1), NULL);
+
+	p = sys_heap_alloc(&heap, 0);
+	zassert_not_null(p, NULL);
+	sys_heap_free(&heap, p);
+	sys_heap_free(&heap, NULL);
+
+	/* Half the heap fits, twice over it doesn't */
+	p = sys_heap_alloc(&heap, HEAP_SZ / 2);
+	zassert_not_null(p, NULL);
+	zassert_is_null(sys_heap_alloc(&heap, HEAP_SZ / 2), NULL);
+	sys_heap_free(&heap, p);
+
+	/* Exhaust with small blocks, then check that they all fit */
+	while (n < MAX_LIVE && (q = sys_heap_alloc(&heap, 32)) != NULL) {
+		live[n++].mem = q;
+	}
+	zassert_equal(n, MAX_LIVE, "only %d small blocks fit", n);
+	while (n-- > 0) {
+		sys_heap_free(&heap, live[n].mem);
+		live[n].mem = NULL;
+	}
+
+	zassert_true(sys_heap_validate(&heap), NULL);
+}
+
+static void free_later(void *p1, void *p2, void *p3)
+{
+	k_sleep(WAIT_MS / 2);
+	k_heap_free(&test_kheap, p1);
+}
+
+/**
+ * @brief k_heap_alloc() timeout and wakeup semantics
+ */
+void test_k_heap_wait(void)
+{
+	void *blk[8];
+	s64_t start;
+	int n = 0;
+
+	while (n < ARRAY_SIZE(blk) &&
+	       (blk[n] = k_heap_alloc(&test_kheap, K_HEAP_SZ / 2,
+				      K_NO_WAIT)) != NULL) {
+		n++;
+	}
+
+	/* SYS_HEAP_BUF_SIZE() promises room for both halves */
+	zassert_true(n >= 2 && n < ARRAY_SIZE(blk), "%d blocks fit", n);
+
+	start = k_uptime_get();
+	zassert_is_null(k_heap_alloc(&test_kheap, K_HEAP_SZ / 2, WAIT_MS),
+			NULL);
+	zassert_true(k_uptime_get() - start >= WAIT_MS, NULL);
+
+	/* A free from another thread satisfies a blocked allocation */
+	k_thread_create(&free_thread, free_stack,
+			K_THREAD_STACK_SIZEOF(free_stack), free_later,
+			blk[0], NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+
+	blk[0] = k_heap_alloc(&test_kheap, K_HEAP_SZ / 2, K_FOREVER);
+	zassert_not_null(blk[0], NULL);
+	k_thread_abort(&free_thread);
+
+	while (n-- > 0) {
+		k_heap_free(&test_kheap, blk[n]);
+	}
+}
+
+#ifdef CONFIG_MEM_POOL_HEAP_BACKEND
+/**
+ * @brief k_malloc() served by the heap backend coalesces on free
+ */
+void test_k_malloc_heap_backend(void)
+{
+	void *p[8];
+
+	for (int i = 0; i < ARRAY_SIZE(p); i++) {
+		p[i] = k_malloc(CONFIG_HEAP_MEM_POOL_SIZE / 16);
+		zassert_not_null(p[i], NULL);
+	}
+	for (int i = 0; i < ARRAY_SIZE(p); i++) {
+		k_free(p[i]);
+	}
+
+	/* Only possible if the freed neighbours merged again */
+	p[0] = k_calloc(1, CONFIG_HEAP_MEM_POOL_SIZE * 3 / 4);
+	zassert_not_null(p[0], NULL);
+	k_free(p[0]);
+}
+#else
+void test_k_malloc_heap_backend(void)
+{
+	ztest_test_skip();
+}
+#endif
+
+void test_main(void)
+{
+	ztest_test_suite(test_heap,
+			 ztest_unit_test(test_heap_spam),
+			 ztest_unit_test(test_heap_limits),
+			 ztest_unit_test(test_k_heap_wait),
+			 ztest_unit_test(test_k_malloc_heap_backend));
+	ztest_run_test_suite(test_heap);
+}
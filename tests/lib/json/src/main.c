@@ -519,6 +519,13 @@ static void test_json_escape_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check OK");
 }
 
+extern void test_json_stream_chunks(void);
+extern void test_json_stream_numbers(void);
+extern void test_json_stream_strings(void);
+extern void test_json_stream_skip(void);
+extern void test_json_stream_invalid(void);
+extern void test_json_stream_net_buf(void);
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -539,7 +546,13 @@ void test_main(void)
 			 ztest_unit_test(test_json_escape_one),
 			 ztest_unit_test(test_json_escape_empty),
 			 ztest_unit_test(test_json_escape_no_op),
-			 ztest_unit_test(test_json_escape_bounds_check)
+			 ztest_unit_test(test_json_escape_bounds_check),
+			 ztest_unit_test(test_json_stream_chunks),
+			 ztest_unit_test(test_json_stream_numbers),
+			 ztest_unit_test(test_json_stream_strings),
+			 ztest_unit_test(test_json_stream_skip),
+			 ztest_unit_test(test_json_stream_invalid),
+			 ztest_unit_test(test_json_stream_net_buf)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <data/json.h>
+#include <net/buf.h>
+
+#define MAX_TOKENS 32
+
+/* Tokens as "<type>[<depth>]<text>", e.g. "\"[1]key:" or "0[1]12" */
+static char tokens[MAX_TOKENS][48];
+static int n_tokens;
+static const char *skip_key;
+static s64_t last_i64;
+static double last_dbl;
+static bool last_integer;
+
+static int record(const struct json_stream_token *token, void *user_data)
+{
+	char *out = tokens[n_tokens];
+
+	ARG_UNUSED(user_data);
+	zassert_true(n_tokens < MAX_TOKENS, "too many tokens");
+	n_tokens++;
+
+	snprintk(out, sizeof(tokens[0]), "%c[%u]%s%s", token->type,
+		 token->depth, token->str ? token->str : "",
+		 token->key ? ":" : "");
+
+	if (token->type == JSON_TOK_NUMBER) {
+		last_integer = token->integer;
+		last_i64 = token->i64;
+		last_dbl = token->dbl;
+	}
+
+	if (token->key && skip_key != NULL && !strcmp(token->str, skip_key)) {
+		return JSON_STREAM_SKIP;
+	}
+
+	return 0;
+}
+
+/* Parse in chunks of chunk_len bytes */
+static int parse(const char *json, size_t chunk_len)
+{
+	static char buf[32];
+	struct json_stream js;
+	size_t len = strlen(json);
+	int ret = 0;
+
+	n_tokens = 0;
+	json_stream_init(&js, record, NULL, buf, sizeof(buf));
+
+	for (size_t off = 0; off < len && ret == 0; off += chunk_len) {
+		ret = json_stream_feed(&js, json + off,
+				       MIN(chunk_len, len - off));
+	}
+
+	if (ret == 0) {
+		ret = json_stream_finish(&js);
+	}
+
+	return ret;
+}
+
+static const char *const nested_tokens[] = {
+	"{[0]", "\"[1]a:", "[[1]", "0[2]1", "t[2]", "n[2]", "][1]",
+	"\"[1]b:", "{[1]", "\"[2]c:", "\"[2]x\ty", "}[1]", "}[0]",
+};
+
+/**
+ * @brief Test parsing input split at every possible place
+ *
+ * @details The same tokens are reported whatever the chunk size, down
+ * to one byte at a time.
+ */
+void test_json_stream_chunks(void)
+{
+	const char *json = " {\"a\" : [1, true,null], "
+			   "\"b\":{\"c\":\"x\\ty\"}} ";
+
+	for (size_t chunk = 1; chunk <= strlen(json); chunk++) {
+		zassert_equal(parse(json, chunk), 0, "chunk %u", chunk);
+		zassert_equal(n_tokens, ARRAY_SIZE(nested_tokens), NULL);
+		for (int i = 0; i < n_tokens; i++) {
+			zassert_true(!strcmp(tokens[i], nested_tokens[i]),
+				     "token %d is %s", i, tokens[i]);
+		}
+	}
+}
+
+/**
+ * @brief Test decoding numbers
+ *
+ * @details Integers within the range of s64_t are reported as such,
+ * others as doubles; invalid numbers are rejected.
+ */
+void test_json_stream_numbers(void)
+{
+	zassert_equal(parse("[9223372036854775807]", 3), 0, NULL);
+	zassert_true(last_integer, NULL);
+	zassert_equal(last_i64, INT64_MAX, NULL);
+
+	zassert_equal(parse("[-9223372036854775808]", 3), 0, NULL);
+	zassert_true(last_integer, NULL);
+	zassert_equal(last_i64, INT64_MIN, NULL);
+
+	/* TESTPOINT: integer out of range */
+	zassert_equal(parse("[9223372036854775808]", 3), 0, NULL);
+	zassert_false(last_integer, NULL);
+	zassert_true(last_dbl > 9.2e18 && last_dbl < 9.3e18, NULL);
+
+	zassert_equal(parse("[-12.5e-1]", 4), 0, NULL);
+	zassert_false(last_integer, NULL);
+	zassert_true(last_dbl == -1.25, NULL);
+
+	zassert_equal(parse("[0.1]", 2), 0, NULL);
+	zassert_true(last_dbl > 0.0999999 && last_dbl < 0.1000001, NULL);
+
+	/* TESTPOINT: a number ending the input */
+	zassert_equal(parse("42", 1), 0, NULL);
+	zassert_true(last_integer && last_i64 == 42, NULL);
+
+	/* TESTPOINT: invalid numbers */
+	zassert_equal(parse("[01]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[1.]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[1e]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[--1]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[1e999]", 1), -ERANGE, NULL);
+}
+
+/**
+ * @brief Test unescaping strings
+ *
+ * @details Escapes are decoded, \\u escapes to UTF-8, surrogate pairs
+ * included, even when split between chunks.
+ */
+void test_json_stream_strings(void)
+{
+	zassert_equal(parse("[\"\\u00e9\\ud83d\\ude00\\/\"]", 1), 0, NULL);
+	zassert_equal(n_tokens, 3, NULL);
+	zassert_true(!strcmp(tokens[1], "\"[1]\xc3\xa9\xf0\x9f\x98\x80/"),
+		     NULL);
+
+	/* TESTPOINT: invalid strings */
+	zassert_equal(parse("[\"\\x\"]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[\"\\u12g4\"]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[\"a\nb\"]", 1), -EINVAL, NULL);
+
+	/* TESTPOINT: a string longer than the buffer */
+	zassert_equal(parse("[\"0123456789012345678901234567890123\"]", 8),
+		      -ENOMEM, NULL);
+}
+
+/**
+ * @brief Test skipping values
+ *
+ * @details The value of a key the callback asks to skip is not
+ * reported, however large or nested, and may hold strings longer than
+ * the buffer.
+ */
+void test_json_stream_skip(void)
+{
+	skip_key = "b";
+	zassert_equal(parse("{\"a\":1,\"b\":{\"x\":[1,{\"y\": "
+			    "\"01234567890123456789012345678901234\"}]}, "
+			    "\"c\":2}", 5), 0, NULL);
+	skip_key = NULL;
+
+	zassert_equal(n_tokens, 7, NULL);
+	zassert_true(!strcmp(tokens[3], "\"[1]b:"), NULL);
+	zassert_true(!strcmp(tokens[4], "\"[1]c:"), NULL);
+	zassert_true(!strcmp(tokens[6], "}[0]"), NULL);
+}
+
+/**
+ * @brief Test rejecting invalid JSON
+ */
+void test_json_stream_invalid(void)
+{
+	zassert_equal(parse("{\"a\" 1}", 1), -EINVAL, NULL);
+	zassert_equal(parse("{\"a\":1,}", 1), -EINVAL, NULL);
+	zassert_equal(parse("[1 2]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[1}", 1), -EINVAL, NULL);
+	zassert_equal(parse("{1:2}", 1), -EINVAL, NULL);
+	zassert_equal(parse("[tru]", 1), -EINVAL, NULL);
+	zassert_equal(parse("{} {}", 1), -EINVAL, NULL);
+
+	/* TESTPOINT: only the matching bracket ends a nested container */
+	zassert_equal(parse("[[1 2]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[[1 {]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[[1:]", 1), -EINVAL, NULL);
+	zassert_equal(parse("[[][", 1), -EINVAL, NULL);
+	zassert_equal(parse("{\"a\":{} 1}", 1), -EINVAL, NULL);
+
+	/* TESTPOINT: incomplete input */
+	zassert_equal(parse("{\"a\":[1", 1), -EINVAL, NULL);
+	zassert_equal(parse("", 1), -EINVAL, NULL);
+}
+
+NET_BUF_POOL_DEFINE(json_pool, 8, 16, 0, NULL);
+
+/**
+ * @brief Test writing JSON straight to network buffers, and parsing it
+ * back from them
+ *
+ * @details The writer separates members and escapes strings; its output
+ * spans several buffers, which the parser reads in place.
+ */
+void test_json_stream_net_buf(void)
+{
+	static char buf[32];
+	const char *expected = "{\"id\":-42,\"t\":[1.5,2.5e-7,1e+20],"
+			       "\"s\":\"a\\\"\\u0001\",\"ok\":true,\"n\":null}";
+	struct net_buf *frags = net_buf_alloc(&json_pool, K_NO_WAIT);
+	struct json_writer jw;
+	struct json_stream js;
+	char out[128];
+
+	zassert_not_null(frags, NULL);
+	json_writer_init(&jw, json_append_bytes_net_buf, frags);
+
+	zassert_equal(json_writer_obj_start(&jw), 0, NULL);
+	zassert_equal(json_writer_key(&jw, "id"), 0, NULL);
+	zassert_equal(json_writer_int64(&jw, -42), 0, NULL);
+	zassert_equal(json_writer_key(&jw, "t"), 0, NULL);
+	zassert_equal(json_writer_arr_start(&jw), 0, NULL);
+	zassert_equal(json_writer_double(&jw, 1.5), 0, NULL);
+	zassert_equal(json_writer_double(&jw, 2.5e-7), 0, NULL);
+	zassert_equal(json_writer_double(&jw, 1e20), 0, NULL);
+	zassert_equal(json_writer_arr_end(&jw), 0, NULL);
+	zassert_equal(json_writer_key(&jw, "s"), 0, NULL);
+	zassert_equal(json_writer_str(&jw, "a\"\x01"), 0, NULL);
+	zassert_equal(json_writer_key(&jw, "ok"), 0, NULL);
+	zassert_equal(json_writer_bool(&jw, true), 0, NULL);
+	zassert_equal(json_writer_key(&jw, "n"), 0, NULL);
+	zassert_equal(json_writer_null(&jw), 0, NULL);
+	zassert_equal(json_writer_obj_end(&jw), 0, NULL);
+
+	/* TESTPOINT: unbalanced end, and values that JSON can't hold */
+	zassert_equal(json_writer_obj_end(&jw), -EINVAL, NULL);
+	zassert_equal(json_writer_double(&jw, __builtin_inf()), -EINVAL,
+		      NULL);
+
+	zassert_not_null(frags->frags, "output should span buffers");
+	out[net_buf_linearize(out, sizeof(out) - 1, frags, 0,
+			      sizeof(out) - 1)] = '\0';
+	zassert_true(!strcmp(out, expected), "wrote %s", out);
+
+	/* TESTPOINT: parse back from the buffers */
+	n_tokens = 0;
+	json_stream_init(&js, record, NULL, buf, sizeof(buf));
+	zassert_equal(json_stream_feed_net_buf(&js, frags), 0, NULL);
+	zassert_equal(json_stream_finish(&js), 0, NULL);
+	zassert_equal(n_tokens, 16, NULL);
+	zassert_true(!strcmp(tokens[10], "\"[1]a\"\x01"), NULL);
+
+	net_buf_unref(frags);
+}
@@ -24,6 +24,11 @@
 
 #define BUF_LEN 10
 
+extern void test_mallinfo(void);
+extern void test_malloc_thread_cache(void);
+extern void test_malloc_thread_cache_large(void);
+extern void test_malloc_thread_cache_idle(void);
+
 /**
  * @brief Test dynamic memory allocation using malloc
  *
@@ -206,7 +211,11 @@ void test_main(void)
 			 ztest_user_unit_test(test_realloc),
 			 ztest_user_unit_test(test_reallocarray),
 			 ztest_user_unit_test(test_memalloc_all),
-			 ztest_user_unit_test(test_memalloc_max)
+			 ztest_user_unit_test(test_memalloc_max),
+			 ztest_user_unit_test(test_mallinfo),
+			 ztest_user_unit_test(test_malloc_thread_cache),
+			 ztest_user_unit_test(test_malloc_thread_cache_large),
+			 ztest_unit_test(test_malloc_thread_cache_idle)
 			 );
 	ztest_run_test_suite(test_c_lib_dynamic_memalloc);
 }
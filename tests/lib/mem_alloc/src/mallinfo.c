@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Tests of the minimal libc malloc() statistics and thread caches
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <stdlib.h>
+#include <malloc.h>
+
+#ifdef CONFIG_NEWLIB_LIBC
+void test_mallinfo(void)
+{
+	/* The minimal libc's mallinfo() is tested */
+	ztest_test_skip();
+}
+#else
+void test_mallinfo(void)
+{
+	struct mallinfo before, during, after;
+	void *ptr;
+
+	(void)malloc_trim(0);
+	before = mallinfo();
+	zassert_equal(before.arena, CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE,
+		      NULL);
+	zassert_true(before.fordblks > 0, NULL);
+	zassert_true(before.keepcost <= before.fordblks, NULL);
+
+	ptr = malloc(300);
+	zassert_not_null(ptr, NULL);
+
+	during = mallinfo();
+	zassert_true(during.uordblks >= before.uordblks + 300, NULL);
+	zassert_true(during.usmblks >= during.uordblks, NULL);
+	zassert_true(during.fordblks < before.fordblks, NULL);
+
+	free(ptr);
+	(void)malloc_trim(0);
+
+	after = mallinfo();
+	zassert_equal(after.uordblks, before.uordblks, NULL);
+	zassert_equal(after.usmblks, during.usmblks, NULL);
+	zassert_equal(after.fordblks, before.fordblks, NULL);
+	zassert_equal(after.smblks, 0, NULL);
+}
+#endif
+
+#ifdef CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHE
+#define N_SMALL 128
+
+static ZTEST_BMEM void *small[N_SMALL];
+
+void test_malloc_thread_cache(void)
+{
+	struct mallinfo info;
+	void *ptr, *again;
+	int n;
+
+	(void)malloc_trim(0);
+
+	/* A freed small block is cached and handed out again for a
+	 * request of the same size class, here 64 bytes
+	 */
+	ptr = malloc(48);
+	zassert_not_null(ptr, NULL);
+	free(ptr);
+
+	info = mallinfo();
+	zassert_equal(info.smblks, 1, NULL);
+	zassert_equal(info.fsmblks, 64, NULL);
+
+	again = malloc(60);
+	zassert_equal(again, ptr, "cached block not reused");
+	free(again);
+
+	zassert_equal(malloc_trim(0), 1, NULL);
+	info = mallinfo();
+	zassert_equal(info.smblks, 0, NULL);
+	zassert_equal(info.fsmblks, 0, NULL);
+
+	/* Fill the arena with small blocks, free them into the cache,
+	 * which holds up to a bin's worth, and check that a large
+	 * allocation still succeeds by flushing the caches
+	 */
+	for (n = 0; n < N_SMALL; n++) {
+		small[n] = malloc(16);
+		if (small[n] == NULL) {
+			break;
+		}
+	}
+	zassert_true(n > CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHE_BLOCKS,
+		     "arena too small for the test");
+
+	for (int i = 0; i < n; i++) {
+		free(small[i]);
+	}
+
+	info = mallinfo();
+	zassert_true(info.smblks > 0, NULL);
+	zassert_true(info.smblks <=
+		     CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHE_BLOCKS, NULL);
+
+	ptr = malloc(CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE / 4);
+	zassert_not_null(ptr, "caches not flushed when the arena ran out");
+	free(ptr);
+}
+
+void test_malloc_thread_cache_large(void)
+{
+	struct mallinfo before, after;
+	void *ptr;
+
+	(void)malloc_trim(0);
+	before = mallinfo();
+
+	/* Blocks larger than the largest class go back to the shared
+	 * heap at once, not into the cache
+	 */
+	ptr = malloc(CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE / 4);
+	zassert_not_null(ptr, NULL);
+	free(ptr);
+
+	after = mallinfo();
+	zassert_equal(after.smblks, 0, "large block cached");
+	zassert_equal(after.fsmblks, 0, NULL);
+	zassert_equal(after.fordblks, before.fordblks, NULL);
+}
+
+#define IDLE_STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static K_THREAD_STACK_DEFINE(idle_stack, IDLE_STACK_SIZE);
+static struct k_thread idle_thread;
+
+static void idle_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	free(malloc(200));
+}
+
+void test_malloc_thread_cache_idle(void)
+{
+	struct mallinfo info;
+
+	(void)malloc_trim(0);
+
+	/* A higher priority thread runs to completion at once,
+	 * leaving a 256 byte block in its cache
+	 */
+	k_thread_create(&idle_thread, idle_stack, IDLE_STACK_SIZE,
+			idle_entry, NULL, NULL, NULL,
+			k_thread_priority_get(k_current_get()) - 1, 0,
+			K_NO_WAIT);
+	k_thread_abort(&idle_thread);
+
+	info = mallinfo();
+	zassert_equal(info.fsmblks, 256, NULL);
+
+	/* Two trims started from this thread's cache return it */
+	for (int i = 0; i < CONFIG_MINIMAL_LIBC_MALLOC_THREAD_CACHE_TRIM_OPS;
+	     i++) {
+		free(malloc(16));
+	}
+
+	info = mallinfo();
+	zassert_true(info.fsmblks <= 16, "idle cache not trimmed");
+}
+#else
+void test_malloc_thread_cache(void)
+{
+	ztest_test_skip();
+}
+
+void test_malloc_thread_cache_large(void)
+{
+	ztest_test_skip();
+}
+
+void test_malloc_thread_cache_idle(void)
+{
+	ztest_test_skip();
+}
+#endif
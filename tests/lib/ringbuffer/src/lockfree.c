@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2019 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/ring_buffer.h>
+
+#define SPSC_POW 6
+#define SPSC_SIZE BIT(SPSC_POW)
+#define MPSC_POW 6
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define N_PRODUCERS 2
+
+#define STRESS_BYTES 200000
+#define STRESS_ITEMS 20000
+
+RING_BUF_SPSC_DECLARE_POW2(spsc_buf, SPSC_POW);
+RING_BUF_MPSC_DECLARE_POW2(mpsc_buf, MPSC_POW);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, N_PRODUCERS + 1, STACK_SIZE);
+static struct k_thread threads[N_PRODUCERS + 1];
+static K_SEM_DEFINE(done_sem, 0, N_PRODUCERS + 1);
+
+/* Wait for the threads to be done, and make sure they are gone before
+ * their structs are used again
+ */
+static void wait_done(int count)
+{
+	for (int i = 0; i < count; i++) {
+		zassert_equal(k_sem_take(&done_sem, K_SECONDS(60)), 0, NULL);
+	}
+
+	for (int i = 0; i < count; i++) {
+		k_thread_abort(&threads[i]);
+	}
+}
+
+/**
+ * @brief Test claiming both areas of a wrapping SPSC claim
+ *
+ * @details Once the indexes are past the middle of the buffer, a claim
+ * of the whole free space spans the end and the start of the buffer,
+ * and the whole buffer can be filled.
+ */
+void test_spsc_claim_wrap(void)
+{
+	struct ring_buf_segs segs;
+	u8_t data[SPSC_SIZE];
+	u32_t granted;
+
+	zassert_equal(ring_buf_spsc_space_get(&spsc_buf), SPSC_SIZE, NULL);
+
+	for (int i = 0; i < SPSC_SIZE; i++) {
+		data[i] = i;
+	}
+
+	/* Move the indexes to 3/4 of the buffer */
+	zassert_equal(ring_buf_spsc_put(&spsc_buf, data, 3 * SPSC_SIZE / 4),
+		      3 * SPSC_SIZE / 4, NULL);
+	zassert_equal(ring_buf_spsc_get(&spsc_buf, data, 3 * SPSC_SIZE / 4),
+		      3 * SPSC_SIZE / 4, NULL);
+
+	/* TESTPOINT: a claim of the whole buffer comes in two areas */
+	granted = ring_buf_spsc_put_claim(&spsc_buf, &segs, SPSC_SIZE + 1);
+	zassert_equal(granted, SPSC_SIZE, NULL);
+	zassert_equal(segs.size[0], SPSC_SIZE / 4, NULL);
+	zassert_equal(segs.size[1], 3 * SPSC_SIZE / 4, NULL);
+	zassert_equal(segs.data[1], spsc_buf.buf, NULL);
+	memset(segs.data[0], 0x11, segs.size[0]);
+	memset(segs.data[1], 0x22, segs.size[1]);
+
+	/* TESTPOINT: nothing is visible before the claim is finished */
+	zassert_equal(ring_buf_spsc_size_get(&spsc_buf), 0, NULL);
+	zassert_equal(ring_buf_spsc_put_finish(&spsc_buf, SPSC_SIZE + 1),
+		      -EINVAL, NULL);
+	zassert_equal(ring_buf_spsc_put_finish(&spsc_buf, SPSC_SIZE), 0, NULL);
+	zassert_equal(ring_buf_spsc_space_get(&spsc_buf), 0, NULL);
+
+	/* TESTPOINT: the consumer gets the same two areas */
+	granted = ring_buf_spsc_get_claim(&spsc_buf, &segs, SPSC_SIZE);
+	zassert_equal(granted, SPSC_SIZE, NULL);
+	zassert_equal(segs.size[0], SPSC_SIZE / 4, NULL);
+	zassert_equal(segs.data[0][0], 0x11, NULL);
+	zassert_equal(segs.data[1][segs.size[1] - 1], 0x22, NULL);
+	zassert_equal(ring_buf_spsc_get_finish(&spsc_buf, SPSC_SIZE + 1),
+		      -EINVAL, NULL);
+	zassert_equal(ring_buf_spsc_get_finish(&spsc_buf, SPSC_SIZE), 0, NULL);
+	zassert_equal(ring_buf_spsc_size_get(&spsc_buf), 0, NULL);
+
+	/* TESTPOINT: a claim that doesn't wrap has an empty second area */
+	granted = ring_buf_spsc_get_claim(&spsc_buf, &segs, 1);
+	zassert_equal(granted, 0, NULL);
+	granted = ring_buf_spsc_put_claim(&spsc_buf, &segs, 4);
+	zassert_equal(granted, 4, NULL);
+	zassert_equal(segs.size[1], 0, NULL);
+}
+
+/**
+ * @brief Test putting and getting MPSC items
+ *
+ * @details Items come out in order with their type, value and data,
+ * wrapping around the end of the buffer, and failed puts are counted.
+ */
+void test_mpsc_item(void)
+{
+	u32_t in[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	u32_t out[8];
+	u16_t type;
+	u8_t value, size32;
+	int i, n = 0;
+
+	/* TESTPOINT: empty */
+	size32 = ARRAY_SIZE(out);
+	zassert_equal(ring_buf_mpsc_item_get(&mpsc_buf, &type, &value, out,
+					     &size32), -EAGAIN, NULL);
+
+	/* TESTPOINT: full, each item taking 2 extra words */
+	while (ring_buf_mpsc_item_put(&mpsc_buf, n, n, in, 6) == 0) {
+		n++;
+	}
+	zassert_equal(n, BIT(MPSC_POW) / 8, NULL);
+	zassert_equal(atomic_get(&mpsc_buf.dropped_put_count), 1, NULL);
+
+	/* TESTPOINT: too small an output area */
+	size32 = 2;
+	zassert_equal(ring_buf_mpsc_item_get(&mpsc_buf, &type, &value, out,
+					     &size32), -EMSGSIZE, NULL);
+	zassert_equal(size32, 6, NULL);
+
+	/* TESTPOINT: items of 7 words wrap around and come out in order */
+	for (i = 0; i < 3 * n; i++) {
+		size32 = ARRAY_SIZE(out);
+		zassert_equal(ring_buf_mpsc_item_get(&mpsc_buf, &type, &value,
+						     out, &size32), 0, NULL);
+		zassert_equal(type, i, NULL);
+		zassert_equal(value, i, NULL);
+		zassert_equal(size32, i < n ? 6 : 5, NULL);
+		zassert_equal(memcmp(in, out, size32 * sizeof(u32_t)), 0, NULL);
+
+		zassert_equal(ring_buf_mpsc_item_put(&mpsc_buf, i + n, i + n,
+						     in, 5), 0, NULL);
+	}
+
+	size32 = ARRAY_SIZE(out);
+	while (ring_buf_mpsc_item_get(&mpsc_buf, &type, &value, out,
+				      &size32) == 0) {
+		zassert_equal(type, i++, NULL);
+		size32 = ARRAY_SIZE(out);
+	}
+	zassert_equal(i, 4 * n, NULL);
+}
+
+static void spsc_producer(void *p1, void *p2, void *p3)
+{
+	struct ring_buf_segs segs;
+	u32_t sent = 0U, granted, chunk = 1U;
+
+	while (sent < STRESS_BYTES) {
+		granted = ring_buf_spsc_put_claim(&spsc_buf, &segs,
+						  MIN(chunk,
+						      STRESS_BYTES - sent));
+		if (granted == 0U) {
+			k_yield();
+			continue;
+		}
+
+		for (int s = 0; s < 2; s++) {
+			for (u32_t i = 0; i < segs.size[s]; i++) {
+				segs.data[s][i] = (u8_t)(sent++ % 251U);
+			}
+		}
+		ring_buf_spsc_put_finish(&spsc_buf, granted);
+
+		/* Vary the claims to exercise the wrap around */
+		chunk = chunk % (SPSC_SIZE + 3) + 7U;
+	}
+
+	k_sem_give(&done_sem);
+}
+
+static void spsc_consumer(void *p1, void *p2, void *p3)
+{
+	u8_t data[SPSC_SIZE / 3];
+	u32_t received = 0U, len;
+
+	while (received < STRESS_BYTES) {
+		len = ring_buf_spsc_get(&spsc_buf, data, sizeof(data));
+		if (len == 0U) {
+			k_yield();
+			continue;
+		}
+
+		for (u32_t i = 0; i < len; i++, received++) {
+			zassert_equal(data[i], (u8_t)(received % 251U),
+				      "corrupted at byte %u", received);
+		}
+	}
+
+	k_sem_give(&done_sem);
+}
+
+/**
+ * @brief Stress an SPSC ring buffer with a producer and a consumer
+ *
+ * @details A byte sequence sent in chunks of varying sizes is received
+ * intact. With CONFIG_SMP, both sides run at the same time on different
+ * CPUs.
+ */
+void test_spsc_stress(void)
+{
+	k_thread_create(&threads[0], stacks[0], STACK_SIZE, spsc_producer,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	k_thread_create(&threads[1], stacks[1], STACK_SIZE, spsc_consumer,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+
+	wait_done(2);
+	zassert_equal(ring_buf_spsc_size_get(&spsc_buf), 0, NULL);
+}
+
+static void mpsc_producer(void *p1, void *p2, void *p3)
+{
+	u16_t id = POINTER_TO_UINT(p1);
+	u32_t data[3];
+
+	for (u32_t seq = 0U; seq < STRESS_ITEMS; seq++) {
+		data[0] = seq;
+		data[1] = ~seq;
+		data[2] = id;
+
+		while (ring_buf_mpsc_item_put(&mpsc_buf, id, seq, data,
+					      1 + seq % 3) != 0) {
+			k_yield();
+		}
+	}
+
+	k_sem_give(&done_sem);
+}
+
+static void mpsc_consumer(void *p1, void *p2, void *p3)
+{
+	u32_t next[N_PRODUCERS] = { 0 };
+	u32_t data[3];
+	u32_t received = 0U;
+	u16_t id;
+	u8_t value, size32;
+
+	while (received < N_PRODUCERS * STRESS_ITEMS) {
+		size32 = ARRAY_SIZE(data);
+		if (ring_buf_mpsc_item_get(&mpsc_buf, &id, &value, data,
+					   &size32) != 0) {
+			k_yield();
+			continue;
+		}
+
+		/* Each producer's items arrive whole and in order */
+		zassert_true(id < N_PRODUCERS, NULL);
+		zassert_equal(data[0], next[id], NULL);
+		zassert_equal(value, (u8_t)next[id], NULL);
+		zassert_equal(size32, 1 + next[id] % 3, NULL);
+		if (size32 > 1) {
+			zassert_equal(data[1], ~next[id], NULL);
+		}
+		if (size32 > 2) {
+			zassert_equal(data[2], id, NULL);
+		}
+
+		next[id]++;
+		received++;
+	}
+
+	k_sem_give(&done_sem);
+}
+
+/**
+ * @brief Stress an MPSC ring buffer with several producers
+ *
+ * @details Items put concurrently by several producers are all
+ * received, each producer's in order. With CONFIG_SMP, producers and
+ * consumer run at the same time on different CPUs.
+ */
+void test_mpsc_stress(void)
+{
+	for (int i = 0; i < N_PRODUCERS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				mpsc_producer, UINT_TO_POINTER(i), NULL, NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+	k_thread_create(&threads[N_PRODUCERS], stacks[N_PRODUCERS],
+			STACK_SIZE, mpsc_consumer, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+
+	wait_done(N_PRODUCERS + 1);
+}
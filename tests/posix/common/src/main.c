@@ -17,6 +17,7 @@ extern void test_posix_realtime(void);
 extern void test_posix_timer(void);
 extern void test_posix_pthread_execution(void);
 extern void test_posix_pthread_termination(void);
+extern void test_posix_pthread_create_recycle(void);
 extern void test_posix_multiple_threads_single_key(void);
 extern void test_posix_single_thread_multiple_keys(void);
 
@@ -25,6 +26,7 @@ void test_main(void)
 	ztest_test_suite(posix_apis,
 			ztest_unit_test(test_posix_pthread_execution),
 			ztest_unit_test(test_posix_pthread_termination),
+			ztest_unit_test(test_posix_pthread_create_recycle),
 			ztest_unit_test(test_posix_multiple_threads_single_key),
 			ztest_unit_test(test_posix_single_thread_multiple_keys),
 			ztest_unit_test(test_posix_clock),
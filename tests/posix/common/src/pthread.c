@@ -422,3 +422,42 @@ void test_posix_pthread_termination(void)
 	ret = pthread_getschedparam(newthread[N_THR_T/2], &policy, &schedparam);
 	zassert_equal(ret, ESRCH, "got attr from terminated thread!");
 }
+
+static void *thread_top_recycle(void *p1)
+{
+	pthread_exit(p1);
+	return NULL;
+}
+
+/**
+ * @brief Test creating threads without a stack
+ *
+ * @details With CONFIG_PTHREAD_POOL_STACK_SIZE, threads need neither
+ * attributes nor a stack, and joining a thread frees it, so more
+ * threads than CONFIG_MAX_PTHREAD_COUNT can be created one after the
+ * other.
+ */
+void test_posix_pthread_create_recycle(void)
+{
+	pthread_t newthread;
+	void *retval;
+	int ret;
+
+	if (CONFIG_PTHREAD_POOL_STACK_SIZE == 0) {
+		ztest_test_skip();
+	}
+
+	for (int i = 0; i < 2 * CONFIG_MAX_PTHREAD_COUNT; i++) {
+		ret = pthread_create(&newthread, NULL, thread_top_recycle,
+				     INT_TO_POINTER(i));
+		zassert_false(ret, "Not enough space to create new thread");
+
+		ret = pthread_join(newthread, &retval);
+		zassert_false(ret, "Unable to join thread");
+		zassert_equal(POINTER_TO_INT(retval), i, NULL);
+	}
+
+	/* TESTPOINT: a joined thread can't be joined again */
+	ret = pthread_join(newthread, &retval);
+	zassert_equal(ret, ESRCH, "joined a thread twice!");
+}